@@ -0,0 +1,232 @@
+#include "lz4Block.h"
+
+#include <string.h>
+
+#define LZ4_MIN_MATCH 4
+/// The last match must start this number of bytes before the end.
+#define LZ4_MF_LIMIT 12
+/// The last bytes are always literals.
+#define LZ4_LAST_LITERALS 5
+#define LZ4_MAX_DISTANCE 65535
+#define LZ4_HASH_LOG 12
+/// Positions without match after which the search skips more bytes.
+#define LZ4_SKIP_TRIGGER 6
+
+static unsigned int read32(const unsigned char *pointer)
+{
+    unsigned int value = 0;
+
+    memcpy(&value, pointer, sizeof(value));
+    return value;
+}
+
+static unsigned int hashSequence(unsigned int sequence)
+{
+    return (sequence * 2654435761U) >> (32 - LZ4_HASH_LOG);
+}
+
+/**
+ * \brief This function writes a length that doesn't fit in the token.
+ */
+static unsigned char* writeLength(unsigned char *output, size_t length)
+{
+    for(; length >= 255; length -= 255)
+        *output++ = 255;
+
+    *output++ = (unsigned char)length;
+    return output;
+}
+
+/**
+ * \brief This function writes one sequence. When matchLength is 0, only the literals are written.
+ *
+ * \return The end of the sequence. If it doesn't fit, NULL value is returned.
+ */
+static unsigned char* writeSequence(unsigned char *output, const unsigned char *outputEnd, const unsigned char *literals,
+        size_t literalsLength, unsigned int distance, size_t matchLength)
+{
+    unsigned char *token = output++;
+
+    // Worst case of the sequence.
+    if((size_t)(outputEnd - token) < 1 + literalsLength / 255 + 1 + literalsLength + 2 + matchLength / 255 + 1)
+        return NULL;
+
+    if(literalsLength >= 15)
+    {
+        *token = 15 << 4;
+        output = writeLength(output, literalsLength - 15);
+    }
+    else
+    {
+        *token = (unsigned char)(literalsLength << 4);
+    }
+
+    memcpy(output, literals, literalsLength);
+    output += literalsLength;
+
+    if(matchLength > 0)
+    {
+        *output++ = (unsigned char)distance;
+        *output++ = (unsigned char)(distance >> 8);
+        matchLength -= LZ4_MIN_MATCH;
+
+        if(matchLength >= 15)
+        {
+            *token |= 15;
+            output = writeLength(output, matchLength - 15);
+        }
+        else
+        {
+            *token |= (unsigned char)matchLength;
+        }
+    }
+
+    return output;
+}
+
+int eProsimaLz4_compress(const char *source, int sourceLength, char *destination, int destinationCapacity)
+{
+    unsigned int positions[1 << LZ4_HASH_LOG];
+    const unsigned char *input = (const unsigned char*)source;
+    unsigned char *output = (unsigned char*)destination, *outputEnd = output + destinationCapacity;
+    size_t position = 0, anchor = 0, reference = 0, matchLength = 0, matchLimit = 0, searchCount = 0;
+    unsigned int sequence = 0, hash = 0;
+
+    if(source == NULL || destination == NULL || sourceLength < 0 || destinationCapacity <= 0)
+        return 0;
+
+    if(sourceLength > LZ4_MF_LIMIT)
+    {
+        memset(positions, 0, sizeof(positions));
+        matchLimit = (size_t)sourceLength - LZ4_MF_LIMIT;
+
+        while(position < matchLimit)
+        {
+            sequence = read32(input + position);
+            hash = hashSequence(sequence);
+            reference = positions[hash];
+            positions[hash] = (unsigned int)position;
+
+            if(reference >= position || position - reference > LZ4_MAX_DISTANCE || read32(input + reference) != sequence)
+            {
+                // Incompressible data is walked faster.
+                position += 1 + (searchCount++ >> LZ4_SKIP_TRIGGER);
+                continue;
+            }
+
+            matchLength = LZ4_MIN_MATCH;
+
+            while(position + matchLength < (size_t)sourceLength - LZ4_LAST_LITERALS &&
+                    input[reference + matchLength] == input[position + matchLength])
+                ++matchLength;
+
+            output = writeSequence(output, outputEnd, input + anchor, position - anchor, (unsigned int)(position - reference), matchLength);
+
+            if(output == NULL)
+                return 0;
+
+            position += matchLength;
+            anchor = position;
+            searchCount = 0;
+
+            // The position before the end of the match improves the next search.
+            if(position - 2 < matchLimit)
+                positions[hashSequence(read32(input + position - 2))] = (unsigned int)(position - 2);
+        }
+    }
+
+    output = writeSequence(output, outputEnd, input + anchor, (size_t)sourceLength - anchor, 0, 0);
+
+    return output != NULL ? (int)(output - (unsigned char*)destination) : 0;
+}
+
+/**
+ * \brief This function reads a length that doesn't fit in the token.
+ *
+ * \return 0 if the length was read. If the data ends, -1 is returned.
+ */
+static int readLength(const unsigned char **input, const unsigned char *inputEnd, size_t *length)
+{
+    unsigned char byte = 0;
+
+    do
+    {
+        if(*input >= inputEnd)
+            return -1;
+
+        byte = *(*input)++;
+        *length += byte;
+    }
+    while(byte == 255);
+
+    return 0;
+}
+
+int eProsimaLz4_decompress(const char *source, int sourceLength, char *destination, int destinationCapacity)
+{
+    const unsigned char *input = (const unsigned char*)source, *inputEnd = input + sourceLength;
+    unsigned char *output = (unsigned char*)destination, *outputEnd = output + destinationCapacity, *match = NULL;
+    size_t literalsLength = 0, matchLength = 0, distance = 0;
+    unsigned char token = 0;
+
+    if(source == NULL || destination == NULL || sourceLength <= 0 || destinationCapacity < 0)
+        return -1;
+
+    for(;;)
+    {
+        if(input >= inputEnd)
+            return -1;
+
+        token = *input++;
+        literalsLength = token >> 4;
+
+        if(literalsLength == 15 && readLength(&input, inputEnd, &literalsLength) != 0)
+            return -1;
+
+        if((size_t)(inputEnd - input) < literalsLength || (size_t)(outputEnd - output) < literalsLength)
+            return -1;
+
+        memcpy(output, input, literalsLength);
+        input += literalsLength;
+        output += literalsLength;
+
+        // The last sequence only has literals.
+        if(input == inputEnd)
+            break;
+
+        if(inputEnd - input < 2)
+            return -1;
+
+        distance = (size_t)input[0] | ((size_t)input[1] << 8);
+        input += 2;
+
+        if(distance == 0 || distance > (size_t)(output - (unsigned char*)destination))
+            return -1;
+
+        matchLength = token & 15;
+
+        if(matchLength == 15 && readLength(&input, inputEnd, &matchLength) != 0)
+            return -1;
+
+        matchLength += LZ4_MIN_MATCH;
+
+        if((size_t)(outputEnd - output) < matchLength)
+            return -1;
+
+        match = output - distance;
+
+        // The match can overlap the output when the distance is shorter than the length.
+        if(distance >= matchLength)
+        {
+            memcpy(output, match, matchLength);
+            output += matchLength;
+        }
+        else
+        {
+            while(matchLength-- > 0)
+                *output++ = *match++;
+        }
+    }
+
+    return (int)(output - (unsigned char*)destination);
+}
@@ -0,0 +1,45 @@
+#ifndef _EPROSIMA_C_COMPRESS_LZ4BLOCK_H_
+#define _EPROSIMA_C_COMPRESS_LZ4BLOCK_H_
+
+#include "eProsima_c/config.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/**
+ * \brief Maximum size of the compressed data of sourceLength bytes.
+ */
+#define EPROSIMA_LZ4_COMPRESS_BOUND(sourceLength) ((sourceLength) + (sourceLength) / 255 + 16)
+
+/**
+ * \brief This function compresses data in the LZ4 block format. The output can be decompressed by any
+ * LZ4 implementation with LZ4_decompress_safe.
+ *
+ * \param source Data to compress. Cannot be NULL.
+ * \param sourceLength Number of bytes to compress.
+ * \param destination Where the compressed data is written. Cannot be NULL.
+ * \param destinationCapacity Size of destination. Compression stops when it is exceeded, so it can be
+ * used to limit the compressed size.
+ * \return Number of bytes of the compressed data. If it doesn't fit in destination, 0 is returned.
+ */
+int eProsimaLz4_compress(const char *source, int sourceLength, char *destination, int destinationCapacity);
+
+/**
+ * \brief This function decompresses data in the LZ4 block format. Malformed data is detected and
+ * it is never read or written outside the buffers.
+ *
+ * \param source Compressed data. Cannot be NULL.
+ * \param sourceLength Number of bytes of compressed data.
+ * \param destination Where the data is written. Cannot be NULL.
+ * \param destinationCapacity Size of destination.
+ * \return Number of bytes of the data. If the compressed data is malformed or the data doesn't fit, -1 is returned.
+ */
+int eProsimaLz4_decompress(const char *source, int sourceLength, char *destination, int destinationCapacity);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_COMPRESS_LZ4BLOCK_H_
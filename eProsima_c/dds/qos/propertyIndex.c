@@ -0,0 +1,310 @@
+#include "propertyIndex.h"
+
+#include <dds_c/dds_c_infrastructure.h>
+#include <osapi/osapi_heap.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME 16777619U
+
+struct PropertyIndexSlot
+{
+    unsigned int hash;
+    struct DDS_Property_t *property;
+};
+
+struct PropertyIndexSortEntry
+{
+    struct DDS_Property_t *property;
+    int position;
+};
+
+struct eProsima_PropertyIndex
+{
+    const struct DDS_PropertyQosPolicy *policy;
+
+    /// Open-addressing hash table. Its length is a power of two.
+    struct PropertyIndexSlot *slots;
+    unsigned int slotsMask;
+
+    /// Properties sorted by name.
+    struct DDS_Property_t **sorted;
+    /// Position in the sequence of each sorted property.
+    int *positions;
+    int length;
+};
+
+static unsigned int hashString(unsigned int hash, const char *string)
+{
+    for(; *string != '\0'; ++string)
+    {
+        hash ^= (unsigned char)*string;
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+static int compareSortEntries(const void *a, const void *b)
+{
+    const struct PropertyIndexSortEntry *entryA = (const struct PropertyIndexSortEntry*)a;
+    const struct PropertyIndexSortEntry *entryB = (const struct PropertyIndexSortEntry*)b;
+    int returnedValue = strcmp(entryA->property->name, entryB->property->name);
+
+    if(returnedValue == 0)
+        returnedValue = entryA->position - entryB->position;
+
+    return returnedValue;
+}
+
+/**
+ * \brief This function compares the beginning of a name with "prefix.".
+ *
+ * \return Lower than 0 if the name is sorted before the prefix, 0 if the name starts with the prefix
+ * and greater than 0 if the name is sorted after the prefix.
+ */
+static int compareWithPrefix(const char *name, const char *prefix, size_t prefixLength)
+{
+    int returnedValue = strncmp(name, prefix, prefixLength);
+
+    if(returnedValue == 0)
+        returnedValue = (unsigned char)name[prefixLength] - (unsigned char)'.';
+
+    return returnedValue;
+}
+
+struct eProsima_PropertyIndex* eProsimaPropertyIndex_new(const struct DDS_PropertyQosPolicy *policy)
+{
+    const char* const METHOD_NAME = "eProsimaPropertyIndex_new";
+    struct eProsima_PropertyIndex *index = NULL;
+    struct PropertyIndexSortEntry *entries = NULL;
+    struct DDS_Property_t *auxProperty = NULL;
+    unsigned int slotsLength = 1, hash = 0, slot = 0;
+    int propertiesLength = 0, count = 0, i = 0;
+
+    if(policy == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    propertiesLength = DDS_PropertySeq_get_length(&policy->value);
+
+    // The hash table is kept at most half full.
+    while(slotsLength < 2 * (unsigned int)propertiesLength)
+        slotsLength <<= 1;
+
+    RTIOsapiHeap_allocateStructure(&index, struct eProsima_PropertyIndex);
+
+    if(index != NULL)
+    {
+        index->policy = policy;
+        index->slotsMask = slotsLength - 1;
+        index->length = 0;
+        RTIOsapiHeap_allocateArray(&index->slots, slotsLength, struct PropertyIndexSlot);
+        RTIOsapiHeap_allocateArray(&index->sorted, propertiesLength + 1, struct DDS_Property_t*);
+        RTIOsapiHeap_allocateArray(&index->positions, propertiesLength + 1, int);
+        RTIOsapiHeap_allocateArray(&entries, propertiesLength + 1, struct PropertyIndexSortEntry);
+
+        if(index->slots != NULL && index->sorted != NULL && index->positions != NULL && entries != NULL)
+        {
+            memset(index->slots, 0, slotsLength * sizeof(struct PropertyIndexSlot));
+
+            for(i = 0; i < propertiesLength; ++i)
+            {
+                auxProperty = DDS_PropertySeq_get_reference(&policy->value, i);
+
+                if(auxProperty == NULL || auxProperty->name == NULL)
+                    continue;
+
+                entries[count].property = auxProperty;
+                entries[count].position = i;
+                ++count;
+
+                // Only the first property with a name is stored in the hash table.
+                hash = hashString(FNV_OFFSET_BASIS, auxProperty->name);
+
+                for(slot = hash & index->slotsMask; index->slots[slot].property != NULL; slot = (slot + 1) & index->slotsMask)
+                {
+                    if(index->slots[slot].hash == hash && strcmp(index->slots[slot].property->name, auxProperty->name) == 0)
+                        break;
+                }
+
+                if(index->slots[slot].property == NULL)
+                {
+                    index->slots[slot].hash = hash;
+                    index->slots[slot].property = auxProperty;
+                }
+            }
+
+            qsort(entries, count, sizeof(struct PropertyIndexSortEntry), compareSortEntries);
+
+            for(i = 0; i < count; ++i)
+            {
+                index->sorted[i] = entries[i].property;
+                index->positions[i] = entries[i].position;
+            }
+
+            index->length = count;
+            RTIOsapiHeap_freeArray(entries);
+        }
+        else
+        {
+            printf("ERROR<%s>: Cannot allocate memory for the index\n", METHOD_NAME);
+
+            if(entries != NULL)
+                RTIOsapiHeap_freeArray(entries);
+
+            eProsimaPropertyIndex_delete(index);
+            index = NULL;
+        }
+    }
+    else
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the index\n", METHOD_NAME);
+    }
+
+    return index;
+}
+
+void eProsimaPropertyIndex_delete(struct eProsima_PropertyIndex *index)
+{
+    if(index != NULL)
+    {
+        if(index->slots != NULL)
+            RTIOsapiHeap_freeArray(index->slots);
+
+        if(index->sorted != NULL)
+            RTIOsapiHeap_freeArray(index->sorted);
+
+        if(index->positions != NULL)
+            RTIOsapiHeap_freeArray(index->positions);
+
+        RTIOsapiHeap_freeStructure(index);
+    }
+}
+
+const struct DDS_PropertyQosPolicy* eProsimaPropertyIndex_getPolicy(const struct eProsima_PropertyIndex *index)
+{
+    return index != NULL ? index->policy : NULL;
+}
+
+struct DDS_Property_t* eProsimaPropertyIndex_lookup(const struct eProsima_PropertyIndex *index, const char *name)
+{
+    return eProsimaPropertyIndex_lookupWithPrefix(index, NULL, name);
+}
+
+struct DDS_Property_t* eProsimaPropertyIndex_lookupWithPrefix(const struct eProsima_PropertyIndex *index,
+        const char *prefix, const char *name)
+{
+    const struct PropertyIndexSlot *auxSlot = NULL;
+    unsigned int hash = FNV_OFFSET_BASIS, slot = 0;
+    size_t prefixLength = 0;
+
+    if(index == NULL || name == NULL)
+        return NULL;
+
+    if(prefix != NULL)
+    {
+        prefixLength = strlen(prefix);
+        hash = hashString(hash, prefix);
+        hash = hashString(hash, ".");
+    }
+
+    hash = hashString(hash, name);
+
+    for(slot = hash & index->slotsMask; index->slots[slot].property != NULL; slot = (slot + 1) & index->slotsMask)
+    {
+        auxSlot = &index->slots[slot];
+
+        if(auxSlot->hash == hash &&
+                (prefix == NULL || compareWithPrefix(auxSlot->property->name, prefix, prefixLength) == 0) &&
+                strcmp(auxSlot->property->name + (prefix != NULL ? prefixLength + 1 : 0), name) == 0)
+            return auxSlot->property;
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief This function looks for the sorted properties whose name starts with "prefix.".
+ *
+ * \param first Where the position in the sorted array of the first property of the range is stored.
+ * \return Number of properties in the range.
+ */
+static int findPrefixRange(const struct eProsima_PropertyIndex *index, const char *prefix, int *first)
+{
+    size_t prefixLength = strlen(prefix);
+    int low = 0, high = 0, middle = 0;
+
+    // First property that is not sorted before the prefix.
+    low = 0;
+    high = index->length;
+    while(low < high)
+    {
+        middle = low + (high - low) / 2;
+
+        if(compareWithPrefix(index->sorted[middle]->name, prefix, prefixLength) < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    *first = low;
+
+    // First property that is sorted after the prefix.
+    high = index->length;
+    while(low < high)
+    {
+        middle = low + (high - low) / 2;
+
+        if(compareWithPrefix(index->sorted[middle]->name, prefix, prefixLength) <= 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low - *first;
+}
+
+int eProsimaPropertyIndex_getPrefixRange(const struct eProsima_PropertyIndex *index, const char *prefix,
+        struct DDS_Property_t * const **properties)
+{
+    int first = 0, count = 0;
+
+    if(index == NULL || prefix == NULL || properties == NULL)
+        return 0;
+
+    count = findPrefixRange(index, prefix, &first);
+    *properties = index->sorted + first;
+    return count;
+}
+
+int eProsimaPropertyIndex_getPrefixProperties(const struct eProsima_PropertyIndex *index, const char *prefix,
+        struct DDS_Property_t **properties)
+{
+    int first = 0, count = 0, i = 0, j = 0, rank = 0;
+
+    if(index == NULL || prefix == NULL || properties == NULL)
+        return 0;
+
+    count = findPrefixRange(index, prefix, &first);
+
+    // The ranges are short, so each property is stored in the place given by the properties before it.
+    for(i = first; i < first + count; ++i)
+    {
+        rank = 0;
+
+        for(j = first; j < first + count; ++j)
+        {
+            if(index->positions[j] < index->positions[i])
+                ++rank;
+        }
+
+        properties[rank] = index->sorted[i];
+    }
+
+    return count;
+}
@@ -0,0 +1,97 @@
+#ifndef _EPROSIMA_C_DDS_QOS_PROPERTYINDEX_H_
+#define _EPROSIMA_C_DDS_QOS_PROPERTYINDEX_H_
+
+#include "eProsima_c/config.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+struct DDS_PropertyQosPolicy;
+struct DDS_Property_t;
+
+/**
+ * \brief Read-only index over the properties of a DDS_PropertyQosPolicy.
+ *
+ * It contains an open-addressing hash table for lookups by name and an array of the properties
+ * sorted by name for lookups by prefix. The index points to the properties of the policy, so the
+ * policy cannot be modified or destroyed while the index is used.
+ */
+struct eProsima_PropertyIndex;
+
+/**
+ * \brief This function builds the index of a policy.
+ *
+ * \param policy The policy to index. Cannot be NULL.
+ * \return The new index. In error case, NULL value is returned.
+ */
+struct eProsima_PropertyIndex* eProsimaPropertyIndex_new(const struct DDS_PropertyQosPolicy *policy);
+
+/**
+ * \brief This function destroys an index. The indexed policy is not modified.
+ *
+ * \param index The index to destroy.
+ */
+void eProsimaPropertyIndex_delete(struct eProsima_PropertyIndex *index);
+
+/**
+ * \brief This function returns the policy used to build the index.
+ *
+ * \param index The index. Cannot be NULL.
+ * \return The indexed policy.
+ */
+const struct DDS_PropertyQosPolicy* eProsimaPropertyIndex_getPolicy(const struct eProsima_PropertyIndex *index);
+
+/**
+ * \brief This function looks for a property by name. Like DDS_PropertyQosPolicyHelper_lookup_property,
+ * if the name is repeated the first property of the sequence is returned.
+ *
+ * \param index The index. Cannot be NULL.
+ * \param name The name of the property. Cannot be NULL.
+ * \return The property. If it doesn't exist, NULL value is returned.
+ */
+struct DDS_Property_t* eProsimaPropertyIndex_lookup(const struct eProsima_PropertyIndex *index, const char *name);
+
+/**
+ * \brief This function looks for the property "prefix.name" without building the full name.
+ *
+ * \param index The index. Cannot be NULL.
+ * \param prefix The prefix of the property (i.e. "UDPv4"). Cannot be NULL.
+ * \param name The name of the property without the prefix (i.e. "multicast_ttl"). Cannot be NULL.
+ * \return The property. If it doesn't exist, NULL value is returned.
+ */
+struct DDS_Property_t* eProsimaPropertyIndex_lookupWithPrefix(const struct eProsima_PropertyIndex *index,
+        const char *prefix, const char *name);
+
+/**
+ * \brief This function returns all the properties whose name starts with "prefix.".
+ *
+ * The properties are sorted by name. Properties with the same name keep the order of the sequence.
+ *
+ * \param index The index. Cannot be NULL.
+ * \param prefix The prefix without the final dot (i.e. "UDPv4"). Cannot be NULL.
+ * \param properties Where a pointer to the first property of the range is stored. The range is valid
+ * while the index exists. Cannot be NULL.
+ * \return Number of properties in the range.
+ */
+int eProsimaPropertyIndex_getPrefixRange(const struct eProsima_PropertyIndex *index, const char *prefix,
+        struct DDS_Property_t * const **properties);
+
+/**
+ * \brief This function stores all the properties whose name starts with "prefix." in the order of the sequence.
+ *
+ * \param index The index. Cannot be NULL.
+ * \param prefix The prefix without the final dot (i.e. "UDPv4"). Cannot be NULL.
+ * \param properties Array where the properties are stored. It has room for the number of properties returned
+ * by eProsimaPropertyIndex_getPrefixRange. Cannot be NULL.
+ * \return Number of properties stored.
+ */
+int eProsimaPropertyIndex_getPrefixProperties(const struct eProsima_PropertyIndex *index, const char *prefix,
+        struct DDS_Property_t **properties);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_QOS_PROPERTYINDEX_H_
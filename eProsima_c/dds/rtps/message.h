@@ -5,10 +5,19 @@
 #define RTPS_HEADER_VERSION_SIZE 2
 #define RTPS_HEADER_VENDORID_SIZE 2
 #define RTPS_HEADER_GUIDPREFIX_SIZE 12
+#define RTPS_HEADER_SIZE (RTPS_HEADER_PROTOCOL_SIZE + RTPS_HEADER_VERSION_SIZE + RTPS_HEADER_VENDORID_SIZE + RTPS_HEADER_GUIDPREFIX_SIZE)
+#define RTPS_HEADER_GUIDPREFIX_OFFSET (RTPS_HEADER_PROTOCOL_SIZE + RTPS_HEADER_VERSION_SIZE + RTPS_HEADER_VENDORID_SIZE)
+
+/* Protocol identifier of the RTPS header. */
+#define RTPS_HEADER_PROTOCOL "RTPS"
 
 #define RTPS_SUBMESSAGE_HEADER_ID_SIZE 1
 #define RTPS_SUBMESSAGE_HEADER_FLAGS_SIZE 1
 #define RTPS_SUBMESSAGE_HEADER_OCTETSTONEXTHEADER_SIZE 2
+#define RTPS_SUBMESSAGE_HEADER_SIZE (RTPS_SUBMESSAGE_HEADER_ID_SIZE + RTPS_SUBMESSAGE_HEADER_FLAGS_SIZE + RTPS_SUBMESSAGE_HEADER_OCTETSTONEXTHEADER_SIZE)
+
+/* Flag of all the submessages. If it is set, the submessage is little-endian. */
+#define RTPS_SUBMESSAGE_FLAG_ENDIANNESS 0x01
 
 // TODO Change BODY
 #define RTPS_SUBMESSAGE_BODY_EXTRAFLAGS_SIZE 2
@@ -16,6 +25,15 @@
 #define RTPS_SUBMESSAGE_BODY_ENTITIESID_SIZE 8
 #define RTPS_SUBMESSAGE_BODY_SEQUENCENUMBER_SIZE 8
 
+/* Offsets in the body of DATA and DATA_FRAG submessages. The readerId is followed by the writerId and the writerSN. */
+#define RTPS_SUBMESSAGE_BODY_ENTITYID_SIZE 4
+#define RTPS_SUBMESSAGE_BODY_READERID_OFFSET (RTPS_SUBMESSAGE_BODY_EXTRAFLAGS_SIZE + RTPS_SUBMESSAGE_BODY_OCTETSTOINLINEQOS_SIZE)
+#define RTPS_SUBMESSAGE_BODY_WRITERID_OFFSET (RTPS_SUBMESSAGE_BODY_READERID_OFFSET + RTPS_SUBMESSAGE_BODY_ENTITYID_SIZE)
+#define RTPS_SUBMESSAGE_BODY_SEQUENCENUMBER_OFFSET (RTPS_SUBMESSAGE_BODY_WRITERID_OFFSET + RTPS_SUBMESSAGE_BODY_ENTITYID_SIZE)
+
+/* Offset of the GUID prefix in the body of INFO_SRC submessages, after unused, version and vendorId. */
+#define RTPS_SUBMESSAGE_INFOSRC_GUIDPREFIX_OFFSET (4 + RTPS_HEADER_VERSION_SIZE + RTPS_HEADER_VENDORID_SIZE)
+
 #define RTPS_SUBMESSAGE_INFOTS_TIMESTAMP_SEC_SIZE 4
 #define RTPS_SUBMESSAGE_INFOTS_TIMESTAMP_NANOSEC_SIZE 4
 #define RTPS_SUBMESSAGE_INFOTS_TIMESTAMP_SIZE RTPS_SUBMESSAGE_INFOTS_TIMESTAMP_SEC_SIZE + RTPS_SUBMESSAGE_INFOTS_TIMESTAMP_NANOSEC_SIZE
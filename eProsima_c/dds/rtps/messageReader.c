@@ -0,0 +1,113 @@
+#include "messageReader.h"
+
+#include <string.h>
+
+void eProsimaRtpsReader_init(struct eProsima_RtpsReader *reader, const NDDS_Transport_Buffer_t *buffers, RTI_INT32 bufferCount)
+{
+    RTI_INT32 i = 0;
+
+    memset(reader, 0, sizeof(struct eProsima_RtpsReader));
+    reader->buffers = buffers;
+    reader->bufferCount = bufferCount;
+    reader->nextSubmessage = RTPS_HEADER_SIZE;
+
+    for(i = 0; i < bufferCount; ++i)
+        reader->length += (size_t)buffers[i].length;
+}
+
+int eProsimaRtpsReader_read(struct eProsima_RtpsReader *reader, size_t offset, void *destination, size_t length)
+{
+    char *output = (char*)destination;
+    size_t start = 0, copied = 0;
+
+    if(offset > reader->length || reader->length - offset < length)
+        return -1;
+
+    // The reader only goes forward.
+    if(offset < reader->bufferOffset)
+    {
+        reader->bufferIndex = 0;
+        reader->bufferOffset = 0;
+    }
+
+    while(length > 0)
+    {
+        while(offset >= reader->bufferOffset + (size_t)reader->buffers[reader->bufferIndex].length)
+        {
+            reader->bufferOffset += (size_t)reader->buffers[reader->bufferIndex].length;
+            ++reader->bufferIndex;
+        }
+
+        start = offset - reader->bufferOffset;
+        copied = (size_t)reader->buffers[reader->bufferIndex].length - start;
+
+        if(copied > length)
+            copied = length;
+
+        memcpy(output, reader->buffers[reader->bufferIndex].pointer + start, copied);
+        output += copied;
+        offset += copied;
+        length -= copied;
+    }
+
+    return 0;
+}
+
+int eProsimaRtpsReader_isRtps(struct eProsima_RtpsReader *reader)
+{
+    char protocol[RTPS_HEADER_PROTOCOL_SIZE];
+
+    return reader->length >= RTPS_HEADER_SIZE && eProsimaRtpsReader_read(reader, 0, protocol, sizeof(protocol)) == 0 &&
+        memcmp(protocol, RTPS_HEADER_PROTOCOL, RTPS_HEADER_PROTOCOL_SIZE) == 0;
+}
+
+int eProsimaRtpsReader_nextSubmessage(struct eProsima_RtpsReader *reader, struct eProsima_RtpsSubmessage *submessage)
+{
+    unsigned char header[RTPS_SUBMESSAGE_HEADER_SIZE];
+    size_t octetsToNextHeader = 0, remaining = 0;
+
+    if(eProsimaRtpsReader_read(reader, reader->nextSubmessage, header, sizeof(header)) != 0)
+        return -1;
+
+    submessage->kind = header[0];
+    submessage->flags = header[1];
+    submessage->offset = reader->nextSubmessage;
+
+    if(submessage->flags & RTPS_SUBMESSAGE_FLAG_ENDIANNESS)
+        octetsToNextHeader = (size_t)header[2] | ((size_t)header[3] << 8);
+    else
+        octetsToNextHeader = ((size_t)header[2] << 8) | (size_t)header[3];
+
+    remaining = reader->length - submessage->offset - RTPS_SUBMESSAGE_HEADER_SIZE;
+
+    // Zero means that the submessage uses the rest of the message, except for the submessages without body.
+    if(octetsToNextHeader == 0 && submessage->kind != RTPS_SUBMESSAGE_PAD && submessage->kind != RTPS_SUBMESSAGE_INFO_TS)
+        submessage->length = remaining;
+    else if(octetsToNextHeader <= remaining)
+        submessage->length = octetsToNextHeader;
+    else
+        return -1;
+
+    reader->nextSubmessage = submessage->offset + RTPS_SUBMESSAGE_HEADER_SIZE + submessage->length;
+
+    return 0;
+}
+
+int eProsimaRtpsReader_containsSubmessage(struct eProsima_RtpsReader *reader, const enum RTPS_SubmessageKind *kinds, int kindsLength)
+{
+    struct eProsima_RtpsSubmessage submessage;
+    int i = 0;
+
+    reader->nextSubmessage = RTPS_HEADER_SIZE;
+
+    while(eProsimaRtpsReader_nextSubmessage(reader, &submessage) == 0)
+    {
+        for(i = 0; i < kindsLength; ++i)
+        {
+            if(submessage.kind == (unsigned char)kinds[i])
+                return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#ifndef _EPROSIMA_C_DDS_RTPS_MESSAGEREADER_H_
+#define _EPROSIMA_C_DDS_RTPS_MESSAGEREADER_H_
+
+#include "eProsima_c/config.h"
+#include "message.h"
+
+#include <transport/transport_interface.h>
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/**
+ * \brief Reads an RTPS message stored in a gather array without copying it. Reads are faster when the
+ * offsets grow, because the reader remembers the last buffer.
+ */
+struct eProsima_RtpsReader
+{
+    const NDDS_Transport_Buffer_t *buffers;
+    RTI_INT32 bufferCount;
+    /// Total length of the message.
+    size_t length;
+    /// Buffer of the last read and offset of its first byte in the message.
+    RTI_INT32 bufferIndex;
+    size_t bufferOffset;
+    /// Offset of the next submessage returned by eProsimaRtpsReader_nextSubmessage.
+    size_t nextSubmessage;
+};
+
+/**
+ * \brief Header of a submessage.
+ */
+struct eProsima_RtpsSubmessage
+{
+    unsigned char kind;
+    unsigned char flags;
+    /// Offset of the submessage header in the message.
+    size_t offset;
+    /// Length of the body. The last submessage can use the rest of the message.
+    size_t length;
+};
+
+/**
+ * \brief This function initializes a reader. The first submessage is the one after the RTPS header.
+ *
+ * \param reader The reader. Cannot be NULL.
+ * \param buffers The gather array. Cannot be NULL.
+ * \param bufferCount Number of buffers.
+ */
+void eProsimaRtpsReader_init(struct eProsima_RtpsReader *reader, const NDDS_Transport_Buffer_t *buffers, RTI_INT32 bufferCount);
+
+/**
+ * \brief This function copies bytes of the message.
+ *
+ * \param reader The reader. Cannot be NULL.
+ * \param offset Offset of the first byte in the message.
+ * \param destination Where the bytes are copied. Cannot be NULL.
+ * \param length Number of bytes.
+ * \return 0 if the bytes were copied. If the message is shorter, -1 is returned.
+ */
+int eProsimaRtpsReader_read(struct eProsima_RtpsReader *reader, size_t offset, void *destination, size_t length);
+
+/**
+ * \brief This function checks that the message starts with an RTPS header.
+ *
+ * \return 1 if the message is an RTPS message. Otherwise 0.
+ */
+int eProsimaRtpsReader_isRtps(struct eProsima_RtpsReader *reader);
+
+/**
+ * \brief This function reads the header of the next submessage.
+ *
+ * \param reader The reader. Cannot be NULL.
+ * \param submessage Where the header is stored. Cannot be NULL.
+ * \return 0 if a submessage was read. If there are no more submessages or the message is malformed, -1 is returned.
+ */
+int eProsimaRtpsReader_nextSubmessage(struct eProsima_RtpsReader *reader, struct eProsima_RtpsSubmessage *submessage);
+
+/**
+ * \brief This function checks if the message contains submessages of a kind.
+ *
+ * \param reader The reader. Cannot be NULL. The iteration of submessages is restarted.
+ * \param kinds Kinds of submessages. Cannot be NULL.
+ * \param kindsLength Number of kinds.
+ * \return 1 if some submessage is of one of the kinds. Otherwise 0.
+ */
+int eProsimaRtpsReader_containsSubmessage(struct eProsima_RtpsReader *reader, const enum RTPS_SubmessageKind *kinds, int kindsLength);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_RTPS_MESSAGEREADER_H_
@@ -0,0 +1,154 @@
+#include "chainStage.h"
+#include "statsStage.h"
+#include "compressionStage.h"
+#include "priorityStage.h"
+#include "filterStage.h"
+#include "dedupStage.h"
+#include "coalesceStage.h"
+#include "shaperStage.h"
+#include "crcStage.h"
+#include "../../qos/propertyIndex.h"
+#include "../../../sys/eProsimaDL.h"
+
+#include <dds_c/dds_c_infrastructure.h>
+#include <osapi/osapi_heap.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define CHAIN_STAGE_TYPES_MAX 32
+
+struct eProsima_ChainStageType
+{
+    const char *name;
+    eProsimaChainStage_create function;
+};
+
+/// Stages of this library.
+static const struct eProsima_ChainStageType builtinStageTypes[] =
+{
+    {"stats", eProsimaStatsStage_create},
+    {"compression", eProsimaCompressionStage_create},
+    {"priority", eProsimaPriorityStage_create},
+    {"filter", eProsimaFilterStage_create},
+    {"dedup", eProsimaDedupStage_create},
+    {"coalesce", eProsimaCoalesceStage_create},
+    {"shaper", eProsimaShaperStage_create},
+    {"crc", eProsimaCrcStage_create}
+};
+
+static struct eProsima_ChainStageType stageTypes[CHAIN_STAGE_TYPES_MAX];
+
+static int stageTypesLength = 0;
+
+static eProsimaChainStage_create findStageType(const char *type)
+{
+    int i = 0;
+
+    // Registered types can replace the stages of this library.
+    for(i = 0; i < stageTypesLength; ++i)
+    {
+        if(strcmp(stageTypes[i].name, type) == 0)
+            return stageTypes[i].function;
+    }
+
+    for(i = 0; i < (int)(sizeof(builtinStageTypes) / sizeof(builtinStageTypes[0])); ++i)
+    {
+        if(strcmp(builtinStageTypes[i].name, type) == 0)
+            return builtinStageTypes[i].function;
+    }
+
+    return NULL;
+}
+
+int eProsimaChainStage_register(const char *type, eProsimaChainStage_create function)
+{
+    const char* const METHOD_NAME = "eProsimaChainStage_register";
+
+    if(type == NULL || function == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return -1;
+    }
+
+    if(stageTypesLength == CHAIN_STAGE_TYPES_MAX)
+    {
+        printf("ERROR<%s>: Cannot register more types of stages\n", METHOD_NAME);
+        return -1;
+    }
+
+    stageTypes[stageTypesLength].name = type;
+    stageTypes[stageTypesLength].function = function;
+    ++stageTypesLength;
+
+    return 0;
+}
+
+struct eProsima_ChainStage* eProsimaChainStage_new(const struct eProsima_PropertyIndex *index, const char *name)
+{
+    const char* const METHOD_NAME = "eProsimaChainStage_new";
+    struct DDS_Property_t *typeProperty = NULL, *libraryProperty = NULL, *functionProperty = NULL;
+    eProsimaChainStage_create function = NULL;
+    const char *type = name;
+    void *library = NULL;
+
+    if(index == NULL || name == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    libraryProperty = eProsimaPropertyIndex_lookupWithPrefix(index, name, "library");
+    functionProperty = eProsimaPropertyIndex_lookupWithPrefix(index, name, "create_function");
+
+    if(libraryProperty != NULL && functionProperty != NULL)
+    {
+        library = eProsimaLoadLibrary(libraryProperty->value);
+
+        if(library != NULL)
+            function = (eProsimaChainStage_create)eProsimaGetProcAddress(library, functionProperty->value);
+    }
+    else
+    {
+        typeProperty = eProsimaPropertyIndex_lookupWithPrefix(index, name, "type");
+
+        if(typeProperty != NULL && typeProperty->value != NULL)
+            type = typeProperty->value;
+
+        function = findStageType(type);
+    }
+
+    if(function == NULL)
+    {
+        printf("ERROR<%s>: Cannot find the stage %s\n", METHOD_NAME, name);
+        return NULL;
+    }
+
+    return function(index, name);
+}
+
+void* eProsimaChainSendContext_allocate(struct eProsima_ChainSendContext *context, size_t size)
+{
+    void *memory = NULL;
+
+    // Allocations are aligned to 8 bytes.
+    size = (size + 7) & ~(size_t)7;
+
+    if(context->scratchLength - context->scratchUsed >= size)
+    {
+        memory = context->scratch + context->scratchUsed;
+        context->scratchUsed += size;
+    }
+
+    return memory;
+}
+
+char* eProsimaChainReceiveContext_getBuffer(struct eProsima_ChainReceiveContext *context)
+{
+    int i = context->message->buffer.pointer == context->buffers[0] ? 1 : 0;
+
+    if(context->buffers[i] == NULL)
+        RTIOsapiHeap_allocateArray(&context->buffers[i], context->messageSizeMax, char);
+
+    return context->buffers[i];
+}
@@ -0,0 +1,172 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_CHAIN_CHAINSTAGE_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_CHAIN_CHAINSTAGE_H_
+
+#include "eProsima_c/config.h"
+
+#include <transport/transport_interface.h>
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+struct eProsima_PropertyIndex;
+
+/**
+ * \brief Result of a stage that processes a message.
+ */
+typedef enum EPROSIMA_CHAIN_STAGE_RESULT
+{
+    /// The message goes to the next stage.
+    EPROSIMA_CHAIN_STAGE_CONTINUE = 0,
+    /// The stage consumed the message (i.e. it was filtered or queued). The send operation succeeds.
+    EPROSIMA_CHAIN_STAGE_DISCARD,
+    /// The message cannot be processed. The send operation fails and a received message is dropped.
+    EPROSIMA_CHAIN_STAGE_ERROR
+} EPROSIMA_CHAIN_STAGE_RESULT;
+
+/**
+ * \brief Message that is being sent through the chain.
+ *
+ * The gather array is a copy of the array of the middleware, so stages can replace, remove or add
+ * buffers up to bufferCountMax. The data of the buffers received from the middleware cannot be modified,
+ * because the middleware can send it again. A stage that transforms the data writes the result in memory
+ * returned by eProsimaChainSendContext_allocate and points the buffers to it.
+ */
+struct eProsima_ChainSendContext
+{
+    NDDS_Transport_SendResource_t sendResource;
+    const NDDS_Transport_Address_t *destAddress;
+    NDDS_Transport_Port_t destPort;
+    RTI_INT32 transportPriority;
+    NDDS_Transport_Buffer_t *buffers;
+    RTI_INT32 bufferCount;
+    RTI_INT32 bufferCountMax;
+
+    /// Scratch memory of the send operation. It is used by eProsimaChainSendContext_allocate.
+    char *scratch;
+    size_t scratchLength;
+    size_t scratchUsed;
+};
+
+/**
+ * \brief Message that is being received through the chain. Stages are called from the innermost one.
+ *
+ * The received buffer belongs to the chain until it is returned, so stages can transform it in place.
+ * A stage that needs more space writes the result in the buffer returned by eProsimaChainReceiveContext_getBuffer.
+ */
+struct eProsima_ChainReceiveContext
+{
+    NDDS_Transport_Message_t *message;
+
+    /// Two buffers of messageSizeMax bytes, allocated the first time they are needed.
+    char *buffers[2];
+    RTI_INT32 messageSizeMax;
+};
+
+/**
+ * \brief Stage of a chain transport. Stages are created from the "chain" property and can be shared by
+ * several threads, so they must protect their own state.
+ */
+struct eProsima_ChainStage
+{
+    /// Bytes that the stage can add to a message. The chain reduces its message_size_max.
+    RTI_INT32 messageOverhead;
+    /// Buffers that the stage can add to the gather array. The chain reduces its gather_send_buffer_count_max.
+    RTI_INT32 extraBufferCount;
+    /// Bytes that the stage allocates with eProsimaChainSendContext_allocate for one message.
+    size_t sendScratchSize;
+    /// Buffers of the message_size_max of the innermost transport that the stage allocates with
+    /// eProsimaChainSendContext_allocate for one message. They are added to sendScratchSize.
+    RTI_INT32 sendScratchMessages;
+
+    /// Processes a message before it goes inward. It can be NULL.
+    EPROSIMA_CHAIN_STAGE_RESULT (*send)(struct eProsima_ChainStage *self, struct eProsima_ChainSendContext *context);
+    /// Processes a received message before it goes outward. It can be NULL.
+    EPROSIMA_CHAIN_STAGE_RESULT (*receive)(struct eProsima_ChainStage *self, struct eProsima_ChainReceiveContext *context);
+    /// Called before a send resource is destroyed. Stages that keep messages to send them later drop the ones
+    /// of this resource. It can be NULL.
+    void (*destroySendResource)(struct eProsima_ChainStage *self, NDDS_Transport_SendResource_t sendResource);
+    /// Destroys the stage.
+    void (*destroy)(struct eProsima_ChainStage *self);
+
+    /// Chain of the stage and its position, set when the stage is added. Used by eProsimaChainStage_sendNext.
+    void *chain;
+    int chainPosition;
+};
+
+/**
+ * \brief Function that creates a stage.
+ *
+ * \param index Index of the properties of the chain. Cannot be NULL.
+ * \param prefix Prefix of the properties of the stage (i.e. "stats"). Cannot be NULL.
+ * \return The new stage. In error case, NULL value is returned.
+ */
+typedef struct eProsima_ChainStage* (*eProsimaChainStage_create)(const struct eProsima_PropertyIndex *index, const char *prefix);
+
+/**
+ * \brief This function registers a type of stage. The stages of this library are always registered.
+ * The name is not copied.
+ *
+ * \param type Name of the type used in the "chain" or "stageName.type" properties. Cannot be NULL.
+ * \param function Function that creates the stages. Cannot be NULL.
+ * \return 0 if the type was registered. In error case -1 is returned.
+ */
+int eProsimaChainStage_register(const char *type, eProsimaChainStage_create function);
+
+/**
+ * \brief This function creates a stage of a chain.
+ *
+ * The type of the stage is the property "name.type" or the name itself. If the properties "name.library"
+ * and "name.create_function" exist, the create function is loaded from the library instead of the
+ * registered types.
+ *
+ * \param index Index of the properties of the chain. Cannot be NULL.
+ * \param name Name of the stage in the "chain" property. Cannot be NULL.
+ * \return The new stage. In error case, NULL value is returned.
+ */
+struct eProsima_ChainStage* eProsimaChainStage_new(const struct eProsima_PropertyIndex *index, const char *name);
+
+/**
+ * \brief This function sends a message through the stages after a stage and the innermost transport.
+ * A stage that consumed a message to send it later (i.e. it was queued) uses it from any thread.
+ * The data is not used after the function returns.
+ *
+ * \param stage The stage. Cannot be NULL.
+ * \param sendResource Send resource of the innermost transport that was used to send the message.
+ * \param destAddress Destination address. Cannot be NULL.
+ * \param destPort Destination port.
+ * \param transportPriority Transport priority.
+ * \param buffers The gather array. Cannot be NULL.
+ * \param bufferCount Number of buffers.
+ * \return RTI_TRUE if the message was sent or consumed by other stage. Otherwise RTI_FALSE.
+ */
+RTI_INT32 eProsimaChainStage_sendNext(struct eProsima_ChainStage *stage, NDDS_Transport_SendResource_t sendResource,
+        const NDDS_Transport_Address_t *destAddress, NDDS_Transport_Port_t destPort, RTI_INT32 transportPriority,
+        const NDDS_Transport_Buffer_t *buffers, RTI_INT32 bufferCount);
+
+/**
+ * \brief This function allocates scratch memory that lives until the message is sent.
+ *
+ * \param context The send context. Cannot be NULL.
+ * \param size Number of bytes.
+ * \return The memory. If the stages need more than the sendScratchSize they declared, NULL value is returned.
+ */
+void* eProsimaChainSendContext_allocate(struct eProsima_ChainSendContext *context, size_t size);
+
+/**
+ * \brief This function returns a buffer of messageSizeMax bytes where a stage can write the transformed
+ * received message. It is not the buffer where the current message is.
+ *
+ * \param context The receive context. Cannot be NULL.
+ * \return The buffer. In error case, NULL value is returned.
+ */
+char* eProsimaChainReceiveContext_getBuffer(struct eProsima_ChainReceiveContext *context);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_CHAIN_CHAINSTAGE_H_
@@ -0,0 +1,574 @@
+#include "chainTransport.h"
+#include "chainStage.h"
+#include "../transportPluginCommon.h"
+#include "../transportPropertyParser.h"
+#include "../../qos/propertyIndex.h"
+#include "../../../sys/atomic.h"
+#include "../../../sys/eProsimaDL.h"
+
+#include <osapi/osapi_heap.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define CHAIN_CLASS_NAME "eprosima_chain"
+
+#if defined(EPROSIMA_TRANSPORT_STATIC_PLUGINS)
+EPROSIMA_DL_REGISTER_SYMBOL(CHAIN_CLASS_NAME, eProsimaChainTransport_create)
+#endif
+
+struct ChainTransportConfig
+{
+    char **chain;
+    int chainLength;
+    int classid;
+};
+
+static const struct eProsima_PropertyDescriptor ChainPropertyDescriptors[] =
+{
+    EPROSIMA_PROPERTY_STRING_LIST(struct ChainTransportConfig, "chain", chain, chainLength),
+    EPROSIMA_PROPERTY_HEX(struct ChainTransportConfig, "parent.classid", classid, 0)
+};
+
+/**
+ * \brief Send context that is not used. The gather array and the scratch memory follow it in the same allocation.
+ */
+struct ChainSendContextNode
+{
+    struct ChainSendContextNode *next;
+    struct eProsima_ChainSendContext context;
+};
+
+struct ChainTransport
+{
+    /// It has to be the first field.
+    NDDS_Transport_Plugin parent;
+    struct NDDS_Transport_Property_t property;
+    struct ChainTransportConfig config;
+    NDDS_Transport_Plugin *inner;
+    struct eProsima_ChainStage **stages;
+    int stagesLength;
+    size_t sendScratchSize;
+
+    /// Send contexts are reused. There is one for each thread that sends at the same time.
+    struct ChainSendContextNode *freeSendContexts;
+    int freeSendContextsLock;
+};
+
+struct ChainRecvResource
+{
+    NDDS_Transport_RecvResource_t inner;
+    struct eProsima_ChainReceiveContext context;
+    /// Buffer returned by the innermost transport. It is restored before the buffer is returned.
+    NDDS_Transport_Buffer_t innerBuffer;
+};
+
+static void lockSendContexts(struct ChainTransport *transport)
+{
+    while(!EPROSIMA_ATOMIC_CAS32(&transport->freeSendContextsLock, 0, 1))
+        EPROSIMA_CPU_RELAX();
+}
+
+static void unlockSendContexts(struct ChainTransport *transport)
+{
+    EPROSIMA_ATOMIC_STORE32(&transport->freeSendContextsLock, 0);
+}
+
+static struct ChainSendContextNode* takeSendContext(struct ChainTransport *transport)
+{
+    struct ChainSendContextNode *node = NULL;
+    size_t buffersOffset = (sizeof(struct ChainSendContextNode) + 7) & ~(size_t)7;
+    size_t scratchOffset = buffersOffset + transport->inner->property->gather_send_buffer_count_max * sizeof(NDDS_Transport_Buffer_t);
+    char *memory = NULL;
+
+    lockSendContexts(transport);
+
+    node = transport->freeSendContexts;
+
+    if(node != NULL)
+        transport->freeSendContexts = node->next;
+
+    unlockSendContexts(transport);
+
+    if(node == NULL)
+    {
+        scratchOffset = (scratchOffset + 7) & ~(size_t)7;
+        RTIOsapiHeap_allocateArray(&memory, scratchOffset + transport->sendScratchSize, char);
+
+        if(memory != NULL)
+        {
+            node = (struct ChainSendContextNode*)memory;
+            memset(node, 0, sizeof(struct ChainSendContextNode));
+            node->context.buffers = (NDDS_Transport_Buffer_t*)(memory + buffersOffset);
+            node->context.bufferCountMax = transport->inner->property->gather_send_buffer_count_max;
+            node->context.scratch = memory + scratchOffset;
+            node->context.scratchLength = transport->sendScratchSize;
+        }
+    }
+
+    return node;
+}
+
+static void giveSendContext(struct ChainTransport *transport, struct ChainSendContextNode *node)
+{
+    lockSendContexts(transport);
+    node->next = transport->freeSendContexts;
+    transport->freeSendContexts = node;
+    unlockSendContexts(transport);
+}
+
+/**
+ * \brief This function sends a message through the stages from the given one and the innermost transport.
+ */
+static RTI_INT32 sendFromStage(struct ChainTransport *transport, int firstStage, const NDDS_Transport_SendResource_t *sendresource_in,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in,
+        const NDDS_Transport_Buffer_t buffer_in[], RTI_INT32 buffer_count_in, void *reserved)
+{
+    struct ChainSendContextNode *node = NULL;
+    struct eProsima_ChainSendContext *context = NULL;
+    EPROSIMA_CHAIN_STAGE_RESULT result = EPROSIMA_CHAIN_STAGE_CONTINUE;
+    RTI_INT32 returnedValue = RTI_FALSE;
+    int i = 0;
+
+    node = takeSendContext(transport);
+
+    if(node == NULL || buffer_count_in > node->context.bufferCountMax)
+    {
+        if(node != NULL)
+            giveSendContext(transport, node);
+        return RTI_FALSE;
+    }
+
+    // Only the descriptors of the buffers are copied.
+    context = &node->context;
+    context->sendResource = *sendresource_in;
+    context->destAddress = dest_address_in;
+    context->destPort = dest_port_in;
+    context->transportPriority = transport_priority_in;
+    memcpy(context->buffers, buffer_in, buffer_count_in * sizeof(NDDS_Transport_Buffer_t));
+    context->bufferCount = buffer_count_in;
+    context->scratchUsed = 0;
+
+    for(i = firstStage; i < transport->stagesLength && result == EPROSIMA_CHAIN_STAGE_CONTINUE; ++i)
+    {
+        if(transport->stages[i]->send != NULL)
+            result = transport->stages[i]->send(transport->stages[i], context);
+    }
+
+    if(result == EPROSIMA_CHAIN_STAGE_CONTINUE)
+        returnedValue = transport->inner->send(transport->inner, sendresource_in, context->destAddress, context->destPort,
+                context->transportPriority, context->buffers, context->bufferCount, reserved);
+    else
+        returnedValue = result == EPROSIMA_CHAIN_STAGE_DISCARD ? RTI_TRUE : RTI_FALSE;
+
+    giveSendContext(transport, node);
+
+    return returnedValue;
+}
+
+static RTI_INT32 ChainTransport_send(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in,
+        const NDDS_Transport_Buffer_t buffer_in[], RTI_INT32 buffer_count_in, void *reserved)
+{
+    return sendFromStage((struct ChainTransport*)self, 0, sendresource_in, dest_address_in, dest_port_in, transport_priority_in,
+            buffer_in, buffer_count_in, reserved);
+}
+
+RTI_INT32 eProsimaChainStage_sendNext(struct eProsima_ChainStage *stage, NDDS_Transport_SendResource_t sendResource,
+        const NDDS_Transport_Address_t *destAddress, NDDS_Transport_Port_t destPort, RTI_INT32 transportPriority,
+        const NDDS_Transport_Buffer_t *buffers, RTI_INT32 bufferCount)
+{
+    return sendFromStage((struct ChainTransport*)stage->chain, stage->chainPosition + 1, &sendResource, destAddress, destPort,
+            transportPriority, buffers, bufferCount, NULL);
+}
+
+static void returnInnerBuffer(struct ChainTransport *transport, struct ChainRecvResource *resource, NDDS_Transport_Message_t *message,
+        void *reserved)
+{
+    message->buffer = resource->innerBuffer;
+
+    if(message->loaned_buffer_param != NULL)
+        transport->inner->return_loaned_buffer_rEA(transport->inner, &resource->inner, message, reserved);
+}
+
+static RTI_INT32 ChainTransport_receive_rEA(NDDS_Transport_Plugin *self, NDDS_Transport_Message_t *message_out,
+        const NDDS_Transport_Buffer_t *buffer_in, const NDDS_Transport_RecvResource_t *recvresource_in, void *reserved)
+{
+    struct ChainTransport *transport = (struct ChainTransport*)self;
+    struct ChainRecvResource *resource = (struct ChainRecvResource*)*recvresource_in;
+    EPROSIMA_CHAIN_STAGE_RESULT result = EPROSIMA_CHAIN_STAGE_CONTINUE;
+    int i = 0;
+
+    for(;;)
+    {
+        if(!transport->inner->receive_rEA(transport->inner, message_out, buffer_in, &resource->inner, reserved))
+            return RTI_FALSE;
+
+        resource->innerBuffer = message_out->buffer;
+
+        // An empty message means that the receive operation was unblocked.
+        if(message_out->buffer.length == 0)
+            return RTI_TRUE;
+
+        // Received messages go through the stages from the innermost one.
+        resource->context.message = message_out;
+        result = EPROSIMA_CHAIN_STAGE_CONTINUE;
+
+        for(i = transport->stagesLength - 1; i >= 0 && result == EPROSIMA_CHAIN_STAGE_CONTINUE; --i)
+        {
+            if(transport->stages[i]->receive != NULL)
+                result = transport->stages[i]->receive(transport->stages[i], &resource->context);
+        }
+
+        if(result == EPROSIMA_CHAIN_STAGE_CONTINUE)
+            return RTI_TRUE;
+
+        returnInnerBuffer(transport, resource, message_out, reserved);
+    }
+}
+
+static void ChainTransport_return_loaned_buffer_rEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        NDDS_Transport_Message_t *message_in, void *reserved)
+{
+    returnInnerBuffer((struct ChainTransport*)self, (struct ChainRecvResource*)*recvresource_in, message_in, reserved);
+}
+
+static RTI_INT32 ChainTransport_unblock_receive_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        void *reserved)
+{
+    struct ChainTransport *transport = (struct ChainTransport*)self;
+
+    return transport->inner->unblock_receive_rrEA(transport->inner, &((struct ChainRecvResource*)*recvresource_in)->inner, reserved);
+}
+
+static RTI_INT32 ChainTransport_create_recvresource_rrEA(NDDS_Transport_Plugin *self, NDDS_Transport_RecvResource_t *recvresource_out,
+        NDDS_Transport_Port_t *port_inout, const NDDS_Transport_Address_t *multicast_address_in, RTI_INT32 reserved)
+{
+    struct ChainTransport *transport = (struct ChainTransport*)self;
+    struct ChainRecvResource *resource = NULL;
+
+    RTIOsapiHeap_allocateStructure(&resource, struct ChainRecvResource);
+
+    if(resource == NULL)
+        return RTI_FALSE;
+
+    memset(resource, 0, sizeof(struct ChainRecvResource));
+    resource->context.messageSizeMax = transport->inner->property->message_size_max;
+
+    if(!transport->inner->create_recvresource_rrEA(transport->inner, &resource->inner, port_inout, multicast_address_in, reserved))
+    {
+        RTIOsapiHeap_freeStructure(resource);
+        return RTI_FALSE;
+    }
+
+    *recvresource_out = resource;
+    return RTI_TRUE;
+}
+
+static void ChainTransport_destroy_recvresource_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in)
+{
+    struct ChainTransport *transport = (struct ChainTransport*)self;
+    struct ChainRecvResource *resource = (struct ChainRecvResource*)*recvresource_in;
+
+    transport->inner->destroy_recvresource_rrEA(transport->inner, &resource->inner);
+
+    if(resource->context.buffers[0] != NULL)
+        RTIOsapiHeap_freeArray(resource->context.buffers[0]);
+    if(resource->context.buffers[1] != NULL)
+        RTIOsapiHeap_freeArray(resource->context.buffers[1]);
+
+    RTIOsapiHeap_freeStructure(resource);
+}
+
+static RTI_INT32 ChainTransport_share_recvresource_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        const NDDS_Transport_Port_t port_in, const NDDS_Transport_Address_t *multicast_address_in, RTI_INT32 reserved)
+{
+    struct ChainTransport *transport = (struct ChainTransport*)self;
+
+    return transport->inner->share_recvresource_rrEA(transport->inner, &((struct ChainRecvResource*)*recvresource_in)->inner,
+            port_in, multicast_address_in, reserved);
+}
+
+static RTI_INT32 ChainTransport_unshare_recvresource_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        const NDDS_Transport_Port_t port_in, const NDDS_Transport_Address_t *multicast_address_in, RTI_INT32 reserved)
+{
+    struct ChainTransport *transport = (struct ChainTransport*)self;
+
+    return transport->inner->unshare_recvresource_rrEA(transport->inner, &((struct ChainRecvResource*)*recvresource_in)->inner,
+            port_in, multicast_address_in, reserved);
+}
+
+/* Send resources are the resources of the innermost transport. */
+
+static RTI_INT32 ChainTransport_create_sendresource_srEA(NDDS_Transport_Plugin *self, NDDS_Transport_SendResource_t *sendresource_out,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in)
+{
+    struct ChainTransport *transport = (struct ChainTransport*)self;
+
+    return transport->inner->create_sendresource_srEA(transport->inner, sendresource_out, dest_address_in, dest_port_in,
+            transport_priority_in);
+}
+
+static void ChainTransport_destroy_sendresource_srEA(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in)
+{
+    struct ChainTransport *transport = (struct ChainTransport*)self;
+    int i = 0;
+
+    for(i = 0; i < transport->stagesLength; ++i)
+    {
+        if(transport->stages[i]->destroySendResource != NULL)
+            transport->stages[i]->destroySendResource(transport->stages[i], *sendresource_in);
+    }
+
+    transport->inner->destroy_sendresource_srEA(transport->inner, sendresource_in);
+}
+
+static RTI_INT32 ChainTransport_share_sendresource_srEA(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in)
+{
+    struct ChainTransport *transport = (struct ChainTransport*)self;
+
+    return transport->inner->share_sendresource_srEA(transport->inner, sendresource_in, dest_address_in, dest_port_in,
+            transport_priority_in);
+}
+
+static RTI_INT32 ChainTransport_unshare_sendresource_srEA(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in)
+{
+    struct ChainTransport *transport = (struct ChainTransport*)self;
+
+    return transport->inner->unshare_sendresource_srEA(transport->inner, sendresource_in, dest_address_in, dest_port_in,
+            transport_priority_in);
+}
+
+static const char* ChainTransport_get_class_name_cEA(NDDS_Transport_Plugin *self)
+{
+    return CHAIN_CLASS_NAME;
+}
+
+static RTI_INT32 ChainTransport_string_to_address_cEA(NDDS_Transport_Plugin *self, NDDS_Transport_Address_t *address_out,
+        const char *address_in)
+{
+    struct ChainTransport *transport = (struct ChainTransport*)self;
+
+    return transport->inner->string_to_address_cEA(transport->inner, address_out, address_in);
+}
+
+static RTI_INT32 ChainTransport_get_receive_interfaces_cEA(NDDS_Transport_Plugin *self, RTI_INT32 *found_more_than_provided_for_out,
+        RTI_INT32 *interface_reported_count_out, NDDS_Transport_Interface_t interface_array_inout[], RTI_INT32 interface_array_size_in)
+{
+    struct ChainTransport *transport = (struct ChainTransport*)self;
+    RTI_INT32 returnedValue = 0, i = 0;
+
+    returnedValue = transport->inner->get_receive_interfaces_cEA(transport->inner, found_more_than_provided_for_out,
+            interface_reported_count_out, interface_array_inout, interface_array_size_in);
+
+    // The interfaces belong to this transport.
+    for(i = 0; returnedValue && i < *interface_reported_count_out; ++i)
+        interface_array_inout[i].transport_classid = transport->property.classid;
+
+    return returnedValue;
+}
+
+static RTI_INT32 ChainTransport_register_listener_cEA(NDDS_Transport_Plugin *self, NDDS_Transport_Listener *listener_in)
+{
+    struct ChainTransport *transport = (struct ChainTransport*)self;
+
+    return transport->inner->register_listener_cEA(transport->inner, listener_in);
+}
+
+static void deleteChainTransport(struct ChainTransport *transport)
+{
+    struct ChainSendContextNode *node = NULL;
+    int i = 0;
+
+    for(i = transport->stagesLength - 1; i >= 0; --i)
+        transport->stages[i]->destroy(transport->stages[i]);
+
+    if(transport->stages != NULL)
+        RTIOsapiHeap_freeArray(transport->stages);
+
+    if(transport->inner != NULL)
+        transport->inner->delete_cEA(transport->inner, NULL);
+
+    while((node = transport->freeSendContexts) != NULL)
+    {
+        transport->freeSendContexts = node->next;
+        RTIOsapiHeap_freeArray((char*)node);
+    }
+
+    if(transport->config.chain != NULL)
+        RTIOsapiHeap_freeArray(transport->config.chain);
+
+    finalizeNDDSTransportPropertiesCompact(&transport->property);
+    RTIOsapiHeap_freeStructure(transport);
+}
+
+static void ChainTransport_delete_cEA(NDDS_Transport_Plugin *self, void *reserved)
+{
+    deleteChainTransport((struct ChainTransport*)self);
+}
+
+/**
+ * \brief This function loads the innermost transport and creates the stages.
+ *
+ * \return 0 if the chain was built. In error case -1 is returned.
+ */
+static int buildChain(struct ChainTransport *transport, const struct eProsima_PropertyIndex *index,
+        NDDS_Transport_Address_t *default_network_address_out)
+{
+    const char* const METHOD_NAME = "buildChain";
+    RTI_INT32 messageOverhead = 0, extraBufferCount = 0;
+    int i = 0;
+
+    transport->inner = loadTransportPluginFromIndex(transport->config.chain[transport->config.chainLength - 1], index,
+            default_network_address_out);
+
+    if(transport->inner == NULL)
+    {
+        printf("ERROR<%s>: Cannot create the transport %s\n", METHOD_NAME, transport->config.chain[transport->config.chainLength - 1]);
+        return -1;
+    }
+
+    if(transport->config.chainLength > 1)
+    {
+        RTIOsapiHeap_allocateArray(&transport->stages, transport->config.chainLength - 1, struct eProsima_ChainStage*);
+
+        if(transport->stages == NULL)
+            return -1;
+    }
+
+    for(i = 0; i < transport->config.chainLength - 1; ++i)
+    {
+        transport->stages[i] = eProsimaChainStage_new(index, transport->config.chain[i]);
+
+        if(transport->stages[i] == NULL)
+            return -1;
+
+        transport->stages[i]->chain = transport;
+        transport->stages[i]->chainPosition = i;
+        ++transport->stagesLength;
+        messageOverhead += transport->stages[i]->messageOverhead;
+        extraBufferCount += transport->stages[i]->extraBufferCount;
+        transport->sendScratchSize += (transport->stages[i]->sendScratchSize + 7) & ~(size_t)7;
+        transport->sendScratchSize += transport->stages[i]->sendScratchMessages *
+            (((size_t)transport->inner->property->message_size_max + 7) & ~(size_t)7);
+    }
+
+    if(copyNDDSTransportPropertiesCompact(&transport->property, transport->inner->property) != 0)
+        return -1;
+
+    transport->property.message_size_max -= messageOverhead;
+    transport->property.gather_send_buffer_count_max -= extraBufferCount;
+
+    if(transport->property.message_size_max <= 0 ||
+            transport->property.gather_send_buffer_count_max < NDDS_TRANSPORT_PROPERTY_GATHER_SEND_BUFFER_COUNT_MIN)
+    {
+        printf("ERROR<%s>: The stages need bigger messages or more buffers than the transport %s\n", METHOD_NAME,
+                transport->config.chain[transport->config.chainLength - 1]);
+        return -1;
+    }
+
+    if(transport->config.classid != 0)
+        transport->property.classid = transport->config.classid;
+
+    return 0;
+}
+
+NDDS_Transport_Plugin* eProsimaChainTransport_create(NDDS_Transport_Address_t *default_network_address_out,
+        const struct DDS_PropertyQosPolicy *property_in)
+{
+    const char* const METHOD_NAME = "eProsimaChainTransport_create";
+    struct ChainTransport *transport = NULL;
+    const struct eProsima_PropertyIndex *index = NULL;
+    struct eProsima_PropertyIndex *builtIndex = NULL;
+    int returnedValue = -1;
+
+    if(property_in == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    RTIOsapiHeap_allocateStructure(&transport, struct ChainTransport);
+
+    if(transport == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the transport\n", METHOD_NAME);
+        return NULL;
+    }
+
+    memset(transport, 0, sizeof(struct ChainTransport));
+
+    if(parseTransportProperties(property_in, "", ChainPropertyDescriptors,
+                sizeof(ChainPropertyDescriptors) / sizeof(ChainPropertyDescriptors[0]), &transport->config) < 0)
+    {
+        printf("ERROR<%s>: Cannot parse the properties\n", METHOD_NAME);
+    }
+    else if(transport->config.chainLength == 0)
+    {
+        printf("ERROR<%s>: The property chain is not defined\n", METHOD_NAME);
+    }
+    else
+    {
+        index = getTransportPropertyIndex(property_in, &builtIndex);
+
+        if(index != NULL)
+            returnedValue = buildChain(transport, index, default_network_address_out);
+
+        eProsimaPropertyIndex_delete(builtIndex);
+    }
+
+    if(returnedValue != 0)
+    {
+        deleteChainTransport(transport);
+        return NULL;
+    }
+
+    transport->parent.property = &transport->property;
+    transport->parent.send = ChainTransport_send;
+    transport->parent.receive_rEA = ChainTransport_receive_rEA;
+    transport->parent.return_loaned_buffer_rEA = ChainTransport_return_loaned_buffer_rEA;
+    transport->parent.unblock_receive_rrEA = ChainTransport_unblock_receive_rrEA;
+    transport->parent.create_recvresource_rrEA = ChainTransport_create_recvresource_rrEA;
+    transport->parent.destroy_recvresource_rrEA = ChainTransport_destroy_recvresource_rrEA;
+    transport->parent.share_recvresource_rrEA = ChainTransport_share_recvresource_rrEA;
+    transport->parent.unshare_recvresource_rrEA = ChainTransport_unshare_recvresource_rrEA;
+    transport->parent.create_sendresource_srEA = ChainTransport_create_sendresource_srEA;
+    transport->parent.destroy_sendresource_srEA = ChainTransport_destroy_sendresource_srEA;
+    transport->parent.share_sendresource_srEA = ChainTransport_share_sendresource_srEA;
+    transport->parent.unshare_sendresource_srEA = ChainTransport_unshare_sendresource_srEA;
+    transport->parent.get_class_name_cEA = ChainTransport_get_class_name_cEA;
+    transport->parent.string_to_address_cEA = ChainTransport_string_to_address_cEA;
+    transport->parent.get_receive_interfaces_cEA = ChainTransport_get_receive_interfaces_cEA;
+    transport->parent.register_listener_cEA = ChainTransport_register_listener_cEA;
+    transport->parent.delete_cEA = ChainTransport_delete_cEA;
+
+    return &transport->parent;
+}
+
+struct eProsima_ChainStage* eProsimaChainTransport_getStage(NDDS_Transport_Plugin *plugin, const char *name)
+{
+    struct ChainTransport *transport = (struct ChainTransport*)plugin;
+    const char *innerName = NULL;
+    size_t innerNameLength = 0;
+    int i = 0;
+
+    if(plugin == NULL || name == NULL || plugin->get_class_name_cEA != ChainTransport_get_class_name_cEA)
+        return NULL;
+
+    for(i = 0; i < transport->stagesLength; ++i)
+    {
+        if(strcmp(transport->config.chain[i], name) == 0)
+            return transport->stages[i];
+    }
+
+    // The stages of an innermost chain are named with its prefix ("udp.stats").
+    innerName = transport->config.chain[transport->config.chainLength - 1];
+    innerNameLength = strlen(innerName);
+
+    if(strncmp(name, innerName, innerNameLength) == 0 && name[innerNameLength] == '.')
+        return eProsimaChainTransport_getStage(transport->inner, name + innerNameLength + 1);
+
+    return NULL;
+}
@@ -0,0 +1,59 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_CHAIN_CHAINTRANSPORT_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_CHAIN_CHAINTRANSPORT_H_
+
+#include "eProsima_c/config.h"
+
+#include <transport/transport_interface.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+struct DDS_PropertyQosPolicy;
+struct eProsima_ChainStage;
+
+/**
+ * \brief This function creates a transport that passes the messages through an ordered chain of stages
+ * before the innermost transport.
+ *
+ * The property "chain" lists the stages from the outermost one, and its last entry is the innermost
+ * transport, i.e. "stats,capture,udp". The properties of each entry use its name as prefix: the stages
+ * are created with eProsimaChainStage_new and the innermost transport is loaded with
+ * loadTransportPluginFromIndex, so it needs the properties "udp.library" and "udp.create_function".
+ * The innermost transport can be other chain, whose stages then use nested prefixes ("udp.stats.*").
+ *
+ * The gather arrays go through the stages without copying the data. The transport uses the addresses
+ * and properties of the innermost transport, so both sides must use the same chain.
+ *
+ * It has the signature of NDDS_Transport_create_plugin, so it can be loaded with loadTransportPluginFromLibrary:
+ *     pluginName.library = eprosima_chain (or the name of the shared library)
+ *     pluginName.create_function = eProsimaChainTransport_create
+ *
+ * The properties are received without the prefix "pluginName.":
+ *     chain: Stages and innermost transport. Required.
+ *     parent.classid: Class id of the transport. Default the class id of the innermost transport.
+ *
+ * \param default_network_address_out Network address of the transport.
+ * \param property_in Properties of the transport.
+ * \return The new transport. In error case, NULL value is returned.
+ */
+NDDS_Transport_Plugin* eProsimaChainTransport_create(NDDS_Transport_Address_t *default_network_address_out,
+        const struct DDS_PropertyQosPolicy *property_in);
+
+/**
+ * \brief This function returns a stage of a chain transport, i.e. to read its metrics with the getMetrics
+ * function of its type. The stage belongs to the transport and is destroyed with it.
+ *
+ * \param plugin A transport created by eProsimaChainTransport_create. Other transports have no stages.
+ * \param name Name of the stage in the "chain" property. The stages of an innermost chain use its name
+ * as prefix, i.e. "udp.stats". Cannot be NULL.
+ * \return The stage. If the transport has no stage with that name, NULL value is returned.
+ */
+struct eProsima_ChainStage* eProsimaChainTransport_getStage(NDDS_Transport_Plugin *plugin, const char *name);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_CHAIN_CHAINTRANSPORT_H_
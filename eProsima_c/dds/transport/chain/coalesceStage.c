@@ -0,0 +1,675 @@
+#include "coalesceStage.h"
+#include "../transportPropertyParser.h"
+#include "../../rtps/messageReader.h"
+#include "../../../sys/atomic.h"
+#include "../../../sys/clock.h"
+
+#include <osapi/osapi_heap.h>
+#include <osapi/osapi_semaphore.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(RTI_WIN32)
+#include <Windows.h>
+#elif defined(RTI_UNIX) || defined(RTI_LINUX)
+#include <pthread.h>
+#define COALESCE_STAGE_PTHREAD
+#endif
+
+/// Biggest HEARTBEAT or ACKNACK that is held, with its header. An ACKNACK with a full bitmap has 56 bytes.
+#define COALESCE_SUBMESSAGE_SIZE_MAX 64
+
+/// Submessages of one message that can be held.
+#define COALESCE_MESSAGE_SUBMESSAGES_MAX 32
+
+#define COALESCE_INFO_DST_SIZE (RTPS_SUBMESSAGE_HEADER_SIZE + RTPS_HEADER_GUIDPREFIX_SIZE)
+
+struct CoalesceStageConfig
+{
+    int windowUs;
+    int maxSize;
+    int destinations;
+};
+
+static const struct eProsima_PropertyDescriptor CoalescePropertyDescriptors[] =
+{
+    EPROSIMA_PROPERTY_INT(struct CoalesceStageConfig, "window_us", windowUs, 0, 1000000, 1000),
+    EPROSIMA_PROPERTY_INT(struct CoalesceStageConfig, "max_size", maxSize, RTPS_HEADER_SIZE + COALESCE_INFO_DST_SIZE + COALESCE_SUBMESSAGE_SIZE_MAX,
+            65507, 1400),
+    EPROSIMA_PROPERTY_INT(struct CoalesceStageConfig, "destinations", destinations, 1, 4096, 64)
+};
+
+/**
+ * \brief Held submessage and the GUID prefix of the INFO_DST it was after (zeros when there was none).
+ */
+struct CoalesceSubmessage
+{
+    unsigned char destination[RTPS_HEADER_GUIDPREFIX_SIZE];
+    size_t length;
+    unsigned char data[COALESCE_SUBMESSAGE_SIZE_MAX];
+};
+
+/**
+ * \brief Submessages held for a destination.
+ */
+struct CoalesceBatch
+{
+    int used;
+    NDDS_Transport_SendResource_t sendResource;
+    NDDS_Transport_Address_t destAddress;
+    NDDS_Transport_Port_t destPort;
+    RTI_INT32 transportPriority;
+    unsigned char header[RTPS_HEADER_SIZE];
+    /// Time when the first submessage was held plus the window.
+    unsigned long long deadline;
+    struct CoalesceSubmessage *submessages;
+    int submessagesLength;
+    /// Size of the datagram, with the INFO_DST submessages that will be added.
+    size_t size;
+};
+
+/**
+ * \brief Datagram built from a batch, ready to be sent outside the lock.
+ */
+struct CoalesceDatagram
+{
+    NDDS_Transport_SendResource_t sendResource;
+    NDDS_Transport_Address_t destAddress;
+    NDDS_Transport_Port_t destPort;
+    RTI_INT32 transportPriority;
+    NDDS_Transport_Buffer_t buffer;
+};
+
+struct CoalesceStage
+{
+    /// It has to be the first field.
+    struct eProsima_ChainStage parent;
+    struct CoalesceStageConfig config;
+    struct CoalesceBatch *batches;
+    /// Submessages of each batch.
+    int batchCapacity;
+    int usedBatches;
+
+    struct RTIOsapiSemaphore *mutex;
+    /// Held by the thread while it sends, so a send resource is not destroyed meanwhile.
+    struct RTIOsapiSemaphore *serviceMutex;
+    /// Given when a batch is used and there was none.
+    struct RTIOsapiSemaphore *pending;
+    int running;
+    int threadCreated;
+#if defined(RTI_WIN32)
+    HANDLE thread;
+#elif defined(COALESCE_STAGE_PTHREAD)
+    pthread_t thread;
+#endif
+    /// Datagram of the thread of the stage.
+    char *threadBuffer;
+
+    struct eProsima_CoalesceStageMetrics metrics;
+};
+
+static const unsigned char unknownPrefix[RTPS_HEADER_GUIDPREFIX_SIZE] = {0};
+
+static void lockStage(struct CoalesceStage *stage)
+{
+    RTIOsapiSemaphore_take(stage->mutex, NULL);
+}
+
+static void unlockStage(struct CoalesceStage *stage)
+{
+    RTIOsapiSemaphore_give(stage->mutex);
+}
+
+/**
+ * \brief This function reads the submessages of a message that can be held.
+ *
+ * \return The number of submessages. If the message has other submessages, or none that can be held, 0 is returned.
+ */
+static int parseControlMessage(const unsigned char *message, size_t length, struct CoalesceSubmessage *submessages)
+{
+    NDDS_Transport_Buffer_t buffer;
+    struct eProsima_RtpsReader reader;
+    struct eProsima_RtpsSubmessage submessage;
+    const unsigned char *destination = unknownPrefix;
+    int submessagesLength = 0;
+
+    buffer.pointer = (char*)message;
+    buffer.length = (RTI_INT32)length;
+    eProsimaRtpsReader_init(&reader, &buffer, 1);
+
+    while(eProsimaRtpsReader_nextSubmessage(&reader, &submessage) == 0)
+    {
+        switch(submessage.kind)
+        {
+            case RTPS_SUBMESSAGE_INFO_DST:
+                if(submessage.length < RTPS_HEADER_GUIDPREFIX_SIZE)
+                    return 0;
+                destination = message + submessage.offset + RTPS_SUBMESSAGE_HEADER_SIZE;
+                break;
+            // The timestamp is only used by DATA submessages.
+            case RTPS_SUBMESSAGE_INFO_TS:
+            case RTPS_SUBMESSAGE_PAD:
+                break;
+            case RTPS_SUBMESSAGE_HEARTBEAT:
+            case RTPS_SUBMESSAGE_ACKNACK:
+                if(submessagesLength == COALESCE_MESSAGE_SUBMESSAGES_MAX ||
+                        RTPS_SUBMESSAGE_HEADER_SIZE + submessage.length > COALESCE_SUBMESSAGE_SIZE_MAX)
+                    return 0;
+
+                memcpy(submessages[submessagesLength].destination, destination, RTPS_HEADER_GUIDPREFIX_SIZE);
+                submessages[submessagesLength].length = RTPS_SUBMESSAGE_HEADER_SIZE + submessage.length;
+                memcpy(submessages[submessagesLength].data, message + submessage.offset, submessages[submessagesLength].length);
+
+                // The last submessage can have octetsToNextHeader 0. It won't be the last one in the merged datagram.
+                if(submessage.flags & RTPS_SUBMESSAGE_FLAG_ENDIANNESS)
+                {
+                    submessages[submessagesLength].data[2] = (unsigned char)(submessage.length & 0xFF);
+                    submessages[submessagesLength].data[3] = (unsigned char)(submessage.length >> 8);
+                }
+                else
+                {
+                    submessages[submessagesLength].data[2] = (unsigned char)(submessage.length >> 8);
+                    submessages[submessagesLength].data[3] = (unsigned char)(submessage.length & 0xFF);
+                }
+
+                ++submessagesLength;
+                break;
+            default:
+                return 0;
+        }
+    }
+
+    return submessagesLength;
+}
+
+/**
+ * \brief This function returns the batch of a destination. With create, a free batch is used if there is none.
+ */
+static struct CoalesceBatch* findBatch(struct CoalesceStage *stage, const struct eProsima_ChainSendContext *context, int create)
+{
+    struct CoalesceBatch *freeBatch = NULL;
+    int i = 0;
+
+    for(i = 0; i < stage->config.destinations; ++i)
+    {
+        struct CoalesceBatch *batch = &stage->batches[i];
+
+        if(!batch->used)
+        {
+            if(freeBatch == NULL)
+                freeBatch = batch;
+        }
+        else if(batch->sendResource == context->sendResource && batch->destPort == context->destPort &&
+                batch->transportPriority == context->transportPriority &&
+                memcmp(&batch->destAddress, context->destAddress, sizeof(NDDS_Transport_Address_t)) == 0)
+            return batch;
+    }
+
+    if(!create || freeBatch == NULL)
+        return NULL;
+
+    freeBatch->used = 1;
+    freeBatch->sendResource = context->sendResource;
+    freeBatch->destAddress = *context->destAddress;
+    freeBatch->destPort = context->destPort;
+    freeBatch->transportPriority = context->transportPriority;
+    freeBatch->submessagesLength = 0;
+    freeBatch->size = RTPS_HEADER_SIZE;
+    ++stage->usedBatches;
+
+    return freeBatch;
+}
+
+/**
+ * \brief This function writes the submessages of a batch in a datagram and frees the batch.
+ */
+static void takeBatch(struct CoalesceStage *stage, struct CoalesceBatch *batch, char *output, struct CoalesceDatagram *datagram)
+{
+    const unsigned char *destination = unknownPrefix;
+    size_t length = RTPS_HEADER_SIZE;
+    int i = 0;
+
+    memcpy(output, batch->header, RTPS_HEADER_SIZE);
+
+    for(i = 0; i < batch->submessagesLength; ++i)
+    {
+        struct CoalesceSubmessage *submessage = &batch->submessages[i];
+
+        // Every held submessage keeps the destination it had.
+        if(memcmp(submessage->destination, destination, RTPS_HEADER_GUIDPREFIX_SIZE) != 0)
+        {
+            output[length] = RTPS_SUBMESSAGE_INFO_DST;
+            output[length + 1] = RTPS_SUBMESSAGE_FLAG_ENDIANNESS;
+            output[length + 2] = RTPS_HEADER_GUIDPREFIX_SIZE;
+            output[length + 3] = 0;
+            memcpy(output + length + RTPS_SUBMESSAGE_HEADER_SIZE, submessage->destination, RTPS_HEADER_GUIDPREFIX_SIZE);
+            length += COALESCE_INFO_DST_SIZE;
+            destination = submessage->destination;
+        }
+
+        memcpy(output + length, submessage->data, submessage->length);
+        length += submessage->length;
+    }
+
+    datagram->sendResource = batch->sendResource;
+    datagram->destAddress = batch->destAddress;
+    datagram->destPort = batch->destPort;
+    datagram->transportPriority = batch->transportPriority;
+    datagram->buffer.pointer = output;
+    datagram->buffer.length = (RTI_INT32)length;
+
+    batch->used = 0;
+    --stage->usedBatches;
+}
+
+static void sendDatagram(struct CoalesceStage *stage, const struct CoalesceDatagram *datagram)
+{
+    EPROSIMA_ATOMIC_ADD64(&stage->metrics.sentDatagrams, 1);
+
+    if(!eProsimaChainStage_sendNext(&stage->parent, datagram->sendResource, &datagram->destAddress, datagram->destPort,
+                datagram->transportPriority, &datagram->buffer, 1))
+        EPROSIMA_ATOMIC_ADD64(&stage->metrics.failedDatagrams, 1);
+}
+
+/**
+ * \brief This function adds a submessage to a batch. A HEARTBEAT replaces the held one of the same writer and reader.
+ */
+static void addSubmessage(struct CoalesceStage *stage, struct CoalesceBatch *batch, const struct CoalesceSubmessage *submessage)
+{
+    const unsigned char *last = batch->submessagesLength > 0 ? batch->submessages[batch->submessagesLength - 1].destination : unknownPrefix;
+    int i = 0;
+
+    if(submessage->data[0] == RTPS_SUBMESSAGE_HEARTBEAT)
+    {
+        for(i = 0; i < batch->submessagesLength; ++i)
+        {
+            struct CoalesceSubmessage *held = &batch->submessages[i];
+
+            // The readerId and writerId are the first 8 bytes of the body. The flags must be the same,
+            // so a final or liveliness HEARTBEAT doesn't replace other kind.
+            if(held->data[0] == RTPS_SUBMESSAGE_HEARTBEAT && held->data[1] == submessage->data[1] &&
+                    held->length == submessage->length &&
+                    memcmp(held->destination, submessage->destination, RTPS_HEADER_GUIDPREFIX_SIZE) == 0 &&
+                    memcmp(held->data + RTPS_SUBMESSAGE_HEADER_SIZE, submessage->data + RTPS_SUBMESSAGE_HEADER_SIZE,
+                        2 * RTPS_SUBMESSAGE_BODY_ENTITYID_SIZE) == 0)
+            {
+                memcpy(held->data, submessage->data, submessage->length);
+                EPROSIMA_ATOMIC_ADD64(&stage->metrics.collapsedHeartbeats, 1);
+                return;
+            }
+        }
+    }
+
+    if(memcmp(last, submessage->destination, RTPS_HEADER_GUIDPREFIX_SIZE) != 0)
+        batch->size += COALESCE_INFO_DST_SIZE;
+
+    batch->submessages[batch->submessagesLength++] = *submessage;
+    batch->size += submessage->length;
+}
+
+static EPROSIMA_CHAIN_STAGE_RESULT CoalesceStage_send(struct eProsima_ChainStage *self, struct eProsima_ChainSendContext *context)
+{
+    struct CoalesceStage *stage = (struct CoalesceStage*)self;
+    struct CoalesceSubmessage submessages[COALESCE_MESSAGE_SUBMESSAGES_MAX];
+    struct CoalesceDatagram datagram;
+    struct eProsima_RtpsReader reader;
+    struct CoalesceBatch *batch = NULL;
+    const unsigned char *message = NULL;
+    char *output = NULL;
+    size_t needed = 0;
+    int submessagesLength = 0, flushed = 0, wasIdle = 0, i = 0;
+
+    eProsimaRtpsReader_init(&reader, context->buffers, context->bufferCount);
+
+    if(!eProsimaRtpsReader_isRtps(&reader))
+        return EPROSIMA_CHAIN_STAGE_CONTINUE;
+
+    if(reader.length <= (size_t)stage->config.maxSize)
+    {
+        if(context->bufferCount == 1)
+        {
+            message = (const unsigned char*)context->buffers[0].pointer;
+        }
+        else
+        {
+            char *linear = (char*)eProsimaChainSendContext_allocate(context, reader.length);
+
+            if(linear == NULL || eProsimaRtpsReader_read(&reader, 0, linear, reader.length) != 0)
+                return EPROSIMA_CHAIN_STAGE_ERROR;
+
+            message = (const unsigned char*)linear;
+        }
+
+        submessagesLength = parseControlMessage(message, reader.length, submessages);
+    }
+
+    output = (char*)eProsimaChainSendContext_allocate(context, (size_t)stage->config.maxSize);
+
+    if(output == NULL)
+        return EPROSIMA_CHAIN_STAGE_ERROR;
+
+    lockStage(stage);
+
+    batch = findBatch(stage, context, submessagesLength > 0);
+
+    if(batch != NULL && batch->submessagesLength > 0 && submessagesLength > 0 &&
+            memcmp(batch->header, message, RTPS_HEADER_SIZE) != 0)
+    {
+        // Messages of other participant are not merged.
+        takeBatch(stage, batch, output, &datagram);
+        flushed = 1;
+        batch = NULL;
+    }
+
+    if(submessagesLength == 0 || batch == NULL)
+    {
+        // The held submessages go before the message.
+        if(batch != NULL && !flushed)
+        {
+            takeBatch(stage, batch, output, &datagram);
+            flushed = 1;
+        }
+
+        unlockStage(stage);
+
+        if(flushed)
+            sendDatagram(stage, &datagram);
+
+        return EPROSIMA_CHAIN_STAGE_CONTINUE;
+    }
+
+    // In the worst case every submessage needs an INFO_DST.
+    for(i = 0; i < submessagesLength; ++i)
+        needed += COALESCE_INFO_DST_SIZE + submessages[i].length;
+
+    if(batch->submessagesLength > 0 &&
+            (batch->size + needed > (size_t)stage->config.maxSize || batch->submessagesLength + submessagesLength > stage->batchCapacity))
+    {
+        takeBatch(stage, batch, output, &datagram);
+        flushed = 1;
+        batch = findBatch(stage, context, 1);
+    }
+
+    if(batch->submessagesLength == 0)
+    {
+        memcpy(batch->header, message, RTPS_HEADER_SIZE);
+        batch->deadline = eProsimaClock_getNanoseconds() + (unsigned long long)stage->config.windowUs * 1000ULL;
+        wasIdle = stage->usedBatches == 1;
+    }
+
+    for(i = 0; i < submessagesLength; ++i)
+        addSubmessage(stage, batch, &submessages[i]);
+
+    EPROSIMA_ATOMIC_ADD64(&stage->metrics.coalescedMessages, 1);
+
+    unlockStage(stage);
+
+    if(wasIdle)
+        RTIOsapiSemaphore_give(stage->pending);
+
+    if(flushed)
+        sendDatagram(stage, &datagram);
+
+    return EPROSIMA_CHAIN_STAGE_DISCARD;
+}
+
+/**
+ * \brief This function sends the batches whose window ended, or all of them with all.
+ *
+ * \return The earliest deadline of the remaining batches. If there are none, 0 is returned.
+ */
+static unsigned long long flushBatches(struct CoalesceStage *stage, int all)
+{
+    struct CoalesceDatagram datagram;
+    unsigned long long now = 0, earliest = 0;
+    int i = 0;
+
+    lockStage(stage);
+
+    for(i = 0; i < stage->config.destinations; ++i)
+    {
+        struct CoalesceBatch *batch = &stage->batches[i];
+
+        if(!batch->used)
+            continue;
+
+        now = eProsimaClock_getNanoseconds();
+
+        if(all || batch->deadline <= now)
+        {
+            takeBatch(stage, batch, stage->threadBuffer, &datagram);
+            unlockStage(stage);
+            sendDatagram(stage, &datagram);
+            lockStage(stage);
+        }
+        else if(earliest == 0 || batch->deadline < earliest)
+        {
+            earliest = batch->deadline;
+        }
+    }
+
+    unlockStage(stage);
+
+    return earliest;
+}
+
+static void runThread(struct CoalesceStage *stage)
+{
+    unsigned long long earliest = 0, now = 0;
+
+    while(EPROSIMA_ATOMIC_LOAD32(&stage->running))
+    {
+        RTIOsapiSemaphore_take(stage->serviceMutex, NULL);
+        earliest = flushBatches(stage, 0);
+        RTIOsapiSemaphore_give(stage->serviceMutex);
+
+        if(earliest == 0)
+        {
+            // Wait until a batch is used.
+            RTIOsapiSemaphore_take(stage->pending, NULL);
+            continue;
+        }
+
+        now = eProsimaClock_getNanoseconds();
+
+        if(earliest > now)
+            eProsimaClock_sleepNanoseconds(earliest - now);
+    }
+}
+
+#if defined(RTI_WIN32)
+static DWORD WINAPI coalesceThreadFunction(LPVOID arg)
+{
+    runThread((struct CoalesceStage*)arg);
+    return 0;
+}
+#elif defined(COALESCE_STAGE_PTHREAD)
+static void* coalesceThreadFunction(void *arg)
+{
+    runThread((struct CoalesceStage*)arg);
+    return NULL;
+}
+#endif
+
+static void CoalesceStage_destroySendResource(struct eProsima_ChainStage *self, NDDS_Transport_SendResource_t sendResource)
+{
+    struct CoalesceStage *stage = (struct CoalesceStage*)self;
+    struct CoalesceDatagram datagram;
+    char *output = NULL;
+    int i = 0;
+
+    RTIOsapiHeap_allocateArray(&output, stage->config.maxSize, char);
+
+    // The thread may be sending a batch of the resource.
+    RTIOsapiSemaphore_take(stage->serviceMutex, NULL);
+    lockStage(stage);
+
+    for(i = 0; i < stage->config.destinations; ++i)
+    {
+        struct CoalesceBatch *batch = &stage->batches[i];
+
+        if(!batch->used || batch->sendResource != sendResource)
+            continue;
+
+        // The held submessages are sent while the resource exists. Without memory they are dropped.
+        if(output != NULL)
+        {
+            takeBatch(stage, batch, output, &datagram);
+            unlockStage(stage);
+            sendDatagram(stage, &datagram);
+            lockStage(stage);
+        }
+        else
+        {
+            batch->used = 0;
+            --stage->usedBatches;
+        }
+    }
+
+    unlockStage(stage);
+    RTIOsapiSemaphore_give(stage->serviceMutex);
+
+    if(output != NULL)
+        RTIOsapiHeap_freeArray(output);
+}
+
+static void deleteCoalesceStage(struct CoalesceStage *stage)
+{
+    int i = 0;
+
+    if(stage->threadCreated)
+    {
+        EPROSIMA_ATOMIC_STORE32(&stage->running, 0);
+        RTIOsapiSemaphore_give(stage->pending);
+#if defined(RTI_WIN32)
+        WaitForSingleObject(stage->thread, INFINITE);
+        CloseHandle(stage->thread);
+#elif defined(COALESCE_STAGE_PTHREAD)
+        pthread_join(stage->thread, NULL);
+#endif
+    }
+
+    if(stage->batches != NULL)
+    {
+        for(i = 0; i < stage->config.destinations; ++i)
+        {
+            if(stage->batches[i].submessages != NULL)
+                RTIOsapiHeap_freeArray(stage->batches[i].submessages);
+        }
+
+        RTIOsapiHeap_freeArray(stage->batches);
+    }
+
+    if(stage->threadBuffer != NULL)
+        RTIOsapiHeap_freeArray(stage->threadBuffer);
+    if(stage->pending != NULL)
+        RTIOsapiSemaphore_delete(stage->pending);
+    if(stage->serviceMutex != NULL)
+        RTIOsapiSemaphore_delete(stage->serviceMutex);
+    if(stage->mutex != NULL)
+        RTIOsapiSemaphore_delete(stage->mutex);
+
+    RTIOsapiHeap_freeStructure(stage);
+}
+
+static void CoalesceStage_destroy(struct eProsima_ChainStage *self)
+{
+    deleteCoalesceStage((struct CoalesceStage*)self);
+}
+
+static int startThread(struct CoalesceStage *stage)
+{
+    stage->running = 1;
+
+#if defined(RTI_WIN32)
+    stage->thread = CreateThread(NULL, 0, coalesceThreadFunction, stage, 0, NULL);
+    stage->threadCreated = stage->thread != NULL;
+#elif defined(COALESCE_STAGE_PTHREAD)
+    stage->threadCreated = pthread_create(&stage->thread, NULL, coalesceThreadFunction, stage) == 0;
+#endif
+
+    return stage->threadCreated ? 0 : -1;
+}
+
+struct eProsima_ChainStage* eProsimaCoalesceStage_create(const struct eProsima_PropertyIndex *index, const char *prefix)
+{
+    const char* const METHOD_NAME = "eProsimaCoalesceStage_create";
+    struct CoalesceStage *stage = NULL;
+    int i = 0;
+
+    if(index == NULL || prefix == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    RTIOsapiHeap_allocateStructure(&stage, struct CoalesceStage);
+
+    if(stage == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the stage\n", METHOD_NAME);
+        return NULL;
+    }
+
+    memset(stage, 0, sizeof(struct CoalesceStage));
+    stage->config.windowUs = 1000;
+    stage->config.maxSize = 1400;
+    stage->config.destinations = 64;
+    parseTransportPropertiesFromIndex(index, prefix, CoalescePropertyDescriptors,
+            sizeof(CoalescePropertyDescriptors) / sizeof(CoalescePropertyDescriptors[0]), &stage->config);
+
+    // The smallest submessage that is held has 28 bytes.
+    stage->batchCapacity = stage->config.maxSize / 28 + 1;
+    stage->mutex = RTIOsapiSemaphore_new(RTI_OSAPI_SEMAPHORE_KIND_MUTEX, NULL);
+    stage->serviceMutex = RTIOsapiSemaphore_new(RTI_OSAPI_SEMAPHORE_KIND_MUTEX, NULL);
+    stage->pending = RTIOsapiSemaphore_new(RTI_OSAPI_SEMAPHORE_KIND_BINARY, NULL);
+    RTIOsapiHeap_allocateArray(&stage->batches, stage->config.destinations, struct CoalesceBatch);
+    RTIOsapiHeap_allocateArray(&stage->threadBuffer, stage->config.maxSize, char);
+
+    if(stage->mutex == NULL || stage->serviceMutex == NULL || stage->pending == NULL || stage->batches == NULL || stage->threadBuffer == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the stage\n", METHOD_NAME);
+        deleteCoalesceStage(stage);
+        return NULL;
+    }
+
+    memset(stage->batches, 0, stage->config.destinations * sizeof(struct CoalesceBatch));
+
+    for(i = 0; i < stage->config.destinations; ++i)
+    {
+        RTIOsapiHeap_allocateArray(&stage->batches[i].submessages, stage->batchCapacity, struct CoalesceSubmessage);
+
+        if(stage->batches[i].submessages == NULL)
+        {
+            printf("ERROR<%s>: Cannot allocate memory for the stage\n", METHOD_NAME);
+            deleteCoalesceStage(stage);
+            return NULL;
+        }
+    }
+
+    if(startThread(stage) != 0)
+    {
+        printf("ERROR<%s>: Cannot create the thread of the stage\n", METHOD_NAME);
+        deleteCoalesceStage(stage);
+        return NULL;
+    }
+
+    // The message linearized when it has several buffers and the datagram of a batch sent before it.
+    stage->parent.sendScratchSize = 2 * (size_t)stage->config.maxSize;
+    stage->parent.send = CoalesceStage_send;
+    stage->parent.destroySendResource = CoalesceStage_destroySendResource;
+    stage->parent.destroy = CoalesceStage_destroy;
+
+    return &stage->parent;
+}
+
+void eProsimaCoalesceStage_getMetrics(const struct eProsima_ChainStage *stage, struct eProsima_CoalesceStageMetrics *metrics)
+{
+    const struct CoalesceStage *coalesceStage = (const struct CoalesceStage*)stage;
+
+    metrics->coalescedMessages = EPROSIMA_ATOMIC_LOAD64(&coalesceStage->metrics.coalescedMessages);
+    metrics->sentDatagrams = EPROSIMA_ATOMIC_LOAD64(&coalesceStage->metrics.sentDatagrams);
+    metrics->collapsedHeartbeats = EPROSIMA_ATOMIC_LOAD64(&coalesceStage->metrics.collapsedHeartbeats);
+    metrics->failedDatagrams = EPROSIMA_ATOMIC_LOAD64(&coalesceStage->metrics.failedDatagrams);
+}
@@ -0,0 +1,63 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_CHAIN_COALESCESTAGE_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_CHAIN_COALESCESTAGE_H_
+
+#include "eProsima_c/config.h"
+#include "chainStage.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/**
+ * \brief Metrics of a coalesce stage. The reduction of the control packet rate is
+ * coalescedMessages / sentDatagrams.
+ */
+struct eProsima_CoalesceStageMetrics
+{
+    /// Messages with only HEARTBEAT and ACKNACK submessages that were held by the stage.
+    unsigned long long coalescedMessages;
+    /// Datagrams sent with the held submessages.
+    unsigned long long sentDatagrams;
+    /// HEARTBEATs replaced by a newer one of the same writer.
+    unsigned long long collapsedHeartbeats;
+    /// Datagrams that the next stages failed to send.
+    unsigned long long failedDatagrams;
+};
+
+/**
+ * \brief This function creates a stage that merges the HEARTBEAT and ACKNACK messages sent to the same
+ * destination in one datagram.
+ *
+ * A message whose submessages are only HEARTBEAT, ACKNACK, INFO_DST, INFO_TS and PAD is held up to window_us
+ * microseconds with the other ones of its destination, send resource and transport priority. A HEARTBEAT
+ * replaces a held one of the same writer for the same reader. Other messages are sent immediately, after the
+ * held submessages of their destination, so the order of the HEARTBEATs and the DATA they announce is kept.
+ * The held submessages are sent by a thread of the stage when the window ends, or before if they fill
+ * max_size bytes.
+ *
+ * The properties use the prefix of the stage:
+ *     window_us: Maximum time a submessage is held. Default 1000.
+ *     max_size: Maximum size of a merged datagram. Default 1400.
+ *     destinations: Destinations with held submessages at the same time. Messages to other destinations are
+ *         sent immediately. Default 64.
+ *
+ * \param index Index of the properties of the chain. Cannot be NULL.
+ * \param prefix Prefix of the properties of the stage. Cannot be NULL.
+ * \return The new stage. In error case, NULL value is returned.
+ */
+struct eProsima_ChainStage* eProsimaCoalesceStage_create(const struct eProsima_PropertyIndex *index, const char *prefix);
+
+/**
+ * \brief This function reads the metrics of a coalesce stage.
+ *
+ * \param stage A stage created by eProsimaCoalesceStage_create. Cannot be NULL.
+ * \param metrics Where the metrics are stored. Cannot be NULL.
+ */
+void eProsimaCoalesceStage_getMetrics(const struct eProsima_ChainStage *stage, struct eProsima_CoalesceStageMetrics *metrics);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_CHAIN_COALESCESTAGE_H_
@@ -0,0 +1,205 @@
+#include "compressionStage.h"
+#include "../transportPropertyParser.h"
+#include "../../rtps/messageReader.h"
+#include "../../../compress/lz4Block.h"
+#include "../../../sys/atomic.h"
+#include "../../../sys/clock.h"
+
+#include <osapi/osapi_heap.h>
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+/// RTPS header followed by the length of the uncompressed body.
+#define COMPRESSION_HEADER_SIZE (RTPS_HEADER_SIZE + 4)
+
+struct CompressionStageConfig
+{
+    int threshold;
+    int maxRatio;
+};
+
+static const struct eProsima_PropertyDescriptor CompressionPropertyDescriptors[] =
+{
+    EPROSIMA_PROPERTY_INT(struct CompressionStageConfig, "threshold", threshold, 0, INT_MAX, 1024),
+    EPROSIMA_PROPERTY_INT(struct CompressionStageConfig, "max_ratio", maxRatio, 1, 100, 90)
+};
+
+/// Submessages whose messages are compressed.
+static const enum RTPS_SubmessageKind compressedKinds[] = {RTPS_SUBMESSAGE_DATA, RTPS_SUBMESSAGE_DATA_FRAG};
+
+struct CompressionStage
+{
+    /// It has to be the first field.
+    struct eProsima_ChainStage parent;
+    struct CompressionStageConfig config;
+    struct eProsima_CompressionStageMetrics metrics;
+};
+
+static EPROSIMA_CHAIN_STAGE_RESULT CompressionStage_send(struct eProsima_ChainStage *self, struct eProsima_ChainSendContext *context)
+{
+    struct CompressionStage *stage = (struct CompressionStage*)self;
+    struct eProsima_RtpsReader reader;
+    unsigned long long start = 0;
+    size_t bodyLength = 0, compressedMax = 0;
+    const char *source = NULL;
+    char *linear = NULL, *output = NULL;
+    int compressedLength = 0;
+
+    eProsimaRtpsReader_init(&reader, context->buffers, context->bufferCount);
+
+    if(reader.length < (size_t)stage->config.threshold || !eProsimaRtpsReader_isRtps(&reader) ||
+            !eProsimaRtpsReader_containsSubmessage(&reader, compressedKinds, sizeof(compressedKinds) / sizeof(compressedKinds[0])))
+        return EPROSIMA_CHAIN_STAGE_CONTINUE;
+
+    EPROSIMA_ATOMIC_ADD64(&stage->metrics.candidateMessages, 1);
+    EPROSIMA_ATOMIC_ADD64(&stage->metrics.candidateBytes, (unsigned long long)reader.length);
+
+    // The compressed message cannot be bigger than this.
+    compressedMax = (reader.length * (size_t)stage->config.maxRatio) / 100;
+
+    if(compressedMax <= COMPRESSION_HEADER_SIZE)
+        return EPROSIMA_CHAIN_STAGE_CONTINUE;
+
+    start = eProsimaClock_getNanoseconds();
+
+    if(context->bufferCount == 1)
+    {
+        source = context->buffers[0].pointer;
+    }
+    else
+    {
+        linear = (char*)eProsimaChainSendContext_allocate(context, reader.length);
+
+        if(linear == NULL || eProsimaRtpsReader_read(&reader, 0, linear, reader.length) != 0)
+            return EPROSIMA_CHAIN_STAGE_ERROR;
+
+        source = linear;
+    }
+
+    output = (char*)eProsimaChainSendContext_allocate(context, compressedMax);
+
+    if(output == NULL)
+        return EPROSIMA_CHAIN_STAGE_ERROR;
+
+    bodyLength = reader.length - RTPS_HEADER_SIZE;
+    compressedLength = eProsimaLz4_compress(source + RTPS_HEADER_SIZE, (int)bodyLength,
+            output + COMPRESSION_HEADER_SIZE, (int)(compressedMax - COMPRESSION_HEADER_SIZE));
+
+    EPROSIMA_ATOMIC_ADD64(&stage->metrics.compressNanoseconds, eProsimaClock_getNanoseconds() - start);
+
+    // The data doesn't compress enough. The original message is sent.
+    if(compressedLength == 0)
+        return EPROSIMA_CHAIN_STAGE_CONTINUE;
+
+    memcpy(output, EPROSIMA_COMPRESSION_PROTOCOL, RTPS_HEADER_PROTOCOL_SIZE);
+    memcpy(output + RTPS_HEADER_PROTOCOL_SIZE, source + RTPS_HEADER_PROTOCOL_SIZE, RTPS_HEADER_SIZE - RTPS_HEADER_PROTOCOL_SIZE);
+    output[RTPS_HEADER_SIZE] = (char)(bodyLength & 0xFF);
+    output[RTPS_HEADER_SIZE + 1] = (char)((bodyLength >> 8) & 0xFF);
+    output[RTPS_HEADER_SIZE + 2] = (char)((bodyLength >> 16) & 0xFF);
+    output[RTPS_HEADER_SIZE + 3] = (char)((bodyLength >> 24) & 0xFF);
+
+    context->buffers[0].pointer = output;
+    context->buffers[0].length = COMPRESSION_HEADER_SIZE + compressedLength;
+    context->bufferCount = 1;
+
+    EPROSIMA_ATOMIC_ADD64(&stage->metrics.compressedMessages, 1);
+    EPROSIMA_ATOMIC_ADD64(&stage->metrics.compressedBytes, (unsigned long long)context->buffers[0].length);
+
+    return EPROSIMA_CHAIN_STAGE_CONTINUE;
+}
+
+static EPROSIMA_CHAIN_STAGE_RESULT CompressionStage_receive(struct eProsima_ChainStage *self, struct eProsima_ChainReceiveContext *context)
+{
+    struct CompressionStage *stage = (struct CompressionStage*)self;
+    const unsigned char *source = (const unsigned char*)context->message->buffer.pointer;
+    RTI_INT32 length = context->message->buffer.length;
+    unsigned long long start = 0;
+    size_t bodyLength = 0;
+    char *output = NULL;
+    int decompressedLength = -1;
+
+    if(length < COMPRESSION_HEADER_SIZE || memcmp(source, EPROSIMA_COMPRESSION_PROTOCOL, RTPS_HEADER_PROTOCOL_SIZE) != 0)
+        return EPROSIMA_CHAIN_STAGE_CONTINUE;
+
+    start = eProsimaClock_getNanoseconds();
+    bodyLength = (size_t)source[RTPS_HEADER_SIZE] | ((size_t)source[RTPS_HEADER_SIZE + 1] << 8) |
+        ((size_t)source[RTPS_HEADER_SIZE + 2] << 16) | ((size_t)source[RTPS_HEADER_SIZE + 3] << 24);
+
+    if(bodyLength <= (size_t)context->messageSizeMax - RTPS_HEADER_SIZE &&
+            (output = eProsimaChainReceiveContext_getBuffer(context)) != NULL)
+    {
+        decompressedLength = eProsimaLz4_decompress((const char*)source + COMPRESSION_HEADER_SIZE, length - COMPRESSION_HEADER_SIZE,
+                output + RTPS_HEADER_SIZE, (int)bodyLength);
+    }
+
+    if(decompressedLength < 0 || (size_t)decompressedLength != bodyLength)
+    {
+        EPROSIMA_ATOMIC_ADD64(&stage->metrics.decompressErrors, 1);
+        return EPROSIMA_CHAIN_STAGE_ERROR;
+    }
+
+    memcpy(output, RTPS_HEADER_PROTOCOL, RTPS_HEADER_PROTOCOL_SIZE);
+    memcpy(output + RTPS_HEADER_PROTOCOL_SIZE, source + RTPS_HEADER_PROTOCOL_SIZE, RTPS_HEADER_SIZE - RTPS_HEADER_PROTOCOL_SIZE);
+    context->message->buffer.pointer = output;
+    context->message->buffer.length = RTPS_HEADER_SIZE + decompressedLength;
+
+    EPROSIMA_ATOMIC_ADD64(&stage->metrics.decompressedMessages, 1);
+    EPROSIMA_ATOMIC_ADD64(&stage->metrics.decompressNanoseconds, eProsimaClock_getNanoseconds() - start);
+
+    return EPROSIMA_CHAIN_STAGE_CONTINUE;
+}
+
+static void CompressionStage_destroy(struct eProsima_ChainStage *self)
+{
+    RTIOsapiHeap_freeStructure((struct CompressionStage*)self);
+}
+
+struct eProsima_ChainStage* eProsimaCompressionStage_create(const struct eProsima_PropertyIndex *index, const char *prefix)
+{
+    const char* const METHOD_NAME = "eProsimaCompressionStage_create";
+    struct CompressionStage *stage = NULL;
+
+    if(index == NULL || prefix == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    RTIOsapiHeap_allocateStructure(&stage, struct CompressionStage);
+
+    if(stage == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the stage\n", METHOD_NAME);
+        return NULL;
+    }
+
+    memset(stage, 0, sizeof(struct CompressionStage));
+    stage->config.threshold = 1024;
+    stage->config.maxRatio = 90;
+    parseTransportPropertiesFromIndex(index, prefix, CompressionPropertyDescriptors,
+            sizeof(CompressionPropertyDescriptors) / sizeof(CompressionPropertyDescriptors[0]), &stage->config);
+
+    // The linearized message and the compressed one.
+    stage->parent.sendScratchMessages = 2;
+    stage->parent.send = CompressionStage_send;
+    stage->parent.receive = CompressionStage_receive;
+    stage->parent.destroy = CompressionStage_destroy;
+
+    return &stage->parent;
+}
+
+void eProsimaCompressionStage_getMetrics(const struct eProsima_ChainStage *stage, struct eProsima_CompressionStageMetrics *metrics)
+{
+    const struct CompressionStage *compressionStage = (const struct CompressionStage*)stage;
+
+    metrics->candidateMessages = EPROSIMA_ATOMIC_LOAD64(&compressionStage->metrics.candidateMessages);
+    metrics->candidateBytes = EPROSIMA_ATOMIC_LOAD64(&compressionStage->metrics.candidateBytes);
+    metrics->compressedMessages = EPROSIMA_ATOMIC_LOAD64(&compressionStage->metrics.compressedMessages);
+    metrics->compressedBytes = EPROSIMA_ATOMIC_LOAD64(&compressionStage->metrics.compressedBytes);
+    metrics->compressNanoseconds = EPROSIMA_ATOMIC_LOAD64(&compressionStage->metrics.compressNanoseconds);
+    metrics->decompressedMessages = EPROSIMA_ATOMIC_LOAD64(&compressionStage->metrics.decompressedMessages);
+    metrics->decompressErrors = EPROSIMA_ATOMIC_LOAD64(&compressionStage->metrics.decompressErrors);
+    metrics->decompressNanoseconds = EPROSIMA_ATOMIC_LOAD64(&compressionStage->metrics.decompressNanoseconds);
+}
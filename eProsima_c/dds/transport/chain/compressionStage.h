@@ -0,0 +1,67 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_CHAIN_COMPRESSIONSTAGE_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_CHAIN_COMPRESSIONSTAGE_H_
+
+#include "eProsima_c/config.h"
+#include "chainStage.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/**
+ * \brief Protocol identifier of the compressed messages. It replaces "RTPS" in the RTPS header.
+ */
+#define EPROSIMA_COMPRESSION_PROTOCOL "RTPZ"
+
+/**
+ * \brief Metrics of a compression stage.
+ */
+struct eProsima_CompressionStageMetrics
+{
+    /// Messages with DATA or DATA_FRAG submessages bigger than the threshold.
+    unsigned long long candidateMessages;
+    unsigned long long candidateBytes;
+    /// Candidate messages that were sent compressed and their size after compression.
+    unsigned long long compressedMessages;
+    unsigned long long compressedBytes;
+    /// Time spent compressing the candidate messages.
+    unsigned long long compressNanoseconds;
+    unsigned long long decompressedMessages;
+    /// Received compressed messages that were malformed.
+    unsigned long long decompressErrors;
+    unsigned long long decompressNanoseconds;
+};
+
+/**
+ * \brief This function creates a stage that compresses with LZ4 the messages with DATA or DATA_FRAG
+ * submessages and decompresses the received messages that were compressed.
+ *
+ * A compressed message keeps the RTPS header with the protocol EPROSIMA_COMPRESSION_PROTOCOL. It is
+ * followed by the length of the rest of the original message (4 bytes, little-endian) and its LZ4 block.
+ * Both sides must use the stage. The metrics are read with eProsimaCompressionStage_getMetrics.
+ *
+ * The properties use the prefix of the stage:
+ *     threshold: Minimum size of the messages that are compressed. Default 1024.
+ *     max_ratio: Maximum size of a compressed message as percentage of the original one. If the compressed
+ *         message is bigger, the original one is sent. Default 90.
+ *
+ * \param index Index of the properties of the chain. Cannot be NULL.
+ * \param prefix Prefix of the properties of the stage. Cannot be NULL.
+ * \return The new stage. In error case, NULL value is returned.
+ */
+struct eProsima_ChainStage* eProsimaCompressionStage_create(const struct eProsima_PropertyIndex *index, const char *prefix);
+
+/**
+ * \brief This function reads the metrics of a compression stage.
+ *
+ * \param stage A stage created by eProsimaCompressionStage_create. Cannot be NULL.
+ * \param metrics Where the metrics are stored. Cannot be NULL.
+ */
+void eProsimaCompressionStage_getMetrics(const struct eProsima_ChainStage *stage, struct eProsima_CompressionStageMetrics *metrics);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_CHAIN_COMPRESSIONSTAGE_H_
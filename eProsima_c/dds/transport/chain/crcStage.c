@@ -0,0 +1,131 @@
+#include "crcStage.h"
+#include "../../../sys/atomic.h"
+#include "../../../sys/crc32c.h"
+#include "../../../macros/snprintf.h"
+
+#include <osapi/osapi_heap.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define CRC_STAGE_NAME_LENGTH 64
+
+struct CrcStage
+{
+    /// It has to be the first field.
+    struct eProsima_ChainStage parent;
+    char name[CRC_STAGE_NAME_LENGTH];
+    struct eProsima_CrcStageMetrics metrics;
+};
+
+static EPROSIMA_CHAIN_STAGE_RESULT CrcStage_send(struct eProsima_ChainStage *self, struct eProsima_ChainSendContext *context)
+{
+    struct CrcStage *stage = (struct CrcStage*)self;
+    unsigned char *trailer = NULL;
+    unsigned int crc = 0;
+    RTI_INT32 i = 0;
+
+    if(context->bufferCount >= context->bufferCountMax)
+        return EPROSIMA_CHAIN_STAGE_ERROR;
+
+    trailer = (unsigned char*)eProsimaChainSendContext_allocate(context, EPROSIMA_CRC_STAGE_TRAILER_SIZE);
+
+    if(trailer == NULL)
+        return EPROSIMA_CHAIN_STAGE_ERROR;
+
+    for(i = 0; i < context->bufferCount; ++i)
+        crc = eProsimaCrc32c_update(crc, context->buffers[i].pointer, (size_t)context->buffers[i].length);
+
+    trailer[0] = (unsigned char)(crc & 0xFF);
+    trailer[1] = (unsigned char)((crc >> 8) & 0xFF);
+    trailer[2] = (unsigned char)((crc >> 16) & 0xFF);
+    trailer[3] = (unsigned char)(crc >> 24);
+
+    context->buffers[context->bufferCount].pointer = (char*)trailer;
+    context->buffers[context->bufferCount].length = EPROSIMA_CRC_STAGE_TRAILER_SIZE;
+    ++context->bufferCount;
+
+    EPROSIMA_ATOMIC_ADD64(&stage->metrics.sentMessages, 1);
+
+    return EPROSIMA_CHAIN_STAGE_CONTINUE;
+}
+
+static EPROSIMA_CHAIN_STAGE_RESULT CrcStage_receive(struct eProsima_ChainStage *self, struct eProsima_ChainReceiveContext *context)
+{
+    struct CrcStage *stage = (struct CrcStage*)self;
+    const unsigned char *message = (const unsigned char*)context->message->buffer.pointer;
+    const unsigned char *trailer = NULL;
+    RTI_INT32 length = context->message->buffer.length - EPROSIMA_CRC_STAGE_TRAILER_SIZE;
+    unsigned int crc = 0;
+
+    if(length < 0)
+    {
+        EPROSIMA_ATOMIC_ADD64(&stage->metrics.corruptedMessages, 1);
+        return EPROSIMA_CHAIN_STAGE_DISCARD;
+    }
+
+    trailer = message + length;
+    crc = (unsigned int)trailer[0] | ((unsigned int)trailer[1] << 8) | ((unsigned int)trailer[2] << 16) |
+        ((unsigned int)trailer[3] << 24);
+
+    EPROSIMA_ATOMIC_ADD64(&stage->metrics.checkedMessages, 1);
+
+    if(eProsimaCrc32c_update(0, message, (size_t)length) != crc)
+    {
+        EPROSIMA_ATOMIC_ADD64(&stage->metrics.corruptedMessages, 1);
+        return EPROSIMA_CHAIN_STAGE_DISCARD;
+    }
+
+    context->message->buffer.length = length;
+
+    return EPROSIMA_CHAIN_STAGE_CONTINUE;
+}
+
+static void CrcStage_destroy(struct eProsima_ChainStage *self)
+{
+    RTIOsapiHeap_freeStructure((struct CrcStage*)self);
+}
+
+struct eProsima_ChainStage* eProsimaCrcStage_create(const struct eProsima_PropertyIndex *index, const char *prefix)
+{
+    const char* const METHOD_NAME = "eProsimaCrcStage_create";
+    struct CrcStage *stage = NULL;
+
+    if(index == NULL || prefix == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    RTIOsapiHeap_allocateStructure(&stage, struct CrcStage);
+
+    if(stage == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the stage\n", METHOD_NAME);
+        return NULL;
+    }
+
+    memset(stage, 0, sizeof(struct CrcStage));
+    SNPRINTF(stage->name, sizeof(stage->name), "%s", prefix);
+
+    if(!eProsimaCrc32c_isHardware())
+        printf("WARNING<%s>: %s: The processor doesn't have the crc32 instruction. Tables are used\n", METHOD_NAME, stage->name);
+
+    stage->parent.messageOverhead = EPROSIMA_CRC_STAGE_TRAILER_SIZE;
+    stage->parent.extraBufferCount = 1;
+    stage->parent.sendScratchSize = EPROSIMA_CRC_STAGE_TRAILER_SIZE;
+    stage->parent.send = CrcStage_send;
+    stage->parent.receive = CrcStage_receive;
+    stage->parent.destroy = CrcStage_destroy;
+
+    return &stage->parent;
+}
+
+void eProsimaCrcStage_getMetrics(const struct eProsima_ChainStage *stage, struct eProsima_CrcStageMetrics *metrics)
+{
+    const struct CrcStage *crcStage = (const struct CrcStage*)stage;
+
+    metrics->sentMessages = EPROSIMA_ATOMIC_LOAD64(&crcStage->metrics.sentMessages);
+    metrics->checkedMessages = EPROSIMA_ATOMIC_LOAD64(&crcStage->metrics.checkedMessages);
+    metrics->corruptedMessages = EPROSIMA_ATOMIC_LOAD64(&crcStage->metrics.corruptedMessages);
+}
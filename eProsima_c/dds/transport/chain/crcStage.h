@@ -0,0 +1,56 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_CHAIN_CRCSTAGE_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_CHAIN_CRCSTAGE_H_
+
+#include "eProsima_c/config.h"
+#include "chainStage.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/// Bytes of the CRC32C trailer added to each message.
+#define EPROSIMA_CRC_STAGE_TRAILER_SIZE 4
+
+/**
+ * \brief Metrics of a crc stage.
+ */
+struct eProsima_CrcStageMetrics
+{
+    /// Messages sent with a trailer.
+    unsigned long long sentMessages;
+    /// Received messages whose trailer was checked.
+    unsigned long long checkedMessages;
+    /// Received messages dropped because the trailer didn't match or they were too short.
+    unsigned long long corruptedMessages;
+};
+
+/**
+ * \brief This function creates a stage that appends a CRC32C of each sent message as a trailer of
+ * EPROSIMA_CRC_STAGE_TRAILER_SIZE bytes in little endian, and checks and removes it from each received message.
+ * Corrupted messages are dropped. It protects against links where the UDP checksum is disabled or offloaded
+ * wrongly, so every participant of the domain must use the stage.
+ *
+ * The CRC is computed over the gather array of the sent message without copying it, and the trailer is added
+ * as other buffer. eProsimaCrc32c_update is used, so the crc32 instruction of SSE4.2 is used when there is one.
+ * The stage has no properties.
+ *
+ * \param index Index of the properties of the chain. Cannot be NULL.
+ * \param prefix Prefix of the properties of the stage. Cannot be NULL.
+ * \return The new stage. In error case, NULL value is returned.
+ */
+struct eProsima_ChainStage* eProsimaCrcStage_create(const struct eProsima_PropertyIndex *index, const char *prefix);
+
+/**
+ * \brief This function reads the metrics of a crc stage.
+ *
+ * \param stage A stage created by eProsimaCrcStage_create. Cannot be NULL.
+ * \param metrics Where the metrics are stored. Cannot be NULL.
+ */
+void eProsimaCrcStage_getMetrics(const struct eProsima_ChainStage *stage, struct eProsima_CrcStageMetrics *metrics);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_CHAIN_CRCSTAGE_H_
@@ -0,0 +1,350 @@
+#include "dedupStage.h"
+#include "../transportPropertyParser.h"
+#include "../../rtps/messageReader.h"
+#include "../../../sys/atomic.h"
+#include "../../../sys/clock.h"
+
+#include <osapi/osapi_heap.h>
+
+#include <stdio.h>
+#include <string.h>
+
+/// GUID prefix and writerId of the writer and readerId of the reader.
+#define DEDUP_KEY_SIZE (RTPS_HEADER_GUIDPREFIX_SIZE + 2 * RTPS_SUBMESSAGE_BODY_ENTITYID_SIZE)
+#define DEDUP_KEY_READERID_OFFSET (RTPS_HEADER_GUIDPREFIX_SIZE + RTPS_SUBMESSAGE_BODY_ENTITYID_SIZE)
+
+/// An entry has 64 bytes, so the table takes 4 MB at most.
+#define DEDUP_WRITERS_MAX (1 << 16)
+
+struct DedupStageConfig
+{
+    int writers;
+    int duplicateIntervalUs;
+};
+
+static const struct eProsima_PropertyDescriptor DedupPropertyDescriptors[] =
+{
+    EPROSIMA_PROPERTY_INT(struct DedupStageConfig, "writers", writers, 1, DEDUP_WRITERS_MAX, 4096),
+    EPROSIMA_PROPERTY_INT(struct DedupStageConfig, "duplicate_interval_us", duplicateIntervalUs, 1, 10000000, 10000)
+};
+
+/**
+ * \brief Window of a writer and reader pair. Bit i of seen is set when the sequence number highest - i was received
+ * in the current epoch, and bit i of previous when it was received in the epoch before it. An epoch lasts
+ * duplicate_interval_us.
+ */
+struct DedupWriter
+{
+    /// Spin lock of the entry. The receive threads of all the ports share the table.
+    unsigned int lock;
+    unsigned int used;
+    unsigned char key[DEDUP_KEY_SIZE];
+    unsigned long long highest;
+    unsigned long long seen;
+    unsigned long long previous;
+    unsigned long long epoch;
+};
+
+typedef enum DEDUP_RESULT
+{
+    DEDUP_NEW = 0,
+    DEDUP_DUPLICATE,
+    /// Older than the window. It cannot be checked.
+    DEDUP_OLD
+} DEDUP_RESULT;
+
+struct DedupStage
+{
+    /// It has to be the first field.
+    struct eProsima_ChainStage parent;
+    struct DedupStageConfig config;
+    struct DedupWriter *writers;
+    unsigned int writersMask;
+    unsigned long long epochNanoseconds;
+    struct eProsima_DedupStageMetrics metrics;
+};
+
+static unsigned int hashKey(const unsigned char *key)
+{
+    unsigned int hash = 2166136261U;
+    int i = 0;
+
+    for(i = 0; i < DEDUP_KEY_SIZE; ++i)
+        hash = (hash ^ key[i]) * 16777619U;
+
+    return hash;
+}
+
+/// readerId of the DATA submessages for all the readers of the participant (ENTITYID_UNKNOWN).
+static const unsigned char DEDUP_READERID_UNKNOWN[RTPS_SUBMESSAGE_BODY_ENTITYID_SIZE] = {0, 0, 0, 0};
+
+static unsigned int readUInt32(const unsigned char *data, int littleEndian)
+{
+    if(littleEndian)
+        return (unsigned int)data[0] | ((unsigned int)data[1] << 8) | ((unsigned int)data[2] << 16) | ((unsigned int)data[3] << 24);
+
+    return ((unsigned int)data[0] << 24) | ((unsigned int)data[1] << 16) | ((unsigned int)data[2] << 8) | (unsigned int)data[3];
+}
+
+/**
+ * \brief This function records a sequence number in the window of its writer and reader pair. A sequence number
+ * is only a duplicate if it was received in the current or the previous epoch, so the retransmissions requested
+ * by the readers pass.
+ */
+static DEDUP_RESULT checkSequenceNumber(struct DedupStage *stage, const unsigned char *key, unsigned long long sequenceNumber)
+{
+    struct DedupWriter *writer = &stage->writers[hashKey(key) & stage->writersMask];
+    unsigned long long epoch = eProsimaClock_getNanoseconds() / stage->epochNanoseconds;
+    DEDUP_RESULT result = DEDUP_NEW;
+    unsigned long long distance = 0;
+
+    while(!EPROSIMA_ATOMIC_CAS32(&writer->lock, 0, 1))
+        EPROSIMA_CPU_RELAX();
+
+    if(!writer->used || memcmp(writer->key, key, DEDUP_KEY_SIZE) != 0)
+    {
+        if(writer->used)
+            EPROSIMA_ATOMIC_ADD64(&stage->metrics.evictedWriters, 1);
+
+        memcpy(writer->key, key, DEDUP_KEY_SIZE);
+        writer->used = 1;
+        writer->highest = sequenceNumber;
+        writer->seen = 1;
+        writer->previous = 0;
+        writer->epoch = epoch;
+    }
+    else
+    {
+        if(epoch != writer->epoch)
+        {
+            writer->previous = epoch == writer->epoch + 1 ? writer->seen : 0;
+            writer->seen = 0;
+            writer->epoch = epoch;
+        }
+
+        if(sequenceNumber > writer->highest)
+        {
+            distance = sequenceNumber - writer->highest;
+            writer->seen = distance < EPROSIMA_DEDUP_STAGE_WINDOW ? (writer->seen << distance) | 1 : 1;
+            writer->previous = distance < EPROSIMA_DEDUP_STAGE_WINDOW ? writer->previous << distance : 0;
+            writer->highest = sequenceNumber;
+        }
+        else
+        {
+            distance = writer->highest - sequenceNumber;
+
+            if(distance >= EPROSIMA_DEDUP_STAGE_WINDOW)
+                result = DEDUP_OLD;
+            else if((writer->seen | writer->previous) & (1ULL << distance))
+                result = DEDUP_DUPLICATE;
+            else
+                writer->seen |= 1ULL << distance;
+        }
+    }
+
+    EPROSIMA_ATOMIC_STORE32(&writer->lock, 0);
+
+    return result;
+}
+
+/**
+ * \brief This function checks, without recording it, if a sequence number was received in the current or the
+ * previous epoch in a DATA of the writer for all the readers (readerId ENTITYID_UNKNOWN). A copy for one
+ * reader is then a duplicate, because that reader already received the DATA.
+ */
+static int isReceivedByAllReaders(struct DedupStage *stage, const unsigned char *key, unsigned long long sequenceNumber)
+{
+    unsigned char unknownKey[DEDUP_KEY_SIZE];
+    struct DedupWriter *writer = NULL;
+    unsigned long long epoch = eProsimaClock_getNanoseconds() / stage->epochNanoseconds, window = 0, distance = 0;
+    int received = 0;
+
+    memcpy(unknownKey, key, DEDUP_KEY_READERID_OFFSET);
+    memcpy(unknownKey + DEDUP_KEY_READERID_OFFSET, DEDUP_READERID_UNKNOWN, RTPS_SUBMESSAGE_BODY_ENTITYID_SIZE);
+    writer = &stage->writers[hashKey(unknownKey) & stage->writersMask];
+
+    while(!EPROSIMA_ATOMIC_CAS32(&writer->lock, 0, 1))
+        EPROSIMA_CPU_RELAX();
+
+    if(writer->used && memcmp(writer->key, unknownKey, DEDUP_KEY_SIZE) == 0 && sequenceNumber <= writer->highest &&
+            (distance = writer->highest - sequenceNumber) < EPROSIMA_DEDUP_STAGE_WINDOW)
+    {
+        // The bits of seen become the previous ones when the next epoch starts.
+        if(epoch == writer->epoch)
+            window = writer->seen | writer->previous;
+        else if(epoch == writer->epoch + 1)
+            window = writer->seen;
+
+        received = (window & (1ULL << distance)) != 0;
+    }
+
+    EPROSIMA_ATOMIC_STORE32(&writer->lock, 0);
+
+    return received;
+}
+
+static EPROSIMA_CHAIN_STAGE_RESULT DedupStage_receive(struct eProsima_ChainStage *self, struct eProsima_ChainReceiveContext *context)
+{
+    struct DedupStage *stage = (struct DedupStage*)self;
+    unsigned char *message = (unsigned char*)context->message->buffer.pointer;
+    unsigned char key[DEDUP_KEY_SIZE];
+    struct eProsima_RtpsReader reader;
+    struct eProsima_RtpsSubmessage submessage;
+    DEDUP_RESULT result = DEDUP_NEW;
+    unsigned long long sequenceNumber = 0;
+    unsigned char *body = NULL;
+    int littleEndian = 0, removed = 0, kept = 0, last = 0;
+
+    if(context->message->buffer.length < RTPS_HEADER_SIZE || memcmp(message, RTPS_HEADER_PROTOCOL, RTPS_HEADER_PROTOCOL_SIZE) != 0)
+        return EPROSIMA_CHAIN_STAGE_CONTINUE;
+
+    memcpy(key, message + RTPS_HEADER_GUIDPREFIX_OFFSET, RTPS_HEADER_GUIDPREFIX_SIZE);
+    eProsimaRtpsReader_init(&reader, &context->message->buffer, 1);
+
+    while(!last && eProsimaRtpsReader_nextSubmessage(&reader, &submessage) == 0)
+    {
+        body = message + submessage.offset + RTPS_SUBMESSAGE_HEADER_SIZE;
+
+        switch(submessage.kind)
+        {
+            case RTPS_SUBMESSAGE_INFO_SRC:
+                // The next submessages are from other participant.
+                if(submessage.length >= RTPS_SUBMESSAGE_INFOSRC_GUIDPREFIX_OFFSET + RTPS_HEADER_GUIDPREFIX_SIZE)
+                    memcpy(key, body + RTPS_SUBMESSAGE_INFOSRC_GUIDPREFIX_OFFSET, RTPS_HEADER_GUIDPREFIX_SIZE);
+                break;
+            case RTPS_SUBMESSAGE_PAD:
+            case RTPS_SUBMESSAGE_INFO_TS:
+            case RTPS_SUBMESSAGE_INFO_DST:
+            case RTPS_SUBMESSAGE_INFO_REPLY_IP4:
+            case RTPS_SUBMESSAGE_INFO_REPLY:
+                break;
+            // DATA_FRAG submessages fall in the default case. They are not deduplicated, because a fragment is only
+            // a duplicate of the same fragment of the sequence number.
+            case RTPS_SUBMESSAGE_DATA:
+                if(submessage.length < RTPS_SUBMESSAGE_BODY_SEQUENCENUMBER_OFFSET + RTPS_SUBMESSAGE_BODY_SEQUENCENUMBER_SIZE)
+                {
+                    kept = 1;
+                    break;
+                }
+
+                littleEndian = submessage.flags & RTPS_SUBMESSAGE_FLAG_ENDIANNESS;
+                memcpy(key + RTPS_HEADER_GUIDPREFIX_SIZE, body + RTPS_SUBMESSAGE_BODY_WRITERID_OFFSET, RTPS_SUBMESSAGE_BODY_ENTITYID_SIZE);
+                memcpy(key + DEDUP_KEY_READERID_OFFSET, body + RTPS_SUBMESSAGE_BODY_READERID_OFFSET, RTPS_SUBMESSAGE_BODY_ENTITYID_SIZE);
+                sequenceNumber = ((unsigned long long)readUInt32(body + RTPS_SUBMESSAGE_BODY_SEQUENCENUMBER_OFFSET, littleEndian) << 32) |
+                    readUInt32(body + RTPS_SUBMESSAGE_BODY_SEQUENCENUMBER_OFFSET + 4, littleEndian);
+
+                EPROSIMA_ATOMIC_ADD64(&stage->metrics.dataSubmessages, 1);
+                result = checkSequenceNumber(stage, key, sequenceNumber);
+
+                if(result == DEDUP_NEW && memcmp(key + DEDUP_KEY_READERID_OFFSET, DEDUP_READERID_UNKNOWN,
+                            RTPS_SUBMESSAGE_BODY_ENTITYID_SIZE) != 0 && isReceivedByAllReaders(stage, key, sequenceNumber))
+                    result = DEDUP_DUPLICATE;
+
+                switch(result)
+                {
+                    case DEDUP_DUPLICATE:
+                        EPROSIMA_ATOMIC_ADD64(&stage->metrics.duplicateSubmessages, 1);
+                        removed = 1;
+
+                        // The last submessage is cut. Other ones become a PAD of the same length.
+                        if(submessage.offset + RTPS_SUBMESSAGE_HEADER_SIZE + submessage.length >= (size_t)context->message->buffer.length)
+                        {
+                            context->message->buffer.length = (RTI_INT32)submessage.offset;
+                            last = 1;
+                        }
+                        else
+                        {
+                            message[submessage.offset] = RTPS_SUBMESSAGE_PAD;
+                            message[submessage.offset + 1] = (unsigned char)littleEndian;
+                        }
+                        break;
+                    case DEDUP_OLD:
+                        EPROSIMA_ATOMIC_ADD64(&stage->metrics.oldSubmessages, 1);
+                        // Fall through.
+                    default:
+                        kept = 1;
+                        break;
+                }
+                break;
+            default:
+                kept = 1;
+                break;
+        }
+    }
+
+    if(removed && !kept)
+    {
+        EPROSIMA_ATOMIC_ADD64(&stage->metrics.droppedMessages, 1);
+        return EPROSIMA_CHAIN_STAGE_DISCARD;
+    }
+
+    return EPROSIMA_CHAIN_STAGE_CONTINUE;
+}
+
+static void DedupStage_destroy(struct eProsima_ChainStage *self)
+{
+    struct DedupStage *stage = (struct DedupStage*)self;
+
+    if(stage->writers != NULL)
+        RTIOsapiHeap_freeArray(stage->writers);
+
+    RTIOsapiHeap_freeStructure(stage);
+}
+
+struct eProsima_ChainStage* eProsimaDedupStage_create(const struct eProsima_PropertyIndex *index, const char *prefix)
+{
+    const char* const METHOD_NAME = "eProsimaDedupStage_create";
+    struct DedupStage *stage = NULL;
+    unsigned int writers = 1;
+
+    if(index == NULL || prefix == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    RTIOsapiHeap_allocateStructure(&stage, struct DedupStage);
+
+    if(stage == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the stage\n", METHOD_NAME);
+        return NULL;
+    }
+
+    memset(stage, 0, sizeof(struct DedupStage));
+    stage->config.writers = 4096;
+    stage->config.duplicateIntervalUs = 10000;
+    parseTransportPropertiesFromIndex(index, prefix, DedupPropertyDescriptors,
+            sizeof(DedupPropertyDescriptors) / sizeof(DedupPropertyDescriptors[0]), &stage->config);
+
+    while(writers < (unsigned int)stage->config.writers)
+        writers *= 2;
+
+    RTIOsapiHeap_allocateArray(&stage->writers, writers, struct DedupWriter);
+
+    if(stage->writers == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the writers\n", METHOD_NAME);
+        RTIOsapiHeap_freeStructure(stage);
+        return NULL;
+    }
+
+    memset(stage->writers, 0, writers * sizeof(struct DedupWriter));
+    stage->writersMask = writers - 1;
+    stage->epochNanoseconds = (unsigned long long)stage->config.duplicateIntervalUs * 1000ULL;
+    stage->parent.receive = DedupStage_receive;
+    stage->parent.destroy = DedupStage_destroy;
+
+    return &stage->parent;
+}
+
+void eProsimaDedupStage_getMetrics(const struct eProsima_ChainStage *stage, struct eProsima_DedupStageMetrics *metrics)
+{
+    const struct DedupStage *dedupStage = (const struct DedupStage*)stage;
+
+    metrics->dataSubmessages = EPROSIMA_ATOMIC_LOAD64(&dedupStage->metrics.dataSubmessages);
+    metrics->duplicateSubmessages = EPROSIMA_ATOMIC_LOAD64(&dedupStage->metrics.duplicateSubmessages);
+    metrics->droppedMessages = EPROSIMA_ATOMIC_LOAD64(&dedupStage->metrics.droppedMessages);
+    metrics->oldSubmessages = EPROSIMA_ATOMIC_LOAD64(&dedupStage->metrics.oldSubmessages);
+    metrics->evictedWriters = EPROSIMA_ATOMIC_LOAD64(&dedupStage->metrics.evictedWriters);
+}
@@ -0,0 +1,73 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_CHAIN_DEDUPSTAGE_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_CHAIN_DEDUPSTAGE_H_
+
+#include "eProsima_c/config.h"
+#include "chainStage.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/// Sequence numbers remembered for each writer.
+#define EPROSIMA_DEDUP_STAGE_WINDOW 64
+
+/**
+ * \brief Metrics of a dedup stage. The duplicate rate is duplicateSubmessages / dataSubmessages.
+ */
+struct eProsima_DedupStageMetrics
+{
+    /// DATA submessages checked by the stage.
+    unsigned long long dataSubmessages;
+    /// DATA submessages that were already received and were removed.
+    unsigned long long duplicateSubmessages;
+    /// Messages dropped because all their submessages were duplicated.
+    unsigned long long droppedMessages;
+    /// DATA submessages older than the window of their writer. They are not removed.
+    unsigned long long oldSubmessages;
+    /// Writers that replaced other writer in the table.
+    unsigned long long evictedWriters;
+};
+
+/**
+ * \brief This function creates a stage that removes duplicated DATA submessages from the received messages.
+ * They arrive when several interfaces, or multicast and unicast, reach the participant. Sent messages are
+ * not modified.
+ *
+ * The stage remembers the last EPROSIMA_DEDUP_STAGE_WINDOW sequence numbers of each writer and reader pair
+ * in a table with one entry per hash of the pair, so every check takes constant time. A DATA for all the readers
+ * (readerId ENTITYID_UNKNOWN, i.e. multicast) reaches every reader, so a later copy of it for one reader (i.e.
+ * unicast) is also a duplicate. The opposite is not: a DATA for all the readers passes after a copy for one reader. Only the copies that
+ * arrive within duplicate_interval_us of the first one are duplicates: the time is split in epochs of that
+ * length and a sequence number is remembered during its epoch and the next one, so a copy is always removed
+ * until duplicate_interval_us has elapsed and always passes after twice that time. The retransmissions that a
+ * reader requests with an ACKNACK arrive later, so they reach the middleware. A writer that collides
+ * with other one replaces it and the history of the replaced one is lost; the stage never removes a
+ * submessage it didn't see before. A duplicated DATA is replaced by a PAD submessage, or cut when it is the
+ * last one, and a message without other submessages than INFO and PAD ones is dropped. DATA_FRAG submessages
+ * are not deduplicated: they always pass, and a message with one of them is never dropped.
+ *
+ * The properties use the prefix of the stage:
+ *     writers: Entries of the table. It is rounded up to a power of two, up to 65536. Default 4096.
+ *     duplicate_interval_us: Time during which the copies of a DATA are removed. It has to be shorter than the
+ *         time a reader takes to receive a retransmission. Default 10000.
+ *
+ * \param index Index of the properties of the chain. Cannot be NULL.
+ * \param prefix Prefix of the properties of the stage. Cannot be NULL.
+ * \return The new stage. In error case, NULL value is returned.
+ */
+struct eProsima_ChainStage* eProsimaDedupStage_create(const struct eProsima_PropertyIndex *index, const char *prefix);
+
+/**
+ * \brief This function reads the metrics of a dedup stage.
+ *
+ * \param stage A stage created by eProsimaDedupStage_create. Cannot be NULL.
+ * \param metrics Where the metrics are stored. Cannot be NULL.
+ */
+void eProsimaDedupStage_getMetrics(const struct eProsima_ChainStage *stage, struct eProsima_DedupStageMetrics *metrics);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_CHAIN_DEDUPSTAGE_H_
@@ -0,0 +1,384 @@
+#include "filterStage.h"
+#include "compressionStage.h"
+#include "../transportPropertyParser.h"
+#include "../../rtps/messageReader.h"
+#include "../../../sys/atomic.h"
+#include "../../../macros/snprintf.h"
+
+#include <osapi/osapi_heap.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define FILTER_STAGE_NAME_LENGTH 64
+
+struct FilterStageConfig
+{
+    char **allowSources;
+    int allowSourcesLength;
+    char **denySources;
+    int denySourcesLength;
+    char **localPrefixes;
+    int localPrefixesLength;
+    char **denyWriters;
+    int denyWritersLength;
+};
+
+static const struct eProsima_PropertyDescriptor FilterPropertyDescriptors[] =
+{
+    EPROSIMA_PROPERTY_STRING_LIST(struct FilterStageConfig, "allow_sources", allowSources, allowSourcesLength),
+    EPROSIMA_PROPERTY_STRING_LIST(struct FilterStageConfig, "deny_sources", denySources, denySourcesLength),
+    EPROSIMA_PROPERTY_STRING_LIST(struct FilterStageConfig, "local_prefixes", localPrefixes, localPrefixesLength),
+    EPROSIMA_PROPERTY_STRING_LIST(struct FilterStageConfig, "deny_writers", denyWriters, denyWritersLength)
+};
+
+/**
+ * \brief Set of keys of the same size. It is an open addressing table whose length is a power of two and
+ * at least twice the number of keys, so lookups of missing keys stop soon.
+ */
+struct FilterSet
+{
+    unsigned char *keys;
+    unsigned char *used;
+    unsigned int mask;
+    size_t keySize;
+    int length;
+};
+
+struct FilterStage
+{
+    /// It has to be the first field.
+    struct eProsima_ChainStage parent;
+    char name[FILTER_STAGE_NAME_LENGTH];
+    struct FilterStageConfig config;
+    struct FilterSet allowSources;
+    struct FilterSet denySources;
+    struct FilterSet localPrefixes;
+    struct FilterSet denyWriters;
+    struct eProsima_FilterStageMetrics metrics;
+};
+
+static unsigned int hashKey(const unsigned char *key, size_t keySize)
+{
+    unsigned int hash = 2166136261U;
+    size_t i = 0;
+
+    for(i = 0; i < keySize; ++i)
+        hash = (hash ^ key[i]) * 16777619U;
+
+    return hash;
+}
+
+static int containsKey(const struct FilterSet *set, const unsigned char *key)
+{
+    unsigned int slot = 0;
+
+    if(set->length == 0)
+        return 0;
+
+    for(slot = hashKey(key, set->keySize) & set->mask; set->used[slot]; slot = (slot + 1) & set->mask)
+    {
+        if(memcmp(set->keys + slot * set->keySize, key, set->keySize) == 0)
+            return 1;
+    }
+
+    return 0;
+}
+
+static int hexDigitValue(char character)
+{
+    if(character >= '0' && character <= '9')
+        return character - '0';
+    if(character >= 'a' && character <= 'f')
+        return character - 'a' + 10;
+    if(character >= 'A' && character <= 'F')
+        return character - 'A' + 10;
+
+    return -1;
+}
+
+/**
+ * \brief This function parses a key of hexadecimal digits, optionally with the prefix "0x" and separated by '.', ':' or '-'.
+ *
+ * \return 0 if the string has exactly the digits of the key. In error case -1 is returned.
+ */
+static int parseKey(const char *value, unsigned char *key, size_t keySize)
+{
+    size_t digits = 0;
+    int digit = 0;
+
+    if(value[0] == '0' && (value[1] == 'x' || value[1] == 'X'))
+        value += 2;
+
+    for(; *value != '\0'; ++value)
+    {
+        if(*value == '.' || *value == ':' || *value == '-')
+            continue;
+
+        if((digit = hexDigitValue(*value)) < 0 || digits == keySize * 2)
+            return -1;
+
+        if(digits % 2 == 0)
+            key[digits / 2] = (unsigned char)(digit << 4);
+        else
+            key[digits / 2] |= (unsigned char)digit;
+
+        ++digits;
+    }
+
+    return digits == keySize * 2 ? 0 : -1;
+}
+
+/**
+ * \brief This function builds a set from the strings of a list property.
+ *
+ * \return 0 if the set was built. In error case -1 is returned.
+ */
+static int buildSet(struct FilterStage *stage, const char *property, char **list, int listLength, size_t keySize, struct FilterSet *set)
+{
+    const char* const METHOD_NAME = "buildSet";
+    unsigned char key[RTPS_HEADER_GUIDPREFIX_SIZE];
+    unsigned int capacity = 2, slot = 0;
+    int i = 0;
+
+    set->keySize = keySize;
+
+    if(listLength == 0)
+        return 0;
+
+    while(capacity < (unsigned int)listLength * 2)
+        capacity *= 2;
+
+    RTIOsapiHeap_allocateArray(&set->keys, capacity * keySize, unsigned char);
+    RTIOsapiHeap_allocateArray(&set->used, capacity, unsigned char);
+
+    if(set->keys == NULL || set->used == NULL)
+    {
+        printf("ERROR<%s>: %s: Cannot allocate memory for %s\n", METHOD_NAME, stage->name, property);
+        return -1;
+    }
+
+    memset(set->used, 0, capacity);
+    set->mask = capacity - 1;
+
+    for(i = 0; i < listLength; ++i)
+    {
+        if(parseKey(list[i], key, keySize) != 0)
+        {
+            printf("ERROR<%s>: %s: Bad value %s in %s\n", METHOD_NAME, stage->name, list[i], property);
+            return -1;
+        }
+
+        if(containsKey(set, key))
+            continue;
+
+        for(slot = hashKey(key, keySize) & set->mask; set->used[slot]; slot = (slot + 1) & set->mask)
+            ;
+
+        memcpy(set->keys + slot * keySize, key, keySize);
+        set->used[slot] = 1;
+        ++set->length;
+    }
+
+    return 0;
+}
+
+static void freeSet(struct FilterSet *set)
+{
+    if(set->keys != NULL)
+        RTIOsapiHeap_freeArray(set->keys);
+    if(set->used != NULL)
+        RTIOsapiHeap_freeArray(set->used);
+}
+
+/**
+ * \brief This function checks the submessages of a message. The DATA and DATA_FRAG submessages of denied writers
+ * become PAD submessages of the same length, or are cut when they are the last one.
+ *
+ * \return EPROSIMA_CHAIN_STAGE_DISCARD if the message is not needed. Otherwise EPROSIMA_CHAIN_STAGE_CONTINUE.
+ */
+static EPROSIMA_CHAIN_STAGE_RESULT filterSubmessages(struct FilterStage *stage, struct eProsima_RtpsReader *reader,
+        NDDS_Transport_Message_t *receivedMessage)
+{
+    unsigned char prefix[RTPS_HEADER_GUIDPREFIX_SIZE], writerId[RTPS_SUBMESSAGE_BODY_ENTITYID_SIZE];
+    static const unsigned char unknownPrefix[RTPS_HEADER_GUIDPREFIX_SIZE] = {0};
+    unsigned char *message = (unsigned char*)receivedMessage->buffer.pointer;
+    struct eProsima_RtpsSubmessage submessage;
+    // Until the first INFO_DST, the submessages are for all the participants.
+    int destinationIsLocal = 1, hasLocalSubmessages = 0;
+    int removed = 0, kept = 0, last = 0;
+
+    while(!last && eProsimaRtpsReader_nextSubmessage(reader, &submessage) == 0)
+    {
+        switch(submessage.kind)
+        {
+            case RTPS_SUBMESSAGE_INFO_DST:
+                if(eProsimaRtpsReader_read(reader, submessage.offset + RTPS_SUBMESSAGE_HEADER_SIZE, prefix, sizeof(prefix)) == 0)
+                {
+                    destinationIsLocal = memcmp(prefix, unknownPrefix, sizeof(prefix)) == 0 ||
+                        containsKey(&stage->localPrefixes, prefix);
+                }
+                break;
+            case RTPS_SUBMESSAGE_PAD:
+            case RTPS_SUBMESSAGE_INFO_TS:
+            case RTPS_SUBMESSAGE_INFO_SRC:
+            case RTPS_SUBMESSAGE_INFO_REPLY_IP4:
+            case RTPS_SUBMESSAGE_INFO_REPLY:
+                break;
+            case RTPS_SUBMESSAGE_DATA:
+            case RTPS_SUBMESSAGE_DATA_FRAG:
+                if(eProsimaRtpsReader_read(reader, submessage.offset + RTPS_SUBMESSAGE_HEADER_SIZE + RTPS_SUBMESSAGE_BODY_WRITERID_OFFSET,
+                            writerId, sizeof(writerId)) == 0 && containsKey(&stage->denyWriters, writerId))
+                {
+                    EPROSIMA_ATOMIC_ADD64(&stage->metrics.writerSubmessages, 1);
+                    removed = 1;
+
+                    // The last submessage is cut. Other ones become a PAD of the same length.
+                    if(submessage.offset + RTPS_SUBMESSAGE_HEADER_SIZE + submessage.length >= (size_t)receivedMessage->buffer.length)
+                    {
+                        receivedMessage->buffer.length = (RTI_INT32)submessage.offset;
+                        last = 1;
+                    }
+                    else
+                    {
+                        message[submessage.offset] = RTPS_SUBMESSAGE_PAD;
+                        message[submessage.offset + 1] = (unsigned char)(submessage.flags & RTPS_SUBMESSAGE_FLAG_ENDIANNESS);
+                    }
+                    break;
+                }
+                // Fall through.
+            default:
+                kept = 1;
+                hasLocalSubmessages |= destinationIsLocal;
+                break;
+        }
+    }
+
+    // The HEARTBEAT, GAP and other submessages of allowed writers and readers are kept.
+    if(removed && !kept)
+    {
+        EPROSIMA_ATOMIC_ADD64(&stage->metrics.writerDrops, 1);
+        return EPROSIMA_CHAIN_STAGE_DISCARD;
+    }
+
+    if(stage->localPrefixes.length > 0 && !hasLocalSubmessages)
+    {
+        EPROSIMA_ATOMIC_ADD64(&stage->metrics.destinationDrops, 1);
+        return EPROSIMA_CHAIN_STAGE_DISCARD;
+    }
+
+    return EPROSIMA_CHAIN_STAGE_CONTINUE;
+}
+
+static EPROSIMA_CHAIN_STAGE_RESULT FilterStage_receive(struct eProsima_ChainStage *self, struct eProsima_ChainReceiveContext *context)
+{
+    struct FilterStage *stage = (struct FilterStage*)self;
+    const unsigned char *message = (const unsigned char*)context->message->buffer.pointer;
+    struct eProsima_RtpsReader reader;
+    const unsigned char *prefix = NULL;
+    int isRtps = 0;
+
+    if(context->message->buffer.length < RTPS_HEADER_SIZE)
+        return EPROSIMA_CHAIN_STAGE_CONTINUE;
+
+    isRtps = memcmp(message, RTPS_HEADER_PROTOCOL, RTPS_HEADER_PROTOCOL_SIZE) == 0;
+
+    if(!isRtps && memcmp(message, EPROSIMA_COMPRESSION_PROTOCOL, RTPS_HEADER_PROTOCOL_SIZE) != 0)
+        return EPROSIMA_CHAIN_STAGE_CONTINUE;
+
+    EPROSIMA_ATOMIC_ADD64(&stage->metrics.receivedMessages, 1);
+
+    prefix = message + RTPS_HEADER_GUIDPREFIX_OFFSET;
+
+    if(containsKey(&stage->denySources, prefix) || (stage->allowSources.length > 0 && !containsKey(&stage->allowSources, prefix)))
+    {
+        EPROSIMA_ATOMIC_ADD64(&stage->metrics.sourceDrops, 1);
+        return EPROSIMA_CHAIN_STAGE_DISCARD;
+    }
+
+    // The submessages of compressed messages cannot be read.
+    if(!isRtps || (stage->localPrefixes.length == 0 && stage->denyWriters.length == 0))
+        return EPROSIMA_CHAIN_STAGE_CONTINUE;
+
+    eProsimaRtpsReader_init(&reader, &context->message->buffer, 1);
+
+    return filterSubmessages(stage, &reader, context->message);
+}
+
+static void deleteFilterStage(struct FilterStage *stage)
+{
+    freeSet(&stage->allowSources);
+    freeSet(&stage->denySources);
+    freeSet(&stage->localPrefixes);
+    freeSet(&stage->denyWriters);
+
+    if(stage->config.allowSources != NULL)
+        RTIOsapiHeap_freeArray(stage->config.allowSources);
+    if(stage->config.denySources != NULL)
+        RTIOsapiHeap_freeArray(stage->config.denySources);
+    if(stage->config.localPrefixes != NULL)
+        RTIOsapiHeap_freeArray(stage->config.localPrefixes);
+    if(stage->config.denyWriters != NULL)
+        RTIOsapiHeap_freeArray(stage->config.denyWriters);
+
+    RTIOsapiHeap_freeStructure(stage);
+}
+
+static void FilterStage_destroy(struct eProsima_ChainStage *self)
+{
+    deleteFilterStage((struct FilterStage*)self);
+}
+
+struct eProsima_ChainStage* eProsimaFilterStage_create(const struct eProsima_PropertyIndex *index, const char *prefix)
+{
+    const char* const METHOD_NAME = "eProsimaFilterStage_create";
+    struct FilterStage *stage = NULL;
+
+    if(index == NULL || prefix == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    RTIOsapiHeap_allocateStructure(&stage, struct FilterStage);
+
+    if(stage == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the stage\n", METHOD_NAME);
+        return NULL;
+    }
+
+    memset(stage, 0, sizeof(struct FilterStage));
+    SNPRINTF(stage->name, sizeof(stage->name), "%s", prefix);
+    parseTransportPropertiesFromIndex(index, prefix, FilterPropertyDescriptors,
+            sizeof(FilterPropertyDescriptors) / sizeof(FilterPropertyDescriptors[0]), &stage->config);
+
+    if(buildSet(stage, "allow_sources", stage->config.allowSources, stage->config.allowSourcesLength,
+                RTPS_HEADER_GUIDPREFIX_SIZE, &stage->allowSources) != 0 ||
+            buildSet(stage, "deny_sources", stage->config.denySources, stage->config.denySourcesLength,
+                RTPS_HEADER_GUIDPREFIX_SIZE, &stage->denySources) != 0 ||
+            buildSet(stage, "local_prefixes", stage->config.localPrefixes, stage->config.localPrefixesLength,
+                RTPS_HEADER_GUIDPREFIX_SIZE, &stage->localPrefixes) != 0 ||
+            buildSet(stage, "deny_writers", stage->config.denyWriters, stage->config.denyWritersLength,
+                RTPS_SUBMESSAGE_BODY_ENTITYID_SIZE, &stage->denyWriters) != 0)
+    {
+        deleteFilterStage(stage);
+        return NULL;
+    }
+
+    stage->parent.receive = FilterStage_receive;
+    stage->parent.destroy = FilterStage_destroy;
+
+    return &stage->parent;
+}
+
+void eProsimaFilterStage_getMetrics(const struct eProsima_ChainStage *stage, struct eProsima_FilterStageMetrics *metrics)
+{
+    const struct FilterStage *filterStage = (const struct FilterStage*)stage;
+
+    metrics->receivedMessages = EPROSIMA_ATOMIC_LOAD64(&filterStage->metrics.receivedMessages);
+    metrics->sourceDrops = EPROSIMA_ATOMIC_LOAD64(&filterStage->metrics.sourceDrops);
+    metrics->destinationDrops = EPROSIMA_ATOMIC_LOAD64(&filterStage->metrics.destinationDrops);
+    metrics->writerDrops = EPROSIMA_ATOMIC_LOAD64(&filterStage->metrics.writerDrops);
+    metrics->writerSubmessages = EPROSIMA_ATOMIC_LOAD64(&filterStage->metrics.writerSubmessages);
+}
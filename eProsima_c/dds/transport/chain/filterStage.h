@@ -0,0 +1,67 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_CHAIN_FILTERSTAGE_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_CHAIN_FILTERSTAGE_H_
+
+#include "eProsima_c/config.h"
+#include "chainStage.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/**
+ * \brief Metrics of a filter stage.
+ */
+struct eProsima_FilterStageMetrics
+{
+    /// Received RTPS messages checked by the stage.
+    unsigned long long receivedMessages;
+    /// Messages dropped by the GUID prefix of their header.
+    unsigned long long sourceDrops;
+    /// Messages whose submessages were all for other participants.
+    unsigned long long destinationDrops;
+    /// Messages whose submessages, other than INFO and PAD ones, were all DATA or DATA_FRAG of denied writers.
+    unsigned long long writerDrops;
+    /// DATA and DATA_FRAG submessages of denied writers, including the ones of dropped messages.
+    unsigned long long writerSubmessages;
+};
+
+/**
+ * \brief This function creates a stage that drops received messages that the participant doesn't need, so
+ * they don't reach the middleware. It is useful on shared multicast groups. Sent messages are not filtered.
+ *
+ * The stage only reads the RTPS header and the submessage headers. The DATA and DATA_FRAG submessages of
+ * writers in deny_writers are replaced in place with PAD submessages of the same length, or cut when they are
+ * the last one, so the HEARTBEAT, GAP and ACKNACK submessages sent with them still arrive. A message is dropped when:
+ *     - The GUID prefix of its header is in deny_sources, or allow_sources is not empty and doesn't have it.
+ *     - Every submessage, other than INFO and PAD ones, was removed because it is from a denied writer.
+ *     - local_prefixes is not empty and every remaining submessage is after an INFO_DST of other participant.
+ *       Submessages before the first INFO_DST, or after an INFO_DST without prefix, are for all participants.
+ * The header is also checked in messages compressed by a compression stage, so the stage can be after it in
+ * the chain and drop them before they are decompressed.
+ *
+ * The lists are compiled in hash sets when the stage is created. The properties use the prefix of the stage:
+ *     allow_sources, deny_sources: GUID prefixes of remote participants, 24 hexadecimal digits each.
+ *         The digits can be separated by '.', ':' or '-'. Default empty.
+ *     local_prefixes: GUID prefixes of the local participants. Default empty (INFO_DST is not checked).
+ *     deny_writers: Entity IDs of writers, 8 hexadecimal digits each (i.e. "000001c2"). Default empty.
+ *
+ * \param index Index of the properties of the chain. Cannot be NULL.
+ * \param prefix Prefix of the properties of the stage. Cannot be NULL.
+ * \return The new stage. In error case, NULL value is returned.
+ */
+struct eProsima_ChainStage* eProsimaFilterStage_create(const struct eProsima_PropertyIndex *index, const char *prefix);
+
+/**
+ * \brief This function reads the metrics of a filter stage.
+ *
+ * \param stage A stage created by eProsimaFilterStage_create. Cannot be NULL.
+ * \param metrics Where the metrics are stored. Cannot be NULL.
+ */
+void eProsimaFilterStage_getMetrics(const struct eProsima_ChainStage *stage, struct eProsima_FilterStageMetrics *metrics);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_CHAIN_FILTERSTAGE_H_
@@ -0,0 +1,717 @@
+#include "priorityStage.h"
+#include "../transportPropertyParser.h"
+#include "../../rtps/messageReader.h"
+#include "../../../sys/atomic.h"
+#include "../../../macros/snprintf.h"
+
+#include <osapi/osapi_heap.h>
+#include <osapi/osapi_semaphore.h>
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(RTI_WIN32)
+#include <Windows.h>
+#elif defined(RTI_UNIX) || defined(RTI_LINUX)
+#include <pthread.h>
+#define PRIORITY_STAGE_PTHREAD
+#endif
+
+#define PRIORITY_STAGE_NAME_LENGTH 64
+
+/// Flows of each level. Other priorities share the last flow.
+#define PRIORITY_STAGE_FLOWS_MAX 16
+
+#define PRIORITY_STAGE_WEIGHT_MAX 16
+
+/// Queued messages are allocated with at least this capacity, so they can be reused.
+#define PRIORITY_STAGE_MESSAGE_CAPACITY_MIN 1024
+
+struct PriorityStageConfig
+{
+    char **priorityLevels;
+    int priorityLevelsLength;
+    int controlLevel;
+    int queueSize;
+    int quantum;
+    int starvationLimit;
+    int drainLimit;
+};
+
+static const struct eProsima_PropertyDescriptor PriorityPropertyDescriptors[] =
+{
+    EPROSIMA_PROPERTY_STRING_LIST(struct PriorityStageConfig, "priority_levels", priorityLevels, priorityLevelsLength),
+    EPROSIMA_PROPERTY_INT(struct PriorityStageConfig, "control_level", controlLevel, 0, 1, 1),
+    EPROSIMA_PROPERTY_INT(struct PriorityStageConfig, "queue_size", queueSize, 1, INT_MAX, 256),
+    EPROSIMA_PROPERTY_INT(struct PriorityStageConfig, "quantum", quantum, 1, INT_MAX / PRIORITY_STAGE_WEIGHT_MAX, 8192),
+    EPROSIMA_PROPERTY_INT(struct PriorityStageConfig, "starvation_limit", starvationLimit, 1, INT_MAX, 16),
+    EPROSIMA_PROPERTY_INT(struct PriorityStageConfig, "drain_limit", drainLimit, 0, INT_MAX, 16)
+};
+
+/// Submessages of the control level, unless the message also has data.
+static const enum RTPS_SubmessageKind controlKinds[] = {RTPS_SUBMESSAGE_HEARTBEAT, RTPS_SUBMESSAGE_ACKNACK,
+    RTPS_SUBMESSAGE_NACK_FRAG, RTPS_SUBMESSAGE_HEARTBEAT_FRAG};
+
+static const enum RTPS_SubmessageKind dataKinds[] = {RTPS_SUBMESSAGE_DATA, RTPS_SUBMESSAGE_DATA_FRAG};
+
+/**
+ * \brief Copy of a message that waits to be sent. The data follows the structure in the same allocation.
+ */
+struct PriorityMessage
+{
+    struct PriorityMessage *next;
+    NDDS_Transport_SendResource_t sendResource;
+    NDDS_Transport_Address_t destAddress;
+    NDDS_Transport_Port_t destPort;
+    RTI_INT32 transportPriority;
+    RTI_INT32 length;
+    RTI_INT32 capacity;
+    char *data;
+};
+
+struct PriorityFlow
+{
+    RTI_INT32 transportPriority;
+    long long weight;
+    /// Bytes the flow can send in the current round.
+    long long deficit;
+    struct PriorityMessage *head;
+    struct PriorityMessage *tail;
+};
+
+struct PriorityLevel
+{
+    /// Minimum transport priority. It is not used by the last level and the control level.
+    RTI_INT32 minPriority;
+    struct PriorityFlow flows[PRIORITY_STAGE_FLOWS_MAX];
+    int flowsLength;
+    /// Flow whose round is in progress.
+    int currentFlow;
+    int queued;
+    /// Times the level was passed over while it had messages.
+    int passedOver;
+};
+
+struct PriorityStage
+{
+    /// It has to be the first field.
+    struct eProsima_ChainStage parent;
+    char name[PRIORITY_STAGE_NAME_LENGTH];
+    struct PriorityStageConfig config;
+    struct PriorityLevel levels[EPROSIMA_PRIORITY_STAGE_LEVELS_MAX];
+    int levelsLength;
+
+    struct RTIOsapiSemaphore *mutex;
+    /// Given when a message leaves a queue and some send waits for space.
+    struct RTIOsapiSemaphore *space;
+    int waitingSends;
+    /// A thread is sending the queued messages.
+    int sending;
+    int queued;
+    /// Send resource of the message that is being sent from the queue.
+    NDDS_Transport_SendResource_t inFlight;
+    int inFlightValid;
+    /// Given when the message that was being sent from the queue is sent and some destroy waits for it.
+    struct RTIOsapiSemaphore *sent;
+    int waitingDestroys;
+    struct PriorityMessage *freeMessages;
+
+    /// Given when the queued messages are handed to the thread of the stage.
+    struct RTIOsapiSemaphore *pending;
+    int running;
+    int threadCreated;
+#if defined(RTI_WIN32)
+    HANDLE thread;
+#elif defined(PRIORITY_STAGE_PTHREAD)
+    pthread_t thread;
+#endif
+
+    /// Protected by the mutex.
+    struct eProsima_PriorityStageMetrics metrics;
+};
+
+static void lockStage(struct PriorityStage *stage)
+{
+    RTIOsapiSemaphore_take(stage->mutex, NULL);
+}
+
+static void unlockStage(struct PriorityStage *stage)
+{
+    RTIOsapiSemaphore_give(stage->mutex);
+}
+
+static int classifyMessage(struct PriorityStage *stage, struct eProsima_ChainSendContext *context)
+{
+    struct eProsima_RtpsReader reader;
+    int level = 0;
+
+    if(stage->config.controlLevel)
+    {
+        eProsimaRtpsReader_init(&reader, context->buffers, context->bufferCount);
+
+        if(eProsimaRtpsReader_isRtps(&reader) &&
+                eProsimaRtpsReader_containsSubmessage(&reader, controlKinds, sizeof(controlKinds) / sizeof(controlKinds[0])) &&
+                !eProsimaRtpsReader_containsSubmessage(&reader, dataKinds, sizeof(dataKinds) / sizeof(dataKinds[0])))
+            return 0;
+
+        level = 1;
+    }
+
+    while(level < stage->levelsLength - 1 && context->transportPriority < stage->levels[level].minPriority)
+        ++level;
+
+    return level;
+}
+
+static struct PriorityFlow* findFlow(struct PriorityStage *stage, struct PriorityLevel *level, RTI_INT32 transportPriority)
+{
+    struct PriorityFlow *flow = NULL;
+    long long floor = 0;
+    int i = 0;
+
+    for(i = 0; i < level->flowsLength; ++i)
+    {
+        if(level->flows[i].transportPriority == transportPriority)
+            return &level->flows[i];
+    }
+
+    // Empty flows are reused by other priorities.
+    for(i = 0; i < level->flowsLength && level->flows[i].head != NULL; ++i)
+        ;
+
+    if(i == PRIORITY_STAGE_FLOWS_MAX)
+        return &level->flows[PRIORITY_STAGE_FLOWS_MAX - 1];
+
+    if(i == level->flowsLength)
+        ++level->flowsLength;
+
+    // The last level and the control level have no minimum.
+    if(level != &stage->levels[stage->levelsLength - 1] && (level != &stage->levels[0] || !stage->config.controlLevel))
+        floor = level->minPriority;
+
+    flow = &level->flows[i];
+    flow->transportPriority = transportPriority;
+    flow->weight = 1 + (long long)transportPriority - floor;
+
+    if(flow->weight < 1)
+        flow->weight = 1;
+    else if(flow->weight > PRIORITY_STAGE_WEIGHT_MAX)
+        flow->weight = PRIORITY_STAGE_WEIGHT_MAX;
+
+    return flow;
+}
+
+/**
+ * \brief This function takes the next message of a level with deficit round robin.
+ */
+static struct PriorityMessage* dequeueFromLevel(struct PriorityStage *stage, struct PriorityLevel *level)
+{
+    struct PriorityFlow *flow = NULL;
+    struct PriorityMessage *message = NULL;
+
+    for(;;)
+    {
+        flow = &level->flows[level->currentFlow];
+
+        if(flow->head != NULL && flow->deficit >= flow->head->length)
+            break;
+
+        if(flow->head == NULL)
+            flow->deficit = 0;
+
+        level->currentFlow = (level->currentFlow + 1) % level->flowsLength;
+        flow = &level->flows[level->currentFlow];
+
+        if(flow->head != NULL)
+            flow->deficit += (long long)stage->config.quantum * flow->weight;
+    }
+
+    message = flow->head;
+    flow->head = message->next;
+    flow->deficit -= message->length;
+
+    if(flow->head == NULL)
+    {
+        flow->tail = NULL;
+        flow->deficit = 0;
+    }
+
+    --level->queued;
+    --stage->queued;
+
+    return message;
+}
+
+static struct PriorityMessage* dequeueMessage(struct PriorityStage *stage)
+{
+    int chosen = -1, first = -1, i = 0;
+
+    for(i = 0; i < stage->levelsLength; ++i)
+    {
+        if(stage->levels[i].queued > 0)
+        {
+            if(first < 0)
+                first = i;
+
+            if(chosen < 0 && stage->levels[i].passedOver >= stage->config.starvationLimit)
+                chosen = i;
+        }
+    }
+
+    if(first < 0)
+        return NULL;
+
+    if(chosen < 0)
+        chosen = first;
+    else if(chosen != first)
+        ++stage->metrics.starvationPromotions;
+
+    for(i = chosen + 1; i < stage->levelsLength; ++i)
+    {
+        if(stage->levels[i].queued > 0)
+            ++stage->levels[i].passedOver;
+    }
+
+    stage->levels[chosen].passedOver = 0;
+    ++stage->metrics.sentMessages[chosen];
+
+    return dequeueFromLevel(stage, &stage->levels[chosen]);
+}
+
+/**
+ * \brief This function sends the queued messages until the queues are empty or limit messages were sent. It is
+ * called with the mutex taken by the thread that set the field sending, and it releases the mutex while each
+ * message is sent. If messages remain, the field sending is passed to the thread of the stage.
+ *
+ * \param limit Maximum number of messages. If it is negative, there is no limit.
+ */
+static void sendQueuedMessages(struct PriorityStage *stage, int limit)
+{
+    struct PriorityMessage *message = NULL;
+    NDDS_Transport_Buffer_t buffer;
+    RTI_INT32 sent = RTI_FALSE;
+
+    for(; limit != 0 && (message = dequeueMessage(stage)) != NULL; --limit)
+    {
+        stage->inFlight = message->sendResource;
+        stage->inFlightValid = 1;
+
+        if(stage->waitingSends > 0)
+            RTIOsapiSemaphore_give(stage->space);
+
+        unlockStage(stage);
+
+        buffer.pointer = message->data;
+        buffer.length = message->length;
+        sent = eProsimaChainStage_sendNext(&stage->parent, message->sendResource, &message->destAddress,
+                message->destPort, message->transportPriority, &buffer, 1);
+
+        lockStage(stage);
+        stage->inFlightValid = 0;
+
+        if(stage->waitingDestroys > 0)
+            RTIOsapiSemaphore_give(stage->sent);
+
+        if(!sent)
+            ++stage->metrics.failedMessages;
+
+        message->next = stage->freeMessages;
+        stage->freeMessages = message;
+    }
+
+    if(stage->queued > 0)
+        RTIOsapiSemaphore_give(stage->pending);
+    else
+        stage->sending = 0;
+}
+
+static void runThread(struct PriorityStage *stage)
+{
+    for(;;)
+    {
+        RTIOsapiSemaphore_take(stage->pending, NULL);
+
+        if(!EPROSIMA_ATOMIC_LOAD32(&stage->running))
+            break;
+
+        // The thread that gave the semaphore left the field sending set.
+        lockStage(stage);
+        sendQueuedMessages(stage, -1);
+        unlockStage(stage);
+    }
+}
+
+#if defined(RTI_WIN32)
+static DWORD WINAPI priorityThreadFunction(LPVOID arg)
+{
+    runThread((struct PriorityStage*)arg);
+    return 0;
+}
+#elif defined(PRIORITY_STAGE_PTHREAD)
+static void* priorityThreadFunction(void *arg)
+{
+    runThread((struct PriorityStage*)arg);
+    return NULL;
+}
+#endif
+
+/**
+ * \brief This function copies a message. It is called without the mutex and the message was taken from the
+ * free list, so it can be NULL.
+ */
+static struct PriorityMessage* copyMessage(struct PriorityMessage *message, struct eProsima_ChainSendContext *context)
+{
+    size_t dataOffset = (sizeof(struct PriorityMessage) + 7) & ~(size_t)7;
+    RTI_INT32 length = 0, capacity = 0;
+    char *memory = NULL;
+    int i = 0;
+
+    for(i = 0; i < context->bufferCount; ++i)
+        length += context->buffers[i].length;
+
+    if(message == NULL || message->capacity < length)
+    {
+        if(message != NULL)
+            RTIOsapiHeap_freeArray((char*)message);
+
+        capacity = length > PRIORITY_STAGE_MESSAGE_CAPACITY_MIN ? length : PRIORITY_STAGE_MESSAGE_CAPACITY_MIN;
+        RTIOsapiHeap_allocateArray(&memory, dataOffset + capacity, char);
+
+        if(memory == NULL)
+            return NULL;
+
+        message = (struct PriorityMessage*)memory;
+        message->capacity = capacity;
+        message->data = memory + dataOffset;
+    }
+
+    message->next = NULL;
+    message->sendResource = context->sendResource;
+    message->destAddress = *context->destAddress;
+    message->destPort = context->destPort;
+    message->transportPriority = context->transportPriority;
+    message->length = 0;
+
+    for(i = 0; i < context->bufferCount; ++i)
+    {
+        memcpy(message->data + message->length, context->buffers[i].pointer, context->buffers[i].length);
+        message->length += context->buffers[i].length;
+    }
+
+    return message;
+}
+
+static EPROSIMA_CHAIN_STAGE_RESULT PriorityStage_send(struct eProsima_ChainStage *self, struct eProsima_ChainSendContext *context)
+{
+    struct PriorityStage *stage = (struct PriorityStage*)self;
+    struct PriorityLevel *level = &stage->levels[classifyMessage(stage, context)];
+    struct PriorityFlow *flow = NULL;
+    struct PriorityMessage *message = NULL;
+    RTI_INT32 sent = RTI_FALSE;
+
+    lockStage(stage);
+
+    // Nothing is being sent, so the message goes without copying it.
+    if(!stage->sending)
+    {
+        stage->sending = 1;
+        unlockStage(stage);
+
+        sent = eProsimaChainStage_sendNext(self, context->sendResource, context->destAddress, context->destPort,
+                context->transportPriority, context->buffers, context->bufferCount);
+
+        lockStage(stage);
+        ++stage->metrics.sentMessages[level - stage->levels];
+        sendQueuedMessages(stage, stage->config.drainLimit);
+        unlockStage(stage);
+
+        return sent ? EPROSIMA_CHAIN_STAGE_DISCARD : EPROSIMA_CHAIN_STAGE_ERROR;
+    }
+
+    if(level->queued >= stage->config.queueSize)
+    {
+        ++stage->metrics.blockedSends;
+
+        // The thread that is sending empties the queues before it stops, so the space will come.
+        while(stage->sending && level->queued >= stage->config.queueSize)
+        {
+            ++stage->waitingSends;
+            unlockStage(stage);
+            RTIOsapiSemaphore_take(stage->space, NULL);
+            lockStage(stage);
+            --stage->waitingSends;
+        }
+
+        // Other waiting send may be waiting for the same semaphore.
+        if(stage->waitingSends > 0)
+            RTIOsapiSemaphore_give(stage->space);
+    }
+
+    message = stage->freeMessages;
+
+    if(message != NULL)
+        stage->freeMessages = message->next;
+
+    unlockStage(stage);
+
+    message = copyMessage(message, context);
+
+    if(message == NULL)
+        return EPROSIMA_CHAIN_STAGE_ERROR;
+
+    lockStage(stage);
+
+    flow = findFlow(stage, level, context->transportPriority);
+
+    if(flow->tail != NULL)
+        flow->tail->next = message;
+    else
+        flow->head = message;
+
+    flow->tail = message;
+    ++level->queued;
+    ++stage->queued;
+    ++stage->metrics.queuedMessages;
+
+    // The sending thread could finish while the message was copied.
+    if(!stage->sending)
+    {
+        stage->sending = 1;
+        sendQueuedMessages(stage, stage->config.drainLimit);
+    }
+
+    unlockStage(stage);
+
+    return EPROSIMA_CHAIN_STAGE_DISCARD;
+}
+
+static void PriorityStage_destroySendResource(struct eProsima_ChainStage *self, NDDS_Transport_SendResource_t sendResource)
+{
+    struct PriorityStage *stage = (struct PriorityStage*)self;
+    struct PriorityMessage **link = NULL, *message = NULL;
+    struct PriorityFlow *flow = NULL;
+    int i = 0, j = 0;
+
+    lockStage(stage);
+
+    for(i = 0; i < stage->levelsLength; ++i)
+    {
+        for(j = 0; j < stage->levels[i].flowsLength; ++j)
+        {
+            flow = &stage->levels[i].flows[j];
+            flow->tail = NULL;
+            link = &flow->head;
+
+            while((message = *link) != NULL)
+            {
+                if(message->sendResource == sendResource)
+                {
+                    *link = message->next;
+                    message->next = stage->freeMessages;
+                    stage->freeMessages = message;
+                    --stage->levels[i].queued;
+                    --stage->queued;
+                    ++stage->metrics.failedMessages;
+                }
+                else
+                {
+                    flow->tail = message;
+                    link = &message->next;
+                }
+            }
+        }
+    }
+
+    // The message that is being sent uses the resource until the send returns.
+    while(stage->inFlightValid && stage->inFlight == sendResource)
+    {
+        ++stage->waitingDestroys;
+        unlockStage(stage);
+        RTIOsapiSemaphore_take(stage->sent, NULL);
+        lockStage(stage);
+        --stage->waitingDestroys;
+    }
+
+    // Other destroy may be waiting for the same semaphore.
+    if(stage->waitingDestroys > 0)
+        RTIOsapiSemaphore_give(stage->sent);
+
+    unlockStage(stage);
+}
+
+static void deletePriorityStage(struct PriorityStage *stage)
+{
+    struct PriorityMessage *message = NULL;
+    int i = 0, j = 0;
+
+    if(stage->threadCreated)
+    {
+        EPROSIMA_ATOMIC_STORE32(&stage->running, 0);
+        RTIOsapiSemaphore_give(stage->pending);
+#if defined(RTI_WIN32)
+        WaitForSingleObject(stage->thread, INFINITE);
+        CloseHandle(stage->thread);
+#elif defined(PRIORITY_STAGE_PTHREAD)
+        pthread_join(stage->thread, NULL);
+#endif
+    }
+
+    for(i = 0; i < stage->levelsLength; ++i)
+    {
+        for(j = 0; j < stage->levels[i].flowsLength; ++j)
+        {
+            while((message = stage->levels[i].flows[j].head) != NULL)
+            {
+                stage->levels[i].flows[j].head = message->next;
+                RTIOsapiHeap_freeArray((char*)message);
+            }
+        }
+    }
+
+    while((message = stage->freeMessages) != NULL)
+    {
+        stage->freeMessages = message->next;
+        RTIOsapiHeap_freeArray((char*)message);
+    }
+
+    if(stage->pending != NULL)
+        RTIOsapiSemaphore_delete(stage->pending);
+    if(stage->sent != NULL)
+        RTIOsapiSemaphore_delete(stage->sent);
+    if(stage->space != NULL)
+        RTIOsapiSemaphore_delete(stage->space);
+
+    if(stage->mutex != NULL)
+        RTIOsapiSemaphore_delete(stage->mutex);
+
+    if(stage->config.priorityLevels != NULL)
+        RTIOsapiHeap_freeArray(stage->config.priorityLevels);
+
+    RTIOsapiHeap_freeStructure(stage);
+}
+
+static void PriorityStage_destroy(struct eProsima_ChainStage *self)
+{
+    deletePriorityStage((struct PriorityStage*)self);
+}
+
+static int startThread(struct PriorityStage *stage)
+{
+    stage->running = 1;
+
+#if defined(RTI_WIN32)
+    stage->thread = CreateThread(NULL, 0, priorityThreadFunction, stage, 0, NULL);
+    stage->threadCreated = stage->thread != NULL;
+#elif defined(PRIORITY_STAGE_PTHREAD)
+    stage->threadCreated = pthread_create(&stage->thread, NULL, priorityThreadFunction, stage) == 0;
+#endif
+
+    return stage->threadCreated ? 0 : -1;
+}
+
+/**
+ * \brief This function creates the levels from the property priority_levels.
+ *
+ * \return 0 if the levels are valid. In error case -1 is returned.
+ */
+static int buildLevels(struct PriorityStage *stage)
+{
+    const char* const METHOD_NAME = "buildLevels";
+    int first = stage->config.controlLevel ? 1 : 0;
+    int i = 0, value = 0;
+
+    if(stage->config.priorityLevelsLength == 0)
+    {
+        stage->levels[first].minPriority = 1;
+        stage->levelsLength = first + 2;
+        return 0;
+    }
+
+    if(first + stage->config.priorityLevelsLength + 1 > EPROSIMA_PRIORITY_STAGE_LEVELS_MAX)
+    {
+        printf("ERROR<%s>: %s: Too many priority levels\n", METHOD_NAME, stage->name);
+        return -1;
+    }
+
+    for(i = 0; i < stage->config.priorityLevelsLength; ++i)
+    {
+        if(parsePropertyInteger(stage->config.priorityLevels[i], 0, &value) != 0 ||
+                (i > 0 && value >= stage->levels[first + i - 1].minPriority))
+        {
+            printf("ERROR<%s>: %s: The priority levels must be integers from the highest one\n", METHOD_NAME, stage->name);
+            return -1;
+        }
+
+        stage->levels[first + i].minPriority = value;
+    }
+
+    stage->levelsLength = first + stage->config.priorityLevelsLength + 1;
+
+    return 0;
+}
+
+struct eProsima_ChainStage* eProsimaPriorityStage_create(const struct eProsima_PropertyIndex *index, const char *prefix)
+{
+    const char* const METHOD_NAME = "eProsimaPriorityStage_create";
+    struct PriorityStage *stage = NULL;
+
+    if(index == NULL || prefix == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    RTIOsapiHeap_allocateStructure(&stage, struct PriorityStage);
+
+    if(stage == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the stage\n", METHOD_NAME);
+        return NULL;
+    }
+
+    memset(stage, 0, sizeof(struct PriorityStage));
+    SNPRINTF(stage->name, sizeof(stage->name), "%s", prefix);
+    stage->config.controlLevel = 1;
+    stage->config.queueSize = 256;
+    stage->config.quantum = 8192;
+    stage->config.starvationLimit = 16;
+    stage->config.drainLimit = 16;
+    parseTransportPropertiesFromIndex(index, prefix, PriorityPropertyDescriptors,
+            sizeof(PriorityPropertyDescriptors) / sizeof(PriorityPropertyDescriptors[0]), &stage->config);
+
+    stage->mutex = RTIOsapiSemaphore_new(RTI_OSAPI_SEMAPHORE_KIND_MUTEX, NULL);
+    stage->space = RTIOsapiSemaphore_new(RTI_OSAPI_SEMAPHORE_KIND_BINARY, NULL);
+    stage->sent = RTIOsapiSemaphore_new(RTI_OSAPI_SEMAPHORE_KIND_BINARY, NULL);
+    stage->pending = RTIOsapiSemaphore_new(RTI_OSAPI_SEMAPHORE_KIND_BINARY, NULL);
+
+    if(stage->mutex == NULL || stage->space == NULL || stage->sent == NULL || stage->pending == NULL ||
+            buildLevels(stage) != 0)
+    {
+        printf("ERROR<%s>: Cannot create the stage %s\n", METHOD_NAME, prefix);
+        deletePriorityStage(stage);
+        return NULL;
+    }
+
+    if(startThread(stage) != 0)
+    {
+        printf("ERROR<%s>: Cannot create the thread of the stage\n", METHOD_NAME);
+        deletePriorityStage(stage);
+        return NULL;
+    }
+
+    stage->parent.send = PriorityStage_send;
+    stage->parent.destroySendResource = PriorityStage_destroySendResource;
+    stage->parent.destroy = PriorityStage_destroy;
+
+    return &stage->parent;
+}
+
+void eProsimaPriorityStage_getMetrics(struct eProsima_ChainStage *stage, struct eProsima_PriorityStageMetrics *metrics)
+{
+    struct PriorityStage *priorityStage = (struct PriorityStage*)stage;
+
+    lockStage(priorityStage);
+    memcpy(metrics, &priorityStage->metrics, sizeof(struct eProsima_PriorityStageMetrics));
+    unlockStage(priorityStage);
+}
@@ -0,0 +1,75 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_CHAIN_PRIORITYSTAGE_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_CHAIN_PRIORITYSTAGE_H_
+
+#include "eProsima_c/config.h"
+#include "chainStage.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/// Maximum number of levels of a priority stage, including the control level.
+#define EPROSIMA_PRIORITY_STAGE_LEVELS_MAX 8
+
+/**
+ * \brief Metrics of a priority stage.
+ */
+struct eProsima_PriorityStageMetrics
+{
+    /// Messages sent from each level. Level 0 is the highest one.
+    unsigned long long sentMessages[EPROSIMA_PRIORITY_STAGE_LEVELS_MAX];
+    /// Messages that were queued because other message was being sent.
+    unsigned long long queuedMessages;
+    /// Sends that waited because the queue of their level was full.
+    unsigned long long blockedSends;
+    /// Lower level messages sent before higher level ones because they waited too long.
+    unsigned long long starvationPromotions;
+    /// Queued messages that the next stages failed to send or that were dropped with their send resource.
+    unsigned long long failedMessages;
+};
+
+/**
+ * \brief This function creates a stage that schedules the messages by transport priority, so control traffic
+ * and high priority topics don't wait behind bulk data sent by other threads.
+ *
+ * The stage sends one message at a time. A message that arrives while other is being sent is copied in the queue
+ * of its level, and the thread that is sending continues with up to drain_limit queued messages before it hands the
+ * rest to the thread of the stage, so a thread is not kept sending the traffic of others. The highest non-empty
+ * level goes first, but a level that was passed over starvation_limit times is served next. Inside a level, each
+ * transport priority is a flow and the flows share the level with deficit round robin, weighted by how much
+ * the priority exceeds the minimum of the level (up to 16 times).
+ *
+ * The levels use the transport priority received by the send operation, before transport_priority_mask and
+ * the DSCP mapping of the innermost transport.
+ *
+ * The properties use the prefix of the stage:
+ *     priority_levels: Minimum transport priority of each level, from the highest one. The last level takes
+ *         the lower priorities. Default "1".
+ *     control_level: If 1, messages with HEARTBEAT, ACKNACK, NACK_FRAG or HEARTBEAT_FRAG and no DATA or DATA_FRAG
+ *         go to a level above all of them. Default 1.
+ *     queue_size: Maximum messages in the queue of each level. A send waits while its level is full. Default 256.
+ *     quantum: Bytes a flow can send in each round of its level, multiplied by its weight. Default 8192.
+ *     starvation_limit: Times a non-empty level can be passed over. Default 16.
+ *     drain_limit: Queued messages a thread sends after its own one. The rest are sent by the thread of the stage.
+ *         Default 16.
+ *
+ * \param index Index of the properties of the chain. Cannot be NULL.
+ * \param prefix Prefix of the properties of the stage. Cannot be NULL.
+ * \return The new stage. In error case, NULL value is returned.
+ */
+struct eProsima_ChainStage* eProsimaPriorityStage_create(const struct eProsima_PropertyIndex *index, const char *prefix);
+
+/**
+ * \brief This function reads the metrics of a priority stage.
+ *
+ * \param stage A stage created by eProsimaPriorityStage_create. Cannot be NULL.
+ * \param metrics Where the metrics are stored. Cannot be NULL.
+ */
+void eProsimaPriorityStage_getMetrics(struct eProsima_ChainStage *stage, struct eProsima_PriorityStageMetrics *metrics);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_CHAIN_PRIORITYSTAGE_H_
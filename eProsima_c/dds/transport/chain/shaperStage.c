@@ -0,0 +1,711 @@
+#include "shaperStage.h"
+#include "../transportPropertyParser.h"
+#include "../../../sys/atomic.h"
+#include "../../../sys/clock.h"
+#include "../../../macros/snprintf.h"
+
+#include <osapi/osapi_heap.h>
+#include <osapi/osapi_semaphore.h>
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+#if defined(RTI_WIN32)
+#include <Windows.h>
+#elif defined(RTI_UNIX) || defined(RTI_LINUX)
+#include <pthread.h>
+#define SHAPER_STAGE_PTHREAD
+#endif
+
+#define SHAPER_STAGE_NAME_LENGTH 64
+
+#define SHAPER_NANOSECONDS_PER_SECOND 1000000000ULL
+
+struct ShaperStageConfig
+{
+    int rate;
+    int burst;
+    int destinationRate;
+    int destinationBurst;
+    int queueSize;
+    int destinations;
+    int tickUs;
+};
+
+static const struct eProsima_PropertyDescriptor ShaperPropertyDescriptors[] =
+{
+    EPROSIMA_PROPERTY_INT(struct ShaperStageConfig, "rate", rate, 0, INT_MAX, 0),
+    EPROSIMA_PROPERTY_INT(struct ShaperStageConfig, "burst", burst, 1, INT_MAX, 65536),
+    EPROSIMA_PROPERTY_INT(struct ShaperStageConfig, "destination_rate", destinationRate, 0, INT_MAX, 0),
+    EPROSIMA_PROPERTY_INT(struct ShaperStageConfig, "destination_burst", destinationBurst, 1, INT_MAX, 65536),
+    EPROSIMA_PROPERTY_INT(struct ShaperStageConfig, "queue_size", queueSize, 0, INT_MAX, 1048576),
+    EPROSIMA_PROPERTY_INT(struct ShaperStageConfig, "destinations", destinations, 1, 4096, 64),
+    EPROSIMA_PROPERTY_INT(struct ShaperStageConfig, "tick_us", tickUs, 1, 1000000, 50)
+};
+
+/**
+ * \brief Token bucket. The tokens can be negative after a message bigger than the burst.
+ */
+struct ShaperBucket
+{
+    long long tokens;
+    /// Time of the last refill. It doesn't include the time of the fraction of token that wasn't added.
+    unsigned long long last;
+};
+
+/**
+ * \brief Queued message. The data follows the structure.
+ */
+struct ShaperMessage
+{
+    struct ShaperMessage *next;
+    unsigned long long queuedTime;
+    size_t length;
+    char data[1];
+};
+
+struct ShaperDestination
+{
+    int used;
+    NDDS_Transport_SendResource_t sendResource;
+    NDDS_Transport_Address_t destAddress;
+    NDDS_Transport_Port_t destPort;
+    RTI_INT32 transportPriority;
+    struct ShaperBucket bucket;
+    struct ShaperMessage *first;
+    struct ShaperMessage *last;
+    size_t queuedBytes;
+
+    /// The destination is in the timer wheel or its messages are being sent.
+    int scheduled;
+    unsigned long long dueTick;
+    struct ShaperDestination *nextScheduled;
+};
+
+struct ShaperStage
+{
+    /// It has to be the first field.
+    struct eProsima_ChainStage parent;
+    char name[SHAPER_STAGE_NAME_LENGTH];
+    struct ShaperStageConfig config;
+    unsigned long long tickNanoseconds;
+    struct ShaperBucket bucket;
+    struct ShaperDestination *destinations;
+
+    /// Timer wheel. Each slot is a list of the destinations whose messages can be sent in a tick of the slot.
+    struct ShaperDestination *wheel[EPROSIMA_SHAPER_STAGE_WHEEL_SLOTS];
+    /// Next tick that the thread processes.
+    unsigned long long currentTick;
+    int scheduledLength;
+
+    /// Protects the state of the stage.
+    struct RTIOsapiSemaphore *mutex;
+    /// Held by the thread while it sends, so a send resource is not destroyed meanwhile.
+    struct RTIOsapiSemaphore *serviceMutex;
+    /// Given when a destination is scheduled and there was none.
+    struct RTIOsapiSemaphore *pending;
+    int running;
+    int threadCreated;
+#if defined(RTI_WIN32)
+    HANDLE thread;
+#elif defined(SHAPER_STAGE_PTHREAD)
+    pthread_t thread;
+#endif
+
+    struct eProsima_ShaperStageMetrics metrics;
+};
+
+static void lockStage(struct ShaperStage *stage)
+{
+    RTIOsapiSemaphore_take(stage->mutex, NULL);
+}
+
+static void unlockStage(struct ShaperStage *stage)
+{
+    RTIOsapiSemaphore_give(stage->mutex);
+}
+
+static void refillBucket(struct ShaperBucket *bucket, int rate, int burst, unsigned long long now)
+{
+    unsigned long long elapsed = 0, fullTime = 0, tokens = 0;
+
+    if(rate == 0 || now <= bucket->last)
+        return;
+
+    elapsed = now - bucket->last;
+    fullTime = (unsigned long long)((long long)burst - bucket->tokens) * SHAPER_NANOSECONDS_PER_SECOND / (unsigned long long)rate;
+
+    if(elapsed >= fullTime)
+    {
+        bucket->tokens = burst;
+        bucket->last = now;
+    }
+    else
+    {
+        // elapsed is less than the time to refill the whole burst, so the product doesn't overflow.
+        tokens = elapsed * (unsigned long long)rate / SHAPER_NANOSECONDS_PER_SECOND;
+        bucket->tokens += (long long)tokens;
+        bucket->last += tokens * SHAPER_NANOSECONDS_PER_SECOND / (unsigned long long)rate;
+    }
+}
+
+/**
+ * \brief This function returns the tokens that a message needs. A message bigger than the burst needs a full bucket.
+ */
+static long long neededTokens(int burst, size_t length)
+{
+    return length < (size_t)burst ? (long long)length : (long long)burst;
+}
+
+static int allowedByBucket(const struct ShaperBucket *bucket, int rate, int burst, size_t length)
+{
+    return rate == 0 || bucket->tokens >= neededTokens(burst, length);
+}
+
+/**
+ * \brief This function returns when a bucket will have the tokens for a message. It has to be refilled before.
+ */
+static unsigned long long bucketReadyTime(const struct ShaperBucket *bucket, int rate, int burst, size_t length)
+{
+    long long deficit = neededTokens(burst, length) - bucket->tokens;
+
+    if(rate == 0 || deficit <= 0)
+        return 0;
+
+    return bucket->last + ((unsigned long long)deficit * SHAPER_NANOSECONDS_PER_SECOND + (unsigned long long)rate - 1) /
+        (unsigned long long)rate;
+}
+
+static void consumeTokens(struct ShaperStage *stage, struct ShaperDestination *destination, size_t length)
+{
+    if(stage->config.rate != 0)
+        stage->bucket.tokens -= (long long)length;
+    if(destination != NULL && stage->config.destinationRate != 0)
+        destination->bucket.tokens -= (long long)length;
+}
+
+/**
+ * \brief This function adds a destination to the timer wheel.
+ *
+ * \return 1 if there were no scheduled destinations. In other case 0 is returned.
+ */
+static int scheduleDestination(struct ShaperStage *stage, struct ShaperDestination *destination, unsigned long long now)
+{
+    unsigned long long readyTime = 0, destinationReadyTime = 0, tick = 0;
+    struct ShaperDestination **slot = NULL;
+
+    readyTime = bucketReadyTime(&stage->bucket, stage->config.rate, stage->config.burst, destination->first->length);
+    destinationReadyTime = bucketReadyTime(&destination->bucket, stage->config.destinationRate, stage->config.destinationBurst,
+            destination->first->length);
+
+    if(destinationReadyTime > readyTime)
+        readyTime = destinationReadyTime;
+    if(readyTime < now)
+        readyTime = now;
+
+    tick = (readyTime + stage->tickNanoseconds - 1) / stage->tickNanoseconds;
+
+    // The slot of a past tick won't be processed until the next turn.
+    if(tick < stage->currentTick)
+        tick = stage->currentTick;
+
+    slot = &stage->wheel[tick % EPROSIMA_SHAPER_STAGE_WHEEL_SLOTS];
+    destination->dueTick = tick;
+    destination->nextScheduled = *slot;
+    *slot = destination;
+    destination->scheduled = 1;
+
+    return ++stage->scheduledLength == 1;
+}
+
+static void unscheduleDestination(struct ShaperStage *stage, struct ShaperDestination *destination)
+{
+    struct ShaperDestination **link = &stage->wheel[destination->dueTick % EPROSIMA_SHAPER_STAGE_WHEEL_SLOTS];
+
+    while(*link != NULL && *link != destination)
+        link = &(*link)->nextScheduled;
+
+    if(*link != NULL)
+        *link = destination->nextScheduled;
+
+    destination->scheduled = 0;
+    --stage->scheduledLength;
+}
+
+/**
+ * \brief This function returns the destination of a message. If it has none, a free or idle one is used. An idle
+ * destination is only reused when its bucket is full, so its new destination doesn't get a burst that its old
+ * destination couldn't have sent.
+ */
+static struct ShaperDestination* findDestination(struct ShaperStage *stage, const struct eProsima_ChainSendContext *context,
+        unsigned long long now)
+{
+    struct ShaperDestination *freeDestination = NULL, *idleDestination = NULL;
+    int i = 0;
+
+    for(i = 0; i < stage->config.destinations; ++i)
+    {
+        struct ShaperDestination *destination = &stage->destinations[i];
+
+        if(!destination->used)
+        {
+            if(freeDestination == NULL)
+                freeDestination = destination;
+        }
+        else if(destination->sendResource == context->sendResource && destination->destPort == context->destPort &&
+                destination->transportPriority == context->transportPriority &&
+                memcmp(&destination->destAddress, context->destAddress, sizeof(NDDS_Transport_Address_t)) == 0)
+        {
+            return destination;
+        }
+        else if(idleDestination == NULL && destination->first == NULL && !destination->scheduled)
+        {
+            refillBucket(&destination->bucket, stage->config.destinationRate, stage->config.destinationBurst, now);
+
+            if(destination->bucket.tokens >= stage->config.destinationBurst)
+                idleDestination = destination;
+        }
+    }
+
+    if(freeDestination == NULL)
+        freeDestination = idleDestination;
+
+    if(freeDestination != NULL)
+    {
+        freeDestination->used = 1;
+        freeDestination->sendResource = context->sendResource;
+        freeDestination->destAddress = *context->destAddress;
+        freeDestination->destPort = context->destPort;
+        freeDestination->transportPriority = context->transportPriority;
+        freeDestination->bucket.tokens = stage->config.destinationBurst;
+        freeDestination->bucket.last = now;
+    }
+
+    return freeDestination;
+}
+
+static EPROSIMA_CHAIN_STAGE_RESULT ShaperStage_send(struct eProsima_ChainStage *self, struct eProsima_ChainSendContext *context)
+{
+    struct ShaperStage *stage = (struct ShaperStage*)self;
+    struct ShaperDestination *destination = NULL;
+    struct ShaperMessage *message = NULL;
+    char *memory = NULL;
+    unsigned long long now = 0;
+    size_t length = 0, offset = 0;
+    int wasIdle = 0, i = 0;
+
+    if(stage->config.rate == 0 && stage->config.destinationRate == 0)
+        return EPROSIMA_CHAIN_STAGE_CONTINUE;
+
+    for(i = 0; i < context->bufferCount; ++i)
+        length += (size_t)context->buffers[i].length;
+
+    lockStage(stage);
+
+    now = eProsimaClock_getNanoseconds();
+    refillBucket(&stage->bucket, stage->config.rate, stage->config.burst, now);
+    destination = findDestination(stage, context, now);
+
+    if(destination == NULL)
+    {
+        // Too many busy destinations. The message only uses the global bucket and it cannot be queued.
+        if(!allowedByBucket(&stage->bucket, stage->config.rate, stage->config.burst, length))
+        {
+            ++stage->metrics.droppedMessages;
+            unlockStage(stage);
+            return EPROSIMA_CHAIN_STAGE_ERROR;
+        }
+
+        consumeTokens(stage, NULL, length);
+        ++stage->metrics.passedMessages;
+        unlockStage(stage);
+        return EPROSIMA_CHAIN_STAGE_CONTINUE;
+    }
+
+    refillBucket(&destination->bucket, stage->config.destinationRate, stage->config.destinationBurst, now);
+
+    // Queued messages go first.
+    if(destination->first == NULL && !destination->scheduled &&
+            allowedByBucket(&stage->bucket, stage->config.rate, stage->config.burst, length) &&
+            allowedByBucket(&destination->bucket, stage->config.destinationRate, stage->config.destinationBurst, length))
+    {
+        consumeTokens(stage, destination, length);
+        ++stage->metrics.passedMessages;
+        unlockStage(stage);
+        return EPROSIMA_CHAIN_STAGE_CONTINUE;
+    }
+
+    if(destination->queuedBytes + length > (size_t)stage->config.queueSize)
+    {
+        ++stage->metrics.droppedMessages;
+        unlockStage(stage);
+        return EPROSIMA_CHAIN_STAGE_ERROR;
+    }
+
+    RTIOsapiHeap_allocateArray(&memory, offsetof(struct ShaperMessage, data) + length, char);
+
+    if(memory == NULL)
+    {
+        ++stage->metrics.droppedMessages;
+        unlockStage(stage);
+        return EPROSIMA_CHAIN_STAGE_ERROR;
+    }
+
+    message = (struct ShaperMessage*)memory;
+
+    for(i = 0; i < context->bufferCount; ++i)
+    {
+        memcpy(message->data + offset, context->buffers[i].pointer, (size_t)context->buffers[i].length);
+        offset += (size_t)context->buffers[i].length;
+    }
+
+    message->next = NULL;
+    message->queuedTime = now;
+    message->length = length;
+
+    if(destination->last != NULL)
+        destination->last->next = message;
+    else
+        destination->first = message;
+    destination->last = message;
+    destination->queuedBytes += length;
+
+    ++stage->metrics.queuedMessages;
+    stage->metrics.queuedBytes += length;
+    if(stage->metrics.queuedBytes > stage->metrics.queuedBytesMax)
+        stage->metrics.queuedBytesMax = stage->metrics.queuedBytes;
+
+    if(!destination->scheduled)
+        wasIdle = scheduleDestination(stage, destination, now);
+
+    unlockStage(stage);
+
+    if(wasIdle)
+        RTIOsapiSemaphore_give(stage->pending);
+
+    return EPROSIMA_CHAIN_STAGE_DISCARD;
+}
+
+static struct ShaperMessage* dequeueMessage(struct ShaperStage *stage, struct ShaperDestination *destination)
+{
+    struct ShaperMessage *message = destination->first;
+
+    destination->first = message->next;
+    if(destination->first == NULL)
+        destination->last = NULL;
+    destination->queuedBytes -= message->length;
+
+    --stage->metrics.queuedMessages;
+    stage->metrics.queuedBytes -= message->length;
+
+    return message;
+}
+
+/**
+ * \brief This function sends the queued messages of a destination while there are tokens, and schedules it again
+ * if some remain. It is called with the mutex taken, which is released while sending.
+ */
+static void serviceDestination(struct ShaperStage *stage, struct ShaperDestination *destination)
+{
+    struct ShaperMessage *message = NULL;
+    NDDS_Transport_Buffer_t buffer;
+    unsigned long long now = 0, delay = 0;
+
+    while(destination->first != NULL)
+    {
+        now = eProsimaClock_getNanoseconds();
+        refillBucket(&stage->bucket, stage->config.rate, stage->config.burst, now);
+        refillBucket(&destination->bucket, stage->config.destinationRate, stage->config.destinationBurst, now);
+
+        if(!allowedByBucket(&stage->bucket, stage->config.rate, stage->config.burst, destination->first->length) ||
+                !allowedByBucket(&destination->bucket, stage->config.destinationRate, stage->config.destinationBurst,
+                    destination->first->length))
+            break;
+
+        message = dequeueMessage(stage, destination);
+        consumeTokens(stage, destination, message->length);
+
+        delay = now - message->queuedTime;
+        ++stage->metrics.shapedMessages;
+        stage->metrics.shapingDelayNanoseconds += delay;
+        if(delay > stage->metrics.shapingDelayNanosecondsMax)
+            stage->metrics.shapingDelayNanosecondsMax = delay;
+
+        // The destination stays scheduled, so new messages are queued after this one.
+        unlockStage(stage);
+        buffer.pointer = message->data;
+        buffer.length = (RTI_INT32)message->length;
+        eProsimaChainStage_sendNext(&stage->parent, destination->sendResource, &destination->destAddress,
+                destination->destPort, destination->transportPriority, &buffer, 1);
+        RTIOsapiHeap_freeArray((char*)message);
+        lockStage(stage);
+    }
+
+    destination->scheduled = 0;
+    --stage->scheduledLength;
+
+    if(destination->first != NULL)
+        scheduleDestination(stage, destination, now);
+}
+
+/**
+ * \brief This function processes the slots of the ticks until now.
+ */
+static void advanceWheel(struct ShaperStage *stage, unsigned long long now)
+{
+    unsigned long long nowTick = now / stage->tickNanoseconds, firstTick = stage->currentTick, steps = 0, step = 0;
+    struct ShaperDestination *list = NULL, *destination = NULL;
+    struct ShaperDestination **slot = NULL;
+
+    if(stage->currentTick > nowTick)
+        return;
+
+    steps = nowTick - firstTick + 1;
+
+    // After a long sleep every slot is processed once.
+    if(steps > EPROSIMA_SHAPER_STAGE_WHEEL_SLOTS)
+        steps = EPROSIMA_SHAPER_STAGE_WHEEL_SLOTS;
+
+    // Destinations scheduled meanwhile go to the next ticks, not to the slots being processed.
+    stage->currentTick = nowTick + 1;
+
+    for(step = 0; step < steps; ++step)
+    {
+        slot = &stage->wheel[(firstTick + step) % EPROSIMA_SHAPER_STAGE_WHEEL_SLOTS];
+        list = *slot;
+        *slot = NULL;
+
+        while(list != NULL)
+        {
+            destination = list;
+            list = destination->nextScheduled;
+
+            if(destination->dueTick > nowTick)
+            {
+                // It is due in other turn of the wheel.
+                destination->nextScheduled = *slot;
+                *slot = destination;
+            }
+            else
+            {
+                serviceDestination(stage, destination);
+            }
+        }
+    }
+}
+
+static void runThread(struct ShaperStage *stage)
+{
+    unsigned long long now = 0, next = 0;
+
+    while(EPROSIMA_ATOMIC_LOAD32(&stage->running))
+    {
+        RTIOsapiSemaphore_take(stage->serviceMutex, NULL);
+        lockStage(stage);
+
+        if(stage->scheduledLength == 0)
+        {
+            unlockStage(stage);
+            RTIOsapiSemaphore_give(stage->serviceMutex);
+            // Wait until a destination is scheduled.
+            RTIOsapiSemaphore_take(stage->pending, NULL);
+            continue;
+        }
+
+        advanceWheel(stage, eProsimaClock_getNanoseconds());
+        next = stage->currentTick * stage->tickNanoseconds;
+
+        unlockStage(stage);
+        RTIOsapiSemaphore_give(stage->serviceMutex);
+
+        now = eProsimaClock_getNanoseconds();
+
+        if(next > now)
+            eProsimaClock_sleepNanoseconds(next - now);
+    }
+}
+
+#if defined(RTI_WIN32)
+static DWORD WINAPI shaperThreadFunction(LPVOID arg)
+{
+    runThread((struct ShaperStage*)arg);
+    return 0;
+}
+#elif defined(SHAPER_STAGE_PTHREAD)
+static void* shaperThreadFunction(void *arg)
+{
+    runThread((struct ShaperStage*)arg);
+    return NULL;
+}
+#endif
+
+static void dropMessages(struct ShaperStage *stage, struct ShaperDestination *destination)
+{
+    while(destination->first != NULL)
+    {
+        RTIOsapiHeap_freeArray((char*)dequeueMessage(stage, destination));
+        ++stage->metrics.droppedMessages;
+    }
+}
+
+static void ShaperStage_destroySendResource(struct eProsima_ChainStage *self, NDDS_Transport_SendResource_t sendResource)
+{
+    struct ShaperStage *stage = (struct ShaperStage*)self;
+    int i = 0;
+
+    RTIOsapiSemaphore_take(stage->serviceMutex, NULL);
+    lockStage(stage);
+
+    for(i = 0; i < stage->config.destinations; ++i)
+    {
+        struct ShaperDestination *destination = &stage->destinations[i];
+
+        if(!destination->used || destination->sendResource != sendResource)
+            continue;
+
+        dropMessages(stage, destination);
+
+        if(destination->scheduled)
+            unscheduleDestination(stage, destination);
+
+        destination->used = 0;
+    }
+
+    unlockStage(stage);
+    RTIOsapiSemaphore_give(stage->serviceMutex);
+}
+
+static void deleteShaperStage(struct ShaperStage *stage)
+{
+    int i = 0;
+
+    if(stage->threadCreated)
+    {
+        EPROSIMA_ATOMIC_STORE32(&stage->running, 0);
+        RTIOsapiSemaphore_give(stage->pending);
+#if defined(RTI_WIN32)
+        WaitForSingleObject(stage->thread, INFINITE);
+        CloseHandle(stage->thread);
+#elif defined(SHAPER_STAGE_PTHREAD)
+        pthread_join(stage->thread, NULL);
+#endif
+    }
+
+    if(stage->destinations != NULL)
+    {
+        for(i = 0; i < stage->config.destinations; ++i)
+            dropMessages(stage, &stage->destinations[i]);
+
+        RTIOsapiHeap_freeArray(stage->destinations);
+    }
+
+    if(stage->pending != NULL)
+        RTIOsapiSemaphore_delete(stage->pending);
+    if(stage->serviceMutex != NULL)
+        RTIOsapiSemaphore_delete(stage->serviceMutex);
+    if(stage->mutex != NULL)
+        RTIOsapiSemaphore_delete(stage->mutex);
+
+    RTIOsapiHeap_freeStructure(stage);
+}
+
+static void ShaperStage_destroy(struct eProsima_ChainStage *self)
+{
+    deleteShaperStage((struct ShaperStage*)self);
+}
+
+static int startThread(struct ShaperStage *stage)
+{
+    stage->running = 1;
+
+#if defined(RTI_WIN32)
+    stage->thread = CreateThread(NULL, 0, shaperThreadFunction, stage, 0, NULL);
+    stage->threadCreated = stage->thread != NULL;
+#elif defined(SHAPER_STAGE_PTHREAD)
+    stage->threadCreated = pthread_create(&stage->thread, NULL, shaperThreadFunction, stage) == 0;
+#endif
+
+    return stage->threadCreated ? 0 : -1;
+}
+
+struct eProsima_ChainStage* eProsimaShaperStage_create(const struct eProsima_PropertyIndex *index, const char *prefix)
+{
+    const char* const METHOD_NAME = "eProsimaShaperStage_create";
+    struct ShaperStage *stage = NULL;
+
+    if(index == NULL || prefix == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    RTIOsapiHeap_allocateStructure(&stage, struct ShaperStage);
+
+    if(stage == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the stage\n", METHOD_NAME);
+        return NULL;
+    }
+
+    memset(stage, 0, sizeof(struct ShaperStage));
+    SNPRINTF(stage->name, sizeof(stage->name), "%s", prefix);
+    stage->config.rate = 0;
+    stage->config.burst = 65536;
+    stage->config.destinationRate = 0;
+    stage->config.destinationBurst = 65536;
+    stage->config.queueSize = 1048576;
+    stage->config.destinations = 64;
+    stage->config.tickUs = 50;
+    parseTransportPropertiesFromIndex(index, prefix, ShaperPropertyDescriptors,
+            sizeof(ShaperPropertyDescriptors) / sizeof(ShaperPropertyDescriptors[0]), &stage->config);
+
+    if(stage->config.rate == 0 && stage->config.destinationRate == 0)
+        printf("WARNING<%s>: %s: rate and destination_rate are 0. Messages are not shaped\n", METHOD_NAME, stage->name);
+
+    stage->tickNanoseconds = (unsigned long long)stage->config.tickUs * 1000ULL;
+    stage->bucket.tokens = stage->config.burst;
+    stage->bucket.last = eProsimaClock_getNanoseconds();
+    stage->currentTick = stage->bucket.last / stage->tickNanoseconds;
+    stage->mutex = RTIOsapiSemaphore_new(RTI_OSAPI_SEMAPHORE_KIND_MUTEX, NULL);
+    stage->serviceMutex = RTIOsapiSemaphore_new(RTI_OSAPI_SEMAPHORE_KIND_MUTEX, NULL);
+    stage->pending = RTIOsapiSemaphore_new(RTI_OSAPI_SEMAPHORE_KIND_BINARY, NULL);
+    RTIOsapiHeap_allocateArray(&stage->destinations, stage->config.destinations, struct ShaperDestination);
+
+    if(stage->mutex == NULL || stage->serviceMutex == NULL || stage->pending == NULL || stage->destinations == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the stage\n", METHOD_NAME);
+        deleteShaperStage(stage);
+        return NULL;
+    }
+
+    memset(stage->destinations, 0, stage->config.destinations * sizeof(struct ShaperDestination));
+
+    if(startThread(stage) != 0)
+    {
+        printf("ERROR<%s>: Cannot create the thread of the stage\n", METHOD_NAME);
+        deleteShaperStage(stage);
+        return NULL;
+    }
+
+    stage->parent.send = ShaperStage_send;
+    stage->parent.destroySendResource = ShaperStage_destroySendResource;
+    stage->parent.destroy = ShaperStage_destroy;
+
+    return &stage->parent;
+}
+
+void eProsimaShaperStage_getMetrics(const struct eProsima_ChainStage *stage, struct eProsima_ShaperStageMetrics *metrics)
+{
+    const struct ShaperStage *shaperStage = (const struct ShaperStage*)stage;
+
+    metrics->passedMessages = EPROSIMA_ATOMIC_LOAD64(&shaperStage->metrics.passedMessages);
+    metrics->shapedMessages = EPROSIMA_ATOMIC_LOAD64(&shaperStage->metrics.shapedMessages);
+    metrics->droppedMessages = EPROSIMA_ATOMIC_LOAD64(&shaperStage->metrics.droppedMessages);
+    metrics->queuedMessages = EPROSIMA_ATOMIC_LOAD64(&shaperStage->metrics.queuedMessages);
+    metrics->queuedBytes = EPROSIMA_ATOMIC_LOAD64(&shaperStage->metrics.queuedBytes);
+    metrics->queuedBytesMax = EPROSIMA_ATOMIC_LOAD64(&shaperStage->metrics.queuedBytesMax);
+    metrics->shapingDelayNanoseconds = EPROSIMA_ATOMIC_LOAD64(&shaperStage->metrics.shapingDelayNanoseconds);
+    metrics->shapingDelayNanosecondsMax = EPROSIMA_ATOMIC_LOAD64(&shaperStage->metrics.shapingDelayNanosecondsMax);
+}
@@ -0,0 +1,81 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_CHAIN_SHAPERSTAGE_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_CHAIN_SHAPERSTAGE_H_
+
+#include "eProsima_c/config.h"
+#include "chainStage.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/// Slots of the timer wheel of a shaper stage. A message that waits more than EPROSIMA_SHAPER_STAGE_WHEEL_SLOTS
+/// ticks stays in its slot for several turns.
+#define EPROSIMA_SHAPER_STAGE_WHEEL_SLOTS 1024
+
+/**
+ * \brief Metrics of a shaper stage. The average shaping delay is shapingDelayNanoseconds / shapedMessages.
+ */
+struct eProsima_ShaperStageMetrics
+{
+    /// Messages sent immediately because there were tokens.
+    unsigned long long passedMessages;
+    /// Messages that were queued and sent later.
+    unsigned long long shapedMessages;
+    /// Messages dropped because the queue of their destination was full, their send resource was destroyed, or
+    /// they had no destination and the bucket of all the destinations had no tokens.
+    unsigned long long droppedMessages;
+    /// Messages in the queues now.
+    unsigned long long queuedMessages;
+    /// Bytes in the queues now.
+    unsigned long long queuedBytes;
+    /// Maximum bytes that were in the queues.
+    unsigned long long queuedBytesMax;
+    /// Time that the shaped messages waited in the queues.
+    unsigned long long shapingDelayNanoseconds;
+    /// Maximum time that a message waited in the queues.
+    unsigned long long shapingDelayNanosecondsMax;
+};
+
+/**
+ * \brief This function creates a stage that limits the rate of the sent bytes with token buckets, one for each
+ * destination and other for all of them, so bursts of DATA_FRAG don't overflow the switches and the receive
+ * buffers.
+ *
+ * A message is sent if both buckets have tokens for it (or are full, for messages bigger than the burst). If not,
+ * the message is copied to the queue of its destination and the stage doesn't block the sender. A thread of the
+ * stage sends the queued messages in order when the buckets are refilled. It is woken by a timer wheel of
+ * EPROSIMA_SHAPER_STAGE_WHEEL_SLOTS slots of tick_us microseconds, so the cost doesn't depend on the number of
+ * waiting destinations.
+ *
+ * The properties use the prefix of the stage. A rate of 0 disables its bucket:
+ *     rate: Bytes per second of all the destinations. Default 0.
+ *     burst: Bytes that can be sent at once to all the destinations. Default 65536.
+ *     destination_rate: Bytes per second of each destination. Default 0.
+ *     destination_burst: Bytes that can be sent at once to each destination. Default 65536.
+ *     queue_size: Bytes that can be queued for each destination. When it is full messages are dropped and the
+ *         send operation fails. Default 1048576.
+ *     destinations: Destinations with a bucket. Idle ones are reused once their bucket is full. Messages to
+ *         others only use the bucket of all the destinations: they are dropped and the send operation fails
+ *         when it has no tokens. Default 64.
+ *     tick_us: Resolution of the timer wheel. Default 50.
+ *
+ * \param index Index of the properties of the chain. Cannot be NULL.
+ * \param prefix Prefix of the properties of the stage. Cannot be NULL.
+ * \return The new stage. In error case, NULL value is returned.
+ */
+struct eProsima_ChainStage* eProsimaShaperStage_create(const struct eProsima_PropertyIndex *index, const char *prefix);
+
+/**
+ * \brief This function reads the metrics of a shaper stage.
+ *
+ * \param stage A stage created by eProsimaShaperStage_create. Cannot be NULL.
+ * \param metrics Where the metrics are stored. Cannot be NULL.
+ */
+void eProsimaShaperStage_getMetrics(const struct eProsima_ChainStage *stage, struct eProsima_ShaperStageMetrics *metrics);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_CHAIN_SHAPERSTAGE_H_
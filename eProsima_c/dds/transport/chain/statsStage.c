@@ -0,0 +1,81 @@
+#include "statsStage.h"
+#include "../../../sys/atomic.h"
+
+#include <osapi/osapi_heap.h>
+
+#include <stdio.h>
+#include <string.h>
+
+struct StatsStage
+{
+    /// It has to be the first field.
+    struct eProsima_ChainStage parent;
+    struct eProsima_StatsStageCounters counters;
+};
+
+static EPROSIMA_CHAIN_STAGE_RESULT StatsStage_send(struct eProsima_ChainStage *self, struct eProsima_ChainSendContext *context)
+{
+    struct StatsStage *stage = (struct StatsStage*)self;
+    unsigned long long length = 0;
+    RTI_INT32 i = 0;
+
+    for(i = 0; i < context->bufferCount; ++i)
+        length += (unsigned long long)context->buffers[i].length;
+
+    EPROSIMA_ATOMIC_ADD64(&stage->counters.sentMessages, 1);
+    EPROSIMA_ATOMIC_ADD64(&stage->counters.sentBytes, length);
+
+    return EPROSIMA_CHAIN_STAGE_CONTINUE;
+}
+
+static EPROSIMA_CHAIN_STAGE_RESULT StatsStage_receive(struct eProsima_ChainStage *self, struct eProsima_ChainReceiveContext *context)
+{
+    struct StatsStage *stage = (struct StatsStage*)self;
+
+    EPROSIMA_ATOMIC_ADD64(&stage->counters.receivedMessages, 1);
+    EPROSIMA_ATOMIC_ADD64(&stage->counters.receivedBytes, (unsigned long long)context->message->buffer.length);
+
+    return EPROSIMA_CHAIN_STAGE_CONTINUE;
+}
+
+static void StatsStage_destroy(struct eProsima_ChainStage *self)
+{
+    RTIOsapiHeap_freeStructure((struct StatsStage*)self);
+}
+
+struct eProsima_ChainStage* eProsimaStatsStage_create(const struct eProsima_PropertyIndex *index, const char *prefix)
+{
+    const char* const METHOD_NAME = "eProsimaStatsStage_create";
+    struct StatsStage *stage = NULL;
+
+    if(index == NULL || prefix == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    RTIOsapiHeap_allocateStructure(&stage, struct StatsStage);
+
+    if(stage == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the stage\n", METHOD_NAME);
+        return NULL;
+    }
+
+    memset(stage, 0, sizeof(struct StatsStage));
+    stage->parent.send = StatsStage_send;
+    stage->parent.receive = StatsStage_receive;
+    stage->parent.destroy = StatsStage_destroy;
+
+    return &stage->parent;
+}
+
+void eProsimaStatsStage_getCounters(const struct eProsima_ChainStage *stage, struct eProsima_StatsStageCounters *counters)
+{
+    const struct StatsStage *statsStage = (const struct StatsStage*)stage;
+
+    counters->sentMessages = EPROSIMA_ATOMIC_LOAD64(&statsStage->counters.sentMessages);
+    counters->sentBytes = EPROSIMA_ATOMIC_LOAD64(&statsStage->counters.sentBytes);
+    counters->receivedMessages = EPROSIMA_ATOMIC_LOAD64(&statsStage->counters.receivedMessages);
+    counters->receivedBytes = EPROSIMA_ATOMIC_LOAD64(&statsStage->counters.receivedBytes);
+}
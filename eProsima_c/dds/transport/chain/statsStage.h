@@ -0,0 +1,45 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_CHAIN_STATSSTAGE_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_CHAIN_STATSSTAGE_H_
+
+#include "eProsima_c/config.h"
+#include "chainStage.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/**
+ * \brief Counters of a stats stage.
+ */
+struct eProsima_StatsStageCounters
+{
+    unsigned long long sentMessages;
+    unsigned long long sentBytes;
+    unsigned long long receivedMessages;
+    unsigned long long receivedBytes;
+};
+
+/**
+ * \brief This function creates a stage that counts the messages and bytes that pass through it.
+ * The counters are read with eProsimaStatsStage_getCounters. The stage doesn't modify the messages.
+ *
+ * \param index Index of the properties of the chain. Cannot be NULL.
+ * \param prefix Prefix of the properties of the stage. Cannot be NULL.
+ * \return The new stage. In error case, NULL value is returned.
+ */
+struct eProsima_ChainStage* eProsimaStatsStage_create(const struct eProsima_PropertyIndex *index, const char *prefix);
+
+/**
+ * \brief This function reads the counters of a stats stage.
+ *
+ * \param stage A stage created by eProsimaStatsStage_create. Cannot be NULL.
+ * \param counters Where the counters are stored. Cannot be NULL.
+ */
+void eProsimaStatsStage_getCounters(const struct eProsima_ChainStage *stage, struct eProsima_StatsStageCounters *counters);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_CHAIN_STATSSTAGE_H_
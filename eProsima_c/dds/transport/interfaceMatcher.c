@@ -0,0 +1,547 @@
+#include "interfaceMatcher.h"
+#include "transportPropertyParser.h"
+
+#include <osapi/osapi_heap.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(RTI_WIN32)
+#include <winsock2.h>
+#include <iphlpapi.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "iphlpapi.lib")
+#endif
+#elif (defined(RTI_UNIX) || defined(RTI_LINUX))
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#endif
+
+#define INTERFACES_MAX 64
+
+#define ADDRESS_STRING_LENGTH 16
+
+#define INTERFACE_NAME_LENGTH 64
+
+/**
+ * \brief IPv4 address of a local interface.
+ */
+struct LocalInterface
+{
+    char name[INTERFACE_NAME_LENGTH];
+    unsigned int address;
+};
+
+/**
+ * \brief Node of the binary trie of addresses. The children are indexes in the array of nodes.
+ */
+struct AddressTrieNode
+{
+    int children[2];
+    int terminal;
+};
+
+/**
+ * \brief Node of the character trie of names. The children are a list of siblings.
+ */
+struct NameTrieNode
+{
+    char character;
+    char terminal;
+    /// The pattern ended with "*" after this node.
+    char anySuffix;
+    int firstChild;
+    int nextSibling;
+};
+
+struct eProsima_InterfaceMatcher
+{
+    struct AddressTrieNode *addressNodes;
+    int addressNodesLength;
+
+    struct NameTrieNode *nameNodes;
+    int nameNodesLength;
+
+    /// Patterns with wildcards that are not at the end. They are checked one by one.
+    char **globs;
+    int globsLength;
+};
+
+/**
+ * \brief This function parses "a.b.c.d", "a.b.c.d/n" and "a.b.*".
+ *
+ * \return 0 if the pattern is an address. Otherwise -1.
+ */
+static int parseAddressPattern(const char *pattern, unsigned int *address, int *prefixLength)
+{
+    unsigned int component = 0;
+    int components = 0, digits = 0;
+
+    *address = 0;
+    *prefixLength = 32;
+
+    for(;;)
+    {
+        if(*pattern == '*' && pattern[1] == '\0' && components < 4)
+        {
+            // A 32 bits shift of "*" would be undefined.
+            if(components > 0)
+                *address <<= 8 * (4 - components);
+            *prefixLength = 8 * components;
+            return 0;
+        }
+
+        for(component = 0, digits = 0; *pattern >= '0' && *pattern <= '9' && digits < 3; ++pattern, ++digits)
+            component = component * 10 + (*pattern - '0');
+
+        if(digits == 0 || component > 255)
+            return -1;
+
+        *address = (*address << 8) | component;
+        ++components;
+
+        if(components == 4)
+            break;
+
+        if(*pattern++ != '.')
+            return -1;
+    }
+
+    if(*pattern == '/')
+    {
+        ++pattern;
+
+        if(parsePropertyInteger(pattern, 0, prefixLength) != 0 || *prefixLength < 0 || *prefixLength > 32)
+            return -1;
+
+        while(*pattern >= '0' && *pattern <= '9')
+            ++pattern;
+    }
+
+    return *pattern == '\0' ? 0 : -1;
+}
+
+static void insertAddress(struct eProsima_InterfaceMatcher *matcher, unsigned int address, int prefixLength)
+{
+    int node = 0, bit = 0, i = 0;
+
+    for(i = 0; i < prefixLength; ++i)
+    {
+        bit = (address >> (31 - i)) & 1;
+
+        if(matcher->addressNodes[node].children[bit] == 0)
+        {
+            memset(&matcher->addressNodes[matcher->addressNodesLength], 0, sizeof(struct AddressTrieNode));
+            matcher->addressNodes[node].children[bit] = matcher->addressNodesLength++;
+        }
+
+        node = matcher->addressNodes[node].children[bit];
+    }
+
+    matcher->addressNodes[node].terminal = 1;
+}
+
+static void insertName(struct eProsima_InterfaceMatcher *matcher, const char *name, int anySuffix)
+{
+    int node = 0, child = 0;
+
+    for(; *name != '\0' && !(anySuffix && name[0] == '*' && name[1] == '\0'); ++name)
+    {
+        for(child = matcher->nameNodes[node].firstChild; child != 0 && matcher->nameNodes[child].character != *name;
+                child = matcher->nameNodes[child].nextSibling);
+
+        if(child == 0)
+        {
+            child = matcher->nameNodesLength++;
+            memset(&matcher->nameNodes[child], 0, sizeof(struct NameTrieNode));
+            matcher->nameNodes[child].character = *name;
+            matcher->nameNodes[child].nextSibling = matcher->nameNodes[node].firstChild;
+            matcher->nameNodes[node].firstChild = child;
+        }
+
+        node = child;
+    }
+
+    if(anySuffix)
+        matcher->nameNodes[node].anySuffix = 1;
+    else
+        matcher->nameNodes[node].terminal = 1;
+}
+
+static int matchGlob(const char *pattern, const char *name)
+{
+    for(; *pattern != '\0'; ++pattern, ++name)
+    {
+        if(*pattern == '*')
+        {
+            for(;; ++name)
+            {
+                if(matchGlob(pattern + 1, name))
+                    return 1;
+
+                if(*name == '\0')
+                    return 0;
+            }
+        }
+
+        if(*name == '\0' || (*pattern != '?' && *pattern != *name))
+            return 0;
+    }
+
+    return *name == '\0';
+}
+
+struct eProsima_InterfaceMatcher* eProsimaInterfaceMatcher_new(char * const *patterns, int patternsLength)
+{
+    const char* const METHOD_NAME = "eProsimaInterfaceMatcher_new";
+    struct eProsima_InterfaceMatcher *matcher = NULL;
+    const char *globs[INTERFACES_MAX];
+    const char *wildcard = NULL;
+    unsigned int address = 0;
+    int prefixLength = 0, nameNodesMax = 1, i = 0;
+
+    if((patterns == NULL && patternsLength > 0) || patternsLength < 0)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    for(i = 0; i < patternsLength; ++i)
+        nameNodesMax += strlen(patterns[i]);
+
+    RTIOsapiHeap_allocateStructure(&matcher, struct eProsima_InterfaceMatcher);
+
+    if(matcher != NULL)
+    {
+        memset(matcher, 0, sizeof(struct eProsima_InterfaceMatcher));
+        RTIOsapiHeap_allocateArray(&matcher->addressNodes, 32 * patternsLength + 1, struct AddressTrieNode);
+        RTIOsapiHeap_allocateArray(&matcher->nameNodes, nameNodesMax, struct NameTrieNode);
+
+        if(matcher->addressNodes != NULL && matcher->nameNodes != NULL)
+        {
+            memset(&matcher->addressNodes[0], 0, sizeof(struct AddressTrieNode));
+            memset(&matcher->nameNodes[0], 0, sizeof(struct NameTrieNode));
+            matcher->addressNodesLength = 1;
+            matcher->nameNodesLength = 1;
+
+            for(i = 0; i < patternsLength; ++i)
+            {
+                wildcard = strpbrk(patterns[i], "*?");
+
+                if(parseAddressPattern(patterns[i], &address, &prefixLength) == 0)
+                    insertAddress(matcher, address, prefixLength);
+                else if(wildcard == NULL)
+                    insertName(matcher, patterns[i], 0);
+                else if(wildcard[0] == '*' && wildcard[1] == '\0')
+                    insertName(matcher, patterns[i], 1);
+                else if(matcher->globsLength < INTERFACES_MAX)
+                    globs[matcher->globsLength++] = patterns[i];
+                else
+                    printf("ERROR<%s>: Too many patterns with wildcards. %s is ignored\n", METHOD_NAME, patterns[i]);
+            }
+
+            if(matcher->globsLength > 0 &&
+                    copyPropertyStringList(globs, NULL, matcher->globsLength, &matcher->globs, &matcher->globsLength) != 0)
+            {
+                printf("ERROR<%s>: Cannot allocate memory for the patterns\n", METHOD_NAME);
+                eProsimaInterfaceMatcher_delete(matcher);
+                matcher = NULL;
+            }
+        }
+        else
+        {
+            printf("ERROR<%s>: Cannot allocate memory for the matcher\n", METHOD_NAME);
+            eProsimaInterfaceMatcher_delete(matcher);
+            matcher = NULL;
+        }
+    }
+    else
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the matcher\n", METHOD_NAME);
+    }
+
+    return matcher;
+}
+
+void eProsimaInterfaceMatcher_delete(struct eProsima_InterfaceMatcher *matcher)
+{
+    if(matcher != NULL)
+    {
+        if(matcher->addressNodes != NULL)
+            RTIOsapiHeap_freeArray(matcher->addressNodes);
+
+        if(matcher->nameNodes != NULL)
+            RTIOsapiHeap_freeArray(matcher->nameNodes);
+
+        if(matcher->globs != NULL)
+            RTIOsapiHeap_freeArray(matcher->globs);
+
+        RTIOsapiHeap_freeStructure(matcher);
+    }
+}
+
+int eProsimaInterfaceMatcher_match(const struct eProsima_InterfaceMatcher *matcher, const char *name, unsigned int address)
+{
+    const char *auxName = NULL;
+    int node = 0, i = 0;
+
+    if(matcher == NULL)
+        return 0;
+
+    // Any prefix of the address that ends in a terminal node matches.
+    for(i = 0; node != 0 || i == 0; ++i)
+    {
+        if(matcher->addressNodes[node].terminal)
+            return 1;
+
+        if(i == 32)
+            break;
+
+        node = matcher->addressNodes[node].children[(address >> (31 - i)) & 1];
+    }
+
+    if(name != NULL)
+    {
+        for(node = 0, auxName = name; ; ++auxName)
+        {
+            if(matcher->nameNodes[node].anySuffix)
+                return 1;
+
+            if(*auxName == '\0')
+            {
+                if(matcher->nameNodes[node].terminal)
+                    return 1;
+
+                break;
+            }
+
+            for(node = matcher->nameNodes[node].firstChild; node != 0 && matcher->nameNodes[node].character != *auxName;
+                    node = matcher->nameNodes[node].nextSibling);
+
+            if(node == 0)
+                break;
+        }
+
+        for(i = 0; i < matcher->globsLength; ++i)
+        {
+            if(matchGlob(matcher->globs[i], name))
+                return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \brief This function stores an interface if there is room.
+ */
+static void addLocalInterface(const char *name, unsigned int address, struct LocalInterface *interfaces, int *interfacesLength)
+{
+    if(*interfacesLength < INTERFACES_MAX)
+    {
+        interfaces[*interfacesLength].name[0] = '\0';
+        if(name != NULL)
+            strncat(interfaces[*interfacesLength].name, name, INTERFACE_NAME_LENGTH - 1);
+        interfaces[*interfacesLength].address = address;
+        ++*interfacesLength;
+    }
+}
+
+/**
+ * \brief This function walks the IPv4 interfaces of the host.
+ *
+ * \return 0 if the interfaces were enumerated. In error case -1 is returned.
+ */
+static int findLocalInterfaces(struct LocalInterface *interfaces, int *interfacesLength)
+{
+#if defined(RTI_WIN32)
+    IP_ADAPTER_ADDRESSES *adapters = NULL, *adapter = NULL;
+    IP_ADAPTER_UNICAST_ADDRESS *unicast = NULL;
+    char name[INTERFACE_NAME_LENGTH];
+    ULONG size = 16384, result = ERROR_BUFFER_OVERFLOW;
+    int returnedValue = -1, tries = 0;
+
+    // The adapters can change between the calls, so the size is requested a few times.
+    for(tries = 0; tries < 3 && result == ERROR_BUFFER_OVERFLOW; ++tries)
+    {
+        if(adapters != NULL)
+            RTIOsapiHeap_freeArray(adapters);
+
+        RTIOsapiHeap_allocateArray(&adapters, size / sizeof(IP_ADAPTER_ADDRESSES) + 1, IP_ADAPTER_ADDRESSES);
+
+        if(adapters == NULL)
+            return returnedValue;
+
+        result = GetAdaptersAddresses(AF_INET, GAA_FLAG_SKIP_ANYCAST | GAA_FLAG_SKIP_MULTICAST | GAA_FLAG_SKIP_DNS_SERVER,
+                NULL, adapters, &size);
+    }
+
+    if(result == NO_ERROR)
+    {
+        for(adapter = adapters; adapter != NULL; adapter = adapter->Next)
+        {
+            // AdapterName is a GUID. The users know the adapters by their friendly name (i.e. "Ethernet").
+            if(WideCharToMultiByte(CP_UTF8, 0, adapter->FriendlyName, -1, name, sizeof(name), NULL, NULL) == 0)
+                name[0] = '\0';
+
+            for(unicast = adapter->FirstUnicastAddress; unicast != NULL; unicast = unicast->Next)
+            {
+                if(unicast->Address.lpSockaddr->sa_family == AF_INET)
+                {
+                    addLocalInterface(name[0] != '\0' ? name : adapter->AdapterName,
+                            ntohl(((struct sockaddr_in*)unicast->Address.lpSockaddr)->sin_addr.s_addr),
+                            interfaces, interfacesLength);
+                }
+            }
+        }
+
+        returnedValue = 0;
+    }
+
+    if(adapters != NULL)
+        RTIOsapiHeap_freeArray(adapters);
+
+    return returnedValue;
+#elif (defined(RTI_UNIX) || defined(RTI_LINUX))
+    struct ifaddrs *ifaddrsList = NULL, *auxInterface = NULL;
+
+    if(getifaddrs(&ifaddrsList) != 0)
+        return -1;
+
+    for(auxInterface = ifaddrsList; auxInterface != NULL; auxInterface = auxInterface->ifa_next)
+    {
+        if(auxInterface->ifa_addr != NULL && auxInterface->ifa_addr->sa_family == AF_INET)
+        {
+            addLocalInterface(auxInterface->ifa_name, ntohl(((struct sockaddr_in*)auxInterface->ifa_addr)->sin_addr.s_addr),
+                    interfaces, interfacesLength);
+        }
+    }
+
+    freeifaddrs(ifaddrsList);
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+/**
+ * \brief This function checks if some interface matches the matcher.
+ */
+static int matchAnyInterface(const struct eProsima_InterfaceMatcher *matcher, const struct LocalInterface *interfaces,
+        int interfacesLength)
+{
+    int i = 0;
+
+    for(i = 0; i < interfacesLength; ++i)
+    {
+        if(eProsimaInterfaceMatcher_match(matcher, interfaces[i].name, interfaces[i].address))
+            return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * \brief This function tells if the transport understands a pattern without resolving it: an interface
+ * name or an address without wildcards nor prefix length.
+ */
+static int isPlainPattern(const char *pattern)
+{
+    return strpbrk(pattern, "*?/") == NULL;
+}
+
+/**
+ * \brief This function adds a string to a list if it was not added before.
+ */
+static void addUniqueString(const char *string, const char **strings, int *stringsLength)
+{
+    int i = 0;
+
+    for(i = 0; i < *stringsLength; ++i)
+    {
+        if(strcmp(strings[i], string) == 0)
+            return;
+    }
+
+    if(*stringsLength < 2 * INTERFACES_MAX)
+        strings[(*stringsLength)++] = string;
+}
+
+int resolveInterfacesList(char ***list, int *listLength)
+{
+    const char* const METHOD_NAME = "resolveInterfacesList";
+    struct eProsima_InterfaceMatcher *matcher = NULL, *patternMatcher = NULL;
+    struct LocalInterface interfaces[INTERFACES_MAX];
+    char addresses[INTERFACES_MAX][ADDRESS_STRING_LENGTH];
+    const char *newStrings[2 * INTERFACES_MAX];
+    char **newList = NULL;
+    unsigned int address = 0;
+    int interfacesLength = 0, newStringsLength = 0, newListLength = 0, matched = 0, i = 0;
+
+    if(list == NULL || listLength == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return -1;
+    }
+
+    if(*list == NULL || *listLength <= 0)
+        return 0;
+
+    // Without the interfaces only the plain patterns are kept.
+    if(findLocalInterfaces(interfaces, &interfacesLength) != 0)
+    {
+        printf("ERROR<%s>: Cannot enumerate the network interfaces\n", METHOD_NAME);
+        interfacesLength = 0;
+    }
+
+    matcher = eProsimaInterfaceMatcher_new(*list, *listLength);
+
+    if(matcher == NULL)
+        return -1;
+
+    for(i = 0; i < interfacesLength; ++i)
+    {
+        if(eProsimaInterfaceMatcher_match(matcher, interfaces[i].name, interfaces[i].address))
+        {
+            address = interfaces[i].address;
+            sprintf(addresses[matched], "%u.%u.%u.%u", (address >> 24) & 0xff, (address >> 16) & 0xff,
+                    (address >> 8) & 0xff, address & 0xff);
+            addUniqueString(addresses[matched], newStrings, &newStringsLength);
+            ++matched;
+        }
+    }
+
+    eProsimaInterfaceMatcher_delete(matcher);
+
+    // The patterns that match no interface are kept if the transport understands them. The others would
+    // be passed as raw strings, so they are dropped.
+    for(i = 0; i < *listLength; ++i)
+    {
+        patternMatcher = eProsimaInterfaceMatcher_new(&(*list)[i], 1);
+
+        if(patternMatcher == NULL || !matchAnyInterface(patternMatcher, interfaces, interfacesLength))
+        {
+            if(isPlainPattern((*list)[i]))
+                addUniqueString((*list)[i], newStrings, &newStringsLength);
+            else
+                printf("WARNING<%s>: No interface matches %s. It is ignored\n", METHOD_NAME, (*list)[i]);
+        }
+
+        eProsimaInterfaceMatcher_delete(patternMatcher);
+    }
+
+    if(newStringsLength > 0 && copyPropertyStringList(newStrings, NULL, newStringsLength, &newList, &newListLength) != 0)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the interfaces\n", METHOD_NAME);
+        return -1;
+    }
+
+    RTIOsapiHeap_freeArray(*list);
+    *list = newList;
+    *listLength = newListLength;
+
+    return matched;
+}
@@ -0,0 +1,72 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_INTERFACEMATCHER_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_INTERFACEMATCHER_H_
+
+#include "eProsima_c/config.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/**
+ * \brief Precompiled set of interface patterns.
+ *
+ * The patterns can be:
+ * - Interface names ("eth0").
+ * - Interface names with wildcards ("eth*", "en?s0").
+ * - IPv4 addresses ("192.168.1.10") and addresses with a final wildcard ("192.168.*").
+ * - CIDR blocks ("10.0.0.0/8").
+ *
+ * The addresses are stored in a binary prefix trie and the names in a character trie, so matching an
+ * interface doesn't depend on the number of patterns.
+ */
+struct eProsima_InterfaceMatcher;
+
+/**
+ * \brief This function compiles a list of patterns.
+ *
+ * \param patterns The patterns. Cannot be NULL if patternsLength is greater than 0.
+ * \param patternsLength Number of patterns.
+ * \return The new matcher. In error case, NULL value is returned.
+ */
+struct eProsima_InterfaceMatcher* eProsimaInterfaceMatcher_new(char * const *patterns, int patternsLength);
+
+/**
+ * \brief This function destroys a matcher.
+ *
+ * \param matcher The matcher to destroy.
+ */
+void eProsimaInterfaceMatcher_delete(struct eProsima_InterfaceMatcher *matcher);
+
+/**
+ * \brief This function checks an interface against the patterns.
+ *
+ * \param matcher The matcher. Cannot be NULL.
+ * \param name The name of the interface. It can be NULL.
+ * \param address The IPv4 address of the interface in host byte order.
+ * \return 1 if the name or the address match some pattern. Otherwise 0.
+ */
+int eProsimaInterfaceMatcher_match(const struct eProsima_InterfaceMatcher *matcher, const char *name, unsigned int address);
+
+/**
+ * \brief This function replaces a list of patterns with the addresses of the local interfaces that
+ * match them.
+ *
+ * The local interfaces are enumerated once and each one is checked against the compiled patterns. In
+ * Windows systems the names of the interfaces are the friendly names of the adapters (i.e. "Ethernet").
+ * The patterns that match no interface are kept if they are plain names or addresses, which the
+ * transport understands. The wildcards and CIDR blocks that match no interface are dropped with a
+ * warning, so the list can become empty. The new list is built with copyPropertyStringList, so it is
+ * released with RTIOsapiHeap_freeArray(list).
+ *
+ * \param list The list of patterns. It was built with copyPropertyStringList. Cannot be NULL.
+ * \param listLength The length of the list. Cannot be NULL.
+ * \return Number of interfaces that match. In error case -1 is returned and the list is not modified.
+ */
+int resolveInterfacesList(char ***list, int *listLength);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_INTERFACEMATCHER_H_
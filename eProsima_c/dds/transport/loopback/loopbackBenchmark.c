@@ -0,0 +1,419 @@
+/* Ping-pong and throughput benchmark of transport plugins over the loopback transport. It doesn't use
+ * the network, so it runs in any Linux system.
+ *
+ * Usage: loopbackBenchmark [-m pingpong|throughput] [-s size] [-n count] [-w warmup] [-t pluginName] [-p name=value]...
+ *
+ * Without -t, the loopback transport is created directly with the -p properties. With -t, the transport is
+ * created with loadTransportPluginFromLibrary(pluginName, properties), so the cost of a chain of plugins
+ * over the loopback transport is the difference with the direct run. Build it with
+ * EPROSIMA_TRANSPORT_STATIC_PLUGINS defined to find the plugins of this library without shared libraries.
+ * Example:
+ *     loopbackBenchmark -m pingpong -t bench -p bench.library=eprosima_loopback -p bench.create_function=eProsimaLoopbackTransport_create
+ */
+
+#include "loopbackTransport.h"
+#include "../transportPluginCommon.h"
+
+#include <dds_c/dds_c_infrastructure.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCHMARK_PING_PORT 7401
+#define BENCHMARK_PONG_PORT 7400
+#define BENCHMARK_PROPERTY_NAME_LENGTH 256
+/// Time a message is retried while the receiver is full before the benchmark fails.
+#define BENCHMARK_SEND_TIMEOUT_NS 1000000000ULL
+/// Retries between two reads of the clock.
+#define BENCHMARK_SEND_RETRIES_PER_CHECK 1024
+
+enum BenchmarkMode
+{
+    BENCHMARK_PINGPONG,
+    BENCHMARK_THROUGHPUT
+};
+
+struct BenchmarkEndpoint
+{
+    NDDS_Transport_Plugin *plugin;
+    NDDS_Transport_RecvResource_t recvResource;
+    NDDS_Transport_SendResource_t sendResource;
+    NDDS_Transport_Address_t address;
+    char *buffer;
+};
+
+struct BenchmarkConfig
+{
+    enum BenchmarkMode mode;
+    int messageSize;
+    int count;
+    int warmup;
+    const char *pluginName;
+    struct DDS_PropertyQosPolicy properties;
+};
+
+struct BenchmarkReceiver
+{
+    struct BenchmarkEndpoint *endpoint;
+    /// Endpoint where messages are echoed in ping-pong mode. NULL in throughput mode.
+    struct BenchmarkEndpoint *echoEndpoint;
+    /// Endpoint that waits for the echoes. It is unblocked when an echo cannot be sent.
+    struct BenchmarkEndpoint *echoDestination;
+    int expected;
+    int received;
+    int failed;
+    unsigned long long bytes;
+    unsigned long long endTime;
+};
+
+static unsigned long long getTimeNs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+static int compareTimes(const void *a, const void *b)
+{
+    unsigned long long timeA = *(const unsigned long long*)a, timeB = *(const unsigned long long*)b;
+
+    return timeA < timeB ? -1 : (timeA > timeB ? 1 : 0);
+}
+
+/**
+ * \brief This function receives a message in the buffer of the endpoint or lent by the plugin.
+ *
+ * \return Length of the message. If the receive operation was unblocked or failed, 0 is returned.
+ */
+static int receiveMessage(struct BenchmarkEndpoint *endpoint, NDDS_Transport_Message_t *message)
+{
+    NDDS_Transport_Buffer_t buffer;
+
+    buffer.pointer = endpoint->buffer;
+    buffer.length = endpoint->plugin->property->message_size_max;
+    memset(message, 0, sizeof(NDDS_Transport_Message_t));
+
+    if(!endpoint->plugin->receive_rEA(endpoint->plugin, message, &buffer, &endpoint->recvResource, NULL))
+        return 0;
+
+    return message->buffer.length;
+}
+
+static void returnMessage(struct BenchmarkEndpoint *endpoint, NDDS_Transport_Message_t *message)
+{
+    if(message->loaned_buffer_param != NULL)
+        endpoint->plugin->return_loaned_buffer_rEA(endpoint->plugin, &endpoint->recvResource, message, NULL);
+}
+
+/**
+ * \brief This function sends a message. When the receiver is full, it retries for BENCHMARK_SEND_TIMEOUT_NS.
+ *
+ * \param retries Incremented with the number of retries. It can be NULL.
+ * \return 0 if the message was sent. In error case -1 is returned.
+ */
+static int sendMessage(struct BenchmarkEndpoint *endpoint, const NDDS_Transport_Port_t port,
+        char *data, int length, unsigned long long *retries)
+{
+    NDDS_Transport_Buffer_t buffer;
+    unsigned long long attempts = 0, deadline = 0;
+
+    buffer.pointer = data;
+    buffer.length = length;
+
+    while(!endpoint->plugin->send(endpoint->plugin, &endpoint->sendResource, &endpoint->address, port, 0, &buffer, 1, NULL))
+    {
+        if(retries != NULL)
+            ++*retries;
+
+        if(++attempts % BENCHMARK_SEND_RETRIES_PER_CHECK == 1)
+        {
+            if(deadline == 0)
+                deadline = getTimeNs() + BENCHMARK_SEND_TIMEOUT_NS;
+            else if(getTimeNs() >= deadline)
+            {
+                printf("ERROR<sendMessage>: The message was not accepted after %llu retries\n", attempts);
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void* receiverThread(void *arg)
+{
+    struct BenchmarkReceiver *receiver = (struct BenchmarkReceiver*)arg;
+    NDDS_Transport_Message_t message;
+    int length = 0;
+
+    while(receiver->received < receiver->expected && (length = receiveMessage(receiver->endpoint, &message)) > 0)
+    {
+        if(receiver->echoEndpoint != NULL &&
+                sendMessage(receiver->echoEndpoint, BENCHMARK_PING_PORT, message.buffer.pointer, length, NULL) != 0)
+        {
+            returnMessage(receiver->endpoint, &message);
+            receiver->failed = 1;
+            receiver->echoDestination->plugin->unblock_receive_rrEA(receiver->echoDestination->plugin,
+                    &receiver->echoDestination->recvResource, NULL);
+            break;
+        }
+
+        returnMessage(receiver->endpoint, &message);
+        ++receiver->received;
+        receiver->bytes += (unsigned long long)length;
+    }
+
+    receiver->endTime = getTimeNs();
+    return NULL;
+}
+
+static int createEndpoint(const struct BenchmarkConfig *config, struct BenchmarkEndpoint *endpoint,
+        NDDS_Transport_Port_t recvPort, NDDS_Transport_Port_t sendPort)
+{
+    NDDS_Transport_Address_t networkAddress;
+
+    memset(endpoint, 0, sizeof(struct BenchmarkEndpoint));
+
+    if(config->pluginName != NULL)
+        endpoint->plugin = loadTransportPluginFromLibrary(config->pluginName, &config->properties, &networkAddress);
+    else
+        endpoint->plugin = eProsimaLoopbackTransport_create(&networkAddress, &config->properties);
+
+    if(endpoint->plugin == NULL)
+        return -1;
+
+    endpoint->buffer = (char*)malloc((size_t)endpoint->plugin->property->message_size_max);
+
+    if(endpoint->buffer == NULL || !endpoint->plugin->string_to_address_cEA(endpoint->plugin, &endpoint->address, "") ||
+            !endpoint->plugin->create_recvresource_rrEA(endpoint->plugin, &endpoint->recvResource, &recvPort, NULL, 0) ||
+            !endpoint->plugin->create_sendresource_srEA(endpoint->plugin, &endpoint->sendResource, &endpoint->address, sendPort, 0))
+        return -1;
+
+    return 0;
+}
+
+static void deleteEndpoint(struct BenchmarkEndpoint *endpoint)
+{
+    if(endpoint->plugin != NULL)
+    {
+        if(endpoint->sendResource != NULL)
+            endpoint->plugin->destroy_sendresource_srEA(endpoint->plugin, &endpoint->sendResource);
+        if(endpoint->recvResource != NULL)
+            endpoint->plugin->destroy_recvresource_rrEA(endpoint->plugin, &endpoint->recvResource);
+
+        endpoint->plugin->delete_cEA(endpoint->plugin, NULL);
+    }
+
+    free(endpoint->buffer);
+}
+
+/**
+ * \return 0 if the benchmark finished. In error case -1 is returned.
+ */
+static int runPingPong(const struct BenchmarkConfig *config, struct BenchmarkEndpoint *ping, struct BenchmarkEndpoint *pong)
+{
+    struct BenchmarkReceiver receiver;
+    NDDS_Transport_Message_t message;
+    unsigned long long *times = (unsigned long long*)malloc((size_t)config->count * sizeof(unsigned long long));
+    unsigned long long start = 0, total = 0;
+    char *data = (char*)calloc(1, (size_t)config->messageSize);
+    pthread_t thread;
+    int i = 0;
+
+    if(times == NULL || data == NULL)
+    {
+        printf("ERROR<runPingPong>: Cannot allocate memory\n");
+        free(times);
+        free(data);
+        return -1;
+    }
+
+    memset(&receiver, 0, sizeof(receiver));
+    receiver.endpoint = pong;
+    receiver.echoEndpoint = pong;
+    receiver.echoDestination = ping;
+    receiver.expected = config->warmup + config->count;
+    pthread_create(&thread, NULL, receiverThread, &receiver);
+
+    for(i = 0; i < config->warmup + config->count; ++i)
+    {
+        start = getTimeNs();
+
+        if(sendMessage(ping, BENCHMARK_PONG_PORT, data, config->messageSize, NULL) != 0 ||
+                receiveMessage(ping, &message) == 0)
+            break;
+
+        returnMessage(ping, &message);
+
+        if(i >= config->warmup)
+            times[i - config->warmup] = getTimeNs() - start;
+    }
+
+    pong->plugin->unblock_receive_rrEA(pong->plugin, &pong->recvResource, NULL);
+    pthread_join(thread, NULL);
+
+    if(i == config->warmup + config->count && !receiver.failed)
+    {
+        qsort(times, (size_t)config->count, sizeof(unsigned long long), compareTimes);
+
+        for(i = 0; i < config->count; ++i)
+            total += times[i];
+
+        printf("pingpong size=%d count=%d round trip (us): min=%.3f mean=%.3f p50=%.3f p90=%.3f p99=%.3f max=%.3f\n",
+                config->messageSize, config->count, times[0] / 1000.0, total / 1000.0 / config->count,
+                times[config->count / 2] / 1000.0, times[config->count * 9 / 10] / 1000.0,
+                times[config->count * 99 / 100] / 1000.0, times[config->count - 1] / 1000.0);
+    }
+    else
+    {
+        printf("ERROR<runPingPong>: The round trip %d failed\n", i);
+        i = -1;
+    }
+
+    free(times);
+    free(data);
+    return i < 0 ? -1 : 0;
+}
+
+/**
+ * \return 0 if the benchmark finished. In error case -1 is returned.
+ */
+static int runThroughput(const struct BenchmarkConfig *config, struct BenchmarkEndpoint *sender, struct BenchmarkEndpoint *receiverEndpoint)
+{
+    struct BenchmarkReceiver receiver;
+    unsigned long long start = 0, retries = 0;
+    char *data = (char*)calloc(1, (size_t)config->messageSize);
+    double seconds = 0;
+    pthread_t thread;
+    int i = 0;
+
+    if(data == NULL)
+    {
+        printf("ERROR<runThroughput>: Cannot allocate memory\n");
+        return -1;
+    }
+
+    memset(&receiver, 0, sizeof(receiver));
+    receiver.endpoint = receiverEndpoint;
+    receiver.expected = config->warmup + config->count;
+    pthread_create(&thread, NULL, receiverThread, &receiver);
+
+    for(i = 0; i < config->warmup && sendMessage(sender, BENCHMARK_PONG_PORT, data, config->messageSize, NULL) == 0; ++i)
+        ;
+
+    start = getTimeNs();
+
+    if(i == config->warmup)
+    {
+        for(i = 0; i < config->count && sendMessage(sender, BENCHMARK_PONG_PORT, data, config->messageSize, &retries) == 0; ++i)
+            ;
+    }
+    else
+        i = -1;
+
+    // The receiver waits for all the messages, so it is unblocked when some of them were not sent.
+    if(i != config->count)
+        receiverEndpoint->plugin->unblock_receive_rrEA(receiverEndpoint->plugin, &receiverEndpoint->recvResource, NULL);
+
+    pthread_join(thread, NULL);
+    free(data);
+
+    if(i != config->count)
+    {
+        printf("ERROR<runThroughput>: Send operation failed\n");
+        return -1;
+    }
+
+    seconds = (receiver.endTime - start) / 1e9;
+    printf("throughput size=%d count=%d: %.0f msg/s %.2f MB/s (full receiver retries=%llu)\n",
+            config->messageSize, config->count, config->count / seconds,
+            (double)config->count * config->messageSize / seconds / 1e6, retries);
+
+    return 0;
+}
+
+static int parseArguments(int argc, char **argv, struct BenchmarkConfig *config)
+{
+    char name[BENCHMARK_PROPERTY_NAME_LENGTH];
+    const char *value = NULL;
+    int i = 0;
+
+    for(i = 1; i + 1 < argc; i += 2)
+    {
+        if(strcmp(argv[i], "-m") == 0)
+        {
+            if(strcmp(argv[i + 1], "pingpong") == 0)
+                config->mode = BENCHMARK_PINGPONG;
+            else if(strcmp(argv[i + 1], "throughput") == 0)
+                config->mode = BENCHMARK_THROUGHPUT;
+            else
+                return -1;
+        }
+        else if(strcmp(argv[i], "-s") == 0)
+            config->messageSize = atoi(argv[i + 1]);
+        else if(strcmp(argv[i], "-n") == 0)
+            config->count = atoi(argv[i + 1]);
+        else if(strcmp(argv[i], "-w") == 0)
+            config->warmup = atoi(argv[i + 1]);
+        else if(strcmp(argv[i], "-t") == 0)
+            config->pluginName = argv[i + 1];
+        else if(strcmp(argv[i], "-p") == 0 && (value = strchr(argv[i + 1], '=')) != NULL &&
+                value - argv[i + 1] < BENCHMARK_PROPERTY_NAME_LENGTH)
+        {
+            memcpy(name, argv[i + 1], (size_t)(value - argv[i + 1]));
+            name[value - argv[i + 1]] = '\0';
+            DDS_PropertyQosPolicyHelper_add_property(&config->properties, name, value + 1, DDS_BOOLEAN_FALSE);
+        }
+        else
+            return -1;
+    }
+
+    return i == argc && config->messageSize > 0 && config->count > 0 && config->warmup >= 0 ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+    struct BenchmarkConfig config = {BENCHMARK_PINGPONG, 64, 100000, 1000, NULL, DDS_PropertyQosPolicy_INITIALIZER};
+    struct BenchmarkEndpoint ping, pong;
+    int returnedValue = 1;
+
+    memset(&ping, 0, sizeof(ping));
+    memset(&pong, 0, sizeof(pong));
+
+    if(parseArguments(argc, argv, &config) != 0)
+    {
+        printf("Usage: %s [-m pingpong|throughput] [-s size] [-n count] [-w warmup] [-t pluginName] [-p name=value]...\n", argv[0]);
+        DDS_PropertyQosPolicy_finalize(&config.properties);
+        return 1;
+    }
+
+    if(createEndpoint(&config, &pong, BENCHMARK_PONG_PORT, BENCHMARK_PING_PORT) == 0 &&
+            createEndpoint(&config, &ping, BENCHMARK_PING_PORT, BENCHMARK_PONG_PORT) == 0)
+    {
+        if(config.messageSize <= ping.plugin->property->message_size_max)
+        {
+            if(config.mode == BENCHMARK_PINGPONG)
+                returnedValue = runPingPong(&config, &ping, &pong) == 0 ? 0 : 1;
+            else
+                returnedValue = runThroughput(&config, &ping, &pong) == 0 ? 0 : 1;
+        }
+        else
+        {
+            printf("ERROR<main>: The size is bigger than parent.message_size_max\n");
+        }
+    }
+    else
+    {
+        printf("ERROR<main>: Cannot create the transport\n");
+    }
+
+    deleteEndpoint(&ping);
+    deleteEndpoint(&pong);
+    DDS_PropertyQosPolicy_finalize(&config.properties);
+
+    return returnedValue;
+}
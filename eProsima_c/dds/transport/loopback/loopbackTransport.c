@@ -0,0 +1,519 @@
+#include "loopbackTransport.h"
+#include "../transportClassIds.h"
+#include "../transportPropertyParser.h"
+#include "../../../sys/atomic.h"
+#include "../../../sys/messageRing.h"
+#include "../../../sys/eProsimaDL.h"
+
+#include <osapi/osapi_heap.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define LOOPBACK_CLASS_NAME "eprosima_loopback"
+#define LOOPBACK_ADDRESS "loopback"
+
+/// Alignment of the rings.
+#define LOOPBACK_RING_ALIGNMENT 64
+
+#if defined(EPROSIMA_TRANSPORT_STATIC_PLUGINS)
+EPROSIMA_DL_REGISTER_SYMBOL(LOOPBACK_CLASS_NAME, eProsimaLoopbackTransport_create)
+#endif
+
+struct LoopbackTransportConfig
+{
+    int messageSizeMax;
+    int gatherSendBufferCountMax;
+    int receivedMessageCountMax;
+};
+
+static const struct eProsima_PropertyDescriptor LoopbackPropertyDescriptors[] =
+{
+    EPROSIMA_PROPERTY_INT(struct LoopbackTransportConfig, "parent.message_size_max", messageSizeMax, 1, INT_MAX, 65536),
+    EPROSIMA_PROPERTY_INT(struct LoopbackTransportConfig, "parent.gather_send_buffer_count_max", gatherSendBufferCountMax,
+            NDDS_TRANSPORT_PROPERTY_GATHER_SEND_BUFFER_COUNT_MIN, INT_MAX, 16),
+    EPROSIMA_PROPERTY_INT(struct LoopbackTransportConfig, "received_message_count_max", receivedMessageCountMax, 1, 65536, 256)
+};
+
+/**
+ * \brief Ring of a port. It is referenced by its receive resource and by the send resources that
+ * send to the port, so it is freed when the last of them is destroyed.
+ */
+struct LoopbackEndpoint
+{
+    struct LoopbackEndpoint *next;
+    NDDS_Transport_Port_t port;
+    /// Receive resource, send resources and sends in progress. It is changed atomically.
+    int references;
+    /// Set when the receive resource is destroyed. Senders drop their reference.
+    int closed;
+    char *memory;
+    struct eProsima_MessageRing *ring;
+};
+
+struct LoopbackTransport
+{
+    /// It has to be the first field.
+    NDDS_Transport_Plugin parent;
+    struct NDDS_Transport_Property_t property;
+    struct LoopbackTransportConfig config;
+    NDDS_Transport_Listener *listener;
+};
+
+struct LoopbackSendResource
+{
+    /// The endpoint is found when the receiver exists. It is replaced holding the lock.
+    struct LoopbackEndpoint *endpoint;
+    int lock;
+    NDDS_Transport_Port_t port;
+};
+
+/// Open endpoints of the process. The list is only used when resources are created, so a spin lock is enough.
+static struct LoopbackEndpoint *LoopbackEndpoints = NULL;
+static int LoopbackEndpointsLock = 0;
+
+static void lockEndpoints(void)
+{
+    while(!EPROSIMA_ATOMIC_CAS32(&LoopbackEndpointsLock, 0, 1))
+        EPROSIMA_CPU_RELAX();
+}
+
+static void unlockEndpoints(void)
+{
+    EPROSIMA_ATOMIC_STORE32(&LoopbackEndpointsLock, 0);
+}
+
+static struct LoopbackEndpoint* findEndpoint(NDDS_Transport_Port_t port)
+{
+    struct LoopbackEndpoint *auxEndpoint = NULL;
+
+    for(auxEndpoint = LoopbackEndpoints; auxEndpoint != NULL && auxEndpoint->port != port; auxEndpoint = auxEndpoint->next);
+
+    return auxEndpoint;
+}
+
+static void freeEndpoint(struct LoopbackEndpoint *endpoint)
+{
+    if(endpoint->memory != NULL)
+        RTIOsapiHeap_freeArray(endpoint->memory);
+
+    RTIOsapiHeap_freeStructure(endpoint);
+}
+
+/**
+ * \brief This function creates the endpoint of a port.
+ *
+ * \return The new endpoint. If the port is used or there is no memory, NULL value is returned.
+ */
+static struct LoopbackEndpoint* openEndpoint(const struct LoopbackTransport *transport, NDDS_Transport_Port_t port)
+{
+    struct LoopbackEndpoint *endpoint = NULL;
+    size_t ringSize = eProsimaMessageRing_getSize(transport->config.receivedMessageCountMax, transport->config.messageSizeMax);
+    size_t misalignment = 0;
+    int used = 0;
+
+    RTIOsapiHeap_allocateStructure(&endpoint, struct LoopbackEndpoint);
+
+    if(endpoint == NULL)
+        return NULL;
+
+    memset(endpoint, 0, sizeof(struct LoopbackEndpoint));
+    endpoint->port = port;
+    endpoint->references = 1;
+    RTIOsapiHeap_allocateArray(&endpoint->memory, ringSize + LOOPBACK_RING_ALIGNMENT, char);
+
+    if(endpoint->memory != NULL)
+    {
+        misalignment = (size_t)endpoint->memory % LOOPBACK_RING_ALIGNMENT;
+        endpoint->ring = eProsimaMessageRing_init(endpoint->memory + (misalignment != 0 ? LOOPBACK_RING_ALIGNMENT - misalignment : 0),
+                transport->config.receivedMessageCountMax, transport->config.messageSizeMax);
+    }
+
+    if(endpoint->ring == NULL)
+    {
+        freeEndpoint(endpoint);
+        return NULL;
+    }
+
+    lockEndpoints();
+
+    // Once it is listed, senders change the references.
+    used = findEndpoint(port) != NULL;
+
+    if(!used)
+    {
+        endpoint->next = LoopbackEndpoints;
+        LoopbackEndpoints = endpoint;
+    }
+
+    unlockEndpoints();
+
+    if(used)
+    {
+        freeEndpoint(endpoint);
+        return NULL;
+    }
+
+    return endpoint;
+}
+
+static struct LoopbackEndpoint* acquireEndpoint(NDDS_Transport_Port_t port)
+{
+    struct LoopbackEndpoint *endpoint = NULL;
+
+    lockEndpoints();
+
+    endpoint = findEndpoint(port);
+
+    // A listed endpoint is referenced by its receive resource, so it is not freed meanwhile.
+    if(endpoint != NULL)
+        EPROSIMA_ATOMIC_ADD32(&endpoint->references, 1);
+
+    unlockEndpoints();
+
+    return endpoint;
+}
+
+static void releaseEndpoint(struct LoopbackEndpoint *endpoint)
+{
+    if(EPROSIMA_ATOMIC_ADD32(&endpoint->references, -1) == 0)
+        freeEndpoint(endpoint);
+}
+
+/**
+ * \brief This function returns the endpoint of a send resource with a reference for the caller. If the
+ * receiver was closed, the endpoint of the new receiver is looked for.
+ *
+ * \return The endpoint. It is released with releaseEndpoint. If there is no receiver, NULL value is returned.
+ */
+static struct LoopbackEndpoint* holdEndpoint(struct LoopbackSendResource *resource)
+{
+    struct LoopbackEndpoint *endpoint = NULL, *closedEndpoint = NULL;
+
+    while(!EPROSIMA_ATOMIC_CAS32(&resource->lock, 0, 1))
+        EPROSIMA_CPU_RELAX();
+
+    endpoint = resource->endpoint;
+
+    if(endpoint != NULL && EPROSIMA_ATOMIC_LOAD32(&endpoint->closed))
+    {
+        closedEndpoint = endpoint;
+        endpoint = NULL;
+    }
+
+    // The receiver could be created after the send resource.
+    if(endpoint == NULL)
+    {
+        endpoint = acquireEndpoint(resource->port);
+        resource->endpoint = endpoint;
+    }
+
+    // The reference of the resource keeps it while the lock is held.
+    if(endpoint != NULL)
+        EPROSIMA_ATOMIC_ADD32(&endpoint->references, 1);
+
+    EPROSIMA_ATOMIC_STORE32(&resource->lock, 0);
+
+    // Sends in progress keep their own reference.
+    if(closedEndpoint != NULL)
+        releaseEndpoint(closedEndpoint);
+
+    return endpoint;
+}
+
+static void closeEndpoint(struct LoopbackEndpoint *endpoint)
+{
+    struct LoopbackEndpoint **auxEndpoint = NULL;
+
+    lockEndpoints();
+
+    for(auxEndpoint = &LoopbackEndpoints; *auxEndpoint != NULL && *auxEndpoint != endpoint; auxEndpoint = &(*auxEndpoint)->next);
+
+    if(*auxEndpoint != NULL)
+        *auxEndpoint = endpoint->next;
+
+    EPROSIMA_ATOMIC_STORE32(&endpoint->closed, 1);
+
+    unlockEndpoints();
+
+    releaseEndpoint(endpoint);
+}
+
+static void setLoopbackAddress(NDDS_Transport_Address_t *address)
+{
+    memset(address, 0, sizeof(NDDS_Transport_Address_t));
+    address->network_ordered_value[15] = 1;
+}
+
+static int isLoopbackAddress(const NDDS_Transport_Address_t *address)
+{
+    NDDS_Transport_Address_t loopbackAddress;
+
+    setLoopbackAddress(&loopbackAddress);
+    return memcmp(address, &loopbackAddress, sizeof(NDDS_Transport_Address_t)) == 0;
+}
+
+static RTI_INT32 LoopbackTransport_send(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in,
+        const NDDS_Transport_Buffer_t buffer_in[], RTI_INT32 buffer_count_in, void *reserved)
+{
+    struct LoopbackEndpoint *endpoint = holdEndpoint((struct LoopbackSendResource*)*sendresource_in);
+    unsigned long long ticket = 0;
+    unsigned int length = 0;
+    char *message = NULL;
+    RTI_INT32 i = 0, returnedValue = RTI_FALSE;
+
+    if(endpoint == NULL)
+        return RTI_FALSE;
+
+    for(i = 0; i < buffer_count_in; ++i)
+        length += buffer_in[i].length;
+
+    // Like a full socket buffer, a full ring drops the message.
+    if(length <= eProsimaMessageRing_getMessageSizeMax(endpoint->ring) &&
+            (message = (char*)eProsimaMessageRing_reserve(endpoint->ring, &ticket)) != NULL)
+    {
+        for(i = 0, length = 0; i < buffer_count_in; ++i)
+        {
+            memcpy(message + length, buffer_in[i].pointer, buffer_in[i].length);
+            length += buffer_in[i].length;
+        }
+
+        eProsimaMessageRing_commit(endpoint->ring, ticket, length);
+        returnedValue = RTI_TRUE;
+    }
+
+    releaseEndpoint(endpoint);
+
+    return returnedValue;
+}
+
+static RTI_INT32 LoopbackTransport_receive_rEA(NDDS_Transport_Plugin *self, NDDS_Transport_Message_t *message_out,
+        const NDDS_Transport_Buffer_t *buffer_in, const NDDS_Transport_RecvResource_t *recvresource_in, void *reserved)
+{
+    struct LoopbackEndpoint *endpoint = (struct LoopbackEndpoint*)*recvresource_in;
+    unsigned int length = 0;
+    char *message = (char*)eProsimaMessageRing_take(endpoint->ring, &length, 1);
+
+    if(message != NULL)
+    {
+        // The message is lent without copying it. It is released in return_loaned_buffer_rEA.
+        message_out->buffer.pointer = message;
+        message_out->buffer.length = (RTI_INT32)length;
+        message_out->loaned_buffer_param = message;
+    }
+    else
+    {
+        // Unblocked by unblock_receive_rrEA.
+        message_out->buffer.length = 0;
+        message_out->loaned_buffer_param = NULL;
+    }
+
+    return RTI_TRUE;
+}
+
+static void LoopbackTransport_return_loaned_buffer_rEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        NDDS_Transport_Message_t *message_in, void *reserved)
+{
+    struct LoopbackEndpoint *endpoint = (struct LoopbackEndpoint*)*recvresource_in;
+
+    if(message_in->loaned_buffer_param != NULL)
+        eProsimaMessageRing_release(endpoint->ring, message_in->loaned_buffer_param);
+
+    message_in->loaned_buffer_param = NULL;
+}
+
+static RTI_INT32 LoopbackTransport_unblock_receive_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        void *reserved)
+{
+    eProsimaMessageRing_unblock(((struct LoopbackEndpoint*)*recvresource_in)->ring);
+    return RTI_TRUE;
+}
+
+static RTI_INT32 LoopbackTransport_create_recvresource_rrEA(NDDS_Transport_Plugin *self, NDDS_Transport_RecvResource_t *recvresource_out,
+        NDDS_Transport_Port_t *port_inout, const NDDS_Transport_Address_t *multicast_address_in, RTI_INT32 reserved)
+{
+    struct LoopbackEndpoint *endpoint = NULL;
+
+    if(multicast_address_in != NULL)
+        return RTI_FALSE;
+
+    // If the port is used by other participant, the middleware tries other port.
+    endpoint = openEndpoint((struct LoopbackTransport*)self, *port_inout);
+
+    if(endpoint == NULL)
+        return RTI_FALSE;
+
+    *recvresource_out = endpoint;
+    return RTI_TRUE;
+}
+
+static void LoopbackTransport_destroy_recvresource_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in)
+{
+    closeEndpoint((struct LoopbackEndpoint*)*recvresource_in);
+}
+
+static RTI_INT32 LoopbackTransport_share_recvresource_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        const NDDS_Transport_Port_t port_in, const NDDS_Transport_Address_t *multicast_address_in, RTI_INT32 reserved)
+{
+    return multicast_address_in == NULL && ((struct LoopbackEndpoint*)*recvresource_in)->port == port_in;
+}
+
+static RTI_INT32 LoopbackTransport_unshare_recvresource_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        const NDDS_Transport_Port_t port_in, const NDDS_Transport_Address_t *multicast_address_in, RTI_INT32 reserved)
+{
+    return RTI_TRUE;
+}
+
+static RTI_INT32 LoopbackTransport_create_sendresource_srEA(NDDS_Transport_Plugin *self, NDDS_Transport_SendResource_t *sendresource_out,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in)
+{
+    struct LoopbackSendResource *resource = NULL;
+
+    if(!isLoopbackAddress(dest_address_in))
+        return RTI_FALSE;
+
+    RTIOsapiHeap_allocateStructure(&resource, struct LoopbackSendResource);
+
+    if(resource == NULL)
+        return RTI_FALSE;
+
+    resource->port = dest_port_in;
+    resource->lock = 0;
+    resource->endpoint = acquireEndpoint(dest_port_in);
+
+    *sendresource_out = resource;
+    return RTI_TRUE;
+}
+
+static void LoopbackTransport_destroy_sendresource_srEA(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in)
+{
+    struct LoopbackSendResource *resource = (struct LoopbackSendResource*)*sendresource_in;
+
+    if(resource->endpoint != NULL)
+        releaseEndpoint(resource->endpoint);
+
+    RTIOsapiHeap_freeStructure(resource);
+}
+
+static RTI_INT32 LoopbackTransport_share_sendresource_srEA(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in)
+{
+    return ((struct LoopbackSendResource*)*sendresource_in)->port == dest_port_in && isLoopbackAddress(dest_address_in);
+}
+
+static RTI_INT32 LoopbackTransport_unshare_sendresource_srEA(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in)
+{
+    return RTI_TRUE;
+}
+
+static const char* LoopbackTransport_get_class_name_cEA(NDDS_Transport_Plugin *self)
+{
+    return LOOPBACK_CLASS_NAME;
+}
+
+static RTI_INT32 LoopbackTransport_string_to_address_cEA(NDDS_Transport_Plugin *self, NDDS_Transport_Address_t *address_out,
+        const char *address_in)
+{
+    if(address_in != NULL && address_in[0] != '\0' && strcmp(address_in, LOOPBACK_ADDRESS) != 0)
+        return RTI_FALSE;
+
+    setLoopbackAddress(address_out);
+    return RTI_TRUE;
+}
+
+static RTI_INT32 LoopbackTransport_get_receive_interfaces_cEA(NDDS_Transport_Plugin *self, RTI_INT32 *found_more_than_provided_for_out,
+        RTI_INT32 *interface_reported_count_out, NDDS_Transport_Interface_t interface_array_inout[], RTI_INT32 interface_array_size_in)
+{
+    struct LoopbackTransport *transport = (struct LoopbackTransport*)self;
+
+    *found_more_than_provided_for_out = interface_array_size_in < 1;
+    *interface_reported_count_out = 0;
+
+    if(interface_array_size_in >= 1)
+    {
+        interface_array_inout[0].transport_classid = transport->property.classid;
+        setLoopbackAddress(&interface_array_inout[0].address);
+        interface_array_inout[0].status = NDDS_TRANSPORT_INTERFACE_STATUS_ENABLED;
+        interface_array_inout[0].rank = 0;
+        *interface_reported_count_out = 1;
+    }
+
+    return RTI_TRUE;
+}
+
+static RTI_INT32 LoopbackTransport_register_listener_cEA(NDDS_Transport_Plugin *self, NDDS_Transport_Listener *listener_in)
+{
+    ((struct LoopbackTransport*)self)->listener = listener_in;
+    return RTI_TRUE;
+}
+
+static void LoopbackTransport_delete_cEA(NDDS_Transport_Plugin *self, void *reserved)
+{
+    RTIOsapiHeap_freeStructure((struct LoopbackTransport*)self);
+}
+
+NDDS_Transport_Plugin* eProsimaLoopbackTransport_create(NDDS_Transport_Address_t *default_network_address_out,
+        const struct DDS_PropertyQosPolicy *property_in)
+{
+    const char* const METHOD_NAME = "eProsimaLoopbackTransport_create";
+    struct LoopbackTransport *transport = NULL;
+
+    if(property_in == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    RTIOsapiHeap_allocateStructure(&transport, struct LoopbackTransport);
+
+    if(transport == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the transport\n", METHOD_NAME);
+        return NULL;
+    }
+
+    memset(transport, 0, sizeof(struct LoopbackTransport));
+    transport->config.messageSizeMax = 65536;
+    transport->config.gatherSendBufferCountMax = 16;
+    transport->config.receivedMessageCountMax = 256;
+    if(parseTransportProperties(property_in, "", LoopbackPropertyDescriptors,
+                sizeof(LoopbackPropertyDescriptors) / sizeof(LoopbackPropertyDescriptors[0]), &transport->config) < 0)
+    {
+        printf("ERROR<%s>: Cannot parse the properties\n", METHOD_NAME);
+        RTIOsapiHeap_freeStructure(transport);
+        return NULL;
+    }
+
+    transport->property.classid = EPROSIMA_TRANSPORT_CLASSID_LOOPBACK;
+    transport->property.address_bit_count = 0;
+    transport->property.properties_bitmap = NDDS_TRANSPORT_PROPERTY_BIT_BUFFER_ALWAYS_LOANED;
+    transport->property.gather_send_buffer_count_max = transport->config.gatherSendBufferCountMax;
+    transport->property.message_size_max = transport->config.messageSizeMax;
+
+    transport->parent.property = &transport->property;
+    transport->parent.send = LoopbackTransport_send;
+    transport->parent.receive_rEA = LoopbackTransport_receive_rEA;
+    transport->parent.return_loaned_buffer_rEA = LoopbackTransport_return_loaned_buffer_rEA;
+    transport->parent.unblock_receive_rrEA = LoopbackTransport_unblock_receive_rrEA;
+    transport->parent.create_recvresource_rrEA = LoopbackTransport_create_recvresource_rrEA;
+    transport->parent.destroy_recvresource_rrEA = LoopbackTransport_destroy_recvresource_rrEA;
+    transport->parent.share_recvresource_rrEA = LoopbackTransport_share_recvresource_rrEA;
+    transport->parent.unshare_recvresource_rrEA = LoopbackTransport_unshare_recvresource_rrEA;
+    transport->parent.create_sendresource_srEA = LoopbackTransport_create_sendresource_srEA;
+    transport->parent.destroy_sendresource_srEA = LoopbackTransport_destroy_sendresource_srEA;
+    transport->parent.share_sendresource_srEA = LoopbackTransport_share_sendresource_srEA;
+    transport->parent.unshare_sendresource_srEA = LoopbackTransport_unshare_sendresource_srEA;
+    transport->parent.get_class_name_cEA = LoopbackTransport_get_class_name_cEA;
+    transport->parent.string_to_address_cEA = LoopbackTransport_string_to_address_cEA;
+    transport->parent.get_receive_interfaces_cEA = LoopbackTransport_get_receive_interfaces_cEA;
+    transport->parent.register_listener_cEA = LoopbackTransport_register_listener_cEA;
+    transport->parent.delete_cEA = LoopbackTransport_delete_cEA;
+
+    // The network address is the whole address.
+    if(default_network_address_out != NULL)
+        setLoopbackAddress(default_network_address_out);
+
+    return &transport->parent;
+}
@@ -0,0 +1,42 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_LOOPBACK_LOOPBACKTRANSPORT_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_LOOPBACK_LOOPBACKTRANSPORT_H_
+
+#include "eProsima_c/config.h"
+
+#include <transport/transport_interface.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+struct DDS_PropertyQosPolicy;
+
+/**
+ * \brief This function creates a transport that only communicates the participants of the same process.
+ * Messages are copied into a lock-free ring of the receive resource and lent to the receiver.
+ *
+ * It doesn't use the network, so it measures the cost of the transport plugins that wrap it. All the
+ * instances of the process share the address "loopback" (or empty string) and ports are unique in the process.
+ *
+ * It has the signature of NDDS_Transport_create_plugin, so it can be loaded with loadTransportPluginFromLibrary:
+ *     pluginName.library = eprosima_loopback (or the name of the shared library)
+ *     pluginName.create_function = eProsimaLoopbackTransport_create
+ *
+ * The properties are received without the prefix "pluginName.":
+ *     parent.message_size_max: Maximum size of a message. Default 65536.
+ *     parent.gather_send_buffer_count_max: Maximum number of buffers of a message. Default 16.
+ *     received_message_count_max: Number of messages a receive resource can store. Default 256.
+ *
+ * \param default_network_address_out Network address of the transport.
+ * \param property_in Properties of the transport.
+ * \return The new transport. In error case, NULL value is returned.
+ */
+NDDS_Transport_Plugin* eProsimaLoopbackTransport_create(NDDS_Transport_Address_t *default_network_address_out,
+        const struct DDS_PropertyQosPolicy *property_in);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_LOOPBACK_LOOPBACKTRANSPORT_H_
@@ -0,0 +1,779 @@
+#include "shmemTransport.h"
+#include "../transportClassIds.h"
+#include "../transportPropertyParser.h"
+#include "../../../sys/atomic.h"
+#include "../../../sys/messageRing.h"
+#include "../../../sys/eProsimaDL.h"
+#include "../../../macros/snprintf.h"
+
+#include <dds_c/dds_c_infrastructure.h>
+#include <osapi/osapi_heap.h>
+#include <osapi/osapi_semaphore.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(RTI_UNIX) || defined(RTI_LINUX)
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#define SHMEM_TRANSPORT_SUPPORTED
+#endif
+
+#define SHMEM_CLASS_NAME "eprosima_shmem"
+#define SHMEM_SEGMENT_NAME_LENGTH 64
+#define SHMEM_SEGMENT_PREFIX_DEFAULT "eprosima_shmem"
+#define SHMEM_HOST_NAME_LENGTH 256
+
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME 16777619U
+
+/// Only the user of the receiver can write in its segments.
+#define SHMEM_SEGMENT_PERMISSIONS_DEFAULT 0600
+
+/// Space before the ring. The ring must be aligned to 64 bytes.
+#define SHMEM_SEGMENT_HEADER_SIZE 64
+
+#if defined(EPROSIMA_TRANSPORT_STATIC_PLUGINS)
+EPROSIMA_DL_REGISTER_SYMBOL(SHMEM_CLASS_NAME, eProsimaShmemTransport_create)
+#endif
+
+struct ShmemTransportConfig
+{
+    int messageSizeMax;
+    int gatherSendBufferCountMax;
+    int receivedMessageCountMax;
+};
+
+static const struct eProsima_PropertyDescriptor ShmemPropertyDescriptors[] =
+{
+    EPROSIMA_PROPERTY_INT(struct ShmemTransportConfig, "parent.message_size_max", messageSizeMax, 1, INT_MAX, 65536),
+    EPROSIMA_PROPERTY_INT(struct ShmemTransportConfig, "parent.gather_send_buffer_count_max", gatherSendBufferCountMax,
+            NDDS_TRANSPORT_PROPERTY_GATHER_SEND_BUFFER_COUNT_MIN, INT_MAX, 16),
+    EPROSIMA_PROPERTY_INT(struct ShmemTransportConfig, "received_message_count_max", receivedMessageCountMax, 1, 65536, 64)
+};
+
+#if defined(SHMEM_TRANSPORT_SUPPORTED)
+
+/**
+ * \brief Header of a segment. It is followed by the ring.
+ */
+struct ShmemSegmentHeader
+{
+    /// Process that owns the receive resource.
+    pid_t ownerPid;
+    /// Set when the receive resource is destroyed or when a new receiver replaces the segment of a
+    /// process that crashed. Senders map the new segment.
+    int closed;
+};
+
+struct ShmemSegment
+{
+    char name[SHMEM_SEGMENT_NAME_LENGTH];
+    void *memory;
+    size_t size;
+    struct eProsima_MessageRing *ring;
+};
+
+struct ShmemTransport
+{
+    /// It has to be the first field.
+    NDDS_Transport_Plugin parent;
+    struct NDDS_Transport_Property_t property;
+    struct ShmemTransportConfig config;
+    char segmentPrefix[SHMEM_SEGMENT_NAME_LENGTH / 2];
+    mode_t segmentPermissions;
+    RTI_UINT32 hostId;
+    /// Zero when the host cannot be identified. Then no address is local and the transport is not used.
+    int hostIdValid;
+    NDDS_Transport_Listener *listener;
+};
+
+struct ShmemRecvResource
+{
+    struct ShmemSegment segment;
+    NDDS_Transport_Port_t port;
+};
+
+/**
+ * \brief A send resource maps the segment of the receiver when it exists, and maps it again when the
+ * receiver is restarted. Senders use the current mapping while they hold it. The previous one is
+ * unmapped by the next remap once nobody holds it.
+ */
+struct ShmemSendResource
+{
+    struct ShmemSegment segments[2];
+    /// Senders that hold each mapping.
+    int users[2];
+    /// Index of the current mapping. It is -1 if the segment is not mapped.
+    int current;
+    /// Serializes the remaps.
+    struct RTIOsapiSemaphore *mutex;
+    NDDS_Transport_Port_t port;
+};
+
+static void getSegmentName(const struct ShmemTransport *transport, NDDS_Transport_Port_t port, char *name)
+{
+    SNPRINTF(name, SHMEM_SEGMENT_NAME_LENGTH, "/%s_%d", transport->segmentPrefix, (int)port);
+}
+
+/**
+ * \brief The host id is stored in the last four bytes of the address.
+ */
+static RTI_UINT32 getAddressHostId(const NDDS_Transport_Address_t *address)
+{
+    const unsigned char *bytes = address->network_ordered_value;
+
+    return ((RTI_UINT32)bytes[12] << 24) | ((RTI_UINT32)bytes[13] << 16) | ((RTI_UINT32)bytes[14] << 8) | bytes[15];
+}
+
+static void setAddressHostId(NDDS_Transport_Address_t *address, RTI_UINT32 hostId)
+{
+    memset(address, 0, sizeof(NDDS_Transport_Address_t));
+    address->network_ordered_value[12] = (unsigned char)(hostId >> 24);
+    address->network_ordered_value[13] = (unsigned char)(hostId >> 16);
+    address->network_ordered_value[14] = (unsigned char)(hostId >> 8);
+    address->network_ordered_value[15] = (unsigned char)hostId;
+}
+
+static RTI_UINT32 hashBytes(RTI_UINT32 hash, const char *bytes, size_t length)
+{
+    size_t i = 0;
+
+    for(i = 0; i < length; ++i)
+    {
+        hash ^= (unsigned char)bytes[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/**
+ * \brief This function reads the first line of a file.
+ *
+ * \return Number of characters read. If the file cannot be read or it is empty, 0 is returned.
+ */
+static size_t readLine(const char *path, char *line, size_t lineLength)
+{
+    FILE *file = fopen(path, "r");
+    size_t length = 0;
+
+    if(file == NULL)
+        return 0;
+
+    if(fgets(line, (int)lineLength, file) != NULL)
+        length = strcspn(line, "\r\n");
+
+    fclose(file);
+    return length;
+}
+
+/**
+ * \brief This function computes the host id from the machine id, or from the boot id, and the host name.
+ * gethostid() is not used because it is usually derived from the address of the host name, which is the same
+ * in many hosts (127.0.1.1).
+ *
+ * \return 0 if the host was identified. Otherwise -1.
+ */
+static int getHostId(RTI_UINT32 *hostId)
+{
+    char line[SHMEM_HOST_NAME_LENGTH];
+    RTI_UINT32 hash = FNV_OFFSET_BASIS;
+    size_t length = readLine("/etc/machine-id", line, sizeof(line));
+
+    if(length == 0)
+        length = readLine("/proc/sys/kernel/random/boot_id", line, sizeof(line));
+
+    if(length == 0)
+        return -1;
+
+    hash = hashBytes(hash, line, length);
+
+    // The containers of a host can share the machine id.
+    if(gethostname(line, sizeof(line)) == 0)
+    {
+        line[sizeof(line) - 1] = '\0';
+        hash = hashBytes(hash, "/", 1);
+        hash = hashBytes(hash, line, strlen(line));
+    }
+
+    *hostId = hash;
+    return 0;
+}
+
+static struct ShmemSegmentHeader* getSegmentHeader(const struct ShmemSegment *segment)
+{
+    return (struct ShmemSegmentHeader*)segment->memory;
+}
+
+static void unmapSegment(struct ShmemSegment *segment)
+{
+    if(segment->memory != NULL)
+    {
+        munmap(segment->memory, segment->size);
+        segment->memory = NULL;
+        segment->ring = NULL;
+    }
+}
+
+/**
+ * \brief This function maps an existing segment.
+ *
+ * \return 0 if the segment was mapped. Otherwise -1.
+ */
+static int openSegment(struct ShmemSegment *segment)
+{
+    struct stat status;
+    int fd = shm_open(segment->name, O_RDWR, 0);
+
+    if(fd < 0)
+        return -1;
+
+    if(fstat(fd, &status) == 0 && status.st_size > SHMEM_SEGMENT_HEADER_SIZE)
+    {
+        segment->size = (size_t)status.st_size;
+        segment->memory = mmap(NULL, segment->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if(segment->memory == MAP_FAILED)
+        {
+            segment->memory = NULL;
+        }
+        else
+        {
+            segment->ring = eProsimaMessageRing_attach((char*)segment->memory + SHMEM_SEGMENT_HEADER_SIZE,
+                    segment->size - SHMEM_SEGMENT_HEADER_SIZE);
+
+            // The receiver is being destroyed.
+            if(segment->ring == NULL || EPROSIMA_ATOMIC_LOAD32(&getSegmentHeader(segment)->closed))
+                unmapSegment(segment);
+        }
+    }
+
+    close(fd);
+    return segment->ring != NULL ? 0 : -1;
+}
+
+/**
+ * \brief This function removes a segment whose owner doesn't exist.
+ *
+ * \return 0 if the segment was removed. Otherwise -1.
+ */
+static int removeStaleSegment(struct ShmemSegment *segment)
+{
+    pid_t ownerPid = 0;
+
+    // A closed segment is being removed by its owner.
+    if(openSegment(segment) != 0)
+        return -1;
+
+    ownerPid = getSegmentHeader(segment)->ownerPid;
+
+    if(ownerPid > 0 && (kill(ownerPid, 0) == 0 || errno != ESRCH))
+    {
+        unmapSegment(segment);
+        return -1;
+    }
+
+    // The senders that mapped it map the new one.
+    EPROSIMA_ATOMIC_STORE32(&getSegmentHeader(segment)->closed, 1);
+    unmapSegment(segment);
+
+    return shm_unlink(segment->name) == 0 ? 0 : -1;
+}
+
+static int createSegment(struct ShmemTransport *transport, struct ShmemSegment *segment)
+{
+    int fd = -1, retry = 0;
+
+    segment->size = SHMEM_SEGMENT_HEADER_SIZE + eProsimaMessageRing_getSize(transport->config.receivedMessageCountMax,
+            transport->config.messageSizeMax);
+
+    for(retry = 0; retry < 2 && fd < 0; ++retry)
+    {
+        fd = shm_open(segment->name, O_RDWR | O_CREAT | O_EXCL, transport->segmentPermissions);
+
+        // A segment of a process that crashed is reused.
+        if(fd < 0 && (errno != EEXIST || removeStaleSegment(segment) != 0))
+            return -1;
+    }
+
+    if(fd < 0)
+        return -1;
+
+    // The umask could have removed some permission given by segment_permissions.
+    if(fchmod(fd, transport->segmentPermissions) == 0 && ftruncate(fd, (off_t)segment->size) == 0)
+    {
+        segment->memory = mmap(NULL, segment->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if(segment->memory == MAP_FAILED)
+        {
+            segment->memory = NULL;
+        }
+        else
+        {
+            ((struct ShmemSegmentHeader*)segment->memory)->ownerPid = getpid();
+            segment->ring = eProsimaMessageRing_init((char*)segment->memory + SHMEM_SEGMENT_HEADER_SIZE,
+                    transport->config.receivedMessageCountMax, transport->config.messageSizeMax);
+        }
+    }
+
+    close(fd);
+
+    if(segment->ring == NULL)
+    {
+        unmapSegment(segment);
+        shm_unlink(segment->name);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * \brief This function holds the current mapping of a send resource.
+ *
+ * \return The index of the mapping. If the segment is not mapped, -1 is returned.
+ */
+static int acquireSegment(struct ShmemSendResource *resource)
+{
+    int current = EPROSIMA_ATOMIC_LOAD32(&resource->current);
+
+    while(current >= 0)
+    {
+        EPROSIMA_ATOMIC_ADD32(&resource->users[current], 1);
+
+        // A remap could have replaced it.
+        if(EPROSIMA_ATOMIC_LOAD32(&resource->current) == current)
+            return current;
+
+        EPROSIMA_ATOMIC_ADD32(&resource->users[current], -1);
+        current = EPROSIMA_ATOMIC_LOAD32(&resource->current);
+    }
+
+    return -1;
+}
+
+static void releaseSegment(struct ShmemSendResource *resource, int index)
+{
+    EPROSIMA_ATOMIC_ADD32(&resource->users[index], -1);
+}
+
+/**
+ * \brief This function maps the segment of the receiver if it is not mapped or if the mapped one was
+ * closed. The new mapping uses the other slot, which is unmapped first if nobody holds it.
+ */
+static void remapSegment(struct ShmemSendResource *resource)
+{
+    int current = 0, next = 0;
+
+    if(RTIOsapiSemaphore_take(resource->mutex, NULL) != RTI_OSAPI_SEMAPHORE_STATUS_OK)
+        return;
+
+    current = EPROSIMA_ATOMIC_LOAD32(&resource->current);
+
+    // Other sender remapped it.
+    if(current >= 0 && !EPROSIMA_ATOMIC_LOAD32(&getSegmentHeader(&resource->segments[current])->closed))
+    {
+        RTIOsapiSemaphore_give(resource->mutex);
+        return;
+    }
+
+    next = current == 0 ? 1 : 0;
+
+    // Without a current mapping any free slot is used.
+    if(current < 0 && EPROSIMA_ATOMIC_LOAD32(&resource->users[next]) != 0)
+        next = 1 - next;
+
+    if(EPROSIMA_ATOMIC_LOAD32(&resource->users[next]) == 0)
+    {
+        unmapSegment(&resource->segments[next]);
+
+        if(openSegment(&resource->segments[next]) == 0)
+            current = next;
+        else
+            current = -1;
+
+        // A closed mapping is not used while the receiver doesn't exist.
+        EPROSIMA_ATOMIC_STORE32(&resource->current, current);
+    }
+
+    RTIOsapiSemaphore_give(resource->mutex);
+}
+
+static RTI_INT32 ShmemTransport_send(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in,
+        const NDDS_Transport_Buffer_t buffer_in[], RTI_INT32 buffer_count_in, void *reserved)
+{
+    struct ShmemSendResource *resource = (struct ShmemSendResource*)*sendresource_in;
+    struct ShmemSegment *segment = NULL;
+    unsigned long long ticket = 0;
+    unsigned int length = 0;
+    char *message = NULL;
+    RTI_INT32 i = 0, returnedValue = RTI_FALSE;
+    int index = acquireSegment(resource);
+
+    // The receiver could be created after the send resource or restarted.
+    if(index < 0 || EPROSIMA_ATOMIC_LOAD32(&getSegmentHeader(&resource->segments[index])->closed))
+    {
+        if(index >= 0)
+            releaseSegment(resource, index);
+
+        remapSegment(resource);
+        index = acquireSegment(resource);
+
+        if(index < 0)
+            return RTI_FALSE;
+
+        // The other slot is still held, so the closed mapping was not replaced.
+        if(EPROSIMA_ATOMIC_LOAD32(&getSegmentHeader(&resource->segments[index])->closed))
+        {
+            releaseSegment(resource, index);
+            return RTI_FALSE;
+        }
+    }
+
+    segment = &resource->segments[index];
+
+    for(i = 0; i < buffer_count_in; ++i)
+        length += buffer_in[i].length;
+
+    // Like a full socket buffer, a full ring drops the message.
+    if(length <= eProsimaMessageRing_getMessageSizeMax(segment->ring) &&
+            (message = (char*)eProsimaMessageRing_reserve(segment->ring, &ticket)) != NULL)
+    {
+        for(i = 0, length = 0; i < buffer_count_in; ++i)
+        {
+            memcpy(message + length, buffer_in[i].pointer, buffer_in[i].length);
+            length += buffer_in[i].length;
+        }
+
+        eProsimaMessageRing_commit(segment->ring, ticket, length);
+        returnedValue = RTI_TRUE;
+    }
+
+    releaseSegment(resource, index);
+
+    return returnedValue;
+}
+
+static RTI_INT32 ShmemTransport_receive_rEA(NDDS_Transport_Plugin *self, NDDS_Transport_Message_t *message_out,
+        const NDDS_Transport_Buffer_t *buffer_in, const NDDS_Transport_RecvResource_t *recvresource_in, void *reserved)
+{
+    struct ShmemRecvResource *resource = (struct ShmemRecvResource*)*recvresource_in;
+    unsigned int length = 0;
+    char *message = (char*)eProsimaMessageRing_take(resource->segment.ring, &length, 1);
+
+    if(message != NULL)
+    {
+        // The message is lent without copying it. It is released in return_loaned_buffer_rEA.
+        message_out->buffer.pointer = message;
+        message_out->buffer.length = (RTI_INT32)length;
+        message_out->loaned_buffer_param = message;
+    }
+    else
+    {
+        // Unblocked by unblock_receive_rrEA.
+        message_out->buffer.length = 0;
+        message_out->loaned_buffer_param = NULL;
+    }
+
+    return RTI_TRUE;
+}
+
+static void ShmemTransport_return_loaned_buffer_rEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        NDDS_Transport_Message_t *message_in, void *reserved)
+{
+    struct ShmemRecvResource *resource = (struct ShmemRecvResource*)*recvresource_in;
+
+    if(message_in->loaned_buffer_param != NULL)
+        eProsimaMessageRing_release(resource->segment.ring, message_in->loaned_buffer_param);
+
+    message_in->loaned_buffer_param = NULL;
+}
+
+static RTI_INT32 ShmemTransport_unblock_receive_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        void *reserved)
+{
+    eProsimaMessageRing_unblock(((struct ShmemRecvResource*)*recvresource_in)->segment.ring);
+    return RTI_TRUE;
+}
+
+static RTI_INT32 ShmemTransport_create_recvresource_rrEA(NDDS_Transport_Plugin *self, NDDS_Transport_RecvResource_t *recvresource_out,
+        NDDS_Transport_Port_t *port_inout, const NDDS_Transport_Address_t *multicast_address_in, RTI_INT32 reserved)
+{
+    const char* const METHOD_NAME = "ShmemTransport_create_recvresource_rrEA";
+    struct ShmemTransport *transport = (struct ShmemTransport*)self;
+    struct ShmemRecvResource *resource = NULL;
+
+    if(multicast_address_in != NULL)
+        return RTI_FALSE;
+
+    RTIOsapiHeap_allocateStructure(&resource, struct ShmemRecvResource);
+
+    if(resource == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the receive resource\n", METHOD_NAME);
+        return RTI_FALSE;
+    }
+
+    memset(resource, 0, sizeof(struct ShmemRecvResource));
+    resource->port = *port_inout;
+    getSegmentName(transport, resource->port, resource->segment.name);
+
+    // If the port is used by other participant, the middleware tries other port.
+    if(createSegment(transport, &resource->segment) != 0)
+    {
+        RTIOsapiHeap_freeStructure(resource);
+        return RTI_FALSE;
+    }
+
+    *recvresource_out = resource;
+    return RTI_TRUE;
+}
+
+static void ShmemTransport_destroy_recvresource_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in)
+{
+    const char* const METHOD_NAME = "ShmemTransport_destroy_recvresource_rrEA";
+    struct ShmemRecvResource *resource = (struct ShmemRecvResource*)*recvresource_in;
+    unsigned int dropped = eProsimaMessageRing_getDropped(resource->segment.ring);
+
+    if(dropped > 0)
+        printf("WARNING<%s>: %u messages with a bad length were dropped in the port %d\n", METHOD_NAME, dropped,
+                (int)resource->port);
+
+    // The senders stop using it.
+    EPROSIMA_ATOMIC_STORE32(&getSegmentHeader(&resource->segment)->closed, 1);
+    unmapSegment(&resource->segment);
+    shm_unlink(resource->segment.name);
+    RTIOsapiHeap_freeStructure(resource);
+}
+
+static RTI_INT32 ShmemTransport_share_recvresource_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        const NDDS_Transport_Port_t port_in, const NDDS_Transport_Address_t *multicast_address_in, RTI_INT32 reserved)
+{
+    return multicast_address_in == NULL && ((struct ShmemRecvResource*)*recvresource_in)->port == port_in;
+}
+
+static RTI_INT32 ShmemTransport_unshare_recvresource_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        const NDDS_Transport_Port_t port_in, const NDDS_Transport_Address_t *multicast_address_in, RTI_INT32 reserved)
+{
+    return RTI_TRUE;
+}
+
+static RTI_INT32 ShmemTransport_create_sendresource_srEA(NDDS_Transport_Plugin *self, NDDS_Transport_SendResource_t *sendresource_out,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in)
+{
+    struct ShmemTransport *transport = (struct ShmemTransport*)self;
+    struct ShmemSendResource *resource = NULL;
+
+    // Only the participants of this host are reachable.
+    if(!transport->hostIdValid || getAddressHostId(dest_address_in) != transport->hostId)
+        return RTI_FALSE;
+
+    RTIOsapiHeap_allocateStructure(&resource, struct ShmemSendResource);
+
+    if(resource == NULL)
+        return RTI_FALSE;
+
+    memset(resource, 0, sizeof(struct ShmemSendResource));
+    resource->port = dest_port_in;
+    resource->current = -1;
+    getSegmentName(transport, dest_port_in, resource->segments[0].name);
+    getSegmentName(transport, dest_port_in, resource->segments[1].name);
+    resource->mutex = RTIOsapiSemaphore_new(RTI_OSAPI_SEMAPHORE_KIND_MUTEX, NULL);
+
+    if(resource->mutex == NULL)
+    {
+        RTIOsapiHeap_freeStructure(resource);
+        return RTI_FALSE;
+    }
+
+    remapSegment(resource);
+
+    *sendresource_out = resource;
+    return RTI_TRUE;
+}
+
+static void ShmemTransport_destroy_sendresource_srEA(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in)
+{
+    struct ShmemSendResource *resource = (struct ShmemSendResource*)*sendresource_in;
+
+    unmapSegment(&resource->segments[0]);
+    unmapSegment(&resource->segments[1]);
+    RTIOsapiSemaphore_delete(resource->mutex);
+    RTIOsapiHeap_freeStructure(resource);
+}
+
+static RTI_INT32 ShmemTransport_share_sendresource_srEA(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in)
+{
+    return ((struct ShmemSendResource*)*sendresource_in)->port == dest_port_in &&
+        ((struct ShmemTransport*)self)->hostIdValid &&
+        getAddressHostId(dest_address_in) == ((struct ShmemTransport*)self)->hostId;
+}
+
+static RTI_INT32 ShmemTransport_unshare_sendresource_srEA(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in)
+{
+    return RTI_TRUE;
+}
+
+static const char* ShmemTransport_get_class_name_cEA(NDDS_Transport_Plugin *self)
+{
+    return SHMEM_CLASS_NAME;
+}
+
+static RTI_INT32 ShmemTransport_string_to_address_cEA(NDDS_Transport_Plugin *self, NDDS_Transport_Address_t *address_out,
+        const char *address_in)
+{
+    int hostId = 0;
+
+    // An empty address is this host. Otherwise it is the hexadecimal host id.
+    if(address_in == NULL || address_in[0] == '\0')
+        hostId = (int)((struct ShmemTransport*)self)->hostId;
+    else if(parsePropertyInteger(address_in, 1, &hostId) != 0)
+        return RTI_FALSE;
+
+    setAddressHostId(address_out, (RTI_UINT32)hostId);
+    return RTI_TRUE;
+}
+
+static RTI_INT32 ShmemTransport_get_receive_interfaces_cEA(NDDS_Transport_Plugin *self, RTI_INT32 *found_more_than_provided_for_out,
+        RTI_INT32 *interface_reported_count_out, NDDS_Transport_Interface_t interface_array_inout[], RTI_INT32 interface_array_size_in)
+{
+    struct ShmemTransport *transport = (struct ShmemTransport*)self;
+
+    *found_more_than_provided_for_out = transport->hostIdValid && interface_array_size_in < 1;
+    *interface_reported_count_out = 0;
+
+    // Without a host id, the address of this host could be the one of other host.
+    if(transport->hostIdValid && interface_array_size_in >= 1)
+    {
+        interface_array_inout[0].transport_classid = transport->property.classid;
+        setAddressHostId(&interface_array_inout[0].address, transport->hostId);
+        interface_array_inout[0].status = NDDS_TRANSPORT_INTERFACE_STATUS_ENABLED;
+        interface_array_inout[0].rank = 0;
+        *interface_reported_count_out = 1;
+    }
+
+    return RTI_TRUE;
+}
+
+static RTI_INT32 ShmemTransport_register_listener_cEA(NDDS_Transport_Plugin *self, NDDS_Transport_Listener *listener_in)
+{
+    ((struct ShmemTransport*)self)->listener = listener_in;
+    return RTI_TRUE;
+}
+
+static void ShmemTransport_delete_cEA(NDDS_Transport_Plugin *self, void *reserved)
+{
+    RTIOsapiHeap_freeStructure((struct ShmemTransport*)self);
+}
+
+#endif // SHMEM_TRANSPORT_SUPPORTED
+
+NDDS_Transport_Plugin* eProsimaShmemTransport_create(NDDS_Transport_Address_t *default_network_address_out,
+        const struct DDS_PropertyQosPolicy *property_in)
+{
+    const char* const METHOD_NAME = "eProsimaShmemTransport_create";
+#if defined(SHMEM_TRANSPORT_SUPPORTED)
+    struct ShmemTransport *transport = NULL;
+    struct DDS_Property_t *segmentPrefix = NULL, *segmentPermissions = NULL;
+    unsigned long permissions = SHMEM_SEGMENT_PERMISSIONS_DEFAULT;
+    char *end = NULL;
+
+    if(property_in == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    RTIOsapiHeap_allocateStructure(&transport, struct ShmemTransport);
+
+    if(transport == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the transport\n", METHOD_NAME);
+        return NULL;
+    }
+
+    memset(transport, 0, sizeof(struct ShmemTransport));
+    transport->config.messageSizeMax = 65536;
+    transport->config.gatherSendBufferCountMax = 16;
+    transport->config.receivedMessageCountMax = 64;
+
+    if(parseTransportProperties(property_in, "", ShmemPropertyDescriptors,
+            sizeof(ShmemPropertyDescriptors) / sizeof(ShmemPropertyDescriptors[0]), &transport->config) < 0)
+    {
+        printf("ERROR<%s>: Cannot parse the properties\n", METHOD_NAME);
+        RTIOsapiHeap_freeStructure(transport);
+        return NULL;
+    }
+
+    segmentPrefix = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, "segment_prefix");
+    SNPRINTF(transport->segmentPrefix, sizeof(transport->segmentPrefix), "%s",
+            segmentPrefix != NULL && segmentPrefix->value != NULL ? segmentPrefix->value : SHMEM_SEGMENT_PREFIX_DEFAULT);
+
+    // Octal mode. The owner always reads and writes its segments.
+    segmentPermissions = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in,
+            "segment_permissions");
+
+    if(segmentPermissions != NULL && segmentPermissions->value != NULL)
+    {
+        permissions = strtoul(segmentPermissions->value, &end, 8);
+
+        if(end == segmentPermissions->value || *end != '\0' || permissions > 0777 || (permissions & 0600) != 0600)
+        {
+            printf("ERROR<%s>: Bad value for segment_permissions\n", METHOD_NAME);
+            RTIOsapiHeap_freeStructure(transport);
+            return NULL;
+        }
+    }
+
+    transport->segmentPermissions = (mode_t)permissions;
+
+    transport->hostIdValid = getHostId(&transport->hostId) == 0;
+
+    if(!transport->hostIdValid)
+        printf("WARNING<%s>: The host cannot be identified. The transport is not used\n", METHOD_NAME);
+
+    transport->property.classid = EPROSIMA_TRANSPORT_CLASSID_SHMEM;
+    transport->property.address_bit_count = 32;
+    transport->property.properties_bitmap = NDDS_TRANSPORT_PROPERTY_BIT_BUFFER_ALWAYS_LOANED;
+    transport->property.gather_send_buffer_count_max = transport->config.gatherSendBufferCountMax;
+    transport->property.message_size_max = transport->config.messageSizeMax;
+
+    transport->parent.property = &transport->property;
+    transport->parent.send = ShmemTransport_send;
+    transport->parent.receive_rEA = ShmemTransport_receive_rEA;
+    transport->parent.return_loaned_buffer_rEA = ShmemTransport_return_loaned_buffer_rEA;
+    transport->parent.unblock_receive_rrEA = ShmemTransport_unblock_receive_rrEA;
+    transport->parent.create_recvresource_rrEA = ShmemTransport_create_recvresource_rrEA;
+    transport->parent.destroy_recvresource_rrEA = ShmemTransport_destroy_recvresource_rrEA;
+    transport->parent.share_recvresource_rrEA = ShmemTransport_share_recvresource_rrEA;
+    transport->parent.unshare_recvresource_rrEA = ShmemTransport_unshare_recvresource_rrEA;
+    transport->parent.create_sendresource_srEA = ShmemTransport_create_sendresource_srEA;
+    transport->parent.destroy_sendresource_srEA = ShmemTransport_destroy_sendresource_srEA;
+    transport->parent.share_sendresource_srEA = ShmemTransport_share_sendresource_srEA;
+    transport->parent.unshare_sendresource_srEA = ShmemTransport_unshare_sendresource_srEA;
+    transport->parent.get_class_name_cEA = ShmemTransport_get_class_name_cEA;
+    transport->parent.string_to_address_cEA = ShmemTransport_string_to_address_cEA;
+    transport->parent.get_receive_interfaces_cEA = ShmemTransport_get_receive_interfaces_cEA;
+    transport->parent.register_listener_cEA = ShmemTransport_register_listener_cEA;
+    transport->parent.delete_cEA = ShmemTransport_delete_cEA;
+
+    // The whole address is the host address.
+    if(default_network_address_out != NULL)
+        memset(default_network_address_out, 0, sizeof(NDDS_Transport_Address_t));
+
+    return &transport->parent;
+#else
+    printf("ERROR<%s>: Shared memory transport is not supported in this platform\n", METHOD_NAME);
+    return NULL;
+#endif
+}
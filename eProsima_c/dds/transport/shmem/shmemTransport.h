@@ -0,0 +1,50 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_SHMEM_SHMEMTRANSPORT_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_SHMEM_SHMEMTRANSPORT_H_
+
+#include "eProsima_c/config.h"
+
+#include <transport/transport_interface.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+struct DDS_PropertyQosPolicy;
+
+/**
+ * \brief This function creates a transport that sends messages to the participants of the same host
+ * through POSIX shared memory.
+ *
+ * Each receive resource (port) owns a segment with a lock-free ring of messages. Senders write the
+ * messages directly in the ring of the destination and the receiver lends them to the middleware
+ * without copying. The receiver sleeps on a futex when the ring is empty. Multicast is not supported.
+ *
+ * The address of a participant is the id of its host, computed from /etc/machine-id (or the boot id) and
+ * the host name. If the host cannot be identified, the transport reports no interface and doesn't send.
+ *
+ * It has the signature of NDDS_Transport_create_plugin, so it can be loaded with loadTransportPluginFromLibrary:
+ *     pluginName.library = eprosima_shmem (or the name of the shared library)
+ *     pluginName.create_function = eProsimaShmemTransport_create
+ *
+ * The properties are received without the prefix "pluginName.":
+ *     parent.message_size_max: Maximum size of a message. Default 65536.
+ *     parent.gather_send_buffer_count_max: Maximum number of buffers of a message. Default 16.
+ *     received_message_count_max: Number of messages in the ring of each port. Default 64.
+ *     segment_prefix: Prefix of the name of the segments. Default "eprosima_shmem".
+ *     segment_permissions: Octal permissions of the segments of the receive resources. Any user that can write
+ *         in a segment can send messages to the participant. Default 600, so only participants of the same user
+ *         communicate; use 660 or 666 to communicate with other users. It has to include 600.
+ *
+ * \param default_network_address_out Network address of the transport.
+ * \param property_in Properties of the transport.
+ * \return The new transport. In error case, NULL value is returned.
+ */
+NDDS_Transport_Plugin* eProsimaShmemTransport_create(NDDS_Transport_Address_t *default_network_address_out,
+        const struct DDS_PropertyQosPolicy *property_in);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_SHMEM_SHMEMTRANSPORT_H_
@@ -0,0 +1,332 @@
+#if defined(RTI_LINUX) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "transportBufferPool.h"
+#include "../../sys/atomic.h"
+
+#include <osapi/osapi_heap.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(RTI_LINUX)
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+/// Buffers are aligned to cache lines.
+#define BUFFER_POOL_ALIGNMENT 64
+
+#define BUFFER_POOL_NODES_MAX 64
+
+#define BUFFER_POOL_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+#if defined(RTI_LINUX)
+#define BUFFER_POOL_MPOL_BIND 2
+#endif
+
+/**
+ * \brief Slab and free list of a NUMA node.
+ *
+ * The head of the free list keeps the index of the first free buffer plus one in the low 32 bits (0 when the
+ * list is empty) and a tag in the high 32 bits. The tag changes in every update, so a pop that read an old head
+ * cannot succeed after other threads popped and pushed the same buffer.
+ */
+struct BufferPoolNode
+{
+    unsigned long long head;
+    char padding[BUFFER_POOL_ALIGNMENT - sizeof(unsigned long long)];
+    char *slab;
+    size_t slabSize;
+    int mapped;
+    /// Next free buffer of each buffer, plus one.
+    unsigned int *next;
+};
+
+struct eProsima_TransportBufferPool
+{
+    struct BufferPoolNode nodes[BUFFER_POOL_NODES_MAX];
+    int nodesLength;
+    unsigned int bufferSize;
+    /// Size of the buffers rounded up to the alignment.
+    size_t stride;
+    unsigned int buffersPerNode;
+    unsigned long long heapBuffers;
+};
+
+static int getNodeCount(void)
+{
+#if defined(RTI_LINUX)
+    FILE *file = fopen("/sys/devices/system/node/online", "r");
+    int first = 0, last = 0;
+
+    if(file != NULL)
+    {
+        // The format is "0" or "0-N".
+        int read = fscanf(file, "%d-%d", &first, &last);
+
+        fclose(file);
+
+        if(read == 2 && last >= 0)
+            return last + 1 > BUFFER_POOL_NODES_MAX ? BUFFER_POOL_NODES_MAX : last + 1;
+    }
+#endif
+
+    return 1;
+}
+
+static int getCurrentNode(struct eProsima_TransportBufferPool *pool)
+{
+#if defined(RTI_LINUX) && defined(SYS_getcpu)
+    unsigned int cpu = 0, node = 0;
+
+    if(pool->nodesLength > 1 && syscall(SYS_getcpu, &cpu, &node, NULL) == 0 && node < (unsigned int)pool->nodesLength)
+        return (int)node;
+#endif
+
+    return 0;
+}
+
+static int createNode(struct eProsima_TransportBufferPool *pool, int node, int useHugePages)
+{
+    const char* const METHOD_NAME = "createNode";
+    struct BufferPoolNode *poolNode = &pool->nodes[node];
+    size_t size = pool->stride * pool->buffersPerNode;
+    unsigned int index = 0;
+
+#if defined(RTI_LINUX)
+    if(useHugePages)
+    {
+        size_t hugeSize = (size + BUFFER_POOL_HUGE_PAGE_SIZE - 1) & ~(size_t)(BUFFER_POOL_HUGE_PAGE_SIZE - 1);
+
+#if defined(MAP_HUGETLB)
+        poolNode->slab = (char*)mmap(NULL, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#else
+        poolNode->slab = (char*)MAP_FAILED;
+#endif
+
+        if(poolNode->slab != (char*)MAP_FAILED)
+            size = hugeSize;
+        else
+            printf("INFO<%s>: Huge pages are not available for the buffers of node %d. Normal pages are used\n", METHOD_NAME, node);
+    }
+
+    if(!useHugePages || poolNode->slab == (char*)MAP_FAILED)
+        poolNode->slab = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if(poolNode->slab == (char*)MAP_FAILED)
+    {
+        poolNode->slab = NULL;
+        printf("ERROR<%s>: Cannot map the buffers of node %d\n", METHOD_NAME, node);
+        return -1;
+    }
+
+    poolNode->mapped = 1;
+
+#if defined(SYS_mbind)
+    if(pool->nodesLength > 1)
+    {
+        unsigned long mask = 1UL << node;
+
+        if(syscall(SYS_mbind, poolNode->slab, size, BUFFER_POOL_MPOL_BIND, &mask, sizeof(mask) * 8, 0) != 0)
+            printf("WARNING<%s>: Cannot bind the buffers to node %d\n", METHOD_NAME, node);
+    }
+#endif
+#else
+    (void)useHugePages;
+    RTIOsapiHeap_allocateArray(&poolNode->slab, size, char);
+
+    if(poolNode->slab == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the buffers of node %d\n", METHOD_NAME, node);
+        return -1;
+    }
+#endif
+
+    poolNode->slabSize = size;
+
+    // The pages are faulted in now, not on the receive path.
+    memset(poolNode->slab, 0, size);
+
+    RTIOsapiHeap_allocateArray(&poolNode->next, pool->buffersPerNode, unsigned int);
+
+    if(poolNode->next == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the free list of node %d\n", METHOD_NAME, node);
+        return -1;
+    }
+
+    for(index = 0; index < pool->buffersPerNode; ++index)
+        poolNode->next[index] = index + 1 < pool->buffersPerNode ? index + 2 : 0;
+
+    poolNode->head = 1;
+
+    return 0;
+}
+
+static void freeNode(struct BufferPoolNode *poolNode)
+{
+    if(poolNode->slab != NULL)
+    {
+#if defined(RTI_LINUX)
+        if(poolNode->mapped)
+            munmap(poolNode->slab, poolNode->slabSize);
+#else
+        RTIOsapiHeap_freeArray(poolNode->slab);
+#endif
+    }
+
+    if(poolNode->next != NULL)
+        RTIOsapiHeap_freeArray(poolNode->next);
+}
+
+static char* popBuffer(struct eProsima_TransportBufferPool *pool, int node)
+{
+    struct BufferPoolNode *poolNode = &pool->nodes[node];
+    unsigned long long head = 0, newHead = 0;
+    unsigned int index = 0;
+
+    do
+    {
+        head = EPROSIMA_ATOMIC_LOAD64(&poolNode->head);
+        index = (unsigned int)(head & 0xFFFFFFFFULL);
+
+        if(index == 0)
+            return NULL;
+
+        newHead = (((head >> 32) + 1) << 32) | EPROSIMA_ATOMIC_LOAD32(&poolNode->next[index - 1]);
+    }
+    while(!EPROSIMA_ATOMIC_CAS64(&poolNode->head, head, newHead));
+
+    return poolNode->slab + (size_t)(index - 1) * pool->stride;
+}
+
+static void pushBuffer(struct eProsima_TransportBufferPool *pool, int node, char *pointer)
+{
+    struct BufferPoolNode *poolNode = &pool->nodes[node];
+    unsigned int index = (unsigned int)((size_t)(pointer - poolNode->slab) / pool->stride);
+    unsigned long long head = 0, newHead = 0;
+
+    do
+    {
+        head = EPROSIMA_ATOMIC_LOAD64(&poolNode->head);
+        EPROSIMA_ATOMIC_STORE32(&poolNode->next[index], (unsigned int)(head & 0xFFFFFFFFULL));
+        newHead = (((head >> 32) + 1) << 32) | (index + 1);
+    }
+    while(!EPROSIMA_ATOMIC_CAS64(&poolNode->head, head, newHead));
+}
+
+/// Returns the node that owns the buffer or -1 if it was allocated from the heap.
+static int getOwnerNode(struct eProsima_TransportBufferPool *pool, const char *pointer)
+{
+    int node = 0;
+
+    for(node = 0; node < pool->nodesLength; ++node)
+    {
+        const struct BufferPoolNode *poolNode = &pool->nodes[node];
+
+        if(pointer >= poolNode->slab && pointer < poolNode->slab + pool->stride * pool->buffersPerNode)
+            return node;
+    }
+
+    return -1;
+}
+
+struct eProsima_TransportBufferPool* eProsimaTransportBufferPool_new(unsigned int bufferSize, unsigned int buffersPerNode,
+        int useHugePages)
+{
+    const char* const METHOD_NAME = "eProsimaTransportBufferPool_new";
+    struct eProsima_TransportBufferPool *pool = NULL;
+    int node = 0;
+
+    if(bufferSize == 0 || buffersPerNode == 0)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    RTIOsapiHeap_allocateStructure(&pool, struct eProsima_TransportBufferPool);
+
+    if(pool == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the pool\n", METHOD_NAME);
+        return NULL;
+    }
+
+    memset(pool, 0, sizeof(struct eProsima_TransportBufferPool));
+    pool->bufferSize = bufferSize;
+    pool->stride = ((size_t)bufferSize + BUFFER_POOL_ALIGNMENT - 1) & ~(size_t)(BUFFER_POOL_ALIGNMENT - 1);
+    pool->buffersPerNode = buffersPerNode;
+    pool->nodesLength = getNodeCount();
+
+    for(node = 0; node < pool->nodesLength; ++node)
+    {
+        if(createNode(pool, node, useHugePages) != 0)
+        {
+            eProsimaTransportBufferPool_delete(pool);
+            return NULL;
+        }
+    }
+
+    return pool;
+}
+
+void eProsimaTransportBufferPool_delete(struct eProsima_TransportBufferPool *pool)
+{
+    int node = 0;
+
+    for(node = 0; node < pool->nodesLength; ++node)
+        freeNode(&pool->nodes[node]);
+
+    RTIOsapiHeap_freeStructure(pool);
+}
+
+int eProsimaTransportBufferPool_take(struct eProsima_TransportBufferPool *pool, NDDS_Transport_Buffer_t *buffer)
+{
+    const char* const METHOD_NAME = "eProsimaTransportBufferPool_take";
+    int current = getCurrentNode(pool), node = 0;
+    char *pointer = popBuffer(pool, current);
+
+    // Other nodes are tried before the heap.
+    for(node = 0; pointer == NULL && node < pool->nodesLength; ++node)
+    {
+        if(node != current)
+            pointer = popBuffer(pool, node);
+    }
+
+    if(pointer == NULL)
+    {
+        RTIOsapiHeap_allocateArray(&pointer, pool->bufferSize, char);
+
+        if(pointer == NULL)
+        {
+            printf("ERROR<%s>: Cannot allocate memory for a buffer\n", METHOD_NAME);
+            return -1;
+        }
+
+        if(EPROSIMA_ATOMIC_ADD64(&pool->heapBuffers, 1) == 1)
+            printf("WARNING<%s>: The pool is empty. Buffers are allocated from the heap\n", METHOD_NAME);
+    }
+
+    buffer->pointer = pointer;
+    buffer->length = (RTI_INT32)pool->bufferSize;
+
+    return 0;
+}
+
+void eProsimaTransportBufferPool_give(struct eProsima_TransportBufferPool *pool, char *pointer)
+{
+    int node = getOwnerNode(pool, pointer);
+
+    if(node >= 0)
+        pushBuffer(pool, node, pointer);
+    else
+        RTIOsapiHeap_freeArray(pointer);
+}
+
+unsigned long long eProsimaTransportBufferPool_getHeapBufferCount(struct eProsima_TransportBufferPool *pool)
+{
+    return EPROSIMA_ATOMIC_LOAD64(&pool->heapBuffers);
+}
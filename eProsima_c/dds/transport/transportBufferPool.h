@@ -0,0 +1,68 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_TRANSPORTBUFFERPOOL_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_TRANSPORTBUFFERPOOL_H_
+
+#include "eProsima_c/config.h"
+
+#include <transport/transport_interface.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/**
+ * \brief Pool of receive buffers of the same size.
+ *
+ * The buffers are preallocated in one slab for each NUMA node, with huge pages when the system has them,
+ * and the slab of a node is bound to it. Each node has a lock-free free list. Buffers are taken from the
+ * node of the calling thread and always return to the node that owns them, whatever thread returns them, so
+ * a buffer filled by a thread and released by other one goes back to the first thread. When the pool is
+ * empty, buffers are allocated from the heap.
+ */
+struct eProsima_TransportBufferPool;
+
+/**
+ * \brief This function creates a pool.
+ *
+ * \param bufferSize Size of the buffers, i.e. the message_size_max of the transport.
+ * \param buffersPerNode Buffers of each NUMA node.
+ * \param useHugePages If it is not zero, the slabs use huge pages when they are available.
+ * \return The new pool. In error case, NULL value is returned.
+ */
+struct eProsima_TransportBufferPool* eProsimaTransportBufferPool_new(unsigned int bufferSize, unsigned int buffersPerNode,
+        int useHugePages);
+
+/**
+ * \brief This function deletes a pool. All the buffers must have been returned.
+ *
+ * \param pool The pool. Cannot be NULL.
+ */
+void eProsimaTransportBufferPool_delete(struct eProsima_TransportBufferPool *pool);
+
+/**
+ * \brief This function takes a buffer of the node of the calling thread, or of other node if it is empty.
+ *
+ * \param pool The pool. Cannot be NULL.
+ * \param buffer Where the buffer and its size are stored. Cannot be NULL.
+ * \return 0 if a buffer was taken. If there is no memory, -1 is returned.
+ */
+int eProsimaTransportBufferPool_take(struct eProsima_TransportBufferPool *pool, NDDS_Transport_Buffer_t *buffer);
+
+/**
+ * \brief This function returns a buffer to the node that owns it. It can be called from any thread.
+ *
+ * \param pool The pool. Cannot be NULL.
+ * \param pointer The pointer of a buffer taken from the pool.
+ */
+void eProsimaTransportBufferPool_give(struct eProsima_TransportBufferPool *pool, char *pointer);
+
+/**
+ * \brief This function returns the number of buffers that were allocated from the heap because the pool was empty.
+ */
+unsigned long long eProsimaTransportBufferPool_getHeapBufferCount(struct eProsima_TransportBufferPool *pool);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_TRANSPORTBUFFERPOOL_H_
@@ -0,0 +1,20 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_TRANSPORTCLASSIDS_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_TRANSPORTCLASSIDS_H_
+
+#include <transport/transport_interface.h>
+
+/* Class ids of the transport plugins of this library. User transports must use values above
+ * NDDS_TRANSPORT_CLASSID_RESERVED_RANGE. */
+
+#define EPROSIMA_TRANSPORT_CLASSID_BASE (NDDS_TRANSPORT_CLASSID_RESERVED_RANGE + 0x4550)
+
+/// Same-host shared-memory transport.
+#define EPROSIMA_TRANSPORT_CLASSID_SHMEM (EPROSIMA_TRANSPORT_CLASSID_BASE + 1)
+
+/// UDPv4 transport with batched system calls. Its addresses use the format of the UDPv4 transport.
+#define EPROSIMA_TRANSPORT_CLASSID_UDPMMSG (EPROSIMA_TRANSPORT_CLASSID_BASE + 2)
+
+/// In-process transport.
+#define EPROSIMA_TRANSPORT_CLASSID_LOOPBACK (EPROSIMA_TRANSPORT_CLASSID_BASE + 3)
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_TRANSPORTCLASSIDS_H_
@@ -0,0 +1,394 @@
+#include "transportConfigCache.h"
+#include "../qos/propertyIndex.h"
+#include "../../sys/atomic.h"
+
+#include <dds_c/dds_c_infrastructure.h>
+#include <osapi/osapi_heap.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME 16777619U
+
+#define CACHE_MUTEX_UNINITIALIZED 0
+#define CACHE_MUTEX_INITIALIZING 1
+#define CACHE_MUTEX_INITIALIZED 2
+
+/**
+ * \brief Configuration stored in the cache.
+ *
+ * The key is stored as the strings "prefix", "name1", "value1", "name2", "value2"... one after the
+ * other with their null characters.
+ */
+struct TransportConfigCacheEntry
+{
+    eProsima_TransportConfigBuild build;
+    eProsima_TransportConfigFinalize finalize;
+    unsigned int hash;
+    char *key;
+    size_t keyLength;
+    char *config;
+};
+
+static struct TransportConfigCacheEntry cacheEntries[EPROSIMA_TRANSPORT_CONFIG_CACHE_MAX];
+
+static int cacheEntriesLength = 0;
+
+/**
+ * \brief Index stored in the cache. It indexes a copy of the policy, so it doesn't depend on the policy of the
+ * caller. The key is stored like the one of TransportConfigCacheEntry, with an empty prefix.
+ */
+struct TransportIndexCacheEntry
+{
+    unsigned int hash;
+    char *key;
+    size_t keyLength;
+    struct DDS_PropertyQosPolicy policy;
+    struct eProsima_PropertyIndex *index;
+};
+
+static struct TransportIndexCacheEntry indexEntries[EPROSIMA_TRANSPORT_CONFIG_CACHE_MAX];
+
+static int indexEntriesLength = 0;
+
+static struct RTIOsapiSemaphore *cache_mutex = NULL;
+
+static int cacheMutexState = CACHE_MUTEX_UNINITIALIZED;
+
+/**
+ * \brief This function creates the mutex of the cache the first time. Concurrent callers wait for it.
+ *
+ * \return The mutex. If it cannot be created, NULL value is returned and the next call tries again.
+ */
+static struct RTIOsapiSemaphore* getCacheMutex(void)
+{
+    int state = EPROSIMA_ATOMIC_LOAD32(&cacheMutexState);
+
+    while(state != CACHE_MUTEX_INITIALIZED)
+    {
+        if(state == CACHE_MUTEX_UNINITIALIZED &&
+                EPROSIMA_ATOMIC_CAS32(&cacheMutexState, CACHE_MUTEX_UNINITIALIZED, CACHE_MUTEX_INITIALIZING))
+        {
+            cache_mutex = RTIOsapiSemaphore_new(RTI_OSAPI_SEMAPHORE_KIND_MUTEX, NULL);
+            EPROSIMA_ATOMIC_STORE32(&cacheMutexState, cache_mutex != NULL ? CACHE_MUTEX_INITIALIZED : CACHE_MUTEX_UNINITIALIZED);
+            return cache_mutex;
+        }
+
+        EPROSIMA_CPU_RELAX();
+        state = EPROSIMA_ATOMIC_LOAD32(&cacheMutexState);
+    }
+
+    return cache_mutex;
+}
+
+/**
+ * \brief This function hashes a string including its null character.
+ */
+static unsigned int hashKeyString(unsigned int hash, const char *string)
+{
+    do
+    {
+        hash ^= (unsigned char)*string;
+        hash *= FNV_PRIME;
+    } while(*string++ != '\0');
+
+    return hash;
+}
+
+/**
+ * \brief This function compares a string including its null character with the key at the given position.
+ *
+ * \return The position after the string in the key. If the string is different, 0 is returned.
+ */
+static size_t matchKeyString(const char *key, size_t keyLength, size_t position, const char *string)
+{
+    size_t length = strlen(string) + 1;
+
+    if(position + length <= keyLength && memcmp(key + position, string, length) == 0)
+        return position + length;
+
+    return 0;
+}
+
+/**
+ * \brief This function hashes the key of a set of properties.
+ */
+static unsigned int hashKey(const char *prefix, struct DDS_Property_t * const *properties, int propertiesLength)
+{
+    unsigned int hash = FNV_OFFSET_BASIS;
+    int i = 0;
+
+    hash = hashKeyString(hash, prefix);
+    for(i = 0; i < propertiesLength; ++i)
+    {
+        hash = hashKeyString(hash, properties[i]->name);
+        hash = hashKeyString(hash, properties[i]->value != NULL ? properties[i]->value : "");
+    }
+
+    return hash;
+}
+
+static int matchKey(const char *key, size_t keyLength, const char *prefix,
+        struct DDS_Property_t * const *properties, int propertiesLength)
+{
+    size_t position = 0;
+    int i = 0;
+
+    position = matchKeyString(key, keyLength, 0, prefix);
+
+    for(i = 0; i < propertiesLength && position != 0; ++i)
+    {
+        position = matchKeyString(key, keyLength, position, properties[i]->name);
+
+        if(position != 0)
+            position = matchKeyString(key, keyLength, position, properties[i]->value != NULL ? properties[i]->value : "");
+    }
+
+    return position == keyLength;
+}
+
+static char* buildKey(const char *prefix, struct DDS_Property_t * const *properties, int propertiesLength, size_t *keyLength)
+{
+    char *key = NULL, *position = NULL;
+    const char *value = NULL;
+    size_t length = strlen(prefix) + 1;
+    int i = 0;
+
+    for(i = 0; i < propertiesLength; ++i)
+        length += strlen(properties[i]->name) + 1 + (properties[i]->value != NULL ? strlen(properties[i]->value) : 0) + 1;
+
+    RTIOsapiHeap_allocateArray(&key, length, char);
+
+    if(key != NULL)
+    {
+        position = key;
+        memcpy(position, prefix, strlen(prefix) + 1);
+        position += strlen(prefix) + 1;
+
+        for(i = 0; i < propertiesLength; ++i)
+        {
+            memcpy(position, properties[i]->name, strlen(properties[i]->name) + 1);
+            position += strlen(properties[i]->name) + 1;
+            value = properties[i]->value != NULL ? properties[i]->value : "";
+            memcpy(position, value, strlen(value) + 1);
+            position += strlen(value) + 1;
+        }
+
+        *keyLength = length;
+    }
+
+    return key;
+}
+
+const void* transportConfigCache_get(const struct eProsima_PropertyIndex *index, const char *prefix,
+        size_t configSize, eProsima_TransportConfigBuild build, eProsima_TransportConfigFinalize finalize)
+{
+    const char* const METHOD_NAME = "transportConfigCache_get";
+    struct TransportConfigCacheEntry *entry = NULL;
+    struct RTIOsapiSemaphore *mutex = NULL;
+    struct DDS_Property_t * const *range = NULL;
+    struct DDS_Property_t **properties = NULL;
+    const void *returnedValue = NULL;
+    unsigned int hash = 0;
+    int propertiesLength = 0, i = 0;
+
+    if(index == NULL || prefix == NULL || build == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    mutex = getCacheMutex();
+
+    if(mutex == NULL)
+    {
+        printf("ERROR<%s>: Cannot create cache mutex\n", METHOD_NAME);
+        return NULL;
+    }
+
+    // The key keeps the order of the sequence, because the configuration can depend on it.
+    propertiesLength = eProsimaPropertyIndex_getPrefixRange(index, prefix, &range);
+    RTIOsapiHeap_allocateArray(&properties, propertiesLength + 1, struct DDS_Property_t*);
+
+    if(properties == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the key\n", METHOD_NAME);
+        return NULL;
+    }
+
+    eProsimaPropertyIndex_getPrefixProperties(index, prefix, properties);
+    hash = hashKey(prefix, properties, propertiesLength);
+
+    if(RTIOsapiSemaphore_take(mutex, NULL) == RTI_OSAPI_SEMAPHORE_STATUS_OK)
+    {
+        for(i = 0; i < cacheEntriesLength && returnedValue == NULL; ++i)
+        {
+            if(cacheEntries[i].hash == hash && cacheEntries[i].build == build &&
+                    matchKey(cacheEntries[i].key, cacheEntries[i].keyLength, prefix, properties, propertiesLength))
+                returnedValue = cacheEntries[i].config;
+        }
+
+        if(returnedValue == NULL && cacheEntriesLength < EPROSIMA_TRANSPORT_CONFIG_CACHE_MAX)
+        {
+            entry = &cacheEntries[cacheEntriesLength];
+            entry->build = build;
+            entry->finalize = finalize;
+            entry->hash = hash;
+            entry->key = buildKey(prefix, properties, propertiesLength, &entry->keyLength);
+            RTIOsapiHeap_allocateArray(&entry->config, configSize, char);
+
+            if(entry->key != NULL && entry->config != NULL)
+            {
+                memset(entry->config, 0, configSize);
+
+                if(build(index, prefix, entry->config) == 0)
+                {
+                    returnedValue = entry->config;
+                    ++cacheEntriesLength;
+                }
+            }
+            else
+            {
+                printf("ERROR<%s>: Cannot allocate memory for the cache entry\n", METHOD_NAME);
+            }
+
+            if(returnedValue == NULL)
+            {
+                if(entry->key != NULL)
+                    RTIOsapiHeap_freeArray(entry->key);
+                if(entry->config != NULL)
+                    RTIOsapiHeap_freeArray(entry->config);
+            }
+        }
+
+        RTIOsapiSemaphore_give(mutex);
+    }
+
+    RTIOsapiHeap_freeArray(properties);
+
+    return returnedValue;
+}
+
+const struct eProsima_PropertyIndex* transportConfigCache_getIndex(const struct DDS_PropertyQosPolicy *policy)
+{
+    const char* const METHOD_NAME = "transportConfigCache_getIndex";
+    struct TransportIndexCacheEntry *entry = NULL;
+    struct RTIOsapiSemaphore *mutex = NULL;
+    struct DDS_Property_t **properties = NULL;
+    struct DDS_Property_t *auxProperty = NULL;
+    const struct eProsima_PropertyIndex *returnedValue = NULL;
+    unsigned int hash = 0;
+    int sequenceLength = 0, propertiesLength = 0, i = 0;
+
+    if(policy == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    mutex = getCacheMutex();
+
+    if(mutex == NULL)
+    {
+        printf("ERROR<%s>: Cannot create cache mutex\n", METHOD_NAME);
+        return NULL;
+    }
+
+    // The key is built from the properties that the index contains.
+    sequenceLength = DDS_PropertySeq_get_length(&policy->value);
+    RTIOsapiHeap_allocateArray(&properties, sequenceLength + 1, struct DDS_Property_t*);
+
+    if(properties == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the key\n", METHOD_NAME);
+        return NULL;
+    }
+
+    for(i = 0; i < sequenceLength; ++i)
+    {
+        auxProperty = DDS_PropertySeq_get_reference(&policy->value, i);
+
+        if(auxProperty != NULL && auxProperty->name != NULL)
+            properties[propertiesLength++] = auxProperty;
+    }
+
+    hash = hashKey("", properties, propertiesLength);
+
+    if(RTIOsapiSemaphore_take(mutex, NULL) == RTI_OSAPI_SEMAPHORE_STATUS_OK)
+    {
+        for(i = 0; i < indexEntriesLength && returnedValue == NULL; ++i)
+        {
+            if(indexEntries[i].hash == hash &&
+                    matchKey(indexEntries[i].key, indexEntries[i].keyLength, "", properties, propertiesLength))
+                returnedValue = indexEntries[i].index;
+        }
+
+        if(returnedValue == NULL && indexEntriesLength < EPROSIMA_TRANSPORT_CONFIG_CACHE_MAX)
+        {
+            entry = &indexEntries[indexEntriesLength];
+            entry->hash = hash;
+            entry->key = buildKey("", properties, propertiesLength, &entry->keyLength);
+            entry->index = NULL;
+            DDS_PropertyQosPolicy_initialize(&entry->policy);
+
+            if(entry->key != NULL && DDS_PropertyQosPolicy_copy(&entry->policy, policy) == DDS_RETCODE_OK)
+            {
+                entry->index = eProsimaPropertyIndex_new(&entry->policy);
+
+                if(entry->index != NULL)
+                {
+                    returnedValue = entry->index;
+                    ++indexEntriesLength;
+                }
+            }
+            else
+            {
+                printf("ERROR<%s>: Cannot allocate memory for the cache entry\n", METHOD_NAME);
+            }
+
+            if(returnedValue == NULL)
+            {
+                if(entry->key != NULL)
+                    RTIOsapiHeap_freeArray(entry->key);
+                DDS_PropertyQosPolicy_finalize(&entry->policy);
+            }
+        }
+
+        RTIOsapiSemaphore_give(mutex);
+    }
+
+    RTIOsapiHeap_freeArray(properties);
+
+    return returnedValue;
+}
+
+void transportConfigCache_clear(void)
+{
+    int i = 0;
+
+    if(EPROSIMA_ATOMIC_LOAD32(&cacheMutexState) == CACHE_MUTEX_INITIALIZED &&
+            RTIOsapiSemaphore_take(cache_mutex, NULL) == RTI_OSAPI_SEMAPHORE_STATUS_OK)
+    {
+        for(i = 0; i < cacheEntriesLength; ++i)
+        {
+            if(cacheEntries[i].finalize != NULL)
+                cacheEntries[i].finalize(cacheEntries[i].config);
+
+            RTIOsapiHeap_freeArray(cacheEntries[i].config);
+            RTIOsapiHeap_freeArray(cacheEntries[i].key);
+        }
+
+        cacheEntriesLength = 0;
+
+        for(i = 0; i < indexEntriesLength; ++i)
+        {
+            eProsimaPropertyIndex_delete(indexEntries[i].index);
+            DDS_PropertyQosPolicy_finalize(&indexEntries[i].policy);
+            RTIOsapiHeap_freeArray(indexEntries[i].key);
+        }
+
+        indexEntriesLength = 0;
+        RTIOsapiSemaphore_give(cache_mutex);
+    }
+}
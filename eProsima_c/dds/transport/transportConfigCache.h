@@ -0,0 +1,84 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_TRANSPORTCONFIGCACHE_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_TRANSPORTCONFIGCACHE_H_
+
+#include "eProsima_c/config.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+struct eProsima_PropertyIndex;
+struct DDS_PropertyQosPolicy;
+
+/**
+ * \brief Maximum number of configurations stored in the cache. When the cache is full,
+ * new configurations are built but not stored.
+ */
+#ifndef EPROSIMA_TRANSPORT_CONFIG_CACHE_MAX
+#define EPROSIMA_TRANSPORT_CONFIG_CACHE_MAX 64
+#endif // EPROSIMA_TRANSPORT_CONFIG_CACHE_MAX
+
+/**
+ * \brief Function that builds a configuration from the properties "prefix.*".
+ *
+ * \param index Index of the properties.
+ * \param prefix The prefix of the properties.
+ * \param config Memory where the configuration is built. It is zeroed.
+ * \return 0 if the configuration was built. In error case -1 is returned.
+ */
+typedef int (*eProsima_TransportConfigBuild)(const struct eProsima_PropertyIndex *index, const char *prefix, void *config);
+
+/**
+ * \brief Function that releases the resources of a configuration built by eProsima_TransportConfigBuild.
+ */
+typedef void (*eProsima_TransportConfigFinalize)(void *config);
+
+/**
+ * \brief This function returns the configuration built from the properties "prefix.*".
+ *
+ * The cache is keyed by the build function, the prefix and the names and values of the properties
+ * "prefix.*", in the order of the sequence. If equal properties were used before, the stored configuration
+ * is returned without parsing the properties again. Otherwise the configuration is built and stored.
+ *
+ * The key doesn't include the state of the host, so the build function has to depend only on the
+ * properties. Results that depend on the host (network interfaces, kernel limits) have to be computed
+ * at each use.
+ *
+ * \param index Index of the properties. Cannot be NULL.
+ * \param prefix The prefix of the properties (i.e. "UDPv4"). Cannot be NULL.
+ * \param configSize Size of the configuration.
+ * \param build Function that builds the configuration. Cannot be NULL.
+ * \param finalize Function that releases the configuration. It can be NULL.
+ * \return The stored configuration. It cannot be modified and it is valid until transportConfigCache_clear
+ * is called. If the cache is full or in error case, NULL value is returned.
+ */
+const void* transportConfigCache_get(const struct eProsima_PropertyIndex *index, const char *prefix,
+        size_t configSize, eProsima_TransportConfigBuild build, eProsima_TransportConfigFinalize finalize);
+
+/**
+ * \brief This function returns an index of the properties of a policy.
+ *
+ * The cache is keyed by the names and values of the properties, in the order of the sequence. If a policy with
+ * the same properties was indexed before, the stored index is returned without sorting the properties again.
+ * Otherwise the policy is copied and the copy is indexed, so the index doesn't depend on the given policy.
+ *
+ * \param policy The policy. Cannot be NULL.
+ * \return The stored index. It is valid until transportConfigCache_clear is called. If the cache is full or in
+ * error case, NULL value is returned and the caller has to build its own index.
+ */
+const struct eProsima_PropertyIndex* transportConfigCache_getIndex(const struct DDS_PropertyQosPolicy *policy);
+
+/**
+ * \brief This function removes all the configurations and indexes from the cache. It cannot be called while
+ * some transport is being created, nor while the transports created with the stored configurations exist.
+ */
+void transportConfigCache_clear(void);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_TRANSPORTCONFIGCACHE_H_
@@ -1,6 +1,13 @@
 #include "transportPluginCommon.h"
 #include "../../sys/eProsimaDL.h"
+#include "../../sys/trace.h"
+#include "../../sys/atomic.h"
 #include "../../macros/snprintf.h"
+#include "transportPropertyParser.h"
+#include "transportConfigCache.h"
+#include "interfaceMatcher.h"
+#include "../qos/propertyIndex.h"
+#include "../../log/logFile.h"
 
 #include <dds_c/dds_c_string.h>
 #include <dds_c/dds_c_infrastructure.h>
@@ -8,10 +15,12 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <stddef.h>
 
 #define MAX_KEY_LENGTH 255
 #define MAX_VALUE_DATA_LENGTH 16383
 #define MAX_PACKET_SIZE 65536
+#define UDPV4_AUTO_SOCKET_BUFFER_SIZE_DEFAULT (4 * 1024 * 1024)
 
 // Forward Declarations
 unsigned long getDeviceGuid(char* buff, unsigned long bufferLength);
@@ -21,14 +30,27 @@ unsigned long getDeviceGuid(char* buff, unsigned long bufferLength);
 *  LogFile for the library.
 *
 */
-static FILE *logFile = NULL;
+static struct eProsima_LogFile *logFile = NULL;
 
 static struct RTIOsapiSemaphore *log_mutex = NULL;
 
+static void addWritten(size_t *written, int result)
+{
+	if(result > 0)
+		*written += (size_t)result;
+}
+
 void log_debug(const char *text)
 {
+	FILE *file = NULL;
+	int handle = 0;
+	size_t written = 0;
+
 	if(RTIOsapiSemaphore_take(log_mutex, NULL) == RTI_OSAPI_SEMAPHORE_STATUS_OK) {
-		fprintf(logFile, "Thread_%d: %s\n",RTIOsapiThread_getCurrentThreadID(), text );
+		file = eProsimaLogFile_acquire(logFile, &handle);
+		addWritten(&written, fprintf(file, "Thread_%d: %s\n",RTIOsapiThread_getCurrentThreadID(), text ));
+		fflush(file);
+		eProsimaLogFile_release(logFile, handle, written);
 		if(RTIOsapiSemaphore_give(log_mutex)!= RTI_OSAPI_SEMAPHORE_STATUS_OK) {
 		}
 	}
@@ -36,16 +58,22 @@ void log_debug(const char *text)
 	{
 		fprintf(stderr, "Thread_%d - %s: failed to take mutex\n", RTIOsapiThread_getCurrentThreadID(), __FUNCTION__);
 	}
-	fflush(logFile);
 }
 
 void log_debugf(const char *format, ...)
 {
 	va_list arg_ptr ;
+	FILE *file = NULL;
+	int handle = 0;
+	size_t written = 0;
+
 	if(RTIOsapiSemaphore_take(log_mutex, NULL) == RTI_OSAPI_SEMAPHORE_STATUS_OK) {
+		file = eProsimaLogFile_acquire(logFile, &handle);
 		va_start( arg_ptr, format ) ;
-		vfprintf(logFile,format,arg_ptr) ;
+		addWritten(&written, vfprintf(file,format,arg_ptr));
 		va_end(arg_ptr);
+		fflush(file);
+		eProsimaLogFile_release(logFile, handle, written);
 		if(RTIOsapiSemaphore_give(log_mutex)!= RTI_OSAPI_SEMAPHORE_STATUS_OK) {
 		}
 	}
@@ -53,7 +81,6 @@ void log_debugf(const char *format, ...)
 	{
 		fprintf(stderr, "Thread_%d - %s: failed to take mutex\n", RTIOsapiThread_getCurrentThreadID(), __FUNCTION__);
 	}
-	fflush(logFile);
 }
 
 
@@ -61,20 +88,26 @@ void log_hexdump(const char *text, const char *buf, int len, int bytesPerLine)
 {
 	size_t i;
 	int count = 1;
+	FILE *file = NULL;
+	int handle = 0;
+	size_t written = 0;
+
 	if(text != NULL)
 	{
 		log_debug(text);
 	}
+	file = eProsimaLogFile_acquire(logFile, &handle);
 	for(i=0; i < len; i++)
 	{
-		fprintf(logFile," %02X", ((const unsigned char*)buf)[i]);
+		addWritten(&written, fprintf(file," %02X", ((const unsigned char*)buf)[i]));
 		if(count%bytesPerLine == 0)
 		{    
-			fputc('\n', logFile);
+			addWritten(&written, fputc('\n', file) != EOF);
 		}
 		count++;
 	}
-	fflush(logFile);
+	fflush(file);
+	eProsimaLogFile_release(logFile, handle, written);
 }
 
 void log_address(const NDDS_Transport_Address_t *address)
@@ -82,7 +115,6 @@ void log_address(const NDDS_Transport_Address_t *address)
 	char buf[64];
 	NDDS_Transport_Address_to_string(address, buf, 64);
 	log_debug(buf);
-	fflush(logFile);
 }
 
 void log_rtps_message(const char *text, const NDDS_Transport_Buffer_t buffer_in[], RTI_INT32 buffer_count_in, int bytesPerLine)
@@ -94,7 +126,7 @@ void log_rtps_message(const char *text, const NDDS_Transport_Buffer_t buffer_in[
 		{
 			log_hexdump(i == 0 ? text : NULL, buffer_in[i].pointer, buffer_in[i].length, bytesPerLine);
 		}
-		fputc('\n', logFile);
+		log_debugf("\n");
 		if(RTIOsapiSemaphore_give(log_mutex)!= RTI_OSAPI_SEMAPHORE_STATUS_OK) {
 		}
 	}
@@ -102,12 +134,16 @@ void log_rtps_message(const char *text, const NDDS_Transport_Buffer_t buffer_in[
 	{
 		fprintf(stderr, "Thread_%d - %s: failed to take mutex\n", RTIOsapiThread_getCurrentThreadID(), __FUNCTION__);
 	}
-	fflush(logFile);
 }
 
 void log_init(const char *fileName)
 {
-    const char* const METHOD_NAME = "log_init";
+	log_initWithRotation(fileName, NULL);
+}
+
+void log_initWithRotation(const char *fileName, const struct eProsima_LogRotationConfig *rotation)
+{
+    const char* const METHOD_NAME = "log_initWithRotation";
 
 	if(log_mutex == NULL)
 	{
@@ -121,35 +157,88 @@ void log_init(const char *fileName)
 
 	if(logFile == NULL)
 	{
-        if(fileName != NULL)
+        if(RTIOsapiSemaphore_take(log_mutex, NULL) == RTI_OSAPI_SEMAPHORE_STATUS_OK)
         {
-            if(RTIOsapiSemaphore_take(log_mutex, NULL) == RTI_OSAPI_SEMAPHORE_STATUS_OK)
-            {
-                logFile = fopen(fileName, "a");
+            // Without file name the standard output is used.
+            logFile = eProsimaLogFile_open(fileName, rotation);
 
-                if(RTIOsapiSemaphore_give(log_mutex)!= RTI_OSAPI_SEMAPHORE_STATUS_OK)
-                {
-                    fprintf(stdout, "Thread_%d - %s: failed to give log mutex\n", RTIOsapiThread_getCurrentThreadID(), __FUNCTION__);
-                }
+            if(RTIOsapiSemaphore_give(log_mutex)!= RTI_OSAPI_SEMAPHORE_STATUS_OK)
+            {
+                fprintf(stdout, "Thread_%d - %s: failed to give log mutex\n", RTIOsapiThread_getCurrentThreadID(), __FUNCTION__);
             }
         }
-        if(logFile == NULL)
+	}
+}
+
+/****************
+*
+*  Subtransports preloaded by preloadTransportPlugins.
+*
+*/
+struct PreloadedPlugin
+{
+	char *libraryName;
+	char *functionName;
+	NDDS_Transport_create_plugin functionPointer;
+};
+
+static struct PreloadedPlugin *preloadedPlugins = NULL;
+
+static int preloadedPluginsLength = 0;
+
+static struct RTIOsapiSemaphore *preload_mutex = NULL;
+
+/**
+* \brief This function returns the mutex of the preloaded subtransports. The first call creates it; when several
+* threads create it at the same time, only one of the mutexes is published and the others are deleted.
+*
+* \return The mutex. In error case, NULL value is returned.
+*/
+static struct RTIOsapiSemaphore* getPreloadMutex(void)
+{
+	struct RTIOsapiSemaphore *mutex = (struct RTIOsapiSemaphore*)EPROSIMA_ATOMIC_LOADPTR(&preload_mutex);
+
+	if(mutex == NULL)
+	{
+		mutex = RTIOsapiSemaphore_new(RTI_OSAPI_SEMAPHORE_KIND_MUTEX, NULL);
+
+		if(mutex != NULL && !EPROSIMA_ATOMIC_CASPTR(&preload_mutex, NULL, mutex))
 		{
-			logFile = stdout;
+			RTIOsapiSemaphore_delete(mutex);
+			mutex = (struct RTIOsapiSemaphore*)EPROSIMA_ATOMIC_LOADPTR(&preload_mutex);
 		}
 	}
+
+	return mutex;
 }
 
 /**
-* \brief This function gets the properties of the subtransport.
+* \brief This function returns the create function of a preloaded subtransport.
 *
-* \param transportProperties Structure with the transport properties. Cannot be NULL.
-* \param subtransportProperties Structure where the subtransport properties will be stored. Cannot be NULL.
-* The structure must be initialized.
-* \param subtransportName The name of the subtransport.
+* \return The create function. If the subtransport was not preloaded, NULL value is returned.
 */
-void getSubtransportProperties(const struct DDS_PropertyQosPolicy *transportProperties, struct DDS_PropertyQosPolicy *subtransportProperties,
-							   const char *subtransportName);
+static NDDS_Transport_create_plugin findPreloadedPlugin(const char *libraryName, const char *functionName)
+{
+	struct RTIOsapiSemaphore *mutex = (struct RTIOsapiSemaphore*)EPROSIMA_ATOMIC_LOADPTR(&preload_mutex);
+	NDDS_Transport_create_plugin functionPointer = NULL;
+	int i = 0;
+
+	if(mutex != NULL && RTIOsapiSemaphore_take(mutex, NULL) == RTI_OSAPI_SEMAPHORE_STATUS_OK)
+	{
+		for(i = 0; i < preloadedPluginsLength && functionPointer == NULL; ++i)
+		{
+			if(strcmp(preloadedPlugins[i].libraryName, libraryName) == 0 &&
+					strcmp(preloadedPlugins[i].functionName, functionName) == 0)
+			{
+				functionPointer = preloadedPlugins[i].functionPointer;
+			}
+		}
+
+		RTIOsapiSemaphore_give(mutex);
+	}
+
+	return functionPointer;
+}
 
 /* Implementation */
 
@@ -163,19 +252,28 @@ NDDS_Transport_create_plugin loadLibrary(const char *libraryName,
 	{
 		void *libraryHandle;
 
-		libraryHandle = eProsimaLoadLibrary(libraryName);
+		EPROSIMA_TRACE_BEGIN("loadLibrary", libraryName);
 
-		if(libraryHandle != 0)
-		{
-			functionPointer = (NDDS_Transport_create_plugin)eProsimaGetProcAddress(libraryHandle, functionName);;
+		functionPointer = findPreloadedPlugin(libraryName, functionName);
 
-			if(functionPointer == NULL)
-				printf("ERROR<%s>: Cannot load the function %s from library %s\n", METHOD_NAME, functionName, libraryName);
-		}
-		else
+		if(functionPointer == NULL)
 		{
-			printf("ERROR<%s>: Cannot load the library %s\n", METHOD_NAME, libraryName);
+			libraryHandle = eProsimaLoadLibrary(libraryName);
+
+			if(libraryHandle != 0)
+			{
+				functionPointer = (NDDS_Transport_create_plugin)eProsimaGetProcAddress(libraryHandle, functionName);;
+
+				if(functionPointer == NULL)
+					printf("ERROR<%s>: Cannot load the function %s from library %s\n", METHOD_NAME, functionName, libraryName);
+			}
+			else
+			{
+				printf("ERROR<%s>: Cannot load the library %s\n", METHOD_NAME, libraryName);
+			}
 		}
+
+		EPROSIMA_TRACE_END("loadLibrary");
 	}
 	else
 	{
@@ -185,476 +283,557 @@ NDDS_Transport_create_plugin loadLibrary(const char *libraryName,
 	return functionPointer;
 }
 
-NDDS_Transport_Plugin* loadTransportUDPv4(const struct DDS_PropertyQosPolicy *property_in)
+int preloadTransportPlugins(const struct DDS_PropertyQosPolicy *property_in, int flags, int threadCount)
 {
-	const char* const METHOD_NAME = "loadTransportUDPv4";
-    char pluginName[] = "UDPv4";
-	NDDS_Transport_Plugin *newPlugin = NULL;
-    struct NDDS_Transport_UDPv4_Property_t propertyUDPv4 = NDDS_TRANSPORT_UDPV4_PROPERTY_DEFAULT;
-	struct DDS_Property_t *auxProperty = NULL;
-	int auxLength = 0;
+	const char* const METHOD_NAME = "preloadTransportPlugins";
+	const char suffix[] = ".library";
+	const int suffixLength = sizeof(suffix) - 1;
+	struct DDS_Property_t *auxProperty = NULL, *auxProperty2 = NULL;
+	struct PreloadedPlugin *newPreloadedPlugins = NULL;
+	struct RTIOsapiSemaphore *mutex = NULL;
+	const char **libraries = NULL, **functions = NULL;
+	void **handles = NULL;
+	NDDS_Transport_create_plugin functionPointer = NULL;
+	int returnedValue = -1, propertiesLength = 0, count = 0, i = 0, auxLength = 0;
 	char *auxString = NULL;
 
-	if(pluginName != NULL && property_in != NULL)
+	if(property_in == NULL)
 	{
-        // Property UDPv4.send_socket_buffer_size
-		auxLength = strlen(pluginName) + strlen(".send_socket_buffer_size") + 1; // "UDPv4.send_socket_buffer_size"
-		auxString = DDS_String_alloc(auxLength);
+		printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+		return returnedValue;
+	}
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".send_socket_buffer_size");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.send_socket_buffer_size"
+	mutex = getPreloadMutex();
 
-			if(auxProperty != NULL)
-			{
-                if(sscanf(auxProperty->value, "%d", &propertyUDPv4.send_socket_buffer_size) != 1 ||
-                        propertyUDPv4.send_socket_buffer_size < propertyUDPv4.parent.message_size_max)
-                {
-                    printf("ERROR<%s>: Bad value for UDPv4.send_socket_buffer_size\n", METHOD_NAME);
-                    propertyUDPv4.send_socket_buffer_size = NDDS_TRANSPORT_UDPV4_MESSAGE_SIZE_MAX_DEFAULT;
-                }
-			}
+	if(mutex == NULL)
+	{
+		printf("ERROR<%s>: Cannot create preload mutex\n", METHOD_NAME);
+		return returnedValue;
+	}
 
-            DDS_String_free(auxString);
-		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
-        
-        // Property UDPv4.recv_socket_buffer_size
-		auxLength = strlen(pluginName) + strlen(".recv_socket_buffer_size") + 1; // "UDPv4.recv_socket_buffer_size
-		auxString = DDS_String_alloc(auxLength);
+	propertiesLength = DDS_PropertySeq_get_length(&property_in->value);
+	RTIOsapiHeap_allocateArray(&libraries, propertiesLength + 1, const char*);
+	RTIOsapiHeap_allocateArray(&functions, propertiesLength + 1, const char*);
+	RTIOsapiHeap_allocateArray(&handles, propertiesLength + 1, void*);
 
-		if(auxString != NULL)
+	if(libraries != NULL && functions != NULL && handles != NULL)
+	{
+		// Look for the pairs "pluginName.library" and "pluginName.create_function".
+		for(i = 0; i < propertiesLength; ++i)
 		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".recv_socket_buffer_size");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.recv_socket_buffer_size"
+			auxProperty = DDS_PropertySeq_get_reference(&property_in->value, i);
+			auxLength = (auxProperty != NULL && auxProperty->name != NULL) ? (int)strlen(auxProperty->name) : 0;
 
-			if(auxProperty != NULL)
+			if(auxLength > suffixLength && strcmp(auxProperty->name + auxLength - suffixLength, suffix) == 0)
 			{
-                if(sscanf(auxProperty->value, "%d", &propertyUDPv4.recv_socket_buffer_size) != 1 ||
-                        propertyUDPv4.recv_socket_buffer_size < propertyUDPv4.parent.message_size_max)
-                {
-                    printf("ERROR<%s>: Bad value for UDPv4.recv_socket_buffer_size\n", METHOD_NAME);
-                    propertyUDPv4.recv_socket_buffer_size = NDDS_TRANSPORT_UDPV4_MESSAGE_SIZE_MAX_DEFAULT;
-                }
-			}
+				auxLength = auxLength - suffixLength + strlen(".create_function") + 1; // "pluginName.create_function"
+				auxString = DDS_String_alloc(auxLength);
 
-            DDS_String_free(auxString);
-		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
-        
-        // Property UDPv4.unicast_enabled
-		auxLength = strlen(pluginName) + strlen(".unicast_enabled") + 1; // "UDPv4.unicast_enabled
-		auxString = DDS_String_alloc(auxLength);
+				if(auxString != NULL)
+				{
+					SNPRINTF(auxString, auxLength, "%.*s%s", (int)(strlen(auxProperty->name) - suffixLength),
+							auxProperty->name, ".create_function");
+					auxProperty2 = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString);
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".unicast_enabled");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.unicast_enabled
+					if(auxProperty2 != NULL)
+					{
+						if(findPreloadedPlugin(auxProperty->value, auxProperty2->value) == NULL)
+						{
+							libraries[count] = auxProperty->value;
+							functions[count] = auxProperty2->value;
+							handles[count] = NULL;
+							++count;
+						}
+					}
+					else
+					{
+						printf("ERROR<%s>: There is not defined %s\n", METHOD_NAME, auxString);
+					}
 
-			if(auxProperty != NULL)
-			{
-                if(sscanf(auxProperty->value, "%d", &propertyUDPv4.unicast_enabled) != 1 ||
-                        propertyUDPv4.unicast_enabled < 0 ||
-                        propertyUDPv4.unicast_enabled > 1)
-                {
-                    printf("ERROR<%s>: Bad value for UDPv4.unicast_enabled\n", METHOD_NAME);
-                    propertyUDPv4.unicast_enabled = 1;
-                }
+					DDS_String_free(auxString);
+				}
+				else
+				{
+					printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
+				}
 			}
-
-            DDS_String_free(auxString);
 		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
-        
-        // Property UDPv4.multicast_enabled
-		auxLength = strlen(pluginName) + strlen(".multicast_enabled") + 1; // "UDPv4.multicast_enabled
-		auxString = DDS_String_alloc(auxLength);
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".multicast_enabled");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.multicast_enabled
+		returnedValue = 0;
 
-			if(auxProperty != NULL)
+		if(count > 0 && eProsimaLoadLibraries(libraries, handles, count, flags, threadCount) >= 0)
+		{
+			if(RTIOsapiSemaphore_take(mutex, NULL) == RTI_OSAPI_SEMAPHORE_STATUS_OK)
 			{
-                if(sscanf(auxProperty->value, "%d", &propertyUDPv4.multicast_enabled) != 1 ||
-                        propertyUDPv4.multicast_enabled < 0 ||
-                        propertyUDPv4.multicast_enabled > 1)
-                {
-                    printf("ERROR<%s>: Bad value for UDPv4.multicast_enabled\n", METHOD_NAME);
-                    propertyUDPv4.multicast_enabled = NDDS_TRANSPORT_UDPV4_USE_MULTICAST_DEFAULT;
-                }
-			}
+				RTIOsapiHeap_allocateArray(&newPreloadedPlugins, preloadedPluginsLength + count, struct PreloadedPlugin);
 
-            DDS_String_free(auxString);
-		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
-        
-        // Property UDPv4.multicast_ttl
-		auxLength = strlen(pluginName) + strlen(".multicast_ttl") + 1; // "UDPv4.multicast_ttl
-		auxString = DDS_String_alloc(auxLength);
+				if(newPreloadedPlugins != NULL)
+				{
+					if(preloadedPluginsLength > 0)
+					{
+						memcpy(newPreloadedPlugins, preloadedPlugins, preloadedPluginsLength * sizeof(struct PreloadedPlugin));
+						RTIOsapiHeap_freeArray(preloadedPlugins);
+					}
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".multicast_ttl");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.multicast_ttl
+					preloadedPlugins = newPreloadedPlugins;
 
-			if(auxProperty != NULL)
-			{
-                if(sscanf(auxProperty->value, "%d", &propertyUDPv4.multicast_ttl) != 1)
-                {
-                    printf("ERROR<%s>: Bad value for UDPv4.multicast_ttl\n", METHOD_NAME);
-                    propertyUDPv4.multicast_ttl = NDDS_TRANSPORT_UDPV4_MULTICAST_TTL_DEFAULT;
-                }
-			}
+					for(i = 0; i < count; ++i)
+					{
+						if(handles[i] != NULL)
+						{
+							functionPointer = (NDDS_Transport_create_plugin)eProsimaGetProcAddress(handles[i], functions[i]);
+
+							if(functionPointer != NULL)
+							{
+								preloadedPlugins[preloadedPluginsLength].libraryName = DDS_String_dup(libraries[i]);
+								preloadedPlugins[preloadedPluginsLength].functionName = DDS_String_dup(functions[i]);
+								preloadedPlugins[preloadedPluginsLength].functionPointer = functionPointer;
+								++preloadedPluginsLength;
+								++returnedValue;
+							}
+							else
+							{
+								printf("ERROR<%s>: Cannot load the function %s from library %s\n", METHOD_NAME, functions[i], libraries[i]);
+							}
+						}
+						else
+						{
+							printf("ERROR<%s>: Cannot load the library %s\n", METHOD_NAME, libraries[i]);
+						}
+					}
+				}
+				else
+				{
+					printf("ERROR<%s>: Cannot allocate memory for the preloaded subtransports\n", METHOD_NAME);
+				}
 
-            DDS_String_free(auxString);
-		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
+				RTIOsapiSemaphore_give(mutex);
+			}
 		}
-        
-        // Property UDPv4.multicast_loopback_disabled
-		auxLength = strlen(pluginName) + strlen(".multicast_loopback_disabled") + 1; // "UDPv4.multicast_loopback_disabled
-		auxString = DDS_String_alloc(auxLength);
+	}
+	else
+	{
+		printf("ERROR<%s>: Cannot allocate memory\n", METHOD_NAME);
+	}
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".multicast_loopback_disabled");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.multicast_loopback_disabled
+	if(libraries != NULL)
+		RTIOsapiHeap_freeArray(libraries);
+	if(functions != NULL)
+		RTIOsapiHeap_freeArray(functions);
+	if(handles != NULL)
+		RTIOsapiHeap_freeArray(handles);
 
-			if(auxProperty != NULL)
-			{
-                if(sscanf(auxProperty->value, "%d", &propertyUDPv4.multicast_loopback_disabled) != 1 ||
-                        propertyUDPv4.multicast_loopback_disabled < 0 ||
-                        propertyUDPv4.multicast_loopback_disabled > 1)
-                {
-                    printf("ERROR<%s>: Bad value for UDPv4.multicast_loopback_disabled\n", METHOD_NAME);
-                    propertyUDPv4.multicast_loopback_disabled = 0;
-                }
-			}
+	return returnedValue;
+}
 
-            DDS_String_free(auxString);
-		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
-        
-        // Property UDPv4.ignore_loopback_interface
-		auxLength = strlen(pluginName) + strlen(".ignore_loopback_interface") + 1; // "UDPv4.ignore_loopback_interface
-		auxString = DDS_String_alloc(auxLength);
+/**
+* \brief Properties of the UDPv4 subtransport. Their names are prefixed with "UDPv4.".
+*/
+static const struct eProsima_PropertyDescriptor UDPv4PropertyDescriptors[] =
+{
+	EPROSIMA_PROPERTY_INT_MIN_FIELD_AUTO(struct NDDS_Transport_UDPv4_Property_t, "send_socket_buffer_size", send_socket_buffer_size,
+		parent.message_size_max, NDDS_TRANSPORT_UDPV4_MESSAGE_SIZE_MAX_DEFAULT),
+	EPROSIMA_PROPERTY_INT_MIN_FIELD_AUTO(struct NDDS_Transport_UDPv4_Property_t, "recv_socket_buffer_size", recv_socket_buffer_size,
+		parent.message_size_max, NDDS_TRANSPORT_UDPV4_MESSAGE_SIZE_MAX_DEFAULT),
+	EPROSIMA_PROPERTY_INT(struct NDDS_Transport_UDPv4_Property_t, "unicast_enabled", unicast_enabled, 0, 1, 1),
+	EPROSIMA_PROPERTY_INT(struct NDDS_Transport_UDPv4_Property_t, "multicast_enabled", multicast_enabled, 0, 1,
+		NDDS_TRANSPORT_UDPV4_USE_MULTICAST_DEFAULT),
+	EPROSIMA_PROPERTY_INT(struct NDDS_Transport_UDPv4_Property_t, "multicast_ttl", multicast_ttl, INT_MIN, INT_MAX,
+		NDDS_TRANSPORT_UDPV4_MULTICAST_TTL_DEFAULT),
+	EPROSIMA_PROPERTY_INT(struct NDDS_Transport_UDPv4_Property_t, "multicast_loopback_disabled", multicast_loopback_disabled, 0, 1, 0),
+	EPROSIMA_PROPERTY_INT(struct NDDS_Transport_UDPv4_Property_t, "ignore_loopback_interface", ignore_loopback_interface, -1, 1, -1),
+	EPROSIMA_PROPERTY_INT(struct NDDS_Transport_UDPv4_Property_t, "ignore_nonrunning_interfaces", ignore_nonrunning_interfaces, 0, 1, 0),
+	EPROSIMA_PROPERTY_INT(struct NDDS_Transport_UDPv4_Property_t, "no_zero_copy", no_zero_copy, INT_MIN, INT_MAX, 0),
+	EPROSIMA_PROPERTY_INT(struct NDDS_Transport_UDPv4_Property_t, "send_blocking", send_blocking, NDDS_TRANSPORT_UDPV4_BLOCKING_NEVER,
+		NDDS_TRANSPORT_UDPV4_BLOCKING_UNICAST_ONLY, NDDS_TRANSPORT_UDPV4_BLOCKING_DEFAULT),
+	EPROSIMA_PROPERTY_HEX(struct NDDS_Transport_UDPv4_Property_t, "transport_priority_mask", transport_priority_mask, 0),
+	EPROSIMA_PROPERTY_HEX(struct NDDS_Transport_UDPv4_Property_t, "transport_priority_mapping_low", transport_priority_mapping_low, 0),
+	EPROSIMA_PROPERTY_HEX(struct NDDS_Transport_UDPv4_Property_t, "transport_priority_mapping_high", transport_priority_mapping_high, 0xff),
+	EPROSIMA_PROPERTY_INT(struct NDDS_Transport_UDPv4_Property_t, "send_ping", send_ping, INT_MIN, INT_MAX, 1),
+	EPROSIMA_PROPERTY_INT(struct NDDS_Transport_UDPv4_Property_t, "parent.message_size_max", parent.message_size_max, INT_MIN, INT_MAX, 9216),
+	// TODO Get MIN define from RTI DDS
+	EPROSIMA_PROPERTY_INT(struct NDDS_Transport_UDPv4_Property_t, "parent.gather_send_buffer_count_max", parent.gather_send_buffer_count_max,
+		INT_MIN, INT_MAX, 3),
+	EPROSIMA_PROPERTY_STRING_LIST(struct NDDS_Transport_UDPv4_Property_t, "parent.allow_interfaces_list", parent.allow_interfaces_list,
+		parent.allow_interfaces_list_length),
+	EPROSIMA_PROPERTY_STRING_LIST(struct NDDS_Transport_UDPv4_Property_t, "parent.deny_interfaces_list", parent.deny_interfaces_list,
+		parent.deny_interfaces_list_length),
+	EPROSIMA_PROPERTY_STRING_LIST(struct NDDS_Transport_UDPv4_Property_t, "parent.allow_multicast_interfaces_list",
+		parent.allow_multicast_interfaces_list, parent.allow_multicast_interfaces_list_length),
+	EPROSIMA_PROPERTY_STRING_LIST(struct NDDS_Transport_UDPv4_Property_t, "parent.deny_multicast_interfaces_list",
+		parent.deny_multicast_interfaces_list, parent.deny_multicast_interfaces_list_length)
+};
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".ignore_loopback_interface");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.ignore_loopback_interface
+/**
+* \brief This function replaces the patterns of an interface list (names, wildcards and CIDR blocks)
+* with the addresses of the local interfaces that match them.
+*
+* \return 0 on success. If an allow list becomes empty, which would allow all the interfaces, -1 is returned.
+*/
+static int resolveUDPv4InterfacesList(const char *name, char ***list, RTI_INT32 *listLength, int isAllowList)
+{
+	const char* const METHOD_NAME = "resolveUDPv4InterfacesList";
+	int length = *listLength, returnedValue = 0;
 
-			if(auxProperty != NULL)
-			{
-                if(sscanf(auxProperty->value, "%d", &propertyUDPv4.ignore_loopback_interface) != 1 ||
-                        propertyUDPv4.ignore_loopback_interface < -1 ||
-                        propertyUDPv4.ignore_loopback_interface > 1)
-                {
-                    printf("ERROR<%s>: Bad value for UDPv4.ignore_loopback_interface\n", METHOD_NAME);
-                    propertyUDPv4.ignore_loopback_interface = -1;
-                }
-			}
+	// The plain names and addresses that match no interface are kept, so only an empty list is an error.
+	if(length > 0 && resolveInterfacesList(list, &length) == 0 && isAllowList && length == 0)
+	{
+		printf("ERROR<%s>: No interface matches UDPv4.%s\n", METHOD_NAME, name);
+		returnedValue = -1;
+	}
 
-            DDS_String_free(auxString);
-		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
-        
-        // Property UDPv4.ignore_nonrunning_interfaces
-		auxLength = strlen(pluginName) + strlen(".ignore_nonrunning_interfaces") + 1; // "UDPv4.ignore_nonrunning_interfaces
-		auxString = DDS_String_alloc(auxLength);
+	*listLength = length;
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".ignore_nonrunning_interfaces");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.ignore_nonrunning_interfaces
+	return returnedValue;
+}
 
-			if(auxProperty != NULL)
-			{
-                if(sscanf(auxProperty->value, "%d", &propertyUDPv4.ignore_nonrunning_interfaces) != 1 ||
-                        propertyUDPv4.ignore_nonrunning_interfaces < 0 ||
-                        propertyUDPv4.ignore_nonrunning_interfaces > 1)
-                {
-                    printf("ERROR<%s>: Bad value for UDPv4.ignore_nonrunning_interfaces\n", METHOD_NAME);
-                    propertyUDPv4.ignore_nonrunning_interfaces = 0;
-                }
-			}
+static int resolveUDPv4InterfacesLists(struct NDDS_Transport_UDPv4_Property_t *propertyUDPv4)
+{
+	int returnedValue = 0;
+
+	returnedValue |= resolveUDPv4InterfacesList("parent.allow_interfaces_list", &propertyUDPv4->parent.allow_interfaces_list,
+		&propertyUDPv4->parent.allow_interfaces_list_length, 1);
+	returnedValue |= resolveUDPv4InterfacesList("parent.deny_interfaces_list", &propertyUDPv4->parent.deny_interfaces_list,
+		&propertyUDPv4->parent.deny_interfaces_list_length, 0);
+	returnedValue |= resolveUDPv4InterfacesList("parent.allow_multicast_interfaces_list",
+		&propertyUDPv4->parent.allow_multicast_interfaces_list, &propertyUDPv4->parent.allow_multicast_interfaces_list_length, 1);
+	returnedValue |= resolveUDPv4InterfacesList("parent.deny_multicast_interfaces_list",
+		&propertyUDPv4->parent.deny_multicast_interfaces_list, &propertyUDPv4->parent.deny_multicast_interfaces_list_length, 0);
+
+	return returnedValue;
+}
 
-            DDS_String_free(auxString);
-		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
-        
-        // Property UDPv4.no_zero_copy
-		auxLength = strlen(pluginName) + strlen(".no_zero_copy") + 1; // "UDPv4.no_zero_copy
-		auxString = DDS_String_alloc(auxLength);
+/**
+* \brief This function reads the maximum socket buffer size allowed by the kernel.
+*
+* \param path "/proc/sys/net/core/rmem_max" or "/proc/sys/net/core/wmem_max".
+* \return The maximum size. If it is unknown, -1 is returned.
+*/
+static int readKernelSocketBufferMax(const char *path)
+{
+	int returnedValue = -1;
+#if defined(RTI_LINUX)
+	char buffer[32];
+	size_t length = 0;
+	FILE *file = fopen(path, "r");
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".no_zero_copy");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.no_zero_copy
+	if(file != NULL)
+	{
+		length = fread(buffer, 1, sizeof(buffer) - 1, file);
+		buffer[length] = '\0';
 
-			if(auxProperty != NULL)
-			{
-                if(sscanf(auxProperty->value, "%d", &propertyUDPv4.no_zero_copy) != 1)
-                {
-                    printf("ERROR<%s>: Bad value for UDPv4.no_zero_copy\n", METHOD_NAME);
-                    propertyUDPv4.no_zero_copy = 0;
-                }
-			}
+		if(parsePropertyInteger(buffer, 0, &returnedValue) != 0 || returnedValue <= 0)
+			returnedValue = -1;
 
-            DDS_String_free(auxString);
-		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
-        
-        // Property UDPv4.send_blocking
-		auxLength = strlen(pluginName) + strlen(".send_blocking") + 1; // "UDPv4.send_blocking
-		auxString = DDS_String_alloc(auxLength);
+		fclose(file);
+	}
+#endif
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".send_blocking");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.send_blocking
+	return returnedValue;
+}
 
-			if(auxProperty != NULL)
-			{
-                if(sscanf(auxProperty->value, "%d", &propertyUDPv4.send_blocking) != 1 ||
-                        propertyUDPv4.send_blocking < NDDS_TRANSPORT_UDPV4_BLOCKING_NEVER ||
-                        propertyUDPv4.send_blocking > NDDS_TRANSPORT_UDPV4_BLOCKING_UNICAST_ONLY)
-                {
-                    printf("ERROR<%s>: Bad value for UDPv4.send_blocking\n", METHOD_NAME);
-                    propertyUDPv4.send_blocking = NDDS_TRANSPORT_UDPV4_BLOCKING_DEFAULT;
-                }
-			}
+/**
+* \brief This function chooses the size of a socket buffer configured as "auto".
+*
+* The buffer has to hold the expected burst plus one message. If no burst is declared, the largest
+* size allowed by the kernel is used. The size is clamped to the kernel limit and it is never lower
+* than parent.message_size_max.
+*/
+static int chooseUDPv4SocketBufferSize(const char *name, const char *kernelMaxPath, int messageSizeMax, int expectedBurstSize)
+{
+	const char* const METHOD_NAME = "chooseUDPv4SocketBufferSize";
+	int kernelMax = readKernelSocketBufferMax(kernelMaxPath);
+	int size = 0;
 
-            DDS_String_free(auxString);
-		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
-        
-        // Property UDPv4.transport_priority_mask
-		auxLength = strlen(pluginName) + strlen(".transport_priority_mask") + 1; // "UDPv4.transport_priority_mask
-		auxString = DDS_String_alloc(auxLength);
+	if(expectedBurstSize > 0)
+		size = expectedBurstSize <= INT_MAX - messageSizeMax ? expectedBurstSize + messageSizeMax : INT_MAX;
+	else
+		size = kernelMax > 0 ? kernelMax : UDPV4_AUTO_SOCKET_BUFFER_SIZE_DEFAULT;
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".transport_priority_mask");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.transport_priority_mask
+	if(kernelMax > 0 && size > kernelMax)
+	{
+		printf("WARNING<%s>: UDPv4.%s needs %d bytes, but it is clamped to %d bytes by %s\n", METHOD_NAME,
+			name, size, kernelMax, kernelMaxPath);
+		size = kernelMax;
+	}
 
-			if(auxProperty != NULL)
-			{
-                if(sscanf(auxProperty->value, "0x%X", &propertyUDPv4.transport_priority_mask) != 1)
-                {
-                    if(sscanf(auxProperty->value, "%d", &propertyUDPv4.transport_priority_mask) != 1)
-                    {
-                        printf("ERROR<%s>: Bad value for UDPv4.transport_priority_mask\n", METHOD_NAME);
-                        propertyUDPv4.transport_priority_mask = 0;
-                    }
-                }
-			}
+	if(size < messageSizeMax)
+		size = messageSizeMax;
 
-            DDS_String_free(auxString);
-		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
-        
-        // Property UDPv4.transport_priority_mapping_low
-		auxLength = strlen(pluginName) + strlen(".transport_priority_mapping_low") + 1; // "UDPv4.transport_priority_mapping_low
-		auxString = DDS_String_alloc(auxLength);
+	return size;
+}
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".transport_priority_mapping_low");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.transport_priority_mapping_low
+/**
+* \brief This function parses the property "prefix.expected_burst_size".
+*
+* \return The expected burst. If it is not defined or it is bad, 0 is returned.
+*/
+static int parseUDPv4ExpectedBurstSize(const struct eProsima_PropertyIndex *index, const char *prefix)
+{
+	const char* const METHOD_NAME = "parseUDPv4ExpectedBurstSize";
+	struct DDS_Property_t *property = NULL;
+	int expectedBurstSize = 0;
 
-			if(auxProperty != NULL)
-			{
-                if(sscanf(auxProperty->value, "0x%X", &propertyUDPv4.transport_priority_mapping_low) != 1)
-                {
-                    if(sscanf(auxProperty->value, "%d", &propertyUDPv4.transport_priority_mapping_low) != 1)
-                    {
-                        printf("ERROR<%s>: Bad value for UDPv4.transport_priority_mapping_low\n", METHOD_NAME);
-                        propertyUDPv4.transport_priority_mapping_low = 0;
-                    }
-                }
-			}
+	property = eProsimaPropertyIndex_lookupWithPrefix(index, prefix, "expected_burst_size");
 
-            DDS_String_free(auxString);
-		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
-        
-        // Property UDPv4.transport_priority_mapping_high
-		auxLength = strlen(pluginName) + strlen(".transport_priority_mapping_high") + 1; // "UDPv4.transport_priority_mapping_high
-		auxString = DDS_String_alloc(auxLength);
+	if(property != NULL && property->value != NULL &&
+		(parsePropertyInteger(property->value, 0, &expectedBurstSize) != 0 || expectedBurstSize < 0))
+	{
+		printf("ERROR<%s>: Bad value for %s.expected_burst_size\n", METHOD_NAME, prefix);
+		expectedBurstSize = 0;
+	}
+
+	return expectedBurstSize;
+}
+
+/**
+* \brief This function resolves the socket buffer sizes configured as "auto".
+*/
+static void resolveUDPv4SocketBufferSizes(struct NDDS_Transport_UDPv4_Property_t *propertyUDPv4, int expectedBurstSize)
+{
+	if(propertyUDPv4->send_socket_buffer_size == EPROSIMA_PROPERTY_AUTO)
+	{
+		propertyUDPv4->send_socket_buffer_size = chooseUDPv4SocketBufferSize("send_socket_buffer_size",
+			"/proc/sys/net/core/wmem_max", propertyUDPv4->parent.message_size_max, expectedBurstSize);
+	}
+
+	if(propertyUDPv4->recv_socket_buffer_size == EPROSIMA_PROPERTY_AUTO)
+	{
+		propertyUDPv4->recv_socket_buffer_size = chooseUDPv4SocketBufferSize("recv_socket_buffer_size",
+			"/proc/sys/net/core/rmem_max", propertyUDPv4->parent.message_size_max, expectedBurstSize);
+	}
+}
+
+/**
+* \brief UDPv4 properties stored in the transport configuration cache. They only depend on the properties:
+* the socket buffer sizes are still "auto" and the interface lists have the patterns.
+*/
+struct UDPv4Config
+{
+	struct NDDS_Transport_UDPv4_Property_t propertyUDPv4;
+	int expectedBurstSize;
+};
+
+static int buildUDPv4Config(const struct eProsima_PropertyIndex *index, const char *prefix, void *config)
+{
+	struct UDPv4Config *configUDPv4 = (struct UDPv4Config*)config;
+	struct NDDS_Transport_UDPv4_Property_t propertyUDPv4 = NDDS_TRANSPORT_UDPV4_PROPERTY_DEFAULT;
+
+	parseTransportPropertiesFromIndex(index, prefix, UDPv4PropertyDescriptors,
+		sizeof(UDPv4PropertyDescriptors) / sizeof(UDPv4PropertyDescriptors[0]), &propertyUDPv4);
+	memcpy(&configUDPv4->propertyUDPv4, &propertyUDPv4, sizeof(propertyUDPv4));
+	configUDPv4->expectedBurstSize = parseUDPv4ExpectedBurstSize(index, prefix);
+
+	return 0;
+}
+
+static void finalizeUDPv4Property(struct NDDS_Transport_UDPv4_Property_t *propertyUDPv4)
+{
+	// Each list and its strings were allocated together.
+	if(propertyUDPv4->parent.allow_interfaces_list != NULL)
+		RTIOsapiHeap_freeArray(propertyUDPv4->parent.allow_interfaces_list);
+	if(propertyUDPv4->parent.deny_interfaces_list != NULL)
+		RTIOsapiHeap_freeArray(propertyUDPv4->parent.deny_interfaces_list);
+	if(propertyUDPv4->parent.allow_multicast_interfaces_list != NULL)
+		RTIOsapiHeap_freeArray(propertyUDPv4->parent.allow_multicast_interfaces_list);
+	if(propertyUDPv4->parent.deny_multicast_interfaces_list != NULL)
+		RTIOsapiHeap_freeArray(propertyUDPv4->parent.deny_multicast_interfaces_list);
+
+	propertyUDPv4->parent.allow_interfaces_list = NULL;
+	propertyUDPv4->parent.allow_interfaces_list_length = 0;
+	propertyUDPv4->parent.deny_interfaces_list = NULL;
+	propertyUDPv4->parent.deny_interfaces_list_length = 0;
+	propertyUDPv4->parent.allow_multicast_interfaces_list = NULL;
+	propertyUDPv4->parent.allow_multicast_interfaces_list_length = 0;
+	propertyUDPv4->parent.deny_multicast_interfaces_list = NULL;
+	propertyUDPv4->parent.deny_multicast_interfaces_list_length = 0;
+}
+
+static void finalizeUDPv4Config(void *config)
+{
+	finalizeUDPv4Property(&((struct UDPv4Config*)config)->propertyUDPv4);
+}
+
+/**
+* \brief This function replaces an interface list with a copy, so the list of the cache is not modified.
+* If the copy fails, the list is left empty.
+*/
+static int copyUDPv4InterfacesList(char ***list, RTI_INT32 *listLength)
+{
+	char **cachedList = *list;
+	int cachedListLength = *listLength, length = 0;
+
+	*list = NULL;
+	*listLength = 0;
+
+	if(cachedList != NULL && cachedListLength > 0)
+	{
+		if(copyPropertyStringList((const char * const*)cachedList, NULL, cachedListLength, list, &length) != 0)
+			return -1;
+
+		*listLength = length;
+	}
+
+	return 0;
+}
+
+/**
+* \brief This function fills the UDPv4 properties from a configuration of the cache. The results that depend
+* on the host (interfaces and kernel limits of the socket buffers) are computed now, so each participant
+* sees the current ones. The lists are released with finalizeUDPv4Property.
+*
+* \return 0 on success. In error case -1 is returned.
+*/
+static int prepareUDPv4Property(const struct UDPv4Config *configUDPv4, struct NDDS_Transport_UDPv4_Property_t *propertyUDPv4)
+{
+	const char* const METHOD_NAME = "prepareUDPv4Property";
+	int returnedValue = 0;
+
+	memcpy(propertyUDPv4, &configUDPv4->propertyUDPv4, sizeof(struct NDDS_Transport_UDPv4_Property_t));
+
+	// All the lists are replaced, so none of them points to the cache after a failure.
+	returnedValue |= copyUDPv4InterfacesList(&propertyUDPv4->parent.allow_interfaces_list,
+		&propertyUDPv4->parent.allow_interfaces_list_length);
+	returnedValue |= copyUDPv4InterfacesList(&propertyUDPv4->parent.deny_interfaces_list,
+		&propertyUDPv4->parent.deny_interfaces_list_length);
+	returnedValue |= copyUDPv4InterfacesList(&propertyUDPv4->parent.allow_multicast_interfaces_list,
+		&propertyUDPv4->parent.allow_multicast_interfaces_list_length);
+	returnedValue |= copyUDPv4InterfacesList(&propertyUDPv4->parent.deny_multicast_interfaces_list,
+		&propertyUDPv4->parent.deny_multicast_interfaces_list_length);
+
+	if(returnedValue != 0)
+	{
+		printf("ERROR<%s>: Cannot allocate memory for the interface lists\n", METHOD_NAME);
+		finalizeUDPv4Property(propertyUDPv4);
+		return -1;
+	}
+
+	resolveUDPv4SocketBufferSizes(propertyUDPv4, configUDPv4->expectedBurstSize);
+
+	if(resolveUDPv4InterfacesLists(propertyUDPv4) != 0)
+	{
+		finalizeUDPv4Property(propertyUDPv4);
+		returnedValue = -1;
+	}
+
+	return returnedValue;
+}
+
+/**
+* \brief Subtransport properties stored in the transport configuration cache. The properties are
+* packed in an arena, so they don't depend on the transport properties.
+*/
+struct SubtransportConfig
+{
+	struct DDS_PropertyQosPolicy properties;
+	void *arena;
+};
+
+static int buildSubtransportConfig(const struct eProsima_PropertyIndex *index, const char *prefix, void *config)
+{
+	struct SubtransportConfig *subtransportConfig = (struct SubtransportConfig*)config;
+
+	DDS_PropertyQosPolicy_initialize(&subtransportConfig->properties);
+	subtransportConfig->arena = getSubtransportPropertiesArena(index, &subtransportConfig->properties, prefix,
+		EPROSIMA_SUBTRANSPORT_PROPERTIES_PACK);
+
+	return subtransportConfig->arena != NULL ? 0 : -1;
+}
+
+static void finalizeSubtransportConfig(void *config)
+{
+	struct SubtransportConfig *subtransportConfig = (struct SubtransportConfig*)config;
+
+	releaseSubtransportPropertiesArena(&subtransportConfig->properties, subtransportConfig->arena);
+	DDS_PropertyQosPolicy_finalize(&subtransportConfig->properties);
+}
+
+const struct eProsima_PropertyIndex* getTransportPropertyIndex(const struct DDS_PropertyQosPolicy *policy,
+	struct eProsima_PropertyIndex **builtIndex)
+{
+	const struct eProsima_PropertyIndex *index = NULL;
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".transport_priority_mapping_high");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.transport_priority_mapping_high
+	*builtIndex = NULL;
 
-			if(auxProperty != NULL)
-			{
-                if(sscanf(auxProperty->value, "0x%X", &propertyUDPv4.transport_priority_mapping_high) != 1)
-                {
-                    if(sscanf(auxProperty->value, "%d", &propertyUDPv4.transport_priority_mapping_high) != 1)
-                    {
-                        printf("ERROR<%s>: Bad value for UDPv4.transport_priority_mapping_high\n", METHOD_NAME);
-                        propertyUDPv4.transport_priority_mapping_high = 0xff;
-                    }
-                }
-			}
+	// Participants created from the same profile reuse the index.
+	index = transportConfigCache_getIndex(policy);
 
-            DDS_String_free(auxString);
-		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
-        
-        // Property UDPv4.send_ping
-		auxLength = strlen(pluginName) + strlen(".send_ping") + 1; // "UDPv4.send_ping
-		auxString = DDS_String_alloc(auxLength);
+	if(index == NULL)
+	{
+		*builtIndex = eProsimaPropertyIndex_new(policy);
+		index = *builtIndex;
+	}
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".send_ping");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.send_ping
+	return index;
+}
 
-			if(auxProperty != NULL)
-			{
-                if(sscanf(auxProperty->value, "%d", &propertyUDPv4.send_ping) != 1)
-                {
-                    printf("ERROR<%s>: Bad value for UDPv4.send_ping\n", METHOD_NAME);
-                    propertyUDPv4.send_ping = 1;
-                }
-            }
+NDDS_Transport_Plugin* loadTransportUDPv4(const struct DDS_PropertyQosPolicy *property_in)
+{
+	const char* const METHOD_NAME = "loadTransportUDPv4";
+	NDDS_Transport_Plugin *newPlugin = NULL;
+	const struct eProsima_PropertyIndex *index = NULL;
+	struct eProsima_PropertyIndex *builtIndex = NULL;
 
-            DDS_String_free(auxString);
-		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
+	if(property_in != NULL)
+	{
+		EPROSIMA_TRACE_BEGIN("loadTransportUDPv4", NULL);
 
-		// Property UDPv4.parent.message_size_max
-		auxLength = strlen(pluginName) + strlen(".parent.message_size_max") + 1; // "UDPv4.parent.message_size_max
-		auxString = DDS_String_alloc(auxLength);
+		index = getTransportPropertyIndex(property_in, &builtIndex);
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".parent.message_size_max");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.message_size_max
+		if(index != NULL)
+			newPlugin = loadTransportUDPv4FromIndex(index);
 
-			if(auxProperty != NULL)
-			{
-                if(sscanf(auxProperty->value, "%d", &propertyUDPv4.parent.message_size_max) != 1)
-                {
-                    printf("ERROR<%s>: Bad value for UDPv4.parent.message_size_max\n", METHOD_NAME);
-                    propertyUDPv4.parent.message_size_max = 9216;
-                }
-            }
+		eProsimaPropertyIndex_delete(builtIndex);
 
-            DDS_String_free(auxString);
-		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
+		EPROSIMA_TRACE_END("loadTransportUDPv4");
+	}
+	else
+	{
+		printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+	}
 
-		// Property UDPv4.parent.gather_send_buffer_count_max
-		auxLength = strlen(pluginName) + strlen(".parent.gather_send_buffer_count_max") + 1; // "UDPv4.parent.gather_send_buffer_count_max
-		auxString = DDS_String_alloc(auxLength);
+	return newPlugin;
+}
 
-		if(auxString != NULL)
-		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".parent.gather_send_buffer_count_max");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.gather_send_buffer_count_max
+NDDS_Transport_Plugin* loadTransportUDPv4FromIndex(const struct eProsima_PropertyIndex *index)
+{
+	const char* const METHOD_NAME = "loadTransportUDPv4FromIndex";
+	NDDS_Transport_Plugin *newPlugin = NULL;
+	const struct UDPv4Config *cachedConfigUDPv4 = NULL;
+	struct UDPv4Config configUDPv4;
+	struct NDDS_Transport_UDPv4_Property_t propertyUDPv4 = NDDS_TRANSPORT_UDPV4_PROPERTY_DEFAULT;
+	int prepared = -1;
 
-			if(auxProperty != NULL)
-			{
-                if(sscanf(auxProperty->value, "%d", &propertyUDPv4.parent.gather_send_buffer_count_max) != 1)
-                {
-                    printf("ERROR<%s>: Bad value for UDPv4.parent.gather_send_buffer_count_max\n", METHOD_NAME);
-                    // TODO Get MIN define from RTI DDS
-                    propertyUDPv4.parent.gather_send_buffer_count_max = 3;
-                }
-            }
+	if(index != NULL)
+	{
+		// Participants created from the same profile reuse the parsed properties.
+		EPROSIMA_TRACE_BEGIN("UDPv4 properties", NULL);
+		cachedConfigUDPv4 = (const struct UDPv4Config*)transportConfigCache_get(index, "UDPv4",
+			sizeof(struct UDPv4Config), buildUDPv4Config, finalizeUDPv4Config);
 
-            DDS_String_free(auxString);
+		if(cachedConfigUDPv4 != NULL)
+		{
+			prepared = prepareUDPv4Property(cachedConfigUDPv4, &propertyUDPv4);
 		}
 		else
 		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
+			memset(&configUDPv4, 0, sizeof(configUDPv4));
+			buildUDPv4Config(index, "UDPv4", &configUDPv4);
+			prepared = prepareUDPv4Property(&configUDPv4, &propertyUDPv4);
+			finalizeUDPv4Config(&configUDPv4);
 		}
+		EPROSIMA_TRACE_END("UDPv4 properties");
 
-		// Property UDPv4.parent.allow_interfaces_list
-		auxLength = strlen(pluginName) + strlen(".parent.allow_interfaces_list") + 1; // "UDPv4.parent.allow_interfaces_list
-		auxString = DDS_String_alloc(auxLength);
-
-		if(auxString != NULL)
+		if(prepared == 0)
 		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".parent.allow_interfaces_list");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Value of "UDPv4.allow_interfaces_list
-
-			if(auxProperty != NULL)
-			{
-				propertyUDPv4.parent.allow_interfaces_list_length = 1;
-				RTIOsapiHeap_allocateArray(&propertyUDPv4.parent.allow_interfaces_list, 1, char*);
-				auxLength = strlen(auxProperty->value) + 1;
-				RTIOsapiHeap_allocateArray(propertyUDPv4.parent.allow_interfaces_list, auxLength, char);
-                if(sscanf(auxProperty->value, "%s", propertyUDPv4.parent.allow_interfaces_list[0]) != 1)
-                {
-                    printf("ERROR<%s>: Bad value for UDPv4.parent.allow_interfaces_list\n", METHOD_NAME);
-					RTIOsapiHeap_freeArray(propertyUDPv4.parent.allow_interfaces_list[0]);
-					RTIOsapiHeap_freeArray(propertyUDPv4.parent.allow_interfaces_list);
-					propertyUDPv4.parent.allow_interfaces_list = NULL;
-					propertyUDPv4.parent.allow_interfaces_list_length = 0;
-                }
-            }
+			// Create the UDPv4 plugin.
+			EPROSIMA_TRACE_BEGIN("NDDS_Transport_UDPv4_new", NULL);
+			newPlugin = NDDS_Transport_UDPv4_new(&propertyUDPv4);
+			EPROSIMA_TRACE_END("NDDS_Transport_UDPv4_new");
 
-            DDS_String_free(auxString);
+			// The plugin keeps a copy of the properties.
+			finalizeUDPv4Property(&propertyUDPv4);
 		}
-		else
-		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
-		}
-
-        // Create the UDPv4 plugin.
-        newPlugin = NDDS_Transport_UDPv4_new(&propertyUDPv4);
 	}
 	else
 	{
@@ -669,68 +848,96 @@ NDDS_Transport_Plugin* loadTransportPluginFromLibrary(const char *pluginName, co
 {
 	const char* const METHOD_NAME = "loadTransportPluginFromLibrary";
 	NDDS_Transport_Plugin *newPlugin = NULL;
+	const struct eProsima_PropertyIndex *index = NULL;
+	struct eProsima_PropertyIndex *builtIndex = NULL;
+
+	if(pluginName != NULL && property_in != NULL)
+	{
+		EPROSIMA_TRACE_BEGIN("loadTransportPluginFromLibrary", pluginName);
+
+		// The index is built once per policy and used for all the lookups.
+		index = getTransportPropertyIndex(property_in, &builtIndex);
+
+		if(index != NULL)
+			newPlugin = loadTransportPluginFromIndex(pluginName, index, default_network_address_out);
+
+		eProsimaPropertyIndex_delete(builtIndex);
+
+		EPROSIMA_TRACE_END("loadTransportPluginFromLibrary");
+	}
+	else
+	{
+		printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+	}
+
+	return newPlugin;
+}
+
+NDDS_Transport_Plugin* loadTransportPluginFromIndex(const char *pluginName, const struct eProsima_PropertyIndex *index,
+													NDDS_Transport_Address_t *default_network_address_out)
+{
+	const char* const METHOD_NAME = "loadTransportPluginFromIndex";
+	NDDS_Transport_Plugin *newPlugin = NULL;
 	NDDS_Transport_create_plugin functionPointer = NULL;
 	struct DDS_Property_t *auxProperty = NULL, *auxProperty2 = NULL;
-	int auxLength = 0;
-	char *auxString = NULL;
 
-	if(pluginName != NULL && property_in != NULL)
+	if(pluginName != NULL && index != NULL)
 	{
-		auxLength = strlen(pluginName) + strlen(".library") + 1; // "pluginName.library"
-		auxString = DDS_String_alloc(auxLength);
+		auxProperty = eProsimaPropertyIndex_lookupWithPrefix(index, pluginName, "library"); // Value of "pluginName.library"
 
-		if(auxString != NULL)
+		if(auxProperty != NULL)
 		{
-			SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".library");
-			auxProperty = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString); // Valur of "pluginName.library"
+			auxProperty2 = eProsimaPropertyIndex_lookupWithPrefix(index, pluginName, "create_function"); // Value of "pluginName.create_function"
 
-			if(auxProperty != NULL)
+			if(auxProperty2 != NULL)
 			{
-				DDS_String_free(auxString);
-				auxLength = strlen(pluginName) + strlen(".create_function") + 1; // "pluginName.create_function"
-				auxString = DDS_String_alloc(auxLength);
+				functionPointer = loadLibrary(auxProperty->value, auxProperty2->value);
 
-				if(auxString != NULL)
+				if(functionPointer != NULL)
 				{
-					SNPRINTF(auxString, auxLength, "%s%s", pluginName, ".create_function");
-					auxProperty2 = DDS_PropertyQosPolicyHelper_lookup_property((struct DDS_PropertyQosPolicy*)property_in, auxString);
+					const struct DDS_PropertyQosPolicy *cachedProperties = NULL;
 
-					if(auxProperty2 != NULL)
-					{
-						functionPointer = loadLibrary(auxProperty->value, auxProperty2->value);
+					// Participants created from the same profile reuse the subtransport properties.
+					cachedProperties = (const struct DDS_PropertyQosPolicy*)transportConfigCache_get(index, pluginName,
+						sizeof(struct SubtransportConfig), buildSubtransportConfig, finalizeSubtransportConfig);
 
-						if(functionPointer != NULL)
-						{
-							struct DDS_PropertyQosPolicy newProperties;
+					if(cachedProperties != NULL)
+					{
+						EPROSIMA_TRACE_BEGIN("create_function", auxProperty2->value);
+						newPlugin = functionPointer(default_network_address_out, cachedProperties);
+						EPROSIMA_TRACE_END("create_function");
+					}
+					else
+					{
+						struct DDS_PropertyQosPolicy newProperties;
+						void *arena = NULL;
 
-							DDS_PropertyQosPolicy_initialize(&newProperties);
-							getSubtransportProperties(property_in, &newProperties, pluginName);
+						// The names and values point to the transport properties. Only one allocation is done.
+						DDS_PropertyQosPolicy_initialize(&newProperties);
+						arena = getSubtransportPropertiesArena(index, &newProperties, pluginName,
+							EPROSIMA_SUBTRANSPORT_PROPERTIES_BORROW);
 
-							newPlugin = functionPointer(default_network_address_out, &newProperties); 
+						if(arena != NULL)
+						{
+							EPROSIMA_TRACE_BEGIN("create_function", auxProperty2->value);
+							newPlugin = functionPointer(default_network_address_out, &newProperties);
+							EPROSIMA_TRACE_END("create_function");
 
-							DDS_PropertyQosPolicy_finalize(&newProperties);
+							releaseSubtransportPropertiesArena(&newProperties, arena);
 						}
-					}
-					else
-					{
-						printf("ERROR<%s>: There is not defined %s\n", METHOD_NAME, auxString);
-					}
 
-					DDS_String_free(auxString);
-				}
-				else
-				{
-					printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
+						DDS_PropertyQosPolicy_finalize(&newProperties);
+					}
 				}
 			}
 			else
 			{
-				printf("ERROR<%s>: There is not defined %s\n", METHOD_NAME, auxString);
+				printf("ERROR<%s>: There is not defined %s.create_function\n", METHOD_NAME, pluginName);
 			}
 		}
 		else
 		{
-			printf("ERROR<%s>: Cannot allocate memory to create string\n", METHOD_NAME);
+			printf("ERROR<%s>: There is not defined %s.library\n", METHOD_NAME, pluginName);
 		}
 	}
 	else
@@ -744,12 +951,40 @@ NDDS_Transport_Plugin* loadTransportPluginFromLibrary(const char *pluginName, co
 void getSubtransportProperties(const struct DDS_PropertyQosPolicy *transportProperties, struct DDS_PropertyQosPolicy *subtransportProperties,
 							   const char *subtransportName)
 {
-	struct DDS_PropertySeq property_seq;
-	struct DDS_Property_t *auxProperty = NULL, *newProperty = NULL;
+	const struct eProsima_PropertyIndex *index = NULL;
+	struct eProsima_PropertyIndex *builtIndex = NULL;
+
+	index = getTransportPropertyIndex(transportProperties, &builtIndex);
+
+	if(index != NULL)
+		getSubtransportPropertiesFromIndex(index, subtransportProperties, subtransportName);
+
+	eProsimaPropertyIndex_delete(builtIndex);
+}
+
+void getSubtransportPropertiesFromIndex(const struct eProsima_PropertyIndex *index, struct DDS_PropertyQosPolicy *subtransportProperties,
+										const char *subtransportName)
+{
+	const char* const METHOD_NAME = "getSubtransportPropertiesFromIndex";
+	struct DDS_Property_t * const *range = NULL;
+	struct DDS_Property_t **properties = NULL;
+	struct DDS_Property_t *newProperty = NULL;
 	int count = 0, transportPropertiesLength = 0, subtransportNameLength = 0;
 
-	DDS_PropertyQosPolicyHelper_get_properties((struct DDS_PropertyQosPolicy*)transportProperties, &property_seq, subtransportName);
-	transportPropertiesLength = DDS_PropertySeq_get_length(&property_seq);
+	EPROSIMA_TRACE_BEGIN("getSubtransportProperties", subtransportName);
+
+	transportPropertiesLength = eProsimaPropertyIndex_getPrefixRange(index, subtransportName, &range);
+	RTIOsapiHeap_allocateArray(&properties, transportPropertiesLength + 1, struct DDS_Property_t*);
+
+	if(properties == NULL)
+	{
+		printf("ERROR<%s>: Cannot allocate memory for the properties\n", METHOD_NAME);
+		EPROSIMA_TRACE_END("getSubtransportProperties");
+		return;
+	}
+
+	// The subtransport gets its properties in the order of the sequence.
+	eProsimaPropertyIndex_getPrefixProperties(index, subtransportName, properties);
 
 	DDS_PropertySeq_ensure_length(&subtransportProperties->value, transportPropertiesLength,
 		transportPropertiesLength);
@@ -757,19 +992,145 @@ void getSubtransportProperties(const struct DDS_PropertyQosPolicy *transportProp
 	subtransportNameLength = strlen(subtransportName) + 1; // "pluginName."
 	for(; count < transportPropertiesLength; count++)
 	{
-		auxProperty = DDS_PropertySeq_get_reference(&property_seq, count);
+		newProperty = DDS_PropertySeq_get_reference(&subtransportProperties->value, count);
 
-		if(auxProperty != NULL)
+		if(newProperty != NULL)
+		{
+			newProperty->name = DDS_String_dup(properties[count]->name + subtransportNameLength);
+			newProperty->value = DDS_String_dup(properties[count]->value);
+		}
+	}
+
+	RTIOsapiHeap_freeArray(properties);
+
+	EPROSIMA_TRACE_END("getSubtransportProperties");
+}
+
+/**
+* \brief Memory block used by getSubtransportPropertiesArena. The array of properties is followed by the
+* packed strings.
+*/
+struct SubtransportPropertiesArena
+{
+	DDS_Boolean loaned;
+	struct DDS_Property_t properties[1];
+};
+
+void* getSubtransportPropertiesArena(const struct eProsima_PropertyIndex *index, struct DDS_PropertyQosPolicy *subtransportProperties,
+									 const char *subtransportName, EPROSIMA_SUBTRANSPORT_PROPERTIES_MODE mode)
+{
+	const char* const METHOD_NAME = "getSubtransportPropertiesArena";
+	struct SubtransportPropertiesArena *arena = NULL;
+	struct DDS_Property_t * const *range = NULL;
+	struct DDS_Property_t **properties = NULL;
+	char *strings = NULL;
+	size_t arenaSize = 0, nameLength = 0, valueLength = 0;
+	int count = 0, transportPropertiesLength = 0, arenaPropertiesLength = 0, subtransportNameLength = 0;
+
+	if(index == NULL || subtransportProperties == NULL || subtransportName == NULL)
+	{
+		printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+		return NULL;
+	}
+
+	EPROSIMA_TRACE_BEGIN("getSubtransportProperties", subtransportName);
+
+	transportPropertiesLength = eProsimaPropertyIndex_getPrefixRange(index, subtransportName, &range);
+	RTIOsapiHeap_allocateArray(&properties, transportPropertiesLength + 1, struct DDS_Property_t*);
+
+	if(properties == NULL)
+	{
+		printf("ERROR<%s>: Cannot allocate memory for the properties\n", METHOD_NAME);
+		EPROSIMA_TRACE_END("getSubtransportProperties");
+		return NULL;
+	}
+
+	// The subtransport gets its properties in the order of the sequence.
+	eProsimaPropertyIndex_getPrefixProperties(index, subtransportName, properties);
+	subtransportNameLength = strlen(subtransportName) + 1; // "pluginName."
+	arenaPropertiesLength = transportPropertiesLength > 0 ? transportPropertiesLength : 1;
+
+	arenaSize = offsetof(struct SubtransportPropertiesArena, properties) + arenaPropertiesLength * sizeof(struct DDS_Property_t);
+
+	if(mode == EPROSIMA_SUBTRANSPORT_PROPERTIES_PACK)
+	{
+		for(count = 0; count < transportPropertiesLength; count++)
+		{
+			arenaSize += strlen(properties[count]->name + subtransportNameLength) + 1;
+
+			if(properties[count]->value != NULL)
+				arenaSize += strlen(properties[count]->value) + 1;
+		}
+	}
+
+	RTIOsapiHeap_allocateArray(&strings, arenaSize, char);
+
+	if(strings != NULL)
+	{
+		memset(strings, 0, offsetof(struct SubtransportPropertiesArena, properties) + arenaPropertiesLength * sizeof(struct DDS_Property_t));
+		arena = (struct SubtransportPropertiesArena*)strings;
+		strings = (char*)&arena->properties[arenaPropertiesLength];
+
+		for(count = 0; count < transportPropertiesLength; count++)
+		{
+			if(mode == EPROSIMA_SUBTRANSPORT_PROPERTIES_PACK)
+			{
+				nameLength = strlen(properties[count]->name + subtransportNameLength) + 1;
+				memcpy(strings, properties[count]->name + subtransportNameLength, nameLength);
+				arena->properties[count].name = strings;
+				strings += nameLength;
+
+				if(properties[count]->value != NULL)
+				{
+					valueLength = strlen(properties[count]->value) + 1;
+					memcpy(strings, properties[count]->value, valueLength);
+					arena->properties[count].value = strings;
+					strings += valueLength;
+				}
+			}
+			else
+			{
+				arena->properties[count].name = properties[count]->name + subtransportNameLength;
+				arena->properties[count].value = properties[count]->value;
+			}
+		}
+
+		if(transportPropertiesLength > 0)
 		{
-			newProperty = DDS_PropertySeq_get_reference(&subtransportProperties->value, count);
+			arena->loaned = DDS_PropertySeq_loan_contiguous(&subtransportProperties->value, arena->properties,
+				transportPropertiesLength, transportPropertiesLength);
 
-			if(newProperty != NULL)
+			if(!arena->loaned)
 			{
-				newProperty->name = DDS_String_dup(auxProperty->name + subtransportNameLength);
-				newProperty->value = DDS_String_dup(auxProperty->value);
+				printf("ERROR<%s>: Cannot loan the properties of %s\n", METHOD_NAME, subtransportName);
+				RTIOsapiHeap_freeArray((char*)arena);
+				arena = NULL;
 			}
 		}
 	}
+	else
+	{
+		printf("ERROR<%s>: Cannot allocate memory for the properties\n", METHOD_NAME);
+	}
+
+	RTIOsapiHeap_freeArray(properties);
+
+	EPROSIMA_TRACE_END("getSubtransportProperties");
+
+	return arena;
+}
+
+void releaseSubtransportPropertiesArena(struct DDS_PropertyQosPolicy *subtransportProperties, void *arena)
+{
+	struct SubtransportPropertiesArena *auxArena = (struct SubtransportPropertiesArena*)arena;
+
+	if(subtransportProperties != NULL && auxArena != NULL)
+	{
+		if(auxArena->loaned)
+			DDS_PropertySeq_unloan(&subtransportProperties->value);
+
+		RTIOsapiHeap_freeArray((char*)auxArena);
+	}
 }
 
 void copyNDDSTransportProperties(struct NDDS_Transport_Property_t *dst, const struct NDDS_Transport_Property_t *src)
@@ -904,3 +1265,207 @@ void finalizeNDDSTransportProperties(struct NDDS_Transport_Property_t *propertie
         printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
     }
 }
+
+/**
+ * \brief Header of the block used by the compact interface lists. It is followed by the four arrays
+ * of pointers (allow, deny, allow multicast and deny multicast) and by the strings.
+ */
+struct CompactInterfacesListsHeader
+{
+    size_t size;
+};
+
+/**
+ * \brief Offsets of the four interface lists and their lengths, in the order they are stored in the block.
+ */
+static const struct
+{
+    size_t listOffset;
+    size_t lengthOffset;
+} compactInterfacesLists[] =
+{
+    {offsetof(struct NDDS_Transport_Property_t, allow_interfaces_list), offsetof(struct NDDS_Transport_Property_t, allow_interfaces_list_length)},
+    {offsetof(struct NDDS_Transport_Property_t, deny_interfaces_list), offsetof(struct NDDS_Transport_Property_t, deny_interfaces_list_length)},
+    {offsetof(struct NDDS_Transport_Property_t, allow_multicast_interfaces_list), offsetof(struct NDDS_Transport_Property_t, allow_multicast_interfaces_list_length)},
+    {offsetof(struct NDDS_Transport_Property_t, deny_multicast_interfaces_list), offsetof(struct NDDS_Transport_Property_t, deny_multicast_interfaces_list_length)}
+};
+
+#define COMPACT_INTERFACES_LISTS_LENGTH (sizeof(compactInterfacesLists) / sizeof(compactInterfacesLists[0]))
+
+#define COMPACT_LIST(properties, i) ((char***)((char*)(properties) + compactInterfacesLists[i].listOffset))
+#define COMPACT_LIST_LENGTH(properties, i) ((RTI_INT32*)((char*)(properties) + compactInterfacesLists[i].lengthOffset))
+
+static void copyNDDSTransportPropertiesScalars(struct NDDS_Transport_Property_t *dst, const struct NDDS_Transport_Property_t *src)
+{
+    dst->classid = src->classid;
+    dst->address_bit_count = src->address_bit_count;
+    dst->properties_bitmap = src->properties_bitmap;
+    dst->gather_send_buffer_count_max = src->gather_send_buffer_count_max;
+    dst->message_size_max = src->message_size_max;
+}
+
+/**
+ * \brief This function returns the block of compact interface lists. The first non empty list starts
+ * just after the header.
+ */
+static struct CompactInterfacesListsHeader* getCompactInterfacesListsBlock(const struct NDDS_Transport_Property_t *properties)
+{
+    unsigned int i = 0;
+
+    for(i = 0; i < COMPACT_INTERFACES_LISTS_LENGTH; ++i)
+    {
+        if(*COMPACT_LIST_LENGTH(properties, i) > 0 && *COMPACT_LIST(properties, i) != NULL)
+            return (struct CompactInterfacesListsHeader*)((char*)*COMPACT_LIST(properties, i) - sizeof(struct CompactInterfacesListsHeader));
+    }
+
+    return NULL;
+}
+
+int copyNDDSTransportPropertiesCompact(struct NDDS_Transport_Property_t *dst, const struct NDDS_Transport_Property_t *src)
+{
+    const char* const METHOD_NAME = "copyNDDSTransportPropertiesCompact";
+    struct CompactInterfacesListsHeader *header = NULL;
+    char **pointers = NULL, *strings = NULL, *block = NULL;
+    const char *auxString = NULL;
+    size_t size = sizeof(struct CompactInterfacesListsHeader), length = 0;
+    unsigned int i = 0;
+    int j = 0, pointersLength = 0;
+
+    if(dst == NULL || src == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return -1;
+    }
+
+    // Size of the pointers and the strings of the four lists.
+    for(i = 0; i < COMPACT_INTERFACES_LISTS_LENGTH; ++i)
+    {
+        for(j = 0; j < *COMPACT_LIST_LENGTH(src, i); ++j)
+        {
+            auxString = (*COMPACT_LIST(src, i))[j];
+            size += sizeof(char*) + (auxString != NULL ? strlen(auxString) + 1 : 0);
+        }
+
+        pointersLength += *COMPACT_LIST_LENGTH(src, i) > 0 ? *COMPACT_LIST_LENGTH(src, i) : 0;
+    }
+
+    copyNDDSTransportPropertiesScalars(dst, src);
+
+    if(pointersLength > 0)
+    {
+        RTIOsapiHeap_allocateArray(&block, size, char);
+
+        if(block == NULL)
+        {
+            printf("ERROR<%s>: Cannot allocate memory for the interfaces lists\n", METHOD_NAME);
+            return -1;
+        }
+
+        header = (struct CompactInterfacesListsHeader*)block;
+        header->size = size;
+        pointers = (char**)(header + 1);
+        strings = (char*)(pointers + pointersLength);
+    }
+
+    for(i = 0; i < COMPACT_INTERFACES_LISTS_LENGTH; ++i)
+    {
+        *COMPACT_LIST_LENGTH(dst, i) = *COMPACT_LIST_LENGTH(src, i) > 0 ? *COMPACT_LIST_LENGTH(src, i) : 0;
+        *COMPACT_LIST(dst, i) = *COMPACT_LIST_LENGTH(dst, i) > 0 ? pointers : NULL;
+
+        for(j = 0; j < *COMPACT_LIST_LENGTH(dst, i); ++j)
+        {
+            auxString = (*COMPACT_LIST(src, i))[j];
+
+            if(auxString != NULL)
+            {
+                length = strlen(auxString) + 1;
+                memcpy(strings, auxString, length);
+                *pointers++ = strings;
+                strings += length;
+            }
+            else
+            {
+                *pointers++ = NULL;
+            }
+        }
+    }
+
+    return 0;
+}
+
+int cloneNDDSTransportPropertiesCompact(struct NDDS_Transport_Property_t *dst, const struct NDDS_Transport_Property_t *src)
+{
+    const char* const METHOD_NAME = "cloneNDDSTransportPropertiesCompact";
+    const struct CompactInterfacesListsHeader *srcHeader = NULL;
+    char *block = NULL, **auxList = NULL;
+    unsigned int i = 0;
+    int j = 0;
+
+    if(dst == NULL || src == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return -1;
+    }
+
+    srcHeader = getCompactInterfacesListsBlock(src);
+    copyNDDSTransportPropertiesScalars(dst, src);
+
+    if(srcHeader != NULL)
+    {
+        RTIOsapiHeap_allocateArray(&block, srcHeader->size, char);
+
+        if(block == NULL)
+        {
+            printf("ERROR<%s>: Cannot allocate memory for the interfaces lists\n", METHOD_NAME);
+            return -1;
+        }
+
+        memcpy(block, srcHeader, srcHeader->size);
+    }
+
+    // The pointers of the copy are moved from the source block to the new block.
+    for(i = 0; i < COMPACT_INTERFACES_LISTS_LENGTH; ++i)
+    {
+        *COMPACT_LIST_LENGTH(dst, i) = *COMPACT_LIST_LENGTH(src, i) > 0 ? *COMPACT_LIST_LENGTH(src, i) : 0;
+        *COMPACT_LIST(dst, i) = NULL;
+
+        if(*COMPACT_LIST_LENGTH(dst, i) > 0)
+        {
+            auxList = (char**)(block + ((const char*)*COMPACT_LIST(src, i) - (const char*)srcHeader));
+            *COMPACT_LIST(dst, i) = auxList;
+
+            for(j = 0; j < *COMPACT_LIST_LENGTH(dst, i); ++j)
+            {
+                if(auxList[j] != NULL)
+                    auxList[j] = block + (auxList[j] - (const char*)srcHeader);
+            }
+        }
+    }
+
+    return 0;
+}
+
+void finalizeNDDSTransportPropertiesCompact(struct NDDS_Transport_Property_t *properties)
+{
+    const char* const METHOD_NAME = "finalizeNDDSTransportPropertiesCompact";
+    struct CompactInterfacesListsHeader *header = NULL;
+    unsigned int i = 0;
+
+    if(properties != NULL)
+    {
+        header = getCompactInterfacesListsBlock(properties);
+
+        if(header != NULL)
+            RTIOsapiHeap_freeArray((char*)header);
+
+        for(i = 0; i < COMPACT_INTERFACES_LISTS_LENGTH; ++i)
+        {
+            *COMPACT_LIST(properties, i) = NULL;
+            *COMPACT_LIST_LENGTH(properties, i) = 0;
+        }
+    }
+    else
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+    }
+}
@@ -13,6 +13,7 @@ extern "C"
 #endif // __cplusplus
 
 struct DDS_PropertyQosPolicy;
+struct eProsima_PropertyIndex;
 
 /**
  * \brief This function loads a dll library and gets the pointer of a function.
@@ -22,6 +23,8 @@ struct DDS_PropertyQosPolicy;
  *         (NDDS_Transport_Address_t *default_network_address_out,
  *         const struct DDS_PropertyQosPolicy *property_in);
  *
+ * Functions registered with EPROSIMA_DL_REGISTER_SYMBOL are returned without using the dynamic loader.
+ *
  * \param libraryName The name of the dll library. Cannot be NULL.
  * \param functionName The name of the function to be returned. Cannot be NULL.
  * \return A pointer to the function that was specified in the parameters. In error case,
@@ -30,6 +33,21 @@ struct DDS_PropertyQosPolicy;
 NDDS_Transport_create_plugin loadLibrary(const char *libraryName,
         const char *functionName);
 
+/**
+ * \brief This function preloads the libraries of all the subtransports defined in the properties.
+ *
+ * Every property "pluginName.library" is taken into account. The libraries are loaded in parallel
+ * and the function defined in "pluginName.create_function" is resolved and stored. Later calls to
+ * loadLibrary and loadTransportPluginFromLibrary use the stored functions.
+ *
+ * \param property_in Properties where the subtransports are defined. Cannot be NULL.
+ * \param flags Combination of EPROSIMA_DL_FLAGS values used to load the libraries. Use EPROSIMA_DL_NOW
+ * to bind all the symbols before the first message is sent.
+ * \param threadCount Maximum number of threads used to load the libraries.
+ * \return Number of subtransports whose create function was preloaded. In error case, -1 is returned.
+ */
+int preloadTransportPlugins(const struct DDS_PropertyQosPolicy *property_in, int flags, int threadCount);
+
 /**
  * \brief This function loads a UDPv4 subtransport. This function also gets UDPv4 subtransport properties from Qos profiles XML.
  * If the load operation was successfull, then this function creates the IDPv4 subtransport.
@@ -40,6 +58,16 @@ NDDS_Transport_create_plugin loadLibrary(const char *libraryName,
  */
 NDDS_Transport_Plugin* loadTransportUDPv4(const struct DDS_PropertyQosPolicy *property_in);
 
+/**
+ * \brief This function is like loadTransportUDPv4, but the properties are found in an index.
+ * Only the properties "UDPv4.*" are visited. The parsed properties are stored in the transport
+ * configuration cache, so they are parsed only once for each different set of "UDPv4.*" properties.
+ *
+ * \param index Index of the properties of the transport that wants to create the UDPv4 subtransport. Cannot be NULL.
+ * \return The new UDPv4 transport. In error case, NULL value is returned.
+ */
+NDDS_Transport_Plugin* loadTransportUDPv4FromIndex(const struct eProsima_PropertyIndex *index);
+
 /**
  * \brief This function loads a library where is the subtransport that is needed.
  * If the load operation was successfull, then this function creates the subtransport.
@@ -52,9 +80,126 @@ NDDS_Transport_Plugin* loadTransportUDPv4(const struct DDS_PropertyQosPolicy *pr
 NDDS_Transport_Plugin* loadTransportPluginFromLibrary(const char *pluginName, const struct DDS_PropertyQosPolicy *property_in,
     NDDS_Transport_Address_t *default_network_address_out);
 
+/**
+ * \brief This function is like loadTransportPluginFromLibrary, but the properties are found in an index.
+ * When several participants are created from the same properties, the index can be built once
+ * with eProsimaPropertyIndex_new and used for all of them. The subtransport properties are stored in
+ * the transport configuration cache, so they are built only once for each different set of
+ * "pluginName.*" properties.
+ *
+ * \param pluginName The name of the subtransport. Cannot be NULL.
+ * \param index Index of the properties of the transport that wants to create the subtransport. Cannot be NULL.
+ * \return The new transport plugin. In error case, NULL value is returned.
+ */
+NDDS_Transport_Plugin* loadTransportPluginFromIndex(const char *pluginName, const struct eProsima_PropertyIndex *index,
+    NDDS_Transport_Address_t *default_network_address_out);
+
+/**
+ * \brief This function returns an index of the properties of a policy. Policies with the same properties share
+ * the index stored in the transport configuration cache. When the cache cannot store it, a new index is built.
+ *
+ * \param policy The policy. Cannot be NULL.
+ * \param builtIndex Where the new index is stored when one is built, or NULL value. The caller deletes it with
+ * eProsimaPropertyIndex_delete after using the returned index. Cannot be NULL.
+ * \return The index. In error case, NULL value is returned.
+ */
+const struct eProsima_PropertyIndex* getTransportPropertyIndex(const struct DDS_PropertyQosPolicy *policy,
+    struct eProsima_PropertyIndex **builtIndex);
+
+/**
+ * \brief This function gets the properties of the subtransport, in the order of the sequence.
+ *
+ * \param transportProperties Structure with the transport properties. Cannot be NULL.
+ * \param subtransportProperties Structure where the subtransport properties will be stored. Cannot be NULL.
+ * The structure must be initialized.
+ * \param subtransportName The name of the subtransport.
+ */
+void getSubtransportProperties(const struct DDS_PropertyQosPolicy *transportProperties, struct DDS_PropertyQosPolicy *subtransportProperties,
+    const char *subtransportName);
+
+/**
+ * \brief This function gets the properties "subtransportName.*" of the subtransport using an index, in the order
+ * of the sequence.
+ * The prefix "subtransportName." is removed from the names.
+ *
+ * \param index Index of the transport properties. Cannot be NULL.
+ * \param subtransportProperties Structure where the subtransport properties will be stored. Cannot be NULL.
+ * The structure must be initialized.
+ * \param subtransportName The name of the subtransport.
+ */
+void getSubtransportPropertiesFromIndex(const struct eProsima_PropertyIndex *index, struct DDS_PropertyQosPolicy *subtransportProperties,
+    const char *subtransportName);
+
+/**
+ * \brief Modes of getSubtransportPropertiesArena.
+ */
+typedef enum EPROSIMA_SUBTRANSPORT_PROPERTIES_MODE
+{
+    /// The names and values point to the strings of the transport properties. The transport
+    /// properties cannot be modified or destroyed while the subtransport properties are used.
+    EPROSIMA_SUBTRANSPORT_PROPERTIES_BORROW = 0,
+    /// The names and values are copied into the arena.
+    EPROSIMA_SUBTRANSPORT_PROPERTIES_PACK
+} EPROSIMA_SUBTRANSPORT_PROPERTIES_MODE;
+
+/**
+ * \brief This function gets the properties "subtransportName.*" of the subtransport using one allocation.
+ *
+ * The properties are stored in an arena that is loaned to the sequence of the subtransport properties.
+ * The names and values are not duplicated one by one. The arena has to be released with
+ * releaseSubtransportPropertiesArena before the subtransport properties are finalized.
+ *
+ * \param index Index of the transport properties. Cannot be NULL.
+ * \param subtransportProperties Structure where the subtransport properties will be stored. Cannot be NULL.
+ * The structure must be initialized and empty.
+ * \param subtransportName The name of the subtransport. Cannot be NULL.
+ * \param mode Whether the strings are borrowed from the transport properties or packed in the arena.
+ * \return The arena. In error case, NULL value is returned.
+ */
+void* getSubtransportPropertiesArena(const struct eProsima_PropertyIndex *index, struct DDS_PropertyQosPolicy *subtransportProperties,
+    const char *subtransportName, EPROSIMA_SUBTRANSPORT_PROPERTIES_MODE mode);
+
+/**
+ * \brief This function releases the arena returned by getSubtransportPropertiesArena with a single free.
+ *
+ * \param subtransportProperties The subtransport properties that use the arena. Cannot be NULL.
+ * \param arena The arena.
+ */
+void releaseSubtransportPropertiesArena(struct DDS_PropertyQosPolicy *subtransportProperties, void *arena);
+
 void copyNDDSTransportProperties(struct NDDS_Transport_Property_t *dst, const struct NDDS_Transport_Property_t *src);
 void finalizeNDDSTransportProperties(struct NDDS_Transport_Property_t *properties);
 
+/**
+ * \brief This function copies the transport properties storing the four interface lists and their
+ * strings in one allocation.
+ *
+ * The source can use any layout. The copy has to be released with finalizeNDDSTransportPropertiesCompact
+ * and it can be copied again with cloneNDDSTransportPropertiesCompact.
+ *
+ * \param dst Structure where the properties will be copied. Cannot be NULL.
+ * \param src The properties to copy. Cannot be NULL.
+ * \return 0 if the properties were copied. In error case -1 is returned.
+ */
+int copyNDDSTransportPropertiesCompact(struct NDDS_Transport_Property_t *dst, const struct NDDS_Transport_Property_t *src);
+
+/**
+ * \brief This function copies transport properties created by copyNDDSTransportPropertiesCompact.
+ * The block of interface lists is copied with one memcpy and its pointers are rebased.
+ *
+ * \param dst Structure where the properties will be copied. Cannot be NULL.
+ * \param src The properties to copy. They must use the compact layout. Cannot be NULL.
+ * \return 0 if the properties were copied. In error case -1 is returned.
+ */
+int cloneNDDSTransportPropertiesCompact(struct NDDS_Transport_Property_t *dst, const struct NDDS_Transport_Property_t *src);
+
+/**
+ * \brief This function releases the interface lists of properties that use the compact layout with one free.
+ *
+ * \param properties The properties. Cannot be NULL.
+ */
+void finalizeNDDSTransportPropertiesCompact(struct NDDS_Transport_Property_t *properties);
+
 /**
  * \brief logs a text message
  *
@@ -105,6 +250,17 @@ void log_rtps_message(const char *text, const NDDS_Transport_Buffer_t buffer_in[
  */
 void log_init(const char *fileName);
 
+struct eProsima_LogRotationConfig;
+
+/**
+ * \brief This function initializes the log system with rotation of the file. See eProsimaLogFile_open.
+ *
+ * \param fileName Indicates the file name where the log will be stored. If the value is NULL,
+ * then the log will be shown in the standard output.
+ * \param rotation Rotation of the file. If the value is NULL, the file is not rotated.
+ */
+void log_initWithRotation(const char *fileName, const struct eProsima_LogRotationConfig *rotation);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
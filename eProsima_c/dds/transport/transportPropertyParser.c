@@ -0,0 +1,331 @@
+#include "transportPropertyParser.h"
+#include "../qos/propertyIndex.h"
+
+#include <dds_c/dds_c_infrastructure.h>
+#include <osapi/osapi_heap.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define PROPERTY_DESCRIPTORS_MAX 64
+
+#define PROPERTY_STRING_LIST_MAX 64
+
+#define PROPERTY_FIELD(structure, offset, type) ((type*)((char*)(structure) + (offset)))
+
+int parsePropertyInteger(const char *value, int allowHex, int *result)
+{
+    unsigned long long accumulator = 0, limit = (unsigned long long)INT_MAX;
+    unsigned int base = 10, digit = 0;
+    int negative = 0, digits = 0;
+
+    if(value == NULL || result == NULL)
+        return -1;
+
+    while(*value == ' ' || *value == '\t' || *value == '\n' || *value == '\r')
+        ++value;
+
+    if(*value == '-' || *value == '+')
+    {
+        negative = (*value == '-');
+        limit = negative ? (unsigned long long)INT_MAX + 1 : limit;
+        ++value;
+    }
+
+    if(allowHex && value[0] == '0' && (value[1] == 'x' || value[1] == 'X'))
+    {
+        base = 16;
+        // Hexadecimal values are bit masks and can use all the bits.
+        limit = (unsigned long long)UINT_MAX;
+        value += 2;
+    }
+
+    for(;; ++value, ++digits)
+    {
+        if(*value >= '0' && *value <= '9')
+            digit = *value - '0';
+        else if(base == 16 && *value >= 'a' && *value <= 'f')
+            digit = *value - 'a' + 10;
+        else if(base == 16 && *value >= 'A' && *value <= 'F')
+            digit = *value - 'A' + 10;
+        else
+            break;
+
+        accumulator = accumulator * base + digit;
+
+        if(accumulator > limit)
+            return -1;
+    }
+
+    if(digits == 0)
+        return -1;
+
+    *result = negative ? (int)(0 - accumulator) : (int)(unsigned int)accumulator;
+    return 0;
+}
+
+static int isListSeparator(char character)
+{
+    return character == ',' || character == ' ' || character == '\t' || character == '\n' || character == '\r';
+}
+
+int copyPropertyStringList(const char * const *strings, const size_t *lengths, int stringsLength,
+        char ***list, int *listLength)
+{
+    char *auxString = NULL;
+    size_t size = 0;
+    int i = 0;
+
+    if(strings == NULL || list == NULL || listLength == NULL || stringsLength <= 0)
+        return -1;
+
+    size = stringsLength * sizeof(char*);
+    for(i = 0; i < stringsLength; ++i)
+        size += (lengths != NULL ? lengths[i] : strlen(strings[i])) + 1;
+
+    // The array of pointers is followed by the strings, so the list is released with one free.
+    RTIOsapiHeap_allocateArray(list, size / sizeof(char*) + 1, char*);
+
+    if(*list == NULL)
+        return -1;
+
+    auxString = (char*)(*list + stringsLength);
+
+    for(i = 0; i < stringsLength; ++i)
+    {
+        size = lengths != NULL ? lengths[i] : strlen(strings[i]);
+        memcpy(auxString, strings[i], size);
+        auxString[size] = '\0';
+        (*list)[i] = auxString;
+        auxString += size + 1;
+    }
+
+    *listLength = stringsLength;
+    return 0;
+}
+
+/**
+ * \brief This function stores a list with the tokens of the value. The tokens are separated by commas
+ * or white spaces.
+ */
+static int parsePropertyStringList(const char *value, char ***list, int *listLength)
+{
+    const char *tokens[PROPERTY_STRING_LIST_MAX];
+    size_t lengths[PROPERTY_STRING_LIST_MAX];
+    int tokensLength = 0;
+
+    for(;;)
+    {
+        while(isListSeparator(*value))
+            ++value;
+
+        if(*value == '\0')
+            break;
+
+        if(tokensLength == PROPERTY_STRING_LIST_MAX)
+            return -1;
+
+        tokens[tokensLength] = value;
+
+        while(*value != '\0' && !isListSeparator(*value))
+            ++value;
+
+        lengths[tokensLength] = value - tokens[tokensLength];
+        ++tokensLength;
+    }
+
+    return copyPropertyStringList(tokens, lengths, tokensLength, list, listLength);
+}
+
+/**
+ * \brief This function parses the value of one property and stores it in the structure.
+ *
+ * \return 0 if the value was stored. If the value is bad, the default value is stored and -1 is returned.
+ */
+static int applyPropertyDescriptor(const char *prefix, const struct eProsima_PropertyDescriptor *descriptor,
+        const char *value, void *structure)
+{
+    const char* const METHOD_NAME = "parseTransportProperties";
+    int *field = PROPERTY_FIELD(structure, descriptor->offset, int);
+    int returnedValue = 0;
+
+    switch(descriptor->type)
+    {
+        case EPROSIMA_PROPERTY_TYPE_INT_AUTO:
+            if(strcmp(value, "auto") == 0)
+            {
+                *field = EPROSIMA_PROPERTY_AUTO;
+                break;
+            }
+            // Fall through.
+        case EPROSIMA_PROPERTY_TYPE_INT:
+        case EPROSIMA_PROPERTY_TYPE_HEX:
+            if(parsePropertyInteger(value, descriptor->type == EPROSIMA_PROPERTY_TYPE_HEX, field) != 0 ||
+                    *field < descriptor->minValue || *field > descriptor->maxValue)
+            {
+                printf("ERROR<%s>: Bad value for %s%s%s\n", METHOD_NAME, prefix, *prefix != '\0' ? "." : "", descriptor->name);
+                *field = descriptor->defaultValue;
+                returnedValue = -1;
+            }
+            break;
+        case EPROSIMA_PROPERTY_TYPE_STRING_LIST:
+            if(parsePropertyStringList(value, PROPERTY_FIELD(structure, descriptor->offset, char**),
+                        PROPERTY_FIELD(structure, descriptor->auxOffset, int)) != 0)
+            {
+                printf("ERROR<%s>: Bad value for %s%s%s\n", METHOD_NAME, prefix, *prefix != '\0' ? "." : "", descriptor->name);
+                *PROPERTY_FIELD(structure, descriptor->offset, char**) = NULL;
+                *PROPERTY_FIELD(structure, descriptor->auxOffset, int) = 0;
+                returnedValue = -1;
+            }
+            break;
+    }
+
+    return returnedValue;
+}
+
+/**
+ * \brief This function applies one property if it has the prefix and a descriptor.
+ *
+ * \param badValues It is incremented if the value of the property is bad.
+ * \return 1 if the property was stored. Otherwise 0.
+ */
+static int parseTransportProperty(const char *prefix, size_t prefixLength, const struct DDS_Property_t *property,
+        const struct eProsima_PropertyDescriptor *descriptors, int descriptorsLength, void *structure,
+        unsigned long long *parsed, int *badValues)
+{
+    int i = 0;
+
+    if(property == NULL || property->name == NULL || property->value == NULL)
+        return 0;
+
+    // An empty prefix is used with the subtransport properties, whose names don't have prefix.
+    if(prefixLength > 0)
+    {
+        if(strncmp(property->name, prefix, prefixLength) != 0 || property->name[prefixLength] != '.')
+            return 0;
+
+        ++prefixLength;
+    }
+
+    for(i = 0; i < descriptorsLength; ++i)
+    {
+        if(strcmp(property->name + prefixLength, descriptors[i].name) == 0)
+        {
+            if((*parsed & (1ULL << i)) == 0)
+            {
+                *parsed |= 1ULL << i;
+                if(applyPropertyDescriptor(prefix, &descriptors[i], property->value, structure) != 0)
+                    ++*badValues;
+                return 1;
+            }
+
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \brief This function checks the minimum values that depend on other fields. It is called when all
+ * the fields are known.
+ *
+ * \return Number of fields with a bad value. The default value is stored in them.
+ */
+static int checkDependentFields(const char *prefix, const struct eProsima_PropertyDescriptor *descriptors,
+        int descriptorsLength, void *structure, unsigned long long parsed)
+{
+    const char* const METHOD_NAME = "parseTransportProperties";
+    int *field = NULL;
+    int i = 0, badValues = 0;
+
+    for(i = 0; i < descriptorsLength; ++i)
+    {
+        if((parsed & (1ULL << i)) != 0 && descriptors[i].type != EPROSIMA_PROPERTY_TYPE_STRING_LIST &&
+                descriptors[i].auxOffset != EPROSIMA_PROPERTY_NO_FIELD)
+        {
+            field = PROPERTY_FIELD(structure, descriptors[i].offset, int);
+
+            if(descriptors[i].type == EPROSIMA_PROPERTY_TYPE_INT_AUTO && *field == EPROSIMA_PROPERTY_AUTO)
+                continue;
+
+            if(*field < *PROPERTY_FIELD(structure, descriptors[i].auxOffset, int))
+            {
+                printf("ERROR<%s>: Bad value for %s%s%s\n", METHOD_NAME, prefix, *prefix != '\0' ? "." : "", descriptors[i].name);
+                *field = descriptors[i].defaultValue;
+                ++badValues;
+            }
+        }
+    }
+
+    return badValues;
+}
+
+int parseTransportProperties(const struct DDS_PropertyQosPolicy *property_in, const char *prefix,
+        const struct eProsima_PropertyDescriptor *descriptors, int descriptorsLength, void *structure)
+{
+    const char* const METHOD_NAME = "parseTransportProperties";
+    unsigned long long parsed = 0;
+    size_t prefixLength = 0;
+    int returnedValue = -1, propertiesLength = 0, count = 0, badValues = 0;
+
+    if(property_in != NULL && prefix != NULL && descriptors != NULL && structure != NULL &&
+            descriptorsLength >= 0 && descriptorsLength <= PROPERTY_DESCRIPTORS_MAX)
+    {
+        returnedValue = 0;
+        prefixLength = strlen(prefix);
+        propertiesLength = DDS_PropertySeq_get_length(&property_in->value);
+
+        for(count = 0; count < propertiesLength; ++count)
+        {
+            returnedValue += parseTransportProperty(prefix, prefixLength, DDS_PropertySeq_get_reference(&property_in->value, count),
+                    descriptors, descriptorsLength, structure, &parsed, &badValues);
+        }
+
+        badValues += checkDependentFields(prefix, descriptors, descriptorsLength, structure, parsed);
+
+        if(badValues > 0)
+            returnedValue = -1;
+    }
+    else
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+    }
+
+    return returnedValue;
+}
+
+int parseTransportPropertiesFromIndex(const struct eProsima_PropertyIndex *index, const char *prefix,
+        const struct eProsima_PropertyDescriptor *descriptors, int descriptorsLength, void *structure)
+{
+    const char* const METHOD_NAME = "parseTransportPropertiesFromIndex";
+    struct DDS_Property_t * const *properties = NULL;
+    unsigned long long parsed = 0;
+    size_t prefixLength = 0;
+    int returnedValue = -1, propertiesLength = 0, count = 0, badValues = 0;
+
+    if(index != NULL && prefix != NULL && descriptors != NULL && structure != NULL &&
+            descriptorsLength >= 0 && descriptorsLength <= PROPERTY_DESCRIPTORS_MAX)
+    {
+        returnedValue = 0;
+        prefixLength = strlen(prefix);
+        propertiesLength = eProsimaPropertyIndex_getPrefixRange(index, prefix, &properties);
+
+        for(count = 0; count < propertiesLength; ++count)
+        {
+            returnedValue += parseTransportProperty(prefix, prefixLength, properties[count],
+                    descriptors, descriptorsLength, structure, &parsed, &badValues);
+        }
+
+        badValues += checkDependentFields(prefix, descriptors, descriptorsLength, structure, parsed);
+
+        if(badValues > 0)
+            returnedValue = -1;
+    }
+    else
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+    }
+
+    return returnedValue;
+}
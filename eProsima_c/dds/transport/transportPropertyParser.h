@@ -0,0 +1,161 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_TRANSPORTPROPERTYPARSER_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_TRANSPORTPROPERTYPARSER_H_
+
+#include "eProsima_c/config.h"
+
+#include <stddef.h>
+#include <limits.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+struct DDS_PropertyQosPolicy;
+struct eProsima_PropertyIndex;
+
+/**
+ * \brief Types of the values that can be parsed from the properties.
+ */
+typedef enum EPROSIMA_PROPERTY_TYPE
+{
+    /// Decimal integer stored in an int field.
+    EPROSIMA_PROPERTY_TYPE_INT = 0,
+    /// Hexadecimal integer ("0x" prefix) or decimal integer stored in an int field.
+    EPROSIMA_PROPERTY_TYPE_HEX,
+    /// Like EPROSIMA_PROPERTY_TYPE_INT, but the value "auto" is also accepted. It is stored as EPROSIMA_PROPERTY_AUTO.
+    EPROSIMA_PROPERTY_TYPE_INT_AUTO,
+    /// List of strings separated by commas stored in a char** field. Its length is stored in the int
+    /// field auxOffset. The list and its strings use one allocation that is released with
+    /// RTIOsapiHeap_freeArray(list).
+    EPROSIMA_PROPERTY_TYPE_STRING_LIST
+} EPROSIMA_PROPERTY_TYPE;
+
+/// Value stored by EPROSIMA_PROPERTY_TYPE_INT_AUTO descriptors when the property is "auto".
+#define EPROSIMA_PROPERTY_AUTO INT_MIN
+
+/// Value of auxOffset when the descriptor doesn't use it.
+#define EPROSIMA_PROPERTY_NO_FIELD ((size_t)-1)
+
+/**
+ * \brief Describes how one property is parsed and where its value is stored.
+ */
+struct eProsima_PropertyDescriptor
+{
+    /// Name of the property without the prefix (i.e. "send_socket_buffer_size").
+    const char *name;
+
+    EPROSIMA_PROPERTY_TYPE type;
+
+    /// Offset of the field where the value is stored.
+    size_t offset;
+
+    /// Offset of an int field with the minimum value (integers) or with the list length (string lists).
+    size_t auxOffset;
+
+    int minValue;
+
+    int maxValue;
+
+    /// Value stored when the property has a bad value.
+    int defaultValue;
+};
+
+/**
+ * \brief Descriptor of an integer property with a fixed range.
+ */
+#define EPROSIMA_PROPERTY_INT(structType, name, field, minValue, maxValue, defaultValue) \
+    { name, EPROSIMA_PROPERTY_TYPE_INT, offsetof(structType, field), EPROSIMA_PROPERTY_NO_FIELD, minValue, maxValue, defaultValue }
+
+/**
+ * \brief Descriptor of an integer property whose minimum value is the value of other field.
+ */
+#define EPROSIMA_PROPERTY_INT_MIN_FIELD(structType, name, field, minField, defaultValue) \
+    { name, EPROSIMA_PROPERTY_TYPE_INT, offsetof(structType, field), offsetof(structType, minField), INT_MIN, INT_MAX, defaultValue }
+
+/**
+ * \brief Descriptor of an integer property whose minimum value is the value of other field and that
+ * accepts the value "auto".
+ */
+#define EPROSIMA_PROPERTY_INT_MIN_FIELD_AUTO(structType, name, field, minField, defaultValue) \
+    { name, EPROSIMA_PROPERTY_TYPE_INT_AUTO, offsetof(structType, field), offsetof(structType, minField), INT_MIN + 1, INT_MAX, defaultValue }
+
+/**
+ * \brief Descriptor of an hexadecimal or decimal integer property.
+ */
+#define EPROSIMA_PROPERTY_HEX(structType, name, field, defaultValue) \
+    { name, EPROSIMA_PROPERTY_TYPE_HEX, offsetof(structType, field), EPROSIMA_PROPERTY_NO_FIELD, INT_MIN, INT_MAX, defaultValue }
+
+/**
+ * \brief Descriptor of a string list property.
+ */
+#define EPROSIMA_PROPERTY_STRING_LIST(structType, name, field, lengthField) \
+    { name, EPROSIMA_PROPERTY_TYPE_STRING_LIST, offsetof(structType, field), offsetof(structType, lengthField), 0, 0, 0 }
+
+/**
+ * \brief This function parses an integer without using sscanf.
+ *
+ * Leading white spaces and a sign are accepted. Like sscanf, the parsing stops at the first character
+ * that is not a digit.
+ *
+ * \param value The string to parse. Cannot be NULL.
+ * \param allowHex If it is not zero, a "0x" prefix selects hexadecimal format.
+ * \param result Where the value is stored. Cannot be NULL.
+ * \return 0 if the value was parsed. In error case -1 is returned.
+ */
+int parsePropertyInteger(const char *value, int allowHex, int *result);
+
+/**
+ * \brief This function builds a list of strings with one allocation. The array of pointers is followed
+ * by the strings, so the list is released with RTIOsapiHeap_freeArray(list).
+ *
+ * \param strings The strings to copy. Cannot be NULL.
+ * \param lengths Number of characters of each string. If it is NULL, the strings must end with a null character.
+ * \param stringsLength Number of strings. It has to be greater than 0.
+ * \param list Where the list is stored. Cannot be NULL.
+ * \param listLength Where the length of the list is stored. Cannot be NULL.
+ * \return 0 if the list was built. In error case -1 is returned.
+ */
+int copyPropertyStringList(const char * const *strings, const size_t *lengths, int stringsLength,
+        char ***list, int *listLength);
+
+/**
+ * \brief This function fills a structure using the properties that start with "prefix.".
+ *
+ * The sequence of properties is walked once. Each property with the prefix is matched against the
+ * descriptors and its value is parsed and stored in the structure. When a property has a bad value,
+ * an error is printed and the default value of its descriptor is stored. The fields whose property
+ * is not defined are not modified. If a property is defined several times, the first one is used.
+ *
+ * \param property_in Properties to parse. Cannot be NULL.
+ * \param prefix The prefix of the properties (i.e. "UDPv4"). Cannot be NULL. If it is empty, the names
+ * of the properties are matched without prefix, like the subtransport properties received by a plugin.
+ * \param descriptors Array of descriptors. Cannot be NULL.
+ * \param descriptorsLength Number of descriptors. Cannot be greater than 64.
+ * \param structure Structure that will be filled. Cannot be NULL.
+ * \return Number of properties that were stored. If some property has a bad value or in error case, -1 is
+ * returned; the fields are filled anyway.
+ */
+int parseTransportProperties(const struct DDS_PropertyQosPolicy *property_in, const char *prefix,
+        const struct eProsima_PropertyDescriptor *descriptors, int descriptorsLength, void *structure);
+
+/**
+ * \brief This function is like parseTransportProperties, but only the properties with the prefix are
+ * visited. They are found in the index without walking the whole sequence.
+ *
+ * \param index Index of the properties to parse. Cannot be NULL.
+ * \param prefix The prefix of the properties (i.e. "UDPv4"). Cannot be NULL.
+ * \param descriptors Array of descriptors. Cannot be NULL.
+ * \param descriptorsLength Number of descriptors. Cannot be greater than 64.
+ * \param structure Structure that will be filled. Cannot be NULL.
+ * \return Number of properties that were stored. If some property has a bad value or in error case, -1 is
+ * returned; the fields are filled anyway.
+ */
+int parseTransportPropertiesFromIndex(const struct eProsima_PropertyIndex *index, const char *prefix,
+        const struct eProsima_PropertyDescriptor *descriptors, int descriptorsLength, void *structure);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_TRANSPORTPROPERTYPARSER_H_
@@ -0,0 +1,1606 @@
+#if defined(RTI_LINUX) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // recvmmsg, sendmmsg
+#endif
+
+#include "udpMmsgTransport.h"
+#include "../transportClassIds.h"
+#include "../transportPropertyParser.h"
+#include "../transportBufferPool.h"
+#include "../../../sys/atomic.h"
+#include "../../../sys/eProsimaDL.h"
+#include "../../../sys/messageRing.h"
+#include "../../../macros/snprintf.h"
+
+#include <osapi/osapi_heap.h>
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(RTI_LINUX)
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <linux/filter.h>
+#define UDPMMSG_TRANSPORT_SUPPORTED
+#endif
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#ifndef SO_REUSEPORT
+#define SO_REUSEPORT 15
+#endif
+#ifndef SO_ATTACH_REUSEPORT_CBPF
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
+#ifndef SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+
+#define UDPMMSG_CLASS_NAME "eprosima_udpmmsg"
+
+/// Maximum size of a datagram coalesced by GRO or sent with GSO.
+#define UDPMMSG_SEGMENTED_SIZE_MAX 65507
+/// Maximum number of segments of a GSO datagram.
+#define UDPMMSG_SEGMENTS_MAX 64
+
+#define UDPMMSG_INTERFACES_MAX 64
+
+#define UDPMMSG_RECEIVE_THREADS_MAX 64
+#define UDPMMSG_BUSY_POLL_CPUS_MAX 64
+#define UDPMMSG_RING_ALIGNMENT 64
+
+#if defined(EPROSIMA_TRANSPORT_STATIC_PLUGINS)
+EPROSIMA_DL_REGISTER_SYMBOL(UDPMMSG_CLASS_NAME, eProsimaUdpMmsgTransport_create)
+#endif
+
+struct UdpMmsgTransportConfig
+{
+    int messageSizeMax;
+    int gatherSendBufferCountMax;
+    int sendSocketBufferSize;
+    int recvSocketBufferSize;
+    int multicastTtl;
+    int batchSize;
+    int flushTimeoutUs;
+    int useGso;
+    int useGro;
+    int receiveThreads;
+    char **receiveThreadCpusList;
+    int receiveThreadCpusListLength;
+    int receiveQueueSize;
+    int steerByGuidPrefix;
+    int busyPoll;
+    int busyPollUs;
+    char **busyPollCpusList;
+    int busyPollCpusListLength;
+    int busyPollIdleSpins;
+    int busyPollBackoffMaxUs;
+    int bufferPoolSize;
+    int bufferPoolHugePages;
+
+    /// CPUs parsed from receiveThreadCpusList.
+    int receiveThreadCpus[UDPMMSG_RECEIVE_THREADS_MAX];
+    /// CPUs parsed from busyPollCpusList.
+    int busyPollCpus[UDPMMSG_BUSY_POLL_CPUS_MAX];
+};
+
+static const struct eProsima_PropertyDescriptor UdpMmsgPropertyDescriptors[] =
+{
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "parent.message_size_max", messageSizeMax, 1, UDPMMSG_SEGMENTED_SIZE_MAX, 9216),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "parent.gather_send_buffer_count_max", gatherSendBufferCountMax,
+            NDDS_TRANSPORT_PROPERTY_GATHER_SEND_BUFFER_COUNT_MIN, 1024, 16),
+    EPROSIMA_PROPERTY_INT_MIN_FIELD(struct UdpMmsgTransportConfig, "send_socket_buffer_size", sendSocketBufferSize, messageSizeMax, 131072),
+    EPROSIMA_PROPERTY_INT_MIN_FIELD(struct UdpMmsgTransportConfig, "recv_socket_buffer_size", recvSocketBufferSize, messageSizeMax, 131072),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "multicast_ttl", multicastTtl, 0, 255, 1),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "batch_size", batchSize, 1, 1024, 32),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "flush_timeout_us", flushTimeoutUs, 0, 1000000, 0),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "use_gso", useGso, 0, 1, 0),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "use_gro", useGro, 0, 1, 0),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "receive_threads", receiveThreads, 1, UDPMMSG_RECEIVE_THREADS_MAX, 1),
+    EPROSIMA_PROPERTY_STRING_LIST(struct UdpMmsgTransportConfig, "receive_thread_cpus", receiveThreadCpusList, receiveThreadCpusListLength),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "receive_queue_size", receiveQueueSize, 1, 65536, 1024),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "steer_by_guid_prefix", steerByGuidPrefix, 0, 1, 1),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "busy_poll", busyPoll, 0, 1, 0),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "busy_poll_us", busyPollUs, 0, 1000000, 50),
+    EPROSIMA_PROPERTY_STRING_LIST(struct UdpMmsgTransportConfig, "busy_poll_cpus", busyPollCpusList, busyPollCpusListLength),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "busy_poll_idle_spins", busyPollIdleSpins, 0, INT_MAX, 10000),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "busy_poll_backoff_max_us", busyPollBackoffMaxUs, 1, 1000000, 100),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "buffer_pool_size", bufferPoolSize, 0, 1048576, 0),
+    EPROSIMA_PROPERTY_INT(struct UdpMmsgTransportConfig, "buffer_pool_huge_pages", bufferPoolHugePages, 0, 1, 1)
+};
+
+#if defined(UDPMMSG_TRANSPORT_SUPPORTED)
+
+/**
+ * \brief Message queued to be sent. Its data is in the storage of the queue.
+ */
+struct UdpMmsgQueuedMessage
+{
+    struct sockaddr_in destination;
+    size_t offset;
+    size_t length;
+};
+
+struct UdpMmsgTransport
+{
+    /// It has to be the first field.
+    NDDS_Transport_Plugin parent;
+    struct NDDS_Transport_Property_t property;
+    struct UdpMmsgTransportConfig config;
+    NDDS_Transport_Listener *listener;
+
+    int sendSocket;
+
+    /// Queue of messages. It is only used when flushTimeoutUs is not 0.
+    pthread_mutex_t queueMutex;
+    pthread_cond_t queueCondition;
+    pthread_t flushThread;
+    int flushThreadRunning;
+    struct UdpMmsgQueuedMessage *queue;
+    int queueLength;
+    char *queueStorage;
+    size_t queueStorageLength;
+    struct timespec queueDeadline;
+    struct mmsghdr *sendMessages;
+    struct iovec *sendIovecs;
+    char *sendControls;
+
+    /// Metrics of the busy poll mode. Each thread adds its counters when it receives or backs off.
+    struct eProsima_UdpMmsgReceiveMetrics receiveMetrics;
+
+    /// Receive buffers of all the ports when buffer_pool_size is not 0.
+    struct eProsima_TransportBufferPool *bufferPool;
+
+    /// Each CPU of busy_poll_cpus is assigned to one receive resource. It is 1 while it is assigned.
+    int busyPollCpusUsed[UDPMMSG_BUSY_POLL_CPUS_MAX];
+};
+
+/**
+ * \brief Buffers of the datagrams received by one recvmmsg call. The buffer of each datagram is in its iovec.
+ * They are in the storage or, when the transport has a buffer pool, they are taken from the pool by the
+ * thread that receives, so they are in its NUMA node.
+ */
+struct UdpMmsgBatch
+{
+    struct mmsghdr *messages;
+    struct iovec *iovecs;
+    char *storage;
+    char *controls;
+    size_t slotSize;
+    int batchSize;
+    struct eProsima_TransportBufferPool *pool;
+};
+
+/**
+ * \brief Message queued by a shard when the transport has a buffer pool. The datagram stays in the buffer
+ * where it was received.
+ */
+struct UdpMmsgPooledMessage
+{
+    char *buffer;
+    unsigned int length;
+};
+
+struct UdpMmsgRecvResource;
+
+/**
+ * \brief Socket of a sharded receive port and the thread that reads it.
+ */
+struct UdpMmsgShard
+{
+    struct UdpMmsgRecvResource *resource;
+    int socket;
+    int cpu;
+    struct UdpMmsgBatch batch;
+    pthread_t thread;
+    int threadCreated;
+};
+
+struct UdpMmsgRecvResource
+{
+    struct UdpMmsgTransport *transport;
+    int socket;
+    NDDS_Transport_Port_t port;
+    int isMulticast;
+    struct in_addr multicastAddress;
+
+    /// Batch of received datagrams.
+    struct UdpMmsgBatch batch;
+    int received;
+    int current;
+    /// Offset of the next segment inside the current datagram when GRO is used.
+    size_t segmentOffset;
+    /// Index in busy_poll_cpus of the CPU of the receive thread of the middleware. -1 if it is not pinned.
+    int busyPollCpu;
+    /// The receive thread of the middleware was pinned to its CPU.
+    int receiveThreadPinned;
+
+    /// Shards of a unicast port when receive_threads is greater than 1. Their threads copy the datagrams
+    /// to the ring and the receive thread of the middleware takes them from it. The socket field is not used.
+    struct UdpMmsgShard *shards;
+    int shardsLength;
+    int shardsRunning;
+    /// Socket whose name reserves the port for the shards of this process while the resource exists.
+    int portLock;
+    char *ringMemory;
+    struct eProsima_MessageRing *ring;
+};
+
+struct UdpMmsgSendResource
+{
+    struct sockaddr_in destination;
+};
+
+#define UDPMMSG_CONTROL_SIZE CMSG_SPACE(sizeof(int))
+
+static in_addr_t getAddressIPv4(const NDDS_Transport_Address_t *address)
+{
+    in_addr_t returnedValue = 0;
+
+    memcpy(&returnedValue, &address->network_ordered_value[12], sizeof(returnedValue));
+    return returnedValue;
+}
+
+static void setAddressIPv4(NDDS_Transport_Address_t *address, in_addr_t ipv4)
+{
+    memset(address, 0, sizeof(NDDS_Transport_Address_t));
+    memcpy(&address->network_ordered_value[12], &ipv4, sizeof(ipv4));
+}
+
+static void addTimespecMicroseconds(struct timespec *time, int microseconds)
+{
+    time->tv_nsec += (long)microseconds * 1000;
+
+    while(time->tv_nsec >= 1000000000L)
+    {
+        time->tv_nsec -= 1000000000L;
+        ++time->tv_sec;
+    }
+}
+
+static int isTimespecReached(const struct timespec *time)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    return now.tv_sec > time->tv_sec || (now.tv_sec == time->tv_sec && now.tv_nsec >= time->tv_nsec);
+}
+
+/**
+ * \brief This function sends one by one the segments of a datagram that sendmmsg rejected with EIO, EINVAL
+ * or EOPNOTSUPP. GSO is disabled, because some kernels and devices accept the socket option but reject the
+ * segmented datagrams.
+ */
+static void sendSegmentsWithoutGso(struct UdpMmsgTransport *transport, struct msghdr *message)
+{
+    const char* const METHOD_NAME = "sendSegmentsWithoutGso";
+    char *data = (char*)message->msg_iov[0].iov_base;
+    size_t length = message->msg_iov[0].iov_len, segmentSize = (size_t)*(int*)CMSG_DATA(CMSG_FIRSTHDR(message)), offset = 0;
+
+    printf("WARNING<%s>: UDP GSO is not supported. It is disabled\n", METHOD_NAME);
+    transport->config.useGso = 0;
+
+    for(offset = 0; offset < length; offset += segmentSize)
+    {
+        sendto(transport->sendSocket, data + offset, length - offset < segmentSize ? length - offset : segmentSize, 0,
+                (struct sockaddr*)message->msg_name, message->msg_namelen);
+    }
+}
+
+/**
+ * \brief This function sends the queued messages with sendmmsg. The queue mutex has to be taken.
+ *
+ * With GSO, consecutive messages to the same destination are joined in one datagram while they have
+ * the size of the first one. Only the last message of a datagram can be smaller.
+ */
+static void flushQueue(struct UdpMmsgTransport *transport)
+{
+    struct UdpMmsgQueuedMessage *first = NULL, *auxMessage = NULL;
+    struct mmsghdr *sendMessage = NULL;
+    struct cmsghdr *control = NULL;
+    size_t length = 0;
+    int messagesLength = 0, sent = 0, result = 0, i = 0, j = 0;
+
+    for(i = 0; i < transport->queueLength; i = j)
+    {
+        first = &transport->queue[i];
+        length = first->length;
+
+        for(j = i + 1; transport->config.useGso && j < transport->queueLength && j - i < UDPMMSG_SEGMENTS_MAX; ++j)
+        {
+            auxMessage = &transport->queue[j];
+
+            if(auxMessage->destination.sin_addr.s_addr != first->destination.sin_addr.s_addr ||
+                    auxMessage->destination.sin_port != first->destination.sin_port ||
+                    auxMessage->length > first->length || transport->queue[j - 1].length != first->length ||
+                    length + auxMessage->length > UDPMMSG_SEGMENTED_SIZE_MAX)
+                break;
+
+            length += auxMessage->length;
+        }
+
+        if(!transport->config.useGso)
+            j = i + 1;
+
+        // The data of the joined messages is contiguous in the storage.
+        sendMessage = &transport->sendMessages[messagesLength];
+        memset(sendMessage, 0, sizeof(struct mmsghdr));
+        transport->sendIovecs[messagesLength].iov_base = transport->queueStorage + first->offset;
+        transport->sendIovecs[messagesLength].iov_len = length;
+        sendMessage->msg_hdr.msg_name = &first->destination;
+        sendMessage->msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        sendMessage->msg_hdr.msg_iov = &transport->sendIovecs[messagesLength];
+        sendMessage->msg_hdr.msg_iovlen = 1;
+
+        if(j - i > 1)
+        {
+            sendMessage->msg_hdr.msg_control = transport->sendControls + messagesLength * UDPMMSG_CONTROL_SIZE;
+            sendMessage->msg_hdr.msg_controllen = UDPMMSG_CONTROL_SIZE;
+            control = CMSG_FIRSTHDR(&sendMessage->msg_hdr);
+            control->cmsg_level = SOL_UDP;
+            control->cmsg_type = UDP_SEGMENT;
+            control->cmsg_len = CMSG_LEN(sizeof(int));
+            *(int*)CMSG_DATA(control) = (int)first->length;
+        }
+
+        ++messagesLength;
+    }
+
+    while(sent < messagesLength)
+    {
+        result = sendmmsg(transport->sendSocket, transport->sendMessages + sent, messagesLength - sent, 0);
+
+        if(result > 0)
+            sent += result;
+        else if(result < 0 && errno == EINTR)
+            continue;
+        else
+        {
+            // Only the errors of a rejected segmented datagram disable GSO. With other errors (i.e. ENOBUFS or
+            // an unreachable destination) the datagram is dropped like any UDP datagram that cannot be sent.
+            if(transport->sendMessages[sent].msg_hdr.msg_controllen != 0 && result < 0 &&
+                    (errno == EIO || errno == EINVAL || errno == EOPNOTSUPP))
+                sendSegmentsWithoutGso(transport, &transport->sendMessages[sent].msg_hdr);
+
+            ++sent;
+        }
+    }
+
+    transport->queueLength = 0;
+    transport->queueStorageLength = 0;
+}
+
+static void* flushThreadFunction(void *arg)
+{
+    struct UdpMmsgTransport *transport = (struct UdpMmsgTransport*)arg;
+
+    pthread_mutex_lock(&transport->queueMutex);
+
+    while(transport->flushThreadRunning)
+    {
+        if(transport->queueLength == 0)
+            pthread_cond_wait(&transport->queueCondition, &transport->queueMutex);
+        else if(isTimespecReached(&transport->queueDeadline))
+            flushQueue(transport);
+        else
+            pthread_cond_timedwait(&transport->queueCondition, &transport->queueMutex, &transport->queueDeadline);
+    }
+
+    if(transport->queueLength > 0)
+        flushQueue(transport);
+
+    pthread_mutex_unlock(&transport->queueMutex);
+    return NULL;
+}
+
+static RTI_INT32 UdpMmsgTransport_send(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in,
+        const NDDS_Transport_Buffer_t buffer_in[], RTI_INT32 buffer_count_in, void *reserved)
+{
+    struct UdpMmsgTransport *transport = (struct UdpMmsgTransport*)self;
+    struct UdpMmsgSendResource *resource = (struct UdpMmsgSendResource*)*sendresource_in;
+    struct UdpMmsgQueuedMessage *queued = NULL;
+    struct iovec iovecs[UDPMMSG_SEGMENTS_MAX];
+    struct msghdr message;
+    size_t length = 0;
+    RTI_INT32 i = 0;
+
+    if(buffer_count_in > UDPMMSG_SEGMENTS_MAX)
+        return RTI_FALSE;
+
+    for(i = 0; i < buffer_count_in; ++i)
+    {
+        iovecs[i].iov_base = buffer_in[i].pointer;
+        iovecs[i].iov_len = buffer_in[i].length;
+        length += buffer_in[i].length;
+    }
+
+    if(length > (size_t)transport->config.messageSizeMax)
+        return RTI_FALSE;
+
+    if(transport->config.flushTimeoutUs == 0)
+    {
+        memset(&message, 0, sizeof(message));
+        message.msg_name = &resource->destination;
+        message.msg_namelen = sizeof(struct sockaddr_in);
+        message.msg_iov = iovecs;
+        message.msg_iovlen = buffer_count_in;
+
+        return sendmsg(transport->sendSocket, &message, 0) >= 0 ? RTI_TRUE : RTI_FALSE;
+    }
+
+    pthread_mutex_lock(&transport->queueMutex);
+
+    queued = &transport->queue[transport->queueLength];
+    queued->destination = resource->destination;
+    queued->offset = transport->queueStorageLength;
+    queued->length = length;
+
+    for(i = 0; i < buffer_count_in; ++i)
+    {
+        memcpy(transport->queueStorage + transport->queueStorageLength, buffer_in[i].pointer, buffer_in[i].length);
+        transport->queueStorageLength += buffer_in[i].length;
+    }
+
+    if(++transport->queueLength == transport->config.batchSize)
+    {
+        flushQueue(transport);
+    }
+    else if(transport->queueLength == 1)
+    {
+        // The first message sets when the queue is flushed.
+        clock_gettime(CLOCK_REALTIME, &transport->queueDeadline);
+        addTimespecMicroseconds(&transport->queueDeadline, transport->config.flushTimeoutUs);
+        pthread_cond_signal(&transport->queueCondition);
+    }
+
+    pthread_mutex_unlock(&transport->queueMutex);
+
+    return RTI_TRUE;
+}
+
+/**
+ * \brief This function returns the size of the segments of a datagram coalesced by GRO.
+ */
+static size_t getGroSegmentSize(struct msghdr *message, size_t length)
+{
+    struct cmsghdr *control = NULL;
+
+    for(control = CMSG_FIRSTHDR(message); control != NULL; control = CMSG_NXTHDR(message, control))
+    {
+        if(control->cmsg_level == SOL_UDP && control->cmsg_type == UDP_GRO)
+            return (size_t)*(int*)CMSG_DATA(control);
+    }
+
+    return length;
+}
+
+static void pinCurrentThread(int cpu)
+{
+    const char* const METHOD_NAME = "pinCurrentThread";
+#if defined(CPU_SET)
+    cpu_set_t cpus;
+
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+
+    if(pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0)
+        printf("WARNING<%s>: Cannot pin the thread to the CPU %d\n", METHOD_NAME, cpu);
+#else
+    printf("WARNING<%s>: Threads cannot be pinned in this platform\n", METHOD_NAME);
+#endif
+}
+
+/**
+ * \brief This function receives a batch of datagrams.
+ *
+ * In busy poll mode, the socket is polled without blocking. After busy_poll_idle_spins empty polls, the thread
+ * sleeps between polls, doubling the sleep up to busy_poll_backoff_max_us, until a datagram arrives.
+ *
+ * \param running If it is not NULL, the function returns 0 when it becomes 0.
+ * \return Number of datagrams. In error case -1 is returned.
+ */
+static int receiveBatch(struct UdpMmsgTransport *transport, int recvSocket, struct UdpMmsgBatch *batch, int *running)
+{
+    struct timespec backoff;
+    unsigned long long emptyPolls = 0, backoffs = 0;
+    long backoffUs = 1;
+    int result = 0, spins = 0;
+
+    if(!transport->config.busyPoll)
+        return recvmmsg(recvSocket, batch->messages, transport->config.batchSize, MSG_WAITFORONE, NULL);
+
+    while(running == NULL || EPROSIMA_ATOMIC_LOAD32(running))
+    {
+        result = recvmmsg(recvSocket, batch->messages, transport->config.batchSize, MSG_DONTWAIT, NULL);
+
+        if(result > 0 || (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+            break;
+
+        ++emptyPolls;
+
+        if(spins < transport->config.busyPollIdleSpins)
+        {
+            ++spins;
+            EPROSIMA_CPU_RELAX();
+        }
+        else
+        {
+            ++backoffs;
+            backoff.tv_sec = backoffUs / 1000000;
+            backoff.tv_nsec = (backoffUs % 1000000) * 1000;
+            nanosleep(&backoff, NULL);
+
+            if(backoffUs < transport->config.busyPollBackoffMaxUs)
+                backoffUs = backoffUs * 2 < transport->config.busyPollBackoffMaxUs ? backoffUs * 2 : transport->config.busyPollBackoffMaxUs;
+        }
+    }
+
+    if(result > 0)
+    {
+        EPROSIMA_ATOMIC_ADD64(&transport->receiveMetrics.hitPolls, 1);
+        EPROSIMA_ATOMIC_ADD64(&transport->receiveMetrics.receivedDatagrams, (unsigned long long)result);
+    }
+
+    EPROSIMA_ATOMIC_ADD64(&transport->receiveMetrics.emptyPolls, emptyPolls);
+    EPROSIMA_ATOMIC_ADD64(&transport->receiveMetrics.backoffs, backoffs);
+
+    return result > 0 || running == NULL || EPROSIMA_ATOMIC_LOAD32(running) ? result : 0;
+}
+
+/**
+ * \brief This function allocates the buffers of a batch. With a pool, the buffers of the datagrams are taken
+ * later by fillBatch.
+ *
+ * \return 0 if the batch was created. In error case -1 is returned.
+ */
+static int createBatch(struct UdpMmsgBatch *batch, int batchSize, size_t slotSize, int useGro, struct eProsima_TransportBufferPool *pool)
+{
+    int i = 0;
+
+    batch->slotSize = slotSize;
+    batch->batchSize = batchSize;
+    batch->pool = pool;
+    RTIOsapiHeap_allocateArray(&batch->messages, batchSize, struct mmsghdr);
+    RTIOsapiHeap_allocateArray(&batch->iovecs, batchSize, struct iovec);
+    if(pool == NULL)
+        RTIOsapiHeap_allocateArray(&batch->storage, batchSize * slotSize, char);
+    if(useGro)
+        RTIOsapiHeap_allocateArray(&batch->controls, batchSize * UDPMMSG_CONTROL_SIZE, char);
+
+    if(batch->messages == NULL || batch->iovecs == NULL || (pool == NULL && batch->storage == NULL) || (useGro && batch->controls == NULL))
+        return -1;
+
+    memset(batch->messages, 0, batchSize * sizeof(struct mmsghdr));
+    for(i = 0; i < batchSize; ++i)
+    {
+        batch->iovecs[i].iov_base = batch->storage != NULL ? batch->storage + i * slotSize : NULL;
+        batch->iovecs[i].iov_len = slotSize;
+        batch->messages[i].msg_hdr.msg_iov = &batch->iovecs[i];
+        batch->messages[i].msg_hdr.msg_iovlen = 1;
+
+        if(batch->controls != NULL)
+        {
+            batch->messages[i].msg_hdr.msg_control = batch->controls + i * UDPMMSG_CONTROL_SIZE;
+            batch->messages[i].msg_hdr.msg_controllen = UDPMMSG_CONTROL_SIZE;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \brief This function takes from the pool the buffers of the datagrams of a batch that have none.
+ *
+ * \return 0 if all the datagrams have a buffer. In error case -1 is returned.
+ */
+static int fillBatch(struct UdpMmsgBatch *batch)
+{
+    NDDS_Transport_Buffer_t buffer;
+    int i = 0;
+
+    for(i = 0; i < batch->batchSize; ++i)
+    {
+        if(batch->iovecs[i].iov_base == NULL)
+        {
+            if(eProsimaTransportBufferPool_take(batch->pool, &buffer) != 0)
+                return -1;
+
+            batch->iovecs[i].iov_base = buffer.pointer;
+        }
+    }
+
+    return 0;
+}
+
+static void freeBatch(struct UdpMmsgBatch *batch)
+{
+    int i = 0;
+
+    if(batch->messages != NULL)
+        RTIOsapiHeap_freeArray(batch->messages);
+    if(batch->pool != NULL && batch->iovecs != NULL)
+    {
+        for(i = 0; i < batch->batchSize; ++i)
+        {
+            if(batch->iovecs[i].iov_base != NULL)
+                eProsimaTransportBufferPool_give(batch->pool, (char*)batch->iovecs[i].iov_base);
+        }
+    }
+    if(batch->iovecs != NULL)
+        RTIOsapiHeap_freeArray(batch->iovecs);
+    if(batch->storage != NULL)
+        RTIOsapiHeap_freeArray(batch->storage);
+    if(batch->controls != NULL)
+        RTIOsapiHeap_freeArray(batch->controls);
+}
+
+static RTI_INT32 receiveFromRing(struct UdpMmsgRecvResource *resource, NDDS_Transport_Message_t *message_out)
+{
+    unsigned int length = 0;
+    char *message = (char*)eProsimaMessageRing_take(resource->ring, &length, 1);
+
+    if(message != NULL)
+    {
+        // The copy made by the shard, or its pool buffer, is lent. It is released in return_loaned_buffer_rEA.
+        if(resource->transport->bufferPool != NULL)
+        {
+            message_out->buffer.pointer = ((struct UdpMmsgPooledMessage*)message)->buffer;
+            message_out->buffer.length = (RTI_INT32)((struct UdpMmsgPooledMessage*)message)->length;
+        }
+        else
+        {
+            message_out->buffer.pointer = message;
+            message_out->buffer.length = (RTI_INT32)length;
+        }
+
+        message_out->loaned_buffer_param = message;
+    }
+    else
+    {
+        // Unblocked by unblock_receive_rrEA.
+        message_out->buffer.length = 0;
+        message_out->loaned_buffer_param = NULL;
+    }
+
+    return RTI_TRUE;
+}
+
+static RTI_INT32 UdpMmsgTransport_receive_rEA(NDDS_Transport_Plugin *self, NDDS_Transport_Message_t *message_out,
+        const NDDS_Transport_Buffer_t *buffer_in, const NDDS_Transport_RecvResource_t *recvresource_in, void *reserved)
+{
+    struct UdpMmsgTransport *transport = (struct UdpMmsgTransport*)self;
+    struct UdpMmsgRecvResource *resource = (struct UdpMmsgRecvResource*)*recvresource_in;
+    struct mmsghdr *auxMessage = NULL;
+    size_t length = 0, segmentSize = 0;
+    int result = 0, i = 0;
+
+    if(resource->ring != NULL)
+        return receiveFromRing(resource, message_out);
+
+    // The receive thread belongs to the middleware, so it is pinned when it starts polling.
+    if(resource->busyPollCpu >= 0 && !resource->receiveThreadPinned)
+    {
+        pinCurrentThread(transport->config.busyPollCpus[resource->busyPollCpu]);
+        resource->receiveThreadPinned = 1;
+    }
+
+    // The buffers are taken by the receive thread of the middleware, after it was pinned.
+    if(resource->batch.pool != NULL && resource->batch.iovecs[0].iov_base == NULL && fillBatch(&resource->batch) != 0)
+        return RTI_FALSE;
+
+    for(;;)
+    {
+        if(resource->current < resource->received)
+        {
+            auxMessage = &resource->batch.messages[resource->current];
+            length = auxMessage->msg_len;
+            segmentSize = getGroSegmentSize(&auxMessage->msg_hdr, length);
+
+            // The datagrams are lent from the batch. They are not reused until the batch is consumed.
+            message_out->buffer.pointer = (char*)resource->batch.iovecs[resource->current].iov_base + resource->segmentOffset;
+            message_out->buffer.length = (RTI_INT32)(length - resource->segmentOffset < segmentSize ?
+                    length - resource->segmentOffset : segmentSize);
+            message_out->loaned_buffer_param = NULL;
+
+            resource->segmentOffset += message_out->buffer.length;
+
+            if(resource->segmentOffset >= length)
+            {
+                ++resource->current;
+                resource->segmentOffset = 0;
+            }
+
+            // An empty datagram is sent by unblock_receive_rrEA.
+            return RTI_TRUE;
+        }
+
+        for(i = 0; i < resource->received; ++i)
+            resource->batch.messages[i].msg_hdr.msg_controllen = resource->batch.controls != NULL ? UDPMMSG_CONTROL_SIZE : 0;
+
+        resource->received = 0;
+        resource->current = 0;
+        resource->segmentOffset = 0;
+
+        result = receiveBatch(transport, resource->socket, &resource->batch, NULL);
+
+        if(result > 0)
+            resource->received = result;
+        else if(result < 0 && errno != EINTR)
+            return RTI_FALSE;
+    }
+}
+
+static void UdpMmsgTransport_return_loaned_buffer_rEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        NDDS_Transport_Message_t *message_in, void *reserved)
+{
+    struct UdpMmsgRecvResource *resource = (struct UdpMmsgRecvResource*)*recvresource_in;
+
+    if(message_in->loaned_buffer_param != NULL)
+    {
+        // The buffer returns to the NUMA node of the shard that received it.
+        if(resource->transport->bufferPool != NULL)
+            eProsimaTransportBufferPool_give(resource->transport->bufferPool,
+                    ((struct UdpMmsgPooledMessage*)message_in->loaned_buffer_param)->buffer);
+
+        eProsimaMessageRing_release(resource->ring, message_in->loaned_buffer_param);
+    }
+
+    message_in->loaned_buffer_param = NULL;
+}
+
+static RTI_INT32 UdpMmsgTransport_unblock_receive_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        void *reserved)
+{
+    struct UdpMmsgTransport *transport = (struct UdpMmsgTransport*)self;
+    struct UdpMmsgRecvResource *resource = (struct UdpMmsgRecvResource*)*recvresource_in;
+    struct sockaddr_in destination;
+
+    // An empty datagram would only reach one of the shards.
+    if(resource->ring != NULL)
+    {
+        eProsimaMessageRing_unblock(resource->ring);
+        return RTI_TRUE;
+    }
+
+    // Like the UDPv4 transport, an empty datagram wakes up the receive thread.
+    memset(&destination, 0, sizeof(destination));
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons((unsigned short)resource->port);
+    destination.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    return sendto(transport->sendSocket, "", 0, 0, (struct sockaddr*)&destination, sizeof(destination)) == 0 ? RTI_TRUE : RTI_FALSE;
+}
+
+/**
+ * \brief This function creates a socket bound to a receive port.
+ *
+ * \return The socket. If the port is used by other participant or there is an error, -1 is returned.
+ */
+static int openRecvSocket(struct UdpMmsgTransport *transport, NDDS_Transport_Port_t port, int isMulticast, int reusePort)
+{
+    const char* const METHOD_NAME = "openRecvSocket";
+    struct sockaddr_in address;
+    int option = 1, recvSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    if(recvSocket < 0)
+        return -1;
+
+    setsockopt(recvSocket, SOL_SOCKET, SO_RCVBUF, &transport->config.recvSocketBufferSize, sizeof(int));
+
+    // Multicast ports are shared with other participants.
+    if(isMulticast)
+        setsockopt(recvSocket, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+
+    if(reusePort && setsockopt(recvSocket, SOL_SOCKET, SO_REUSEPORT, &option, sizeof(option)) != 0)
+    {
+        printf("ERROR<%s>: SO_REUSEPORT is not supported\n", METHOD_NAME);
+        close(recvSocket);
+        return -1;
+    }
+
+    if(transport->config.useGro && setsockopt(recvSocket, SOL_UDP, UDP_GRO, &option, sizeof(option)) != 0)
+        printf("WARNING<%s>: UDP GRO is not supported\n", METHOD_NAME);
+
+    // The kernel polls the device queue in the receive calls. Raising it needs CAP_NET_ADMIN.
+    if(transport->config.busyPoll && transport->config.busyPollUs > 0 &&
+            setsockopt(recvSocket, SOL_SOCKET, SO_BUSY_POLL, &transport->config.busyPollUs, sizeof(int)) != 0)
+        printf("WARNING<%s>: SO_BUSY_POLL cannot be set. Only the socket is polled\n", METHOD_NAME);
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((unsigned short)port);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if(bind(recvSocket, (struct sockaddr*)&address, sizeof(address)) != 0)
+    {
+        close(recvSocket);
+        return -1;
+    }
+
+    return recvSocket;
+}
+
+/**
+ * \brief This function attaches to the shards a program that selects the shard with the GUID prefix of the
+ * RTPS header, so the messages of a participant are received in order by one shard. Datagrams without
+ * RTPS header go to the first shard.
+ *
+ * \return 0 if the program was attached. In error case -1 is returned.
+ */
+static int attachGuidPrefixSteering(struct UdpMmsgRecvResource *resource)
+{
+    // The program sees the UDP payload. The GUID prefix is in the bytes 8 to 19 of the RTPS header.
+    struct sock_filter code[] =
+    {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 8),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 12),
+        BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 16),
+        BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+        BPF_STMT(BPF_ALU | BPF_MUL | BPF_K, 0x9E3779B1U),
+        BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 16),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, (unsigned int)resource->shardsLength),
+        BPF_STMT(BPF_RET | BPF_A, 0)
+    };
+    struct sock_fprog program;
+
+    program.len = sizeof(code) / sizeof(code[0]);
+    program.filter = code;
+
+    return setsockopt(resource->shards[0].socket, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) == 0 ? 0 : -1;
+}
+
+static void* shardThreadFunction(void *arg)
+{
+    struct UdpMmsgShard *shard = (struct UdpMmsgShard*)arg;
+    struct UdpMmsgRecvResource *resource = shard->resource;
+    struct eProsima_TransportBufferPool *pool = resource->transport->bufferPool;
+    struct UdpMmsgPooledMessage *pooledMessage = NULL;
+    NDDS_Transport_Buffer_t buffer;
+    unsigned long long ticket = 0;
+    char *slot = NULL;
+    int result = 0, i = 0;
+
+    if(shard->cpu >= 0)
+        pinCurrentThread(shard->cpu);
+
+    // The buffers are taken after pinning the thread, so they are in its NUMA node.
+    if(pool != NULL && fillBatch(&shard->batch) != 0)
+        return NULL;
+
+    while(EPROSIMA_ATOMIC_LOAD32(&resource->shardsRunning))
+    {
+        result = receiveBatch(resource->transport, shard->socket, &shard->batch, &resource->shardsRunning);
+
+        if(result < 0 && errno != EINTR)
+            break;
+
+        for(i = 0; i < result; ++i)
+        {
+            // Empty datagrams only wake up receive threads.
+            if(shard->batch.messages[i].msg_len == 0)
+                continue;
+
+            if(pool == NULL)
+            {
+                // When the middleware is slower, the socket buffer fills and the kernel drops the datagrams.
+                while((slot = (char*)eProsimaMessageRing_reserve(resource->ring, &ticket)) == NULL &&
+                        EPROSIMA_ATOMIC_LOAD32(&resource->shardsRunning))
+                    sched_yield();
+
+                if(slot == NULL)
+                    break;
+
+                memcpy(slot, shard->batch.iovecs[i].iov_base, shard->batch.messages[i].msg_len);
+                eProsimaMessageRing_commit(resource->ring, ticket, shard->batch.messages[i].msg_len);
+                continue;
+            }
+
+            // The buffer is queued without copying and the datagram gets a new one. It is taken before the slot,
+            // because a reserved slot has to be committed. If there is no memory, the datagram is dropped and
+            // its buffer is reused.
+            if(eProsimaTransportBufferPool_take(pool, &buffer) != 0)
+            {
+                EPROSIMA_ATOMIC_ADD64(&resource->transport->receiveMetrics.droppedDatagrams, 1);
+                continue;
+            }
+
+            while((slot = (char*)eProsimaMessageRing_reserve(resource->ring, &ticket)) == NULL &&
+                    EPROSIMA_ATOMIC_LOAD32(&resource->shardsRunning))
+                sched_yield();
+
+            if(slot == NULL)
+            {
+                eProsimaTransportBufferPool_give(pool, buffer.pointer);
+                break;
+            }
+
+            pooledMessage = (struct UdpMmsgPooledMessage*)slot;
+            pooledMessage->buffer = (char*)shard->batch.iovecs[i].iov_base;
+            pooledMessage->length = shard->batch.messages[i].msg_len;
+            shard->batch.iovecs[i].iov_base = buffer.pointer;
+
+            eProsimaMessageRing_commit(resource->ring, ticket, sizeof(struct UdpMmsgPooledMessage));
+        }
+    }
+
+    return NULL;
+}
+
+static void freeRecvResource(struct UdpMmsgRecvResource *resource)
+{
+    int i = 0;
+
+    if(resource->shards != NULL)
+    {
+        // Shutting down the sockets wakes up the threads blocked in recvmmsg.
+        EPROSIMA_ATOMIC_STORE32(&resource->shardsRunning, 0);
+
+        for(i = 0; i < resource->shardsLength; ++i)
+        {
+            if(resource->shards[i].socket >= 0)
+                shutdown(resource->shards[i].socket, SHUT_RDWR);
+        }
+
+        for(i = 0; i < resource->shardsLength; ++i)
+        {
+            if(resource->shards[i].threadCreated)
+                pthread_join(resource->shards[i].thread, NULL);
+            if(resource->shards[i].socket >= 0)
+                close(resource->shards[i].socket);
+            freeBatch(&resource->shards[i].batch);
+        }
+
+        RTIOsapiHeap_freeArray(resource->shards);
+    }
+
+    if(resource->portLock >= 0)
+        close(resource->portLock);
+
+    // The pool buffers of the messages the middleware didn't take return to the pool.
+    if(resource->ring != NULL && resource->transport->bufferPool != NULL)
+    {
+        struct UdpMmsgPooledMessage *pooledMessage = NULL;
+        unsigned int length = 0;
+
+        while((pooledMessage = (struct UdpMmsgPooledMessage*)eProsimaMessageRing_take(resource->ring, &length, 0)) != NULL)
+        {
+            eProsimaTransportBufferPool_give(resource->transport->bufferPool, pooledMessage->buffer);
+            eProsimaMessageRing_release(resource->ring, pooledMessage);
+        }
+    }
+
+    if(resource->busyPollCpu >= 0)
+        EPROSIMA_ATOMIC_STORE32(&resource->transport->busyPollCpusUsed[resource->busyPollCpu], 0);
+    if(resource->ringMemory != NULL)
+        RTIOsapiHeap_freeArray(resource->ringMemory);
+    if(resource->socket >= 0)
+        close(resource->socket);
+    freeBatch(&resource->batch);
+
+    RTIOsapiHeap_freeStructure(resource);
+}
+
+/**
+ * \brief This function reserves a port for the shards with an abstract Unix socket named after it. Other
+ * participant that binds SO_REUSEPORT sockets to the port would join the group of the shards, so it has to
+ * reserve the port first. The kernel releases the name when the process ends.
+ *
+ * \return The socket. If other participant reserved the port or there is an error, -1 is returned.
+ */
+static int lockPort(NDDS_Transport_Port_t port)
+{
+    struct sockaddr_un address;
+    socklen_t addressLength = 0;
+    int lockSocket = socket(AF_UNIX, SOCK_DGRAM, 0);
+
+    if(lockSocket < 0)
+        return -1;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    // The first character of an abstract name is the null character.
+    addressLength = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + 1 +
+        SNPRINTF(address.sun_path + 1, sizeof(address.sun_path) - 1, UDPMMSG_CLASS_NAME ".%u", (unsigned int)port));
+
+    if(bind(lockSocket, (struct sockaddr*)&address, addressLength) != 0)
+    {
+        close(lockSocket);
+        return -1;
+    }
+
+    return lockSocket;
+}
+
+/**
+ * \brief This function assigns to a receive resource the first free CPU of busy_poll_cpus, so the receive threads
+ * of the middleware don't share a CPU.
+ *
+ * \return Index of the CPU in busy_poll_cpus. If all of them are assigned, -1 is returned.
+ */
+static int assignBusyPollCpu(struct UdpMmsgTransport *transport)
+{
+    const char* const METHOD_NAME = "assignBusyPollCpu";
+    int i = 0;
+
+    for(i = 0; i < transport->config.busyPollCpusListLength; ++i)
+    {
+        if(EPROSIMA_ATOMIC_CAS32(&transport->busyPollCpusUsed[i], 0, 1))
+            return i;
+    }
+
+    printf("WARNING<%s>: All the CPUs of busy_poll_cpus are assigned. The receive thread is not pinned\n", METHOD_NAME);
+    return -1;
+}
+
+/**
+ * \brief This function opens the sockets of the shards of a unicast port and starts their threads.
+ *
+ * \return 0 if the shards were created. If the port is used or there is an error, -1 is returned.
+ */
+static int createShards(struct UdpMmsgTransport *transport, struct UdpMmsgRecvResource *resource)
+{
+    const char* const METHOD_NAME = "createShards";
+    // With a pool, the ring only keeps the buffers of the messages.
+    unsigned int ringMessageSizeMax = transport->bufferPool != NULL ?
+        (unsigned int)sizeof(struct UdpMmsgPooledMessage) : (unsigned int)transport->config.messageSizeMax;
+    size_t ringSize = eProsimaMessageRing_getSize((unsigned int)transport->config.receiveQueueSize, ringMessageSizeMax);
+    size_t misalignment = 0;
+    int i = 0, probe = -1;
+
+    // SO_REUSEPORT would let other participant bind the port, so it is reserved and checked with a normal
+    // socket first. The reservation is kept until the shards are closed.
+    resource->portLock = lockPort(resource->port);
+
+    if(resource->portLock < 0)
+        return -1;
+
+    probe = openRecvSocket(transport, resource->port, 0, 0);
+
+    if(probe < 0)
+        return -1;
+
+    close(probe);
+
+    RTIOsapiHeap_allocateArray(&resource->shards, transport->config.receiveThreads, struct UdpMmsgShard);
+    RTIOsapiHeap_allocateArray(&resource->ringMemory, ringSize + UDPMMSG_RING_ALIGNMENT, char);
+
+    if(resource->shards == NULL || resource->ringMemory == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the shards\n", METHOD_NAME);
+        return -1;
+    }
+
+    misalignment = (size_t)resource->ringMemory % UDPMMSG_RING_ALIGNMENT;
+    resource->ring = eProsimaMessageRing_init(resource->ringMemory + (misalignment != 0 ? UDPMMSG_RING_ALIGNMENT - misalignment : 0),
+            (unsigned int)transport->config.receiveQueueSize, ringMessageSizeMax);
+    memset(resource->shards, 0, transport->config.receiveThreads * sizeof(struct UdpMmsgShard));
+
+    for(i = 0; i < transport->config.receiveThreads; ++i)
+        resource->shards[i].socket = -1;
+
+    resource->shardsLength = transport->config.receiveThreads;
+
+    // The sockets are bound first, so the kernel numbers them in the order of the shards.
+    for(i = 0; i < resource->shardsLength; ++i)
+    {
+        resource->shards[i].resource = resource;
+        resource->shards[i].cpu = transport->config.receiveThreadCpusListLength > 0 ?
+            transport->config.receiveThreadCpus[i % transport->config.receiveThreadCpusListLength] : -1;
+        resource->shards[i].socket = openRecvSocket(transport, resource->port, 0, 1);
+
+        if(resource->shards[i].socket < 0 ||
+                createBatch(&resource->shards[i].batch, transport->config.batchSize, (size_t)transport->config.messageSizeMax, 0,
+                    transport->bufferPool) != 0)
+        {
+            printf("ERROR<%s>: Cannot create the shard %d of the port %u\n", METHOD_NAME, i, (unsigned int)resource->port);
+            return -1;
+        }
+    }
+
+    if(transport->config.steerByGuidPrefix && attachGuidPrefixSteering(resource) != 0)
+        printf("WARNING<%s>: Cannot steer the messages by GUID prefix. The kernel hashes the source address\n", METHOD_NAME);
+
+    resource->shardsRunning = 1;
+
+    for(i = 0; i < resource->shardsLength; ++i)
+    {
+        if(pthread_create(&resource->shards[i].thread, NULL, shardThreadFunction, &resource->shards[i]) != 0)
+        {
+            printf("ERROR<%s>: Cannot create the thread of the shard %d\n", METHOD_NAME, i);
+            return -1;
+        }
+
+        resource->shards[i].threadCreated = 1;
+    }
+
+    return 0;
+}
+
+static RTI_INT32 UdpMmsgTransport_create_recvresource_rrEA(NDDS_Transport_Plugin *self, NDDS_Transport_RecvResource_t *recvresource_out,
+        NDDS_Transport_Port_t *port_inout, const NDDS_Transport_Address_t *multicast_address_in, RTI_INT32 reserved)
+{
+    const char* const METHOD_NAME = "UdpMmsgTransport_create_recvresource_rrEA";
+    struct UdpMmsgTransport *transport = (struct UdpMmsgTransport*)self;
+    struct UdpMmsgRecvResource *resource = NULL;
+    struct ip_mreq membership;
+
+    RTIOsapiHeap_allocateStructure(&resource, struct UdpMmsgRecvResource);
+
+    if(resource == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the receive resource\n", METHOD_NAME);
+        return RTI_FALSE;
+    }
+
+    memset(resource, 0, sizeof(struct UdpMmsgRecvResource));
+    resource->transport = transport;
+    resource->socket = -1;
+    resource->portLock = -1;
+    resource->busyPollCpu = -1;
+    resource->port = *port_inout;
+    resource->isMulticast = multicast_address_in != NULL;
+
+    // Every socket bound to a multicast port receives all the datagrams, so multicast ports are not sharded.
+    if(transport->config.receiveThreads > 1 && !resource->isMulticast)
+    {
+        if(createShards(transport, resource) != 0)
+        {
+            // The port can be used by other participant. The middleware tries other port.
+            freeRecvResource(resource);
+            return RTI_FALSE;
+        }
+
+        *recvresource_out = resource;
+        return RTI_TRUE;
+    }
+
+    if(transport->config.busyPoll && transport->config.busyPollCpusListLength > 0)
+        resource->busyPollCpu = assignBusyPollCpu(transport);
+
+    if(createBatch(&resource->batch, transport->config.batchSize,
+                transport->config.useGro ? UDPMMSG_SEGMENTED_SIZE_MAX : (size_t)transport->config.messageSizeMax,
+                transport->config.useGro, transport->bufferPool) != 0)
+    {
+        printf("ERROR<%s>: Cannot create the receive resource\n", METHOD_NAME);
+        freeRecvResource(resource);
+        return RTI_FALSE;
+    }
+
+    resource->socket = openRecvSocket(transport, resource->port, resource->isMulticast, 0);
+
+    if(resource->socket < 0)
+    {
+        // The port is used by other participant. The middleware tries other port.
+        freeRecvResource(resource);
+        return RTI_FALSE;
+    }
+
+    if(resource->isMulticast)
+    {
+        resource->multicastAddress.s_addr = getAddressIPv4(multicast_address_in);
+        membership.imr_multiaddr = resource->multicastAddress;
+        membership.imr_interface.s_addr = htonl(INADDR_ANY);
+
+        if(setsockopt(resource->socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0)
+        {
+            printf("ERROR<%s>: Cannot join the multicast group\n", METHOD_NAME);
+            freeRecvResource(resource);
+            return RTI_FALSE;
+        }
+    }
+
+    *recvresource_out = resource;
+    return RTI_TRUE;
+}
+
+static void UdpMmsgTransport_destroy_recvresource_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in)
+{
+    freeRecvResource((struct UdpMmsgRecvResource*)*recvresource_in);
+}
+
+static RTI_INT32 UdpMmsgTransport_share_recvresource_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        const NDDS_Transport_Port_t port_in, const NDDS_Transport_Address_t *multicast_address_in, RTI_INT32 reserved)
+{
+    struct UdpMmsgRecvResource *resource = (struct UdpMmsgRecvResource*)*recvresource_in;
+    struct ip_mreq membership;
+
+    if(resource->port != port_in || resource->isMulticast != (multicast_address_in != NULL))
+        return RTI_FALSE;
+
+    if(multicast_address_in != NULL && getAddressIPv4(multicast_address_in) != resource->multicastAddress.s_addr)
+    {
+        // Other group in the same port.
+        membership.imr_multiaddr.s_addr = getAddressIPv4(multicast_address_in);
+        membership.imr_interface.s_addr = htonl(INADDR_ANY);
+
+        return setsockopt(resource->socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) == 0;
+    }
+
+    return RTI_TRUE;
+}
+
+static RTI_INT32 UdpMmsgTransport_unshare_recvresource_rrEA(NDDS_Transport_Plugin *self, const NDDS_Transport_RecvResource_t *recvresource_in,
+        const NDDS_Transport_Port_t port_in, const NDDS_Transport_Address_t *multicast_address_in, RTI_INT32 reserved)
+{
+    return RTI_TRUE;
+}
+
+static RTI_INT32 UdpMmsgTransport_create_sendresource_srEA(NDDS_Transport_Plugin *self, NDDS_Transport_SendResource_t *sendresource_out,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in)
+{
+    struct UdpMmsgSendResource *resource = NULL;
+
+    RTIOsapiHeap_allocateStructure(&resource, struct UdpMmsgSendResource);
+
+    if(resource == NULL)
+        return RTI_FALSE;
+
+    memset(resource, 0, sizeof(struct UdpMmsgSendResource));
+    resource->destination.sin_family = AF_INET;
+    resource->destination.sin_port = htons((unsigned short)dest_port_in);
+    resource->destination.sin_addr.s_addr = getAddressIPv4(dest_address_in);
+
+    *sendresource_out = resource;
+    return RTI_TRUE;
+}
+
+static void UdpMmsgTransport_destroy_sendresource_srEA(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in)
+{
+    // Queued messages keep a copy of the destination, so they don't depend on the resource.
+    RTIOsapiHeap_freeStructure((struct UdpMmsgSendResource*)*sendresource_in);
+}
+
+static RTI_INT32 UdpMmsgTransport_share_sendresource_srEA(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in)
+{
+    struct UdpMmsgSendResource *resource = (struct UdpMmsgSendResource*)*sendresource_in;
+
+    return resource->destination.sin_port == htons((unsigned short)dest_port_in) &&
+        resource->destination.sin_addr.s_addr == getAddressIPv4(dest_address_in);
+}
+
+static RTI_INT32 UdpMmsgTransport_unshare_sendresource_srEA(NDDS_Transport_Plugin *self, const NDDS_Transport_SendResource_t *sendresource_in,
+        const NDDS_Transport_Address_t *dest_address_in, const NDDS_Transport_Port_t dest_port_in, RTI_INT32 transport_priority_in)
+{
+    return RTI_TRUE;
+}
+
+static const char* UdpMmsgTransport_get_class_name_cEA(NDDS_Transport_Plugin *self)
+{
+    return UDPMMSG_CLASS_NAME;
+}
+
+static RTI_INT32 UdpMmsgTransport_string_to_address_cEA(NDDS_Transport_Plugin *self, NDDS_Transport_Address_t *address_out,
+        const char *address_in)
+{
+    struct in_addr address;
+
+    if(address_in == NULL || inet_pton(AF_INET, address_in, &address) != 1)
+        return RTI_FALSE;
+
+    setAddressIPv4(address_out, address.s_addr);
+    return RTI_TRUE;
+}
+
+static RTI_INT32 UdpMmsgTransport_get_receive_interfaces_cEA(NDDS_Transport_Plugin *self, RTI_INT32 *found_more_than_provided_for_out,
+        RTI_INT32 *interface_reported_count_out, NDDS_Transport_Interface_t interface_array_inout[], RTI_INT32 interface_array_size_in)
+{
+    struct UdpMmsgTransport *transport = (struct UdpMmsgTransport*)self;
+    struct ifaddrs *interfaces = NULL, *auxInterface = NULL;
+
+    *found_more_than_provided_for_out = RTI_FALSE;
+    *interface_reported_count_out = 0;
+
+    if(getifaddrs(&interfaces) != 0)
+        return RTI_FALSE;
+
+    for(auxInterface = interfaces; auxInterface != NULL; auxInterface = auxInterface->ifa_next)
+    {
+        if(auxInterface->ifa_addr == NULL || auxInterface->ifa_addr->sa_family != AF_INET || !(auxInterface->ifa_flags & IFF_UP))
+            continue;
+
+        if(*interface_reported_count_out == interface_array_size_in)
+        {
+            *found_more_than_provided_for_out = RTI_TRUE;
+            break;
+        }
+
+        interface_array_inout[*interface_reported_count_out].transport_classid = transport->property.classid;
+        setAddressIPv4(&interface_array_inout[*interface_reported_count_out].address,
+                ((struct sockaddr_in*)auxInterface->ifa_addr)->sin_addr.s_addr);
+        interface_array_inout[*interface_reported_count_out].status = NDDS_TRANSPORT_INTERFACE_STATUS_ENABLED;
+        interface_array_inout[*interface_reported_count_out].rank = 0;
+        ++*interface_reported_count_out;
+    }
+
+    freeifaddrs(interfaces);
+    return RTI_TRUE;
+}
+
+static RTI_INT32 UdpMmsgTransport_register_listener_cEA(NDDS_Transport_Plugin *self, NDDS_Transport_Listener *listener_in)
+{
+    ((struct UdpMmsgTransport*)self)->listener = listener_in;
+    return RTI_TRUE;
+}
+
+static void deleteUdpMmsgTransport(struct UdpMmsgTransport *transport)
+{
+    const char* const METHOD_NAME = "deleteUdpMmsgTransport";
+
+    if(transport->receiveMetrics.droppedDatagrams > 0)
+    {
+        printf("WARNING<%s>: %llu datagrams were dropped because there was no receive buffer\n", METHOD_NAME,
+                transport->receiveMetrics.droppedDatagrams);
+    }
+
+    if(transport->flushThreadRunning)
+    {
+        pthread_mutex_lock(&transport->queueMutex);
+        transport->flushThreadRunning = 0;
+        pthread_cond_signal(&transport->queueCondition);
+        pthread_mutex_unlock(&transport->queueMutex);
+        pthread_join(transport->flushThread, NULL);
+    }
+
+    if(transport->config.flushTimeoutUs != 0)
+    {
+        pthread_cond_destroy(&transport->queueCondition);
+        pthread_mutex_destroy(&transport->queueMutex);
+    }
+
+    if(transport->sendSocket >= 0)
+        close(transport->sendSocket);
+    if(transport->queue != NULL)
+        RTIOsapiHeap_freeArray(transport->queue);
+    if(transport->queueStorage != NULL)
+        RTIOsapiHeap_freeArray(transport->queueStorage);
+    if(transport->sendMessages != NULL)
+        RTIOsapiHeap_freeArray(transport->sendMessages);
+    if(transport->sendIovecs != NULL)
+        RTIOsapiHeap_freeArray(transport->sendIovecs);
+    if(transport->sendControls != NULL)
+        RTIOsapiHeap_freeArray(transport->sendControls);
+    if(transport->config.receiveThreadCpusList != NULL)
+        RTIOsapiHeap_freeArray(transport->config.receiveThreadCpusList);
+    if(transport->config.busyPollCpusList != NULL)
+        RTIOsapiHeap_freeArray(transport->config.busyPollCpusList);
+    if(transport->bufferPool != NULL)
+        eProsimaTransportBufferPool_delete(transport->bufferPool);
+
+    RTIOsapiHeap_freeStructure(transport);
+}
+
+static void UdpMmsgTransport_delete_cEA(NDDS_Transport_Plugin *self, void *reserved)
+{
+    deleteUdpMmsgTransport((struct UdpMmsgTransport*)self);
+}
+
+/**
+ * \brief This function parses a list of CPUs.
+ *
+ * \return 0 if the CPUs are valid. In error case -1 is returned.
+ */
+static int parseCpus(char **list, int listLength, int *cpus, int cpusMax, const char *name)
+{
+    const char* const METHOD_NAME = "parseCpus";
+    int i = 0;
+
+    if(listLength > cpusMax)
+    {
+        printf("ERROR<%s>: Too many CPUs in %s\n", METHOD_NAME, name);
+        return -1;
+    }
+
+    for(i = 0; i < listLength; ++i)
+    {
+        if(parsePropertyInteger(list[i], 0, &cpus[i]) != 0 || cpus[i] < 0)
+        {
+            printf("ERROR<%s>: Bad CPU %s in %s\n", METHOD_NAME, list[i], name);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int parseReceiveThreadCpus(struct UdpMmsgTransportConfig *config)
+{
+    const char* const METHOD_NAME = "parseReceiveThreadCpus";
+
+    if(parseCpus(config->receiveThreadCpusList, config->receiveThreadCpusListLength, config->receiveThreadCpus,
+                UDPMMSG_RECEIVE_THREADS_MAX, "receive_thread_cpus") != 0 ||
+            parseCpus(config->busyPollCpusList, config->busyPollCpusListLength, config->busyPollCpus,
+                UDPMMSG_BUSY_POLL_CPUS_MAX, "busy_poll_cpus") != 0)
+        return -1;
+
+    // The shards copy each datagram to the ring, so they cannot split GRO datagrams bigger than a message.
+    if(config->receiveThreads > 1 && config->useGro)
+    {
+        printf("WARNING<%s>: UDP GRO is not used with several receive threads\n", METHOD_NAME);
+        config->useGro = 0;
+    }
+
+    return 0;
+}
+
+/**
+ * \brief This function creates the queue of messages and the thread that flushes it.
+ *
+ * \return 0 if the queue was created. In error case -1 is returned.
+ */
+static int createQueue(struct UdpMmsgTransport *transport)
+{
+    int batchSize = transport->config.batchSize;
+
+    RTIOsapiHeap_allocateArray(&transport->queue, batchSize, struct UdpMmsgQueuedMessage);
+    RTIOsapiHeap_allocateArray(&transport->queueStorage, (size_t)batchSize * transport->config.messageSizeMax, char);
+    RTIOsapiHeap_allocateArray(&transport->sendMessages, batchSize, struct mmsghdr);
+    RTIOsapiHeap_allocateArray(&transport->sendIovecs, batchSize, struct iovec);
+    RTIOsapiHeap_allocateArray(&transport->sendControls, batchSize * UDPMMSG_CONTROL_SIZE, char);
+
+    if(transport->queue == NULL || transport->queueStorage == NULL || transport->sendMessages == NULL ||
+            transport->sendIovecs == NULL || transport->sendControls == NULL)
+        return -1;
+
+    pthread_mutex_init(&transport->queueMutex, NULL);
+    pthread_cond_init(&transport->queueCondition, NULL);
+    transport->flushThreadRunning = 1;
+
+    if(pthread_create(&transport->flushThread, NULL, flushThreadFunction, transport) != 0)
+    {
+        transport->flushThreadRunning = 0;
+        return -1;
+    }
+
+    return 0;
+}
+
+#endif // UDPMMSG_TRANSPORT_SUPPORTED
+
+NDDS_Transport_Plugin* eProsimaUdpMmsgTransport_create(NDDS_Transport_Address_t *default_network_address_out,
+        const struct DDS_PropertyQosPolicy *property_in)
+{
+    const char* const METHOD_NAME = "eProsimaUdpMmsgTransport_create";
+#if defined(UDPMMSG_TRANSPORT_SUPPORTED)
+    struct UdpMmsgTransport *transport = NULL;
+
+    if(property_in == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return NULL;
+    }
+
+    RTIOsapiHeap_allocateStructure(&transport, struct UdpMmsgTransport);
+
+    if(transport == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the transport\n", METHOD_NAME);
+        return NULL;
+    }
+
+    memset(transport, 0, sizeof(struct UdpMmsgTransport));
+    transport->sendSocket = -1;
+    transport->config.messageSizeMax = 9216;
+    transport->config.gatherSendBufferCountMax = 16;
+    transport->config.sendSocketBufferSize = 131072;
+    transport->config.recvSocketBufferSize = 131072;
+    transport->config.multicastTtl = 1;
+    transport->config.batchSize = 32;
+    transport->config.receiveThreads = 1;
+    transport->config.receiveQueueSize = 1024;
+    transport->config.steerByGuidPrefix = 1;
+    transport->config.busyPollUs = 50;
+    transport->config.busyPollIdleSpins = 10000;
+    transport->config.busyPollBackoffMaxUs = 100;
+    transport->config.bufferPoolHugePages = 1;
+    if(parseTransportProperties(property_in, "", UdpMmsgPropertyDescriptors,
+                sizeof(UdpMmsgPropertyDescriptors) / sizeof(UdpMmsgPropertyDescriptors[0]), &transport->config) < 0)
+    {
+        printf("ERROR<%s>: Cannot parse the properties\n", METHOD_NAME);
+        deleteUdpMmsgTransport(transport);
+        return NULL;
+    }
+
+    if(parseReceiveThreadCpus(&transport->config) != 0)
+    {
+        deleteUdpMmsgTransport(transport);
+        return NULL;
+    }
+
+    // The buffers have the size of the slots of the batches.
+    if(transport->config.bufferPoolSize > 0 &&
+            (transport->bufferPool = eProsimaTransportBufferPool_new(transport->config.useGro ? UDPMMSG_SEGMENTED_SIZE_MAX :
+                (unsigned int)transport->config.messageSizeMax, (unsigned int)transport->config.bufferPoolSize,
+                transport->config.bufferPoolHugePages)) == NULL)
+    {
+        printf("ERROR<%s>: Cannot create the buffer pool\n", METHOD_NAME);
+        deleteUdpMmsgTransport(transport);
+        return NULL;
+    }
+
+    transport->sendSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    if(transport->sendSocket < 0 || (transport->config.flushTimeoutUs != 0 && createQueue(transport) != 0))
+    {
+        printf("ERROR<%s>: Cannot create the send socket\n", METHOD_NAME);
+        deleteUdpMmsgTransport(transport);
+        return NULL;
+    }
+
+    setsockopt(transport->sendSocket, SOL_SOCKET, SO_SNDBUF, &transport->config.sendSocketBufferSize, sizeof(int));
+    setsockopt(transport->sendSocket, IPPROTO_IP, IP_MULTICAST_TTL, &transport->config.multicastTtl, sizeof(int));
+
+    transport->property.classid = EPROSIMA_TRANSPORT_CLASSID_UDPMMSG;
+    transport->property.address_bit_count = 32;
+    transport->property.properties_bitmap = NDDS_TRANSPORT_PROPERTY_BIT_BUFFER_ALWAYS_LOANED;
+    transport->property.gather_send_buffer_count_max = transport->config.gatherSendBufferCountMax < UDPMMSG_SEGMENTS_MAX ?
+        transport->config.gatherSendBufferCountMax : UDPMMSG_SEGMENTS_MAX;
+    transport->property.message_size_max = transport->config.messageSizeMax;
+
+    transport->parent.property = &transport->property;
+    transport->parent.send = UdpMmsgTransport_send;
+    transport->parent.receive_rEA = UdpMmsgTransport_receive_rEA;
+    transport->parent.return_loaned_buffer_rEA = UdpMmsgTransport_return_loaned_buffer_rEA;
+    transport->parent.unblock_receive_rrEA = UdpMmsgTransport_unblock_receive_rrEA;
+    transport->parent.create_recvresource_rrEA = UdpMmsgTransport_create_recvresource_rrEA;
+    transport->parent.destroy_recvresource_rrEA = UdpMmsgTransport_destroy_recvresource_rrEA;
+    transport->parent.share_recvresource_rrEA = UdpMmsgTransport_share_recvresource_rrEA;
+    transport->parent.unshare_recvresource_rrEA = UdpMmsgTransport_unshare_recvresource_rrEA;
+    transport->parent.create_sendresource_srEA = UdpMmsgTransport_create_sendresource_srEA;
+    transport->parent.destroy_sendresource_srEA = UdpMmsgTransport_destroy_sendresource_srEA;
+    transport->parent.share_sendresource_srEA = UdpMmsgTransport_share_sendresource_srEA;
+    transport->parent.unshare_sendresource_srEA = UdpMmsgTransport_unshare_sendresource_srEA;
+    transport->parent.get_class_name_cEA = UdpMmsgTransport_get_class_name_cEA;
+    transport->parent.string_to_address_cEA = UdpMmsgTransport_string_to_address_cEA;
+    transport->parent.get_receive_interfaces_cEA = UdpMmsgTransport_get_receive_interfaces_cEA;
+    transport->parent.register_listener_cEA = UdpMmsgTransport_register_listener_cEA;
+    transport->parent.delete_cEA = UdpMmsgTransport_delete_cEA;
+
+    // The IPv4 address is the host address.
+    if(default_network_address_out != NULL)
+        memset(default_network_address_out, 0, sizeof(NDDS_Transport_Address_t));
+
+    return &transport->parent;
+#else
+    printf("ERROR<%s>: recvmmsg/sendmmsg transport is not supported in this platform\n", METHOD_NAME);
+    return NULL;
+#endif
+}
+
+void eProsimaUdpMmsgTransport_getReceiveMetrics(NDDS_Transport_Plugin *plugin, struct eProsima_UdpMmsgReceiveMetrics *metrics)
+{
+#if defined(UDPMMSG_TRANSPORT_SUPPORTED)
+    struct UdpMmsgTransport *transport = (struct UdpMmsgTransport*)plugin;
+
+    metrics->hitPolls = EPROSIMA_ATOMIC_LOAD64(&transport->receiveMetrics.hitPolls);
+    metrics->emptyPolls = EPROSIMA_ATOMIC_LOAD64(&transport->receiveMetrics.emptyPolls);
+    metrics->receivedDatagrams = EPROSIMA_ATOMIC_LOAD64(&transport->receiveMetrics.receivedDatagrams);
+    metrics->backoffs = EPROSIMA_ATOMIC_LOAD64(&transport->receiveMetrics.backoffs);
+    metrics->droppedDatagrams = EPROSIMA_ATOMIC_LOAD64(&transport->receiveMetrics.droppedDatagrams);
+#else
+    memset(metrics, 0, sizeof(struct eProsima_UdpMmsgReceiveMetrics));
+#endif
+}
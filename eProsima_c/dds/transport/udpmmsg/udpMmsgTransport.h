@@ -0,0 +1,110 @@
+#ifndef _EPROSIMA_C_DDS_TRANSPORT_UDPMMSG_UDPMMSGTRANSPORT_H_
+#define _EPROSIMA_C_DDS_TRANSPORT_UDPMMSG_UDPMMSGTRANSPORT_H_
+
+#include "eProsima_c/config.h"
+
+#include <transport/transport_interface.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+struct DDS_PropertyQosPolicy;
+
+/**
+ * \brief This function creates a UDPv4 transport that receives and sends batches of datagrams with
+ * recvmmsg and sendmmsg. It is only available in Linux systems.
+ *
+ * Received datagrams are lent to the middleware from the batch without copying them. Sends are only batched
+ * when flush_timeout_us is greater than 0: messages are queued and sent with one sendmmsg call when batch_size
+ * messages are queued or when the oldest one has waited flush_timeout_us microseconds. With the default 0, every
+ * message is sent immediately with one sendmsg call, with the latency of the builtin UDPv4 transport, and only the
+ * receive side is batched. Throughput oriented deployments should set it, i.e. to 100. use_gso also needs the queue:
+ * queued messages of the same size to the same destination are sent as one segmented datagram. If the kernel rejects
+ * one with EIO, EINVAL or EOPNOTSUPP, its segments are sent one by one and GSO is disabled. With UDP GRO, coalesced
+ * datagrams are split again.
+ *
+ * When receive_threads is greater than 1, each unicast receive port is opened by that number of SO_REUSEPORT
+ * sockets, each one read by its own thread, so the system calls and copies of the ingest use several cores.
+ * The threads copy the datagrams to a queue that the receive thread of the middleware takes without copying.
+ * With steer_by_guid_prefix, a BPF program selects the socket with the GUID prefix of the RTPS header, so the
+ * messages of each remote participant are received in order. Otherwise the kernel hashes the source address.
+ * Multicast ports are not sharded. A sharded port is reserved with an abstract Unix socket named after it, so
+ * two participants of the same user that open it at the same time cannot both join the SO_REUSEPORT group.
+ *
+ * With busy_poll, the receive calls don't block: the threads spin on the sockets, with SO_BUSY_POLL when the
+ * process can set it, and sleep with an exponential backoff when there is no traffic. Each port that is not sharded
+ * gets a CPU of busy_poll_cpus for the receive thread of the middleware that reads it; when all of them are
+ * assigned, the thread is not pinned. The threads of the shards are pinned to receive_thread_cpus.
+ *
+ * With buffer_pool_size, the datagrams are received in buffers of a pool preallocated in each NUMA node (see
+ * transportBufferPool.h). Each receive thread takes its buffers from its own node, and the shards queue them
+ * to the middleware without copying the datagrams. The pool should keep receive_queue_size + receive_threads *
+ * batch_size buffers per sharded port; when it is empty, buffers are allocated from the heap, and a shard that
+ * cannot allocate one drops the datagram.
+ *
+ * It has the signature of NDDS_Transport_create_plugin, so it can be loaded with loadTransportPluginFromLibrary:
+ *     pluginName.library = eprosima_udpmmsg (or the name of the shared library)
+ *     pluginName.create_function = eProsimaUdpMmsgTransport_create
+ *
+ * The properties are received without the prefix "pluginName.":
+ *     parent.message_size_max: Maximum size of a message. Default 9216.
+ *     parent.gather_send_buffer_count_max: Maximum number of buffers of a message. Default 16.
+ *     send_socket_buffer_size, recv_socket_buffer_size: Size of the socket buffers. Default 131072.
+ *     multicast_ttl: Time to live of the multicast datagrams. Default 1.
+ *     batch_size: Maximum number of datagrams of a system call. Default 32.
+ *     flush_timeout_us: Maximum time a message is queued before it is sent. Default 0 (no queue, so sends are
+ *         not batched).
+ *     use_gso: 1 to send queued messages with UDP generic segmentation offload. Default 0. Requires flush_timeout_us.
+ *     use_gro: 1 to receive with UDP generic receive offload. Default 0. Not used with several receive threads.
+ *     receive_threads: Sockets and threads of each unicast receive port. Default 1.
+ *     receive_thread_cpus: CPUs of the receive threads, i.e. "2,3,4,5". They are assigned in order. Default none.
+ *     receive_queue_size: Messages queued between the receive threads and the middleware. Default 1024.
+ *     steer_by_guid_prefix: 1 to select the receive thread with the GUID prefix. Default 1.
+ *     busy_poll: 1 to poll the receive sockets instead of blocking. Default 0.
+ *     busy_poll_us: Value of SO_BUSY_POLL. 0 only polls the socket. Default 50.
+ *     busy_poll_cpus: CPUs of the receive threads of the middleware, one per port, i.e. isolated cores "6,7".
+ *         Default none (not pinned).
+ *     busy_poll_idle_spins: Empty polls before the thread starts sleeping. Default 10000.
+ *     busy_poll_backoff_max_us: Maximum sleep between polls. Default 100.
+ *     buffer_pool_size: Receive buffers of each NUMA node. Default 0 (no pool).
+ *     buffer_pool_huge_pages: 1 to use huge pages for the buffer pool when they are available. Default 1.
+ *
+ * \param default_network_address_out Network address of the transport.
+ * \param property_in Properties of the transport.
+ * \return The new transport. In error case, NULL value is returned.
+ */
+NDDS_Transport_Plugin* eProsimaUdpMmsgTransport_create(NDDS_Transport_Address_t *default_network_address_out,
+        const struct DDS_PropertyQosPolicy *property_in);
+
+/**
+ * \brief Metrics of the receive threads.
+ */
+struct eProsima_UdpMmsgReceiveMetrics
+{
+    /// Polls that received datagrams and the datagrams they received.
+    unsigned long long hitPolls;
+    unsigned long long receivedDatagrams;
+    /// Polls that found no datagram.
+    unsigned long long emptyPolls;
+    /// Sleeps of the idle threads.
+    unsigned long long backoffs;
+    /// Datagrams that the shards dropped because they couldn't take a buffer from the pool or the heap.
+    unsigned long long droppedDatagrams;
+};
+
+/**
+ * \brief This function reads the metrics of the receive threads. The efficiency of the busy poll mode is
+ * hitPolls / (hitPolls + emptyPolls).
+ *
+ * \param plugin A transport created by eProsimaUdpMmsgTransport_create. Cannot be NULL.
+ * \param metrics Where the metrics are stored. Cannot be NULL.
+ */
+void eProsimaUdpMmsgTransport_getReceiveMetrics(NDDS_Transport_Plugin *plugin, struct eProsima_UdpMmsgReceiveMetrics *metrics);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_DDS_TRANSPORT_UDPMMSG_UDPMMSGTRANSPORT_H_
@@ -31,7 +31,12 @@ void eProsimaLog_print(EPROSIMA_LOG_MESSAGE_TYPE messageType, const char *method
 
 struct eProsima_Log* eProsimaLog_new(const char *filename)
 {
-    const char* const METHOD_NAME = "eProsimaLog_new";
+    return eProsimaLog_newWithRotation(filename, NULL);
+}
+
+struct eProsima_Log* eProsimaLog_newWithRotation(const char *filename, const struct eProsima_LogRotationConfig *rotation)
+{
+    const char* const METHOD_NAME = "eProsimaLog_newWithRotation";
     struct eProsima_Log *log = NULL;
 
     log = (struct eProsima_Log*)malloc(sizeof(struct eProsima_Log));
@@ -39,12 +44,8 @@ struct eProsima_Log* eProsimaLog_new(const char *filename)
     if(log != NULL)
     {
         log->m_verbosity = EPROSIMA_ERROR_VERBOSITY_LEVEL;
-
-        if(filename != NULL)
-            log->m_logFile = fopen(filename, "a");
-
-        if(log->m_logFile == NULL)
-            log->m_logFile = stdout;
+        // Without file the standard output is used.
+        log->m_logFile = eProsimaLogFile_open(filename, rotation);
     }
     else
     {
@@ -58,9 +59,7 @@ void eProsimaLog_delete(struct eProsima_Log *log)
 {
     if(log != NULL)
     {
-        if(log->m_logFile != NULL &&
-                log->m_logFile != stdout)
-            fclose(log->m_logFile);
+        eProsimaLogFile_close(log->m_logFile);
 
         free(log);
     }
@@ -78,17 +77,28 @@ void eProsimaLog_write(struct eProsima_Log *log, EPROSIMA_LOG_MESSAGE_TYPE messa
         const char *method_text, const char *message, ...)
 {
     va_list arg_ptr;
+    FILE *file = NULL;
+    int handle = 0, result = 0;
+    size_t written = 0;
 
     if(log != NULL)
     {
         if((unsigned int)messageType < (unsigned int)log->m_verbosity)
         {
-            fprintf(log->m_logFile, EPROSIMA_LOG_MESSAGES[messageType], method_text);
+            file = eProsimaLogFile_acquire(log->m_logFile, &handle);
+
+            result = fprintf(file, EPROSIMA_LOG_MESSAGES[messageType], method_text);
+            if(result > 0)
+                written += (size_t)result;
             va_start(arg_ptr, message);
-            vfprintf(log->m_logFile, message, arg_ptr);
+            result = vfprintf(file, message, arg_ptr);
             va_end(arg_ptr);
+            if(result > 0)
+                written += (size_t)result;
+
+            fflush(file);
 
-            fflush(log->m_logFile);
+            eProsimaLogFile_release(log->m_logFile, handle, written);
         }
     }
 }
@@ -1,6 +1,8 @@
 #ifndef _EPROSIMA_C_LOG_EPROSIMALOG_H_
 #define _EPROSIMA_C_LOG_EPROSIMALOG_H_
 
+#include "logFile.h"
+
 #include <stdio.h>
 
 #define printError(message) eProsimaLog_print(EPROSIMA_LOG_ERROR, METHOD_NAME, message)
@@ -43,11 +45,13 @@ extern "C"
     {
         EPROSIMA_LOG_VERBOSITY_LEVEL m_verbosity;
 
-        FILE *m_logFile;
+        struct eProsima_LogFile *m_logFile;
     };
 
     struct eProsima_Log* eProsimaLog_new(const char *filename);
 
+    struct eProsima_Log* eProsimaLog_newWithRotation(const char *filename, const struct eProsima_LogRotationConfig *rotation);
+
     void eProsimaLog_delete(struct eProsima_Log *log);
 
     void eProsimaLog_setLogVerbosity(struct eProsima_Log *log, EPROSIMA_LOG_VERBOSITY_LEVEL level);
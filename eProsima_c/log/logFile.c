@@ -0,0 +1,595 @@
+#include "logFile.h"
+#include "../compress/lz4Block.h"
+#include "../sys/atomic.h"
+#include "../sys/clock.h"
+#include "../macros/snprintf.h"
+
+#include <osapi/osapi_semaphore.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(RTI_WIN32)
+#include <Windows.h>
+#include <io.h>
+#include <fcntl.h>
+#elif defined(RTI_UNIX) || defined(RTI_LINUX)
+#include <pthread.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#define LOG_FILE_PTHREAD
+#endif
+
+/// Handles that can be in use at the same time: the current one and the rotated ones not closed yet.
+#define LOG_FILE_HANDLES 4
+
+#define LOG_FILE_HANDLE_FREE 0
+#define LOG_FILE_HANDLE_CURRENT 1
+#define LOG_FILE_HANDLE_RETIRED 2
+
+/// Bytes added to the path for the suffix of the rotated files.
+#define LOG_FILE_SUFFIX_LENGTH 48
+
+/// Time between checks of a rotated handle that is still used.
+#define LOG_FILE_RETRY_NANOSECONDS 10000000ULL
+
+/// LZ4 frame with independent blocks of 64 KB and no checksums.
+#define LOG_FILE_LZ4_MAGIC 0x184D2204U
+#define LOG_FILE_LZ4_FLG 0x60
+#define LOG_FILE_LZ4_BD 0x40
+/// Second byte of the xxHash32 of the FLG and BD bytes.
+#define LOG_FILE_LZ4_HC 0x82
+#define LOG_FILE_LZ4_BLOCK_SIZE 65536
+#define LOG_FILE_LZ4_UNCOMPRESSED 0x80000000U
+
+struct LogFileHandle
+{
+    FILE *file;
+    /// Writers that acquired the handle.
+    int users;
+    int state;
+    /// Name of the rotated file written with the handle.
+    char *segment;
+};
+
+struct eProsima_LogFile
+{
+    char *path;
+    struct eProsima_LogRotationConfig config;
+    int rotates;
+    struct LogFileHandle handles[LOG_FILE_HANDLES];
+    int current;
+    /// Set by the writer that exceeds a limit. The background thread rotates the file and clears it.
+    int rotating;
+    unsigned long long size;
+    unsigned long long deadline;
+    unsigned int sequence;
+
+    /// Rotated files kept, oldest first.
+    char **retained;
+    int retainedLength;
+
+    /// Given when a rotation is requested and when the file is closed.
+    struct RTIOsapiSemaphore *signal;
+    int running;
+    int threadCreated;
+#if defined(RTI_WIN32)
+    HANDLE thread;
+#elif defined(LOG_FILE_PTHREAD)
+    pthread_t thread;
+#endif
+};
+
+static void writeUInt32(unsigned char *buffer, unsigned int value)
+{
+    buffer[0] = (unsigned char)(value & 0xFF);
+    buffer[1] = (unsigned char)((value >> 8) & 0xFF);
+    buffer[2] = (unsigned char)((value >> 16) & 0xFF);
+    buffer[3] = (unsigned char)(value >> 24);
+}
+
+/**
+ * \brief This function compresses a file in the LZ4 frame format, so it can be read with "lz4 -d".
+ *
+ * \return 0 if the file was compressed. In error case -1 is returned.
+ */
+static int compressSegment(const char *source, const char *destination)
+{
+    FILE *input = NULL, *output = NULL;
+    char *block = NULL, *compressed = NULL;
+    unsigned char header[7];
+    size_t length = 0;
+    int compressedLength = 0, returnedValue = -1;
+
+    input = fopen(source, "rb");
+    output = fopen(destination, "wb");
+    block = (char*)malloc(LOG_FILE_LZ4_BLOCK_SIZE);
+    compressed = (char*)malloc(EPROSIMA_LZ4_COMPRESS_BOUND(LOG_FILE_LZ4_BLOCK_SIZE));
+
+    if(input != NULL && output != NULL && block != NULL && compressed != NULL)
+    {
+        writeUInt32(header, LOG_FILE_LZ4_MAGIC);
+        header[4] = LOG_FILE_LZ4_FLG;
+        header[5] = LOG_FILE_LZ4_BD;
+        header[6] = LOG_FILE_LZ4_HC;
+        returnedValue = fwrite(header, 1, 7, output) == 7 ? 0 : -1;
+
+        while(returnedValue == 0 && (length = fread(block, 1, LOG_FILE_LZ4_BLOCK_SIZE, input)) > 0)
+        {
+            // Blocks that don't get smaller are stored.
+            compressedLength = eProsimaLz4_compress(block, (int)length, compressed, (int)length - 1);
+
+            if(compressedLength > 0)
+            {
+                writeUInt32(header, (unsigned int)compressedLength);
+                if(fwrite(header, 1, 4, output) != 4 || fwrite(compressed, 1, (size_t)compressedLength, output) != (size_t)compressedLength)
+                    returnedValue = -1;
+            }
+            else
+            {
+                writeUInt32(header, (unsigned int)length | LOG_FILE_LZ4_UNCOMPRESSED);
+                if(fwrite(header, 1, 4, output) != 4 || fwrite(block, 1, length, output) != length)
+                    returnedValue = -1;
+            }
+        }
+
+        if(ferror(input))
+            returnedValue = -1;
+
+        // End mark.
+        writeUInt32(header, 0);
+        if(returnedValue == 0 && fwrite(header, 1, 4, output) != 4)
+            returnedValue = -1;
+    }
+
+    if(compressed != NULL)
+        free(compressed);
+    if(block != NULL)
+        free(block);
+    if(input != NULL)
+        fclose(input);
+    if(output != NULL && fclose(output) != 0)
+        returnedValue = -1;
+
+    if(returnedValue != 0)
+        remove(destination);
+
+    return returnedValue;
+}
+
+/**
+ * \brief This function keeps the name of a rotated file and removes the oldest ones over maxFiles.
+ */
+static void retainSegment(struct eProsima_LogFile *logFile, const char *segment)
+{
+    const char* const METHOD_NAME = "retainSegment";
+    int i = 0;
+
+    if(logFile->config.maxFiles == 0)
+        return;
+
+    if(logFile->retainedLength == logFile->config.maxFiles)
+    {
+        if(remove(logFile->retained[0]) != 0)
+            printf("WARNING<%s>: Cannot remove the log file %s\n", METHOD_NAME, logFile->retained[0]);
+
+        free(logFile->retained[0]);
+        for(i = 1; i < logFile->retainedLength; ++i)
+            logFile->retained[i - 1] = logFile->retained[i];
+        --logFile->retainedLength;
+    }
+
+    logFile->retained[logFile->retainedLength] = (char*)malloc(strlen(segment) + 1);
+
+    if(logFile->retained[logFile->retainedLength] != NULL)
+    {
+        strcpy(logFile->retained[logFile->retainedLength], segment);
+        ++logFile->retainedLength;
+    }
+}
+
+/**
+ * \brief This function compresses a rotated file and keeps its name.
+ */
+static void finishSegment(struct eProsima_LogFile *logFile, const char *segment)
+{
+    const char* const METHOD_NAME = "finishSegment";
+    char *compressedName = NULL;
+
+    if(logFile->config.compress)
+    {
+        compressedName = (char*)malloc(strlen(segment) + 5);
+
+        if(compressedName != NULL)
+        {
+            SNPRINTF(compressedName, strlen(segment) + 5, "%s.lz4", segment);
+
+            if(compressSegment(segment, compressedName) == 0)
+            {
+                remove(segment);
+                retainSegment(logFile, compressedName);
+                free(compressedName);
+                return;
+            }
+
+            free(compressedName);
+        }
+
+        printf("WARNING<%s>: Cannot compress the log file %s\n", METHOD_NAME, segment);
+    }
+
+    retainSegment(logFile, segment);
+}
+
+/**
+ * \brief This function closes the rotated handles that are not used and processes their files.
+ *
+ * \return Number of rotated handles that are still used.
+ */
+static int processRetiredHandles(struct eProsima_LogFile *logFile)
+{
+    struct LogFileHandle *handle = NULL;
+    int i = 0, used = 0;
+
+    for(i = 0; i < LOG_FILE_HANDLES; ++i)
+    {
+        handle = &logFile->handles[i];
+
+        if(EPROSIMA_ATOMIC_LOAD32(&handle->state) != LOG_FILE_HANDLE_RETIRED)
+            continue;
+
+        // A writer that acquires it after this check sees that it isn't the current one and doesn't use it.
+        if(EPROSIMA_ATOMIC_LOAD32(&handle->users) != 0)
+        {
+            ++used;
+            continue;
+        }
+
+        fclose(handle->file);
+        handle->file = NULL;
+        finishSegment(logFile, handle->segment);
+        EPROSIMA_ATOMIC_STORE32(&handle->state, LOG_FILE_HANDLE_FREE);
+    }
+
+    return used;
+}
+
+static unsigned long long nowSeconds(void)
+{
+    return (unsigned long long)time(NULL);
+}
+
+/**
+ * \brief This function opens a log file to append to it. In Windows, the file is opened with FILE_SHARE_DELETE,
+ * because it is renamed by the rotation while it is open, and fopen doesn't share the deletion.
+ *
+ * \return The file. In error case, NULL value is returned.
+ */
+static FILE* openLogFile(const char *path)
+{
+#if defined(RTI_WIN32)
+    HANDLE handle = CreateFileA(path, FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+            OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    FILE *file = NULL;
+    int descriptor = -1;
+
+    if(handle == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    // The descriptor owns the handle, and the stream owns the descriptor.
+    descriptor = _open_osfhandle((intptr_t)handle, _O_APPEND | _O_TEXT);
+
+    if(descriptor < 0)
+    {
+        CloseHandle(handle);
+        return NULL;
+    }
+
+    file = _fdopen(descriptor, "a");
+
+    if(file == NULL)
+        _close(descriptor);
+
+    return file;
+#else
+    return fopen(path, "a");
+#endif
+}
+
+/**
+ * \brief This function starts a new file. It is called by the background thread when a writer requests it,
+ * so the writers never wait for the rename and the open. They keep writing in the renamed file until the
+ * handle is exchanged.
+ */
+static void rotate(struct eProsima_LogFile *logFile)
+{
+    const char* const METHOD_NAME = "rotate";
+    struct LogFileHandle *previous = NULL, *next = NULL;
+    char timestamp[32];
+    time_t now = time(NULL);
+    struct tm date;
+    int i = 0, dated = 0;
+
+    for(i = 0; i < LOG_FILE_HANDLES && next == NULL; ++i)
+    {
+        if(EPROSIMA_ATOMIC_LOAD32(&logFile->handles[i].state) == LOG_FILE_HANDLE_FREE)
+            next = &logFile->handles[i];
+    }
+
+    // The previous handles are still used. The flag is kept, so it is tried again when they are closed.
+    if(next == NULL)
+        return;
+
+    previous = &logFile->handles[EPROSIMA_ATOMIC_LOAD32(&logFile->current)];
+
+#if defined(RTI_WIN32)
+    dated = localtime_s(&date, &now) == 0;
+#else
+    dated = localtime_r(&now, &date) != NULL;
+#endif
+    if(!dated || strftime(timestamp, sizeof(timestamp), "%Y%m%d-%H%M%S", &date) == 0)
+        SNPRINTF(timestamp, sizeof(timestamp), "%llu", (unsigned long long)now);
+    SNPRINTF(previous->segment, strlen(logFile->path) + LOG_FILE_SUFFIX_LENGTH, "%s.%s.%u", logFile->path, timestamp,
+            ++logFile->sequence);
+
+    // The writers of the previous handle keep writing in the renamed file.
+    if(rename(logFile->path, previous->segment) == 0)
+    {
+        next->file = openLogFile(logFile->path);
+
+        if(next->file == NULL)
+            rename(previous->segment, logFile->path);
+    }
+
+    if(next->file == NULL)
+    {
+        printf("WARNING<%s>: Cannot rotate the log file %s\n", METHOD_NAME, logFile->path);
+
+        // Next try with the next limit.
+        EPROSIMA_ATOMIC_STORE64(&logFile->size, 0);
+        EPROSIMA_ATOMIC_STORE64(&logFile->deadline, nowSeconds() + logFile->config.maxAge);
+        EPROSIMA_ATOMIC_STORE32(&logFile->rotating, 0);
+        return;
+    }
+
+    EPROSIMA_ATOMIC_STORE32(&next->state, LOG_FILE_HANDLE_CURRENT);
+    EPROSIMA_ATOMIC_STORE32(&logFile->current, (int)(next - logFile->handles));
+    EPROSIMA_ATOMIC_STORE32(&previous->state, LOG_FILE_HANDLE_RETIRED);
+    EPROSIMA_ATOMIC_STORE64(&logFile->size, 0);
+    EPROSIMA_ATOMIC_STORE64(&logFile->deadline, nowSeconds() + logFile->config.maxAge);
+    EPROSIMA_ATOMIC_STORE32(&logFile->rotating, 0);
+}
+
+static void runThread(struct eProsima_LogFile *logFile)
+{
+    int running = 1;
+
+#if defined(RTI_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(LOG_FILE_PTHREAD) && defined(SCHED_IDLE)
+    struct sched_param parameters;
+
+    memset(&parameters, 0, sizeof(parameters));
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &parameters);
+#endif
+
+    while(1)
+    {
+        // Read before processing, so the handles rotated before the close are processed.
+        running = EPROSIMA_ATOMIC_LOAD32(&logFile->running);
+
+        if(running && EPROSIMA_ATOMIC_LOAD32(&logFile->rotating))
+            rotate(logFile);
+
+        // A writer is still using a rotated handle, or the rotation waits for a free one.
+        if(processRetiredHandles(logFile) > 0 || (running && EPROSIMA_ATOMIC_LOAD32(&logFile->rotating)))
+        {
+            eProsimaClock_sleepNanoseconds(LOG_FILE_RETRY_NANOSECONDS);
+            continue;
+        }
+
+        if(!running)
+            break;
+
+        RTIOsapiSemaphore_take(logFile->signal, NULL);
+    }
+}
+
+#if defined(RTI_WIN32)
+static DWORD WINAPI logFileThreadFunction(LPVOID arg)
+{
+    runThread((struct eProsima_LogFile*)arg);
+    return 0;
+}
+#elif defined(LOG_FILE_PTHREAD)
+static void* logFileThreadFunction(void *arg)
+{
+    runThread((struct eProsima_LogFile*)arg);
+    return NULL;
+}
+#endif
+
+static int startThread(struct eProsima_LogFile *logFile)
+{
+    logFile->running = 1;
+
+#if defined(RTI_WIN32)
+    logFile->thread = CreateThread(NULL, 0, logFileThreadFunction, logFile, 0, NULL);
+    logFile->threadCreated = logFile->thread != NULL;
+#elif defined(LOG_FILE_PTHREAD)
+    logFile->threadCreated = pthread_create(&logFile->thread, NULL, logFileThreadFunction, logFile) == 0;
+#endif
+
+    return logFile->threadCreated ? 0 : -1;
+}
+
+static void freeLogFile(struct eProsima_LogFile *logFile)
+{
+    int i = 0;
+
+    for(i = 0; i < LOG_FILE_HANDLES; ++i)
+    {
+        if(logFile->handles[i].file != NULL && logFile->handles[i].file != stdout)
+            fclose(logFile->handles[i].file);
+        if(logFile->handles[i].segment != NULL)
+            free(logFile->handles[i].segment);
+    }
+
+    if(logFile->retained != NULL)
+    {
+        for(i = 0; i < logFile->retainedLength; ++i)
+            free(logFile->retained[i]);
+
+        free(logFile->retained);
+    }
+
+    if(logFile->signal != NULL)
+        RTIOsapiSemaphore_delete(logFile->signal);
+    if(logFile->path != NULL)
+        free(logFile->path);
+
+    free(logFile);
+}
+
+struct eProsima_LogFile* eProsimaLogFile_open(const char *path, const struct eProsima_LogRotationConfig *config)
+{
+    const char* const METHOD_NAME = "eProsimaLogFile_open";
+    struct eProsima_LogFile *logFile = NULL;
+    int i = 0;
+
+    logFile = (struct eProsima_LogFile*)malloc(sizeof(struct eProsima_LogFile));
+
+    if(logFile == NULL)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the log file\n", METHOD_NAME);
+        return NULL;
+    }
+
+    memset(logFile, 0, sizeof(struct eProsima_LogFile));
+    logFile->handles[0].state = LOG_FILE_HANDLE_CURRENT;
+
+    if(path != NULL)
+        logFile->handles[0].file = openLogFile(path);
+
+    if(logFile->handles[0].file == NULL)
+    {
+        logFile->handles[0].file = stdout;
+        return logFile;
+    }
+
+    if(config == NULL || (config->maxSize == 0 && config->maxAge == 0))
+        return logFile;
+
+    logFile->config = *config;
+    logFile->rotates = 1;
+    logFile->path = (char*)malloc(strlen(path) + 1);
+    logFile->signal = RTIOsapiSemaphore_new(RTI_OSAPI_SEMAPHORE_KIND_BINARY, NULL);
+
+    if(config->maxFiles > 0)
+        logFile->retained = (char**)malloc((size_t)config->maxFiles * sizeof(char*));
+
+    for(i = 0; i < LOG_FILE_HANDLES; ++i)
+    {
+        logFile->handles[i].segment = (char*)malloc(strlen(path) + LOG_FILE_SUFFIX_LENGTH);
+
+        if(logFile->handles[i].segment == NULL)
+            break;
+    }
+
+    if(logFile->path == NULL || logFile->signal == NULL || (config->maxFiles > 0 && logFile->retained == NULL) ||
+            i < LOG_FILE_HANDLES)
+    {
+        printf("ERROR<%s>: Cannot allocate memory for the log file\n", METHOD_NAME);
+        freeLogFile(logFile);
+        return NULL;
+    }
+
+    strcpy(logFile->path, path);
+    logFile->deadline = nowSeconds() + config->maxAge;
+
+    // The size of a file opened in append mode starts with its content.
+    if(fseek(logFile->handles[0].file, 0, SEEK_END) == 0)
+    {
+        long size = ftell(logFile->handles[0].file);
+
+        if(size > 0)
+            logFile->size = (unsigned long long)size;
+    }
+
+    if(startThread(logFile) != 0)
+    {
+        printf("ERROR<%s>: Cannot create the thread of the log file\n", METHOD_NAME);
+        freeLogFile(logFile);
+        return NULL;
+    }
+
+    return logFile;
+}
+
+void eProsimaLogFile_close(struct eProsima_LogFile *logFile)
+{
+    if(logFile == NULL)
+        return;
+
+    if(logFile->threadCreated)
+    {
+        EPROSIMA_ATOMIC_STORE32(&logFile->running, 0);
+        RTIOsapiSemaphore_give(logFile->signal);
+#if defined(RTI_WIN32)
+        WaitForSingleObject(logFile->thread, INFINITE);
+        CloseHandle(logFile->thread);
+#elif defined(LOG_FILE_PTHREAD)
+        pthread_join(logFile->thread, NULL);
+#endif
+    }
+
+    freeLogFile(logFile);
+}
+
+FILE* eProsimaLogFile_acquire(struct eProsima_LogFile *logFile, int *handle)
+{
+    int current = 0;
+
+    *handle = 0;
+
+    if(logFile == NULL)
+        return stdout;
+
+    if(!logFile->rotates)
+        return logFile->handles[0].file;
+
+    while(1)
+    {
+        current = EPROSIMA_ATOMIC_LOAD32(&logFile->current);
+        EPROSIMA_ATOMIC_ADD32(&logFile->handles[current].users, 1);
+
+        // The handle can't be closed while it is current and has users.
+        if(EPROSIMA_ATOMIC_LOAD32(&logFile->current) == current)
+            break;
+
+        EPROSIMA_ATOMIC_ADD32(&logFile->handles[current].users, -1);
+    }
+
+    *handle = current;
+
+    return logFile->handles[current].file;
+}
+
+void eProsimaLogFile_release(struct eProsima_LogFile *logFile, int handle, size_t written)
+{
+    unsigned long long size = 0;
+
+    if(logFile == NULL || !logFile->rotates)
+        return;
+
+    EPROSIMA_ATOMIC_ADD32(&logFile->handles[handle].users, -1);
+    size = EPROSIMA_ATOMIC_ADD64(&logFile->size, (unsigned long long)written);
+
+    // Only the writer that sets the flag wakes the background thread up.
+    if(((logFile->config.maxSize != 0 && size >= logFile->config.maxSize) ||
+                (logFile->config.maxAge != 0 && nowSeconds() >= EPROSIMA_ATOMIC_LOAD64(&logFile->deadline))) &&
+            EPROSIMA_ATOMIC_CAS32(&logFile->rotating, 0, 1))
+        RTIOsapiSemaphore_give(logFile->signal);
+}
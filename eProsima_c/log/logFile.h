@@ -0,0 +1,72 @@
+#ifndef _EPROSIMA_C_LOG_LOGFILE_H_
+#define _EPROSIMA_C_LOG_LOGFILE_H_
+
+#include <stdio.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+    /**
+     * \brief Rotation of a log file. A rotated file is renamed to "<file>.<YYYYmmdd-HHMMSS>.<sequence>".
+     */
+    struct eProsima_LogRotationConfig
+    {
+        /// Bytes written to a file that start a new one. 0 disables it.
+        unsigned long long maxSize;
+        /// Seconds after which a new file is started. 0 disables it.
+        unsigned int maxAge;
+        /// Rotated files of this process that are kept. The oldest ones are removed. 0 keeps all of them.
+        int maxFiles;
+        /// If it is not 0, the rotated files are compressed in the LZ4 frame format ("<name>.lz4").
+        int compress;
+    };
+
+    struct eProsima_LogFile;
+
+    /**
+     * \brief This function opens a log file in append mode.
+     *
+     * The writer that exceeds a limit only requests the rotation. A background thread with the lowest priority
+     * renames the file, opens a new one and exchanges the handle atomically, so writers never wait for the file
+     * system; they keep writing in the renamed file until they acquire the new handle. The thread also closes the
+     * previous handles, compresses the rotated files and removes the old ones. If it is behind, the rotation waits
+     * and the file can grow over maxSize.
+     *
+     * \param path Path of the file. If it is NULL or it cannot be opened, the standard output is used.
+     * \param config Rotation. If it is NULL, the file is not rotated.
+     * \return The log file. In error case, NULL value is returned.
+     */
+    struct eProsima_LogFile* eProsimaLogFile_open(const char *path, const struct eProsima_LogRotationConfig *config);
+
+    /**
+     * \brief This function closes a log file. Its rotated files are processed before it returns.
+     */
+    void eProsimaLogFile_close(struct eProsima_LogFile *logFile);
+
+    /**
+     * \brief This function returns the handle where a writer writes. It never blocks.
+     *
+     * \param logFile The log file. If it is NULL, the standard output is returned.
+     * \param handle Where the handle is stored, to release it. Cannot be NULL.
+     * \return The stream. It is valid until eProsimaLogFile_release is called.
+     */
+    FILE* eProsimaLogFile_acquire(struct eProsima_LogFile *logFile, int *handle);
+
+    /**
+     * \brief This function releases a handle returned by eProsimaLogFile_acquire and rotates the file if a
+     * limit was exceeded.
+     *
+     * \param logFile The log file. It can be NULL.
+     * \param handle The handle.
+     * \param written Bytes written with the handle.
+     */
+    void eProsimaLogFile_release(struct eProsima_LogFile *logFile, int handle, size_t written);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_LOG_LOGFILE_H_
@@ -0,0 +1,58 @@
+#ifndef _EPROSIMA_C_SYS_ATOMIC_H_
+#define _EPROSIMA_C_SYS_ATOMIC_H_
+
+/* Atomic operations on 32 and 64 bits integers and on pointers. Loads use acquire semantic, stores use release
+ * semantic and read-modify-write operations are sequentially consistent. */
+
+#if defined(_WIN32)
+#include <Windows.h>
+
+#define EPROSIMA_ATOMIC_LOAD32(pointer) InterlockedCompareExchange((volatile LONG*)(pointer), 0, 0)
+#define EPROSIMA_ATOMIC_STORE32(pointer, value) InterlockedExchange((volatile LONG*)(pointer), (LONG)(value))
+#define EPROSIMA_ATOMIC_ADD32(pointer, value) (InterlockedExchangeAdd((volatile LONG*)(pointer), (LONG)(value)) + (LONG)(value))
+#define EPROSIMA_ATOMIC_CAS32(pointer, expected, desired) \
+    (InterlockedCompareExchange((volatile LONG*)(pointer), (LONG)(desired), (LONG)(expected)) == (LONG)(expected))
+
+#define EPROSIMA_ATOMIC_LOAD64(pointer) InterlockedCompareExchange64((volatile LONGLONG*)(pointer), 0, 0)
+#define EPROSIMA_ATOMIC_STORE64(pointer, value) InterlockedExchange64((volatile LONGLONG*)(pointer), (LONGLONG)(value))
+#define EPROSIMA_ATOMIC_ADD64(pointer, value) (InterlockedExchangeAdd64((volatile LONGLONG*)(pointer), (LONGLONG)(value)) + (LONGLONG)(value))
+#define EPROSIMA_ATOMIC_CAS64(pointer, expected, desired) \
+    (InterlockedCompareExchange64((volatile LONGLONG*)(pointer), (LONGLONG)(desired), (LONGLONG)(expected)) == (LONGLONG)(expected))
+
+#define EPROSIMA_ATOMIC_LOADPTR(pointer) InterlockedCompareExchangePointer((PVOID volatile*)(pointer), NULL, NULL)
+#define EPROSIMA_ATOMIC_CASPTR(pointer, expected, desired) \
+    (InterlockedCompareExchangePointer((PVOID volatile*)(pointer), (PVOID)(desired), (PVOID)(expected)) == (PVOID)(expected))
+
+#define EPROSIMA_ATOMIC_FENCE() MemoryBarrier()
+
+#define EPROSIMA_CPU_RELAX() YieldProcessor()
+
+#elif defined(__GNUC__)
+
+#define EPROSIMA_ATOMIC_LOAD32(pointer) __atomic_load_n((pointer), __ATOMIC_ACQUIRE)
+#define EPROSIMA_ATOMIC_STORE32(pointer, value) __atomic_store_n((pointer), (value), __ATOMIC_RELEASE)
+#define EPROSIMA_ATOMIC_ADD32(pointer, value) __atomic_add_fetch((pointer), (value), __ATOMIC_SEQ_CST)
+#define EPROSIMA_ATOMIC_CAS32(pointer, expected, desired) \
+    __sync_bool_compare_and_swap((pointer), (expected), (desired))
+
+#define EPROSIMA_ATOMIC_LOAD64 EPROSIMA_ATOMIC_LOAD32
+#define EPROSIMA_ATOMIC_STORE64 EPROSIMA_ATOMIC_STORE32
+#define EPROSIMA_ATOMIC_ADD64 EPROSIMA_ATOMIC_ADD32
+#define EPROSIMA_ATOMIC_CAS64 EPROSIMA_ATOMIC_CAS32
+
+#define EPROSIMA_ATOMIC_LOADPTR EPROSIMA_ATOMIC_LOAD32
+#define EPROSIMA_ATOMIC_CASPTR EPROSIMA_ATOMIC_CAS32
+
+#define EPROSIMA_ATOMIC_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#if defined(__i386__) || defined(__x86_64__)
+#define EPROSIMA_CPU_RELAX() __builtin_ia32_pause()
+#else
+#define EPROSIMA_CPU_RELAX() __asm__ __volatile__("" ::: "memory")
+#endif
+
+#else
+#error Atomic operations are not defined for this compiler.
+#endif
+
+#endif // _EPROSIMA_C_SYS_ATOMIC_H_
@@ -0,0 +1,44 @@
+#include "clock.h"
+
+#if defined(RTI_WIN32)
+#include <Windows.h>
+#else
+#include <errno.h>
+#include <time.h>
+#endif
+
+unsigned long long eProsimaClock_getNanoseconds(void)
+{
+#if defined(RTI_WIN32)
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+
+    if(frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+
+    QueryPerformanceCounter(&counter);
+    return (unsigned long long)(counter.QuadPart / frequency.QuadPart) * 1000000000ULL +
+        (unsigned long long)(counter.QuadPart % frequency.QuadPart) * 1000000000ULL / (unsigned long long)frequency.QuadPart;
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+#endif
+}
+
+void eProsimaClock_sleepNanoseconds(unsigned long long nanoseconds)
+{
+#if defined(RTI_WIN32)
+    // Sleep has millisecond resolution. Shorter sleeps yield the processor.
+    Sleep((DWORD)(nanoseconds / 1000000ULL));
+#else
+    struct timespec interval;
+
+    interval.tv_sec = (time_t)(nanoseconds / 1000000000ULL);
+    interval.tv_nsec = (long)(nanoseconds % 1000000000ULL);
+
+    while(nanosleep(&interval, &interval) != 0 && errno == EINTR)
+        ;
+#endif
+}
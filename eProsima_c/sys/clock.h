@@ -0,0 +1,29 @@
+#ifndef _EPROSIMA_C_SYS_CLOCK_H_
+#define _EPROSIMA_C_SYS_CLOCK_H_
+
+#include "eProsima_c/config.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/**
+ * \brief This function returns the time of a monotonic clock. It is used to measure intervals.
+ *
+ * \return Nanoseconds since an arbitrary point.
+ */
+unsigned long long eProsimaClock_getNanoseconds(void);
+
+/**
+ * \brief This function suspends the calling thread. The resolution depends on the system.
+ *
+ * \param nanoseconds Time to sleep.
+ */
+void eProsimaClock_sleepNanoseconds(unsigned long long nanoseconds);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_SYS_CLOCK_H_
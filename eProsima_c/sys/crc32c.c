@@ -0,0 +1,306 @@
+#include "crc32c.h"
+#include "atomic.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <nmmintrin.h>
+#define CRC32C_HARDWARE
+#define CRC32C_TARGET_SSE42
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <nmmintrin.h>
+#define CRC32C_HARDWARE
+#define CRC32C_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+
+/// Castagnoli polynomial, reflected.
+#define CRC32C_POLYNOMIAL 0x82F63B78U
+
+/// Bytes of each stream of the interleaved loops. The long one hides the latency of the instruction with big
+/// buffers and the short one with the rest of them.
+#define CRC32C_LONG 8192
+#define CRC32C_SHORT 256
+
+#define CRC32C_UNINITIALIZED 0
+#define CRC32C_INITIALIZING 1
+#define CRC32C_INITIALIZED 2
+
+static int initState = CRC32C_UNINITIALIZED;
+
+static int hardware = 0;
+
+/// Slicing-by-8 tables.
+static unsigned int crcTable[8][256];
+
+#if defined(CRC32C_HARDWARE)
+/// Tables that shift a CRC through CRC32C_LONG and CRC32C_SHORT zero bytes, to combine the streams.
+static unsigned int crcLongTable[4][256];
+static unsigned int crcShortTable[4][256];
+#endif
+
+static unsigned int readUInt32(const unsigned char *data)
+{
+    return (unsigned int)data[0] | ((unsigned int)data[1] << 8) | ((unsigned int)data[2] << 16) |
+        ((unsigned int)data[3] << 24);
+}
+
+static unsigned int updateSoftware(unsigned int crc, const unsigned char *data, size_t length)
+{
+    unsigned int low = 0, high = 0;
+
+    crc = ~crc;
+
+    while(length > 0 && ((size_t)data & 7) != 0)
+    {
+        crc = crcTable[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+        --length;
+    }
+
+    while(length >= 8)
+    {
+        low = crc ^ readUInt32(data);
+        high = readUInt32(data + 4);
+        crc = crcTable[7][low & 0xFF] ^ crcTable[6][(low >> 8) & 0xFF] ^ crcTable[5][(low >> 16) & 0xFF] ^
+            crcTable[4][low >> 24] ^ crcTable[3][high & 0xFF] ^ crcTable[2][(high >> 8) & 0xFF] ^
+            crcTable[1][(high >> 16) & 0xFF] ^ crcTable[0][high >> 24];
+        data += 8;
+        length -= 8;
+    }
+
+    while(length > 0)
+    {
+        crc = crcTable[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+        --length;
+    }
+
+    return ~crc;
+}
+
+#if defined(CRC32C_HARDWARE)
+
+/**
+ * \brief This function multiplies a vector by a matrix of GF(2). Each element of the matrix is a column.
+ */
+static unsigned int multiplyMatrix(const unsigned int *matrix, unsigned int vector)
+{
+    unsigned int sum = 0;
+
+    while(vector != 0)
+    {
+        if(vector & 1)
+            sum ^= *matrix;
+        vector >>= 1;
+        ++matrix;
+    }
+
+    return sum;
+}
+
+static void squareMatrix(unsigned int *square, const unsigned int *matrix)
+{
+    int i = 0;
+
+    for(i = 0; i < 32; ++i)
+        square[i] = multiplyMatrix(matrix, matrix[i]);
+}
+
+/**
+ * \brief This function creates the tables that shift a CRC through length zero bytes.
+ */
+static void createShiftTable(unsigned int table[4][256], size_t length)
+{
+    unsigned int even[32], odd[32], row = 1;
+    const unsigned int *shift = NULL;
+    int i = 0;
+
+    // Operator of one zero bit.
+    odd[0] = CRC32C_POLYNOMIAL;
+    for(i = 1; i < 32; ++i)
+    {
+        odd[i] = row;
+        row <<= 1;
+    }
+
+    // Operators of two and four zero bits.
+    squareMatrix(even, odd);
+    squareMatrix(odd, even);
+
+    // Each square doubles the zero bits, starting at one byte.
+    shift = odd;
+    while(1)
+    {
+        squareMatrix(even, odd);
+        shift = even;
+        length >>= 1;
+        if(length == 0)
+            break;
+        squareMatrix(odd, even);
+        shift = odd;
+        length >>= 1;
+        if(length == 0)
+            break;
+    }
+
+    for(i = 0; i < 256; ++i)
+    {
+        table[0][i] = multiplyMatrix(shift, (unsigned int)i);
+        table[1][i] = multiplyMatrix(shift, (unsigned int)i << 8);
+        table[2][i] = multiplyMatrix(shift, (unsigned int)i << 16);
+        table[3][i] = multiplyMatrix(shift, (unsigned int)i << 24);
+    }
+}
+
+static unsigned int shiftCrc(unsigned int table[4][256], unsigned int crc)
+{
+    return table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF] ^ table[2][(crc >> 16) & 0xFF] ^ table[3][crc >> 24];
+}
+
+static int detectHardware(void)
+{
+#if defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2") != 0;
+#endif
+}
+
+/**
+ * \brief This function computes the CRC in three streams, so the three cycles of latency of the instruction
+ * are hidden. The CRCs of the streams are combined shifting them through the bytes of the next ones.
+ */
+CRC32C_TARGET_SSE42
+static unsigned int updateHardware(unsigned int crc, const unsigned char *data, size_t length)
+{
+    unsigned long long crc0 = 0, crc1 = 0, crc2 = 0;
+    const unsigned char *end = NULL;
+
+    crc0 = ~crc;
+
+    while(length > 0 && ((size_t)data & 7) != 0)
+    {
+        crc0 = _mm_crc32_u8((unsigned int)crc0, *data++);
+        --length;
+    }
+
+    while(length >= 3 * CRC32C_LONG)
+    {
+        crc1 = 0;
+        crc2 = 0;
+        end = data + CRC32C_LONG;
+        do
+        {
+            crc0 = _mm_crc32_u64(crc0, *(const unsigned long long*)data);
+            crc1 = _mm_crc32_u64(crc1, *(const unsigned long long*)(data + CRC32C_LONG));
+            crc2 = _mm_crc32_u64(crc2, *(const unsigned long long*)(data + 2 * CRC32C_LONG));
+            data += 8;
+        } while(data < end);
+        crc0 = shiftCrc(crcLongTable, (unsigned int)crc0) ^ crc1;
+        crc0 = shiftCrc(crcLongTable, (unsigned int)crc0) ^ crc2;
+        data += 2 * CRC32C_LONG;
+        length -= 3 * CRC32C_LONG;
+    }
+
+    while(length >= 3 * CRC32C_SHORT)
+    {
+        crc1 = 0;
+        crc2 = 0;
+        end = data + CRC32C_SHORT;
+        do
+        {
+            crc0 = _mm_crc32_u64(crc0, *(const unsigned long long*)data);
+            crc1 = _mm_crc32_u64(crc1, *(const unsigned long long*)(data + CRC32C_SHORT));
+            crc2 = _mm_crc32_u64(crc2, *(const unsigned long long*)(data + 2 * CRC32C_SHORT));
+            data += 8;
+        } while(data < end);
+        crc0 = shiftCrc(crcShortTable, (unsigned int)crc0) ^ crc1;
+        crc0 = shiftCrc(crcShortTable, (unsigned int)crc0) ^ crc2;
+        data += 2 * CRC32C_SHORT;
+        length -= 3 * CRC32C_SHORT;
+    }
+
+    while(length >= 8)
+    {
+        crc0 = _mm_crc32_u64(crc0, *(const unsigned long long*)data);
+        data += 8;
+        length -= 8;
+    }
+
+    while(length > 0)
+    {
+        crc0 = _mm_crc32_u8((unsigned int)crc0, *data++);
+        --length;
+    }
+
+    return ~(unsigned int)crc0;
+}
+
+#endif // CRC32C_HARDWARE
+
+static void createTables(void)
+{
+    unsigned int crc = 0;
+    int i = 0, j = 0;
+
+    for(i = 0; i < 256; ++i)
+    {
+        crc = (unsigned int)i;
+        for(j = 0; j < 8; ++j)
+            crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLYNOMIAL : crc >> 1;
+        crcTable[0][i] = crc;
+    }
+
+    for(i = 0; i < 256; ++i)
+    {
+        crc = crcTable[0][i];
+        for(j = 1; j < 8; ++j)
+        {
+            crc = crcTable[0][crc & 0xFF] ^ (crc >> 8);
+            crcTable[j][i] = crc;
+        }
+    }
+
+#if defined(CRC32C_HARDWARE)
+    createShiftTable(crcLongTable, CRC32C_LONG);
+    createShiftTable(crcShortTable, CRC32C_SHORT);
+    hardware = detectHardware();
+#endif
+}
+
+static void initialize(void)
+{
+    if(EPROSIMA_ATOMIC_LOAD32(&initState) == CRC32C_INITIALIZED)
+        return;
+
+    if(EPROSIMA_ATOMIC_CAS32(&initState, CRC32C_UNINITIALIZED, CRC32C_INITIALIZING))
+    {
+        createTables();
+        EPROSIMA_ATOMIC_STORE32(&initState, CRC32C_INITIALIZED);
+        return;
+    }
+
+    // Other thread is creating the tables.
+    while(EPROSIMA_ATOMIC_LOAD32(&initState) != CRC32C_INITIALIZED)
+        EPROSIMA_CPU_RELAX();
+}
+
+unsigned int eProsimaCrc32c_update(unsigned int crc, const void *data, size_t length)
+{
+    initialize();
+
+#if defined(CRC32C_HARDWARE)
+    if(hardware)
+        return updateHardware(crc, (const unsigned char*)data, length);
+#endif
+
+    return updateSoftware(crc, (const unsigned char*)data, length);
+}
+
+int eProsimaCrc32c_isHardware(void)
+{
+    initialize();
+
+    return hardware;
+}
@@ -0,0 +1,38 @@
+#ifndef _EPROSIMA_C_SYS_CRC32C_H_
+#define _EPROSIMA_C_SYS_CRC32C_H_
+
+#include "eProsima_c/config.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/**
+ * \brief This function updates a CRC32C (Castagnoli polynomial, the one of iSCSI and SCTP) with data, so a
+ * checksum of several buffers is computed without copying them. The CRC of "123456789" is 0xE3069283.
+ *
+ * The crc32 instruction of SSE4.2 is used when the processor has it, with three interleaved streams for big
+ * buffers. Other processors use slicing-by-8 tables. Both are initialized the first time.
+ *
+ * \param crc CRC of the previous data. It is 0 for the first buffer.
+ * \param data Data. It can be NULL if length is 0.
+ * \param length Number of bytes.
+ * \return The CRC of the previous data and this one.
+ */
+unsigned int eProsimaCrc32c_update(unsigned int crc, const void *data, size_t length);
+
+/**
+ * \brief This function tells if eProsimaCrc32c_update uses the crc32 instruction of SSE4.2.
+ *
+ * \return 1 if the instruction is used. In other case 0 is returned.
+ */
+int eProsimaCrc32c_isHardware(void);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_SYS_CRC32C_H_
@@ -1,24 +1,211 @@
+#if defined(RTI_LINUX) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // RTLD_DEEPBIND
+#endif
+
 #include "eProsimaDL.h"
+#include "trace.h"
+#include "atomic.h"
 #include "../log/eProsimaLog.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #if defined(RTI_WIN32)
 #include <Windows.h>
 #elif (defined(RTI_UNIX) || defined(RTI_LINUX))
 #include <dlfcn.h>
+#include <pthread.h>
 #endif
 
+/**
+ * \brief Library registered with eProsimaRegisterStaticSymbol. Its address is used as library handle.
+ */
+struct eProsima_StaticLibrary
+{
+    const char *name;
+};
+
+/**
+ * \brief Function registered with eProsimaRegisterStaticSymbol.
+ */
+struct eProsima_StaticSymbol
+{
+    const struct eProsima_StaticLibrary *library;
+    const char *name;
+    void *functionPointer;
+};
+
+static struct eProsima_StaticLibrary staticLibraries[EPROSIMA_DL_STATIC_SYMBOLS_MAX];
+
+static int staticLibrariesLength = 0;
+
+static struct eProsima_StaticSymbol staticSymbols[EPROSIMA_DL_STATIC_SYMBOLS_MAX];
+
+static int staticSymbolsLength = 0;
+
+/// Spin lock of the registered libraries and functions. It needs no initialization, because functions are
+/// registered before main is called.
+static int staticSymbolsLock = 0;
+
+static void eProsimaLockStaticSymbols(void)
+{
+    while(!EPROSIMA_ATOMIC_CAS32(&staticSymbolsLock, 0, 1))
+        EPROSIMA_CPU_RELAX();
+}
+
+static void eProsimaUnlockStaticSymbols(void)
+{
+    EPROSIMA_ATOMIC_STORE32(&staticSymbolsLock, 0);
+}
+
+/**
+ * \brief This function looks for a registered library. The caller holds the lock of the registered functions.
+ */
+static struct eProsima_StaticLibrary* eProsimaFindStaticLibrary(const char *filename)
+{
+    int i = 0;
+
+    for(i = 0; i < staticLibrariesLength; ++i)
+    {
+        if(strcmp(staticLibraries[i].name, filename) == 0)
+            return &staticLibraries[i];
+    }
+
+    return NULL;
+}
+
+static int eProsimaIsStaticLibrary(const void *libraryHandle)
+{
+    return (const char*)libraryHandle >= (const char*)&staticLibraries[0] &&
+        (const char*)libraryHandle < (const char*)&staticLibraries[EPROSIMA_DL_STATIC_SYMBOLS_MAX];
+}
+
+/**
+ * \brief Work of one of the threads used by eProsimaLoadLibraries.
+ * The thread loads the libraries with index first, first + step, first + 2 * step...
+ */
+struct eProsima_DLWorker
+{
+    const char * const *filenames;
+    void **handles;
+    int count;
+    int flags;
+    int first;
+    int step;
+};
+
+static void eProsimaLoadLibrariesWork(struct eProsima_DLWorker *worker)
+{
+    int i = 0;
+
+    for(i = worker->first; i < worker->count; i += worker->step)
+    {
+        worker->handles[i] = eProsimaLoadLibraryWithFlags(worker->filenames[i], worker->flags);
+    }
+}
+
+#if defined(RTI_WIN32)
+static DWORD WINAPI eProsimaLoadLibrariesThread(LPVOID param)
+{
+    eProsimaLoadLibrariesWork((struct eProsima_DLWorker*)param);
+    return 0;
+}
+#elif (defined(RTI_UNIX) || defined(RTI_LINUX))
+static void* eProsimaLoadLibrariesThread(void *param)
+{
+    eProsimaLoadLibrariesWork((struct eProsima_DLWorker*)param);
+    return NULL;
+}
+#endif
+
+int eProsimaRegisterStaticSymbol(const char *libraryName, const char *functionName, void *functionPointer)
+{
+    const char* const METHOD_NAME = "eProsimaRegisterStaticSymbol";
+    struct eProsima_StaticLibrary *library = NULL;
+    const char *error = NULL;
+    int returnedValue = -1;
+
+    if(libraryName != NULL && functionName != NULL && functionPointer != NULL)
+    {
+        eProsimaLockStaticSymbols();
+
+        library = eProsimaFindStaticLibrary(libraryName);
+
+        if(staticSymbolsLength == EPROSIMA_DL_STATIC_SYMBOLS_MAX)
+        {
+            error = "Too many registered functions (EPROSIMA_DL_STATIC_SYMBOLS_MAX)";
+        }
+        else if(library == NULL && staticLibrariesLength == EPROSIMA_DL_STATIC_SYMBOLS_MAX)
+        {
+            error = "Too many registered libraries (EPROSIMA_DL_STATIC_SYMBOLS_MAX)";
+        }
+        else
+        {
+            if(library == NULL)
+            {
+                library = &staticLibraries[staticLibrariesLength];
+                library->name = libraryName;
+                ++staticLibrariesLength;
+            }
+
+            staticSymbols[staticSymbolsLength].library = library;
+            staticSymbols[staticSymbolsLength].name = functionName;
+            staticSymbols[staticSymbolsLength].functionPointer = functionPointer;
+            ++staticSymbolsLength;
+            returnedValue = 0;
+        }
+
+        eProsimaUnlockStaticSymbols();
+
+        if(error != NULL)
+            printError(error);
+    }
+    else
+    {
+        printError("Bad parameters");
+    }
+
+    return returnedValue;
+}
+
 void* eProsimaLoadLibrary(const char *filename)
 {
-    const char* const METHOD_NAME = "eProsimaLoadLibrary";
+    return eProsimaLoadLibraryWithFlags(filename, EPROSIMA_DL_LAZY);
+}
+
+void* eProsimaLoadLibraryWithFlags(const char *filename, int flags)
+{
+    const char* const METHOD_NAME = "eProsimaLoadLibraryWithFlags";
     void *libraryHandle = NULL;
 
     if(filename != NULL)
     {
-#if defined(RTI_WIN32)
+        eProsimaLockStaticSymbols();
+        libraryHandle = eProsimaFindStaticLibrary(filename);
+        eProsimaUnlockStaticSymbols();
+
+        if(libraryHandle != NULL)
+            return libraryHandle;
+
+        EPROSIMA_TRACE_BEGIN("eProsimaLoadLibrary", filename);
+
+#if defined(EPROSIMA_DL_STATIC_ONLY)
+        // The dynamic loader is not used.
+#elif defined(RTI_WIN32)
         libraryHandle = LoadLibrary(filename);
 #elif (defined(RTI_UNIX) || defined(RTI_LINUX))
-        libraryHandle = dlopen(filename, RTLD_LAZY);
+        int mode = (flags & EPROSIMA_DL_NOW) ? RTLD_NOW : RTLD_LAZY;
+
+        mode |= (flags & EPROSIMA_DL_GLOBAL) ? RTLD_GLOBAL : RTLD_LOCAL;
+#if defined(RTLD_DEEPBIND)
+        if(flags & EPROSIMA_DL_DEEPBIND)
+            mode |= RTLD_DEEPBIND;
 #endif
+
+        libraryHandle = dlopen(filename, mode);
+#endif
+
+        EPROSIMA_TRACE_END("eProsimaLoadLibrary");
     }
     else
     {
@@ -28,6 +215,116 @@ void* eProsimaLoadLibrary(const char *filename)
     return libraryHandle;
 }
 
+int eProsimaLoadLibraries(const char * const *filenames, void **handles, int count, int flags, int threadCount)
+{
+    const char* const METHOD_NAME = "eProsimaLoadLibraries";
+    struct eProsima_DLWorker *workers = NULL;
+    int returnedValue = -1, i = 0, created = 0;
+
+    if(filenames != NULL && handles != NULL && count >= 0)
+    {
+        if(threadCount > count)
+            threadCount = count;
+        if(threadCount < 1)
+            threadCount = 1;
+
+        workers = (struct eProsima_DLWorker*)malloc(threadCount * sizeof(struct eProsima_DLWorker));
+
+        if(workers != NULL)
+        {
+            for(i = 0; i < threadCount; ++i)
+            {
+                workers[i].filenames = filenames;
+                workers[i].handles = handles;
+                workers[i].count = count;
+                workers[i].flags = flags;
+                workers[i].first = i;
+                workers[i].step = threadCount;
+            }
+
+            if(threadCount > 1)
+            {
+#if defined(RTI_WIN32)
+                HANDLE *threads = (HANDLE*)malloc(threadCount * sizeof(HANDLE));
+
+                if(threads != NULL)
+                {
+                    // The calling thread does the work of the first worker.
+                    for(created = 1; created < threadCount; ++created)
+                    {
+                        threads[created] = CreateThread(NULL, 0, eProsimaLoadLibrariesThread, &workers[created], 0, NULL);
+
+                        if(threads[created] == NULL)
+                            break;
+                    }
+
+                    eProsimaLoadLibrariesWork(&workers[0]);
+
+                    for(i = 1; i < created; ++i)
+                    {
+                        WaitForSingleObject(threads[i], INFINITE);
+                        CloseHandle(threads[i]);
+                    }
+
+                    free(threads);
+                }
+                else
+                    created = 0;
+#elif (defined(RTI_UNIX) || defined(RTI_LINUX))
+                pthread_t *threads = (pthread_t*)malloc(threadCount * sizeof(pthread_t));
+
+                if(threads != NULL)
+                {
+                    // The calling thread does the work of the first worker.
+                    for(created = 1; created < threadCount; ++created)
+                    {
+                        if(pthread_create(&threads[created], NULL, eProsimaLoadLibrariesThread, &workers[created]) != 0)
+                            break;
+                    }
+
+                    eProsimaLoadLibrariesWork(&workers[0]);
+
+                    for(i = 1; i < created; ++i)
+                        pthread_join(threads[i], NULL);
+
+                    free(threads);
+                }
+                else
+                    created = 0;
+#endif
+
+                // Workers that could not be started are done in the calling thread.
+                for(i = created; i < threadCount; ++i)
+                    eProsimaLoadLibrariesWork(&workers[i]);
+            }
+            else
+            {
+                eProsimaLoadLibrariesWork(&workers[0]);
+            }
+
+            returnedValue = 0;
+
+            for(i = 0; i < count; ++i)
+            {
+                if(handles[i] != NULL)
+                    ++returnedValue;
+            }
+
+            free(workers);
+        }
+        else
+        {
+            printError("Cannot allocate memory for the workers");
+        }
+    }
+    else
+    {
+        printError("Bad parameters");
+    }
+
+    return returnedValue;
+}
+
 void* eProsimaGetProcAddress(void *libraryHandle, const char *functionName)
 {
     const char* const METHOD_NAME = "eProsimaGetProcAddress";
@@ -35,11 +332,35 @@ void* eProsimaGetProcAddress(void *libraryHandle, const char *functionName)
 
     if(libraryHandle != NULL && functionName != NULL)
     {
-#if defined(RTI_WIN32)
+        if(eProsimaIsStaticLibrary(libraryHandle))
+        {
+            int i = 0;
+
+            eProsimaLockStaticSymbols();
+
+            for(i = 0; i < staticSymbolsLength && functionPointer == NULL; ++i)
+            {
+                if(staticSymbols[i].library == libraryHandle &&
+                        strcmp(staticSymbols[i].name, functionName) == 0)
+                    functionPointer = staticSymbols[i].functionPointer;
+            }
+
+            eProsimaUnlockStaticSymbols();
+
+            return functionPointer;
+        }
+
+        EPROSIMA_TRACE_BEGIN("eProsimaGetProcAddress", functionName);
+
+#if defined(EPROSIMA_DL_STATIC_ONLY)
+        // The dynamic loader is not used.
+#elif defined(RTI_WIN32)
         functionPointer = GetProcAddress(libraryHandle, functionName);
 #elif (defined(RTI_UNIX) || defined(RTI_LINUX))
         functionPointer = dlsym(libraryHandle, functionName);
 #endif
+
+        EPROSIMA_TRACE_END("eProsimaGetProcAddress");
     }
     else
     {
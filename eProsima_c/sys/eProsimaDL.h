@@ -1,21 +1,116 @@
 #ifndef _EPROSIMA_C_SYS_EPROSIMADL_H_
 #define _EPROSIMA_C_SYS_EPROSIMADL_H_
 
+/**
+ * \brief Maximum number of functions, and of libraries, that can be registered with eProsimaRegisterStaticSymbol.
+ */
+#ifndef EPROSIMA_DL_STATIC_SYMBOLS_MAX
+#define EPROSIMA_DL_STATIC_SYMBOLS_MAX 64
+#endif // EPROSIMA_DL_STATIC_SYMBOLS_MAX
+
+/**
+ * \brief This macro registers at load time a function that is linked in the executable, so it can be
+ * loaded with eProsimaLoadLibrary and eProsimaGetProcAddress without using the dynamic loader.
+ *
+ * Example: EPROSIMA_DL_REGISTER_SYMBOL("libmyplugin.so", MyPlugin_create)
+ *
+ * When the function is in a static library, the linker has to keep the object file that uses this macro
+ * (i.e. --whole-archive). Otherwise eProsimaRegisterStaticSymbol has to be called explicitly.
+ *
+ * \param libraryName Name used in the "pluginName.library" property.
+ * \param function Function to register. The name of the function is used in the "pluginName.create_function" property.
+ */
+#if defined(_MSC_VER)
+#pragma section(".CRT$XCU", read)
+#define EPROSIMA_DL_REGISTER_SYMBOL(libraryName, function) \
+    static void __cdecl eProsimaDLRegister_##function(void) \
+    { \
+        eProsimaRegisterStaticSymbol(libraryName, #function, (void*)&function); \
+    } \
+    __declspec(allocate(".CRT$XCU")) void (__cdecl *eProsimaDLRegisterPointer_##function)(void) = eProsimaDLRegister_##function;
+#else
+#define EPROSIMA_DL_REGISTER_SYMBOL(libraryName, function) \
+    static void eProsimaDLRegister_##function(void) __attribute__((constructor)); \
+    static void eProsimaDLRegister_##function(void) \
+    { \
+        eProsimaRegisterStaticSymbol(libraryName, #function, (void*)&function); \
+    }
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif // __cplusplus
 
+    /**
+     * \brief Flags that control how a dynamic library is loaded. They can be combined.
+     * They are only applied in UNIX systems. In Windows systems the symbols are always bound at load time.
+     */
+    typedef enum EPROSIMA_DL_FLAGS
+    {
+        /// Symbols are bound the first time they are called (RTLD_LAZY).
+        EPROSIMA_DL_LAZY = 0x00,
+        /// All symbols are bound when the library is loaded (RTLD_NOW).
+        EPROSIMA_DL_NOW = 0x01,
+        /// Symbols of the library are not available for libraries loaded later (RTLD_LOCAL).
+        EPROSIMA_DL_LOCAL = 0x00,
+        /// Symbols of the library are available for libraries loaded later (RTLD_GLOBAL).
+        EPROSIMA_DL_GLOBAL = 0x02,
+        /// The library prefers its own symbols over the global ones (RTLD_DEEPBIND). Only in GNU systems.
+        EPROSIMA_DL_DEEPBIND = 0x04
+    } EPROSIMA_DL_FLAGS;
+
+    /**
+     * \brief This function registers a function that is linked in the executable.
+     *
+     * Later calls to eProsimaLoadLibrary with the same library name return a handle of the registered library
+     * instead of using the dynamic loader, and eProsimaGetProcAddress returns the registered function. The
+     * functions have to be registered before the libraries are loaded. The strings are not copied.
+     *
+     * \param libraryName The name of the library. Cannot be NULL.
+     * \param functionName The name of the function. Cannot be NULL.
+     * \param functionPointer Pointer to the function. Cannot be NULL.
+     * \return 0 if the function was registered. In error case -1 is returned.
+     */
+    int eProsimaRegisterStaticSymbol(const char *libraryName, const char *functionName, void *functionPointer);
+
     /**
      * \brief This function loads a dynamic library.
      *
+     * If some function was registered for this library with eProsimaRegisterStaticSymbol, the dynamic loader
+     * is not used. When EPROSIMA_DL_STATIC_ONLY is defined, the dynamic loader is never used.
+     *
      * \param filename The name of the dynamic library that will be loaded. Cannot be NULL.
      * \return Pointer to the handle of the dynamic library. In error case NULL pointer is returned.
      */
     void* eProsimaLoadLibrary(const char *filename);
 
+    /**
+     * \brief This function loads a dynamic library using the given flags.
+     *
+     * \param filename The name of the dynamic library that will be loaded. Cannot be NULL.
+     * \param flags Combination of EPROSIMA_DL_FLAGS values.
+     * \return Pointer to the handle of the dynamic library. In error case NULL pointer is returned.
+     */
+    void* eProsimaLoadLibraryWithFlags(const char *filename, int flags);
+
+    /**
+     * \brief This function loads several dynamic libraries in parallel using worker threads.
+     *
+     * \param filenames Array with the names of the dynamic libraries. Cannot be NULL.
+     * \param handles Array where the handle of each library will be stored. A NULL handle is stored
+     * for the libraries that could not be loaded. Cannot be NULL.
+     * \param count Number of libraries.
+     * \param flags Combination of EPROSIMA_DL_FLAGS values.
+     * \param threadCount Maximum number of worker threads. If the value is lower than 2, the libraries
+     * are loaded in the calling thread.
+     * \return Number of libraries that were loaded. In error case -1 is returned.
+     */
+    int eProsimaLoadLibraries(const char * const *filenames, void **handles, int count, int flags, int threadCount);
+
     /**
      * \brief This function loads a function pointer that it's in a dynamic library.
+     * If the handle was returned for a registered library, the function is searched in the registered functions.
      *
      * \param libraryHandle The handle of the dynamic library. Cannot be NULL.
      * \param functionName The name of the function. Cannot be NULL.
@@ -0,0 +1,252 @@
+#include "messageRing.h"
+#include "atomic.h"
+
+#include <string.h>
+
+#if defined(RTI_LINUX)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#elif defined(RTI_WIN32)
+#include <Windows.h>
+#elif defined(RTI_UNIX)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#define MESSAGE_RING_MAGIC 0x52494e47U // "RING"
+
+#define MESSAGE_RING_ALIGNMENT 64
+
+/**
+ * \brief Header of the ring. The counters modified by the producers and by the consumer are in
+ * different cache lines.
+ */
+struct eProsima_MessageRing
+{
+    unsigned int magic;
+    unsigned int slotsMask;
+    unsigned int slotSize;
+    unsigned int messageSizeMax;
+    char padding0[MESSAGE_RING_ALIGNMENT - 4 * sizeof(unsigned int)];
+
+    /// Next ticket reserved by the producers.
+    unsigned long long head;
+    char padding1[MESSAGE_RING_ALIGNMENT - sizeof(unsigned long long)];
+
+    /// Next ticket taken by the consumer.
+    unsigned long long tail;
+    /// Futex word. It is increased every time the consumer has to be woken up.
+    unsigned int wakeup;
+    /// Not zero while the consumer is sleeping.
+    unsigned int waiters;
+    unsigned int unblock;
+    /// Messages discarded by the consumer because their length was bad.
+    unsigned int dropped;
+    char padding2[MESSAGE_RING_ALIGNMENT - sizeof(unsigned long long) - 4 * sizeof(unsigned int)];
+};
+
+/**
+ * \brief Header of each slot. The message follows it.
+ *
+ * A slot with ticket t is free when sequence == t, it contains a message when sequence == t + 1 and
+ * it is released when sequence == t + slotsLength.
+ */
+struct MessageRingSlot
+{
+    unsigned long long sequence;
+    unsigned int length;
+    unsigned int reserved;
+};
+
+#define MESSAGE_RING_SLOT(ring, ticket) \
+    ((struct MessageRingSlot*)((char*)((ring) + 1) + (size_t)((ticket) & (ring)->slotsMask) * (ring)->slotSize))
+
+static unsigned int roundUpPowerOfTwo(unsigned int value)
+{
+    unsigned int returnedValue = 1;
+
+    while(returnedValue < value)
+        returnedValue <<= 1;
+
+    return returnedValue;
+}
+
+static unsigned int getSlotSize(unsigned int messageSizeMax)
+{
+    return (sizeof(struct MessageRingSlot) + messageSizeMax + MESSAGE_RING_ALIGNMENT - 1) & ~(MESSAGE_RING_ALIGNMENT - 1);
+}
+
+static void waitWakeup(struct eProsima_MessageRing *ring, unsigned int value)
+{
+#if defined(RTI_LINUX)
+    // Shared futex, so producers of other processes can wake up the consumer.
+    syscall(SYS_futex, &ring->wakeup, FUTEX_WAIT, value, NULL, NULL, 0);
+#elif defined(RTI_WIN32)
+    if(EPROSIMA_ATOMIC_LOAD32(&ring->wakeup) == value)
+        Sleep(1);
+#else
+    if(EPROSIMA_ATOMIC_LOAD32(&ring->wakeup) == value)
+        usleep(1000);
+#endif
+}
+
+static void wakeUp(struct eProsima_MessageRing *ring)
+{
+    EPROSIMA_ATOMIC_ADD32(&ring->wakeup, 1);
+#if defined(RTI_LINUX)
+    syscall(SYS_futex, &ring->wakeup, FUTEX_WAKE, 1, NULL, NULL, 0);
+#endif
+}
+
+size_t eProsimaMessageRing_getSize(unsigned int slotsLength, unsigned int messageSizeMax)
+{
+    return sizeof(struct eProsima_MessageRing) + (size_t)roundUpPowerOfTwo(slotsLength) * getSlotSize(messageSizeMax);
+}
+
+struct eProsima_MessageRing* eProsimaMessageRing_init(void *memory, unsigned int slotsLength, unsigned int messageSizeMax)
+{
+    struct eProsima_MessageRing *ring = (struct eProsima_MessageRing*)memory;
+    unsigned long long ticket = 0;
+
+    if(ring == NULL || slotsLength == 0)
+        return NULL;
+
+    memset(ring, 0, sizeof(struct eProsima_MessageRing));
+    ring->slotsMask = roundUpPowerOfTwo(slotsLength) - 1;
+    ring->slotSize = getSlotSize(messageSizeMax);
+    ring->messageSizeMax = messageSizeMax;
+
+    for(ticket = 0; ticket <= ring->slotsMask; ++ticket)
+    {
+        MESSAGE_RING_SLOT(ring, ticket)->sequence = ticket;
+        MESSAGE_RING_SLOT(ring, ticket)->length = 0;
+    }
+
+    // The magic number is written the last one, so other processes don't use a half initialized ring.
+    EPROSIMA_ATOMIC_STORE32(&ring->magic, MESSAGE_RING_MAGIC);
+
+    return ring;
+}
+
+struct eProsima_MessageRing* eProsimaMessageRing_attach(void *memory, size_t size)
+{
+    struct eProsima_MessageRing *ring = (struct eProsima_MessageRing*)memory;
+
+    if(ring == NULL || size < sizeof(struct eProsima_MessageRing) || EPROSIMA_ATOMIC_LOAD32(&ring->magic) != MESSAGE_RING_MAGIC ||
+            size < sizeof(struct eProsima_MessageRing) + (size_t)(ring->slotsMask + 1) * ring->slotSize)
+        return NULL;
+
+    return ring;
+}
+
+unsigned int eProsimaMessageRing_getMessageSizeMax(const struct eProsima_MessageRing *ring)
+{
+    return ring->messageSizeMax;
+}
+
+void* eProsimaMessageRing_reserve(struct eProsima_MessageRing *ring, unsigned long long *ticket)
+{
+    struct MessageRingSlot *slot = NULL;
+    unsigned long long position = EPROSIMA_ATOMIC_LOAD64(&ring->head), sequence = 0;
+
+    for(;;)
+    {
+        slot = MESSAGE_RING_SLOT(ring, position);
+        sequence = EPROSIMA_ATOMIC_LOAD64(&slot->sequence);
+
+        if(sequence == position)
+        {
+            if(EPROSIMA_ATOMIC_CAS64(&ring->head, position, position + 1))
+                break;
+        }
+        else if((long long)(sequence - position) < 0)
+        {
+            // The consumer has not released this slot yet. The ring is full.
+            return NULL;
+        }
+
+        position = EPROSIMA_ATOMIC_LOAD64(&ring->head);
+    }
+
+    *ticket = position;
+    return slot + 1;
+}
+
+void eProsimaMessageRing_commit(struct eProsima_MessageRing *ring, unsigned long long ticket, unsigned int length)
+{
+    struct MessageRingSlot *slot = MESSAGE_RING_SLOT(ring, ticket);
+
+    slot->length = length;
+    EPROSIMA_ATOMIC_STORE64(&slot->sequence, ticket + 1);
+
+    // The message has to be visible before checking whether the consumer sleeps.
+    EPROSIMA_ATOMIC_FENCE();
+
+    if(EPROSIMA_ATOMIC_LOAD32(&ring->waiters) != 0)
+        wakeUp(ring);
+}
+
+void* eProsimaMessageRing_take(struct eProsima_MessageRing *ring, unsigned int *length, int blocking)
+{
+    struct MessageRingSlot *slot = MESSAGE_RING_SLOT(ring, ring->tail);
+    unsigned int wakeupValue = 0, messageLength = 0;
+
+    for(;;)
+    {
+        if(EPROSIMA_ATOMIC_LOAD64(&slot->sequence) == ring->tail + 1)
+        {
+            messageLength = slot->length;
+            EPROSIMA_ATOMIC_STORE64(&ring->tail, ring->tail + 1);
+
+            // The producers can be other processes, so the length is checked before the message is lent.
+            if(messageLength <= ring->messageSizeMax)
+            {
+                *length = messageLength;
+                return slot + 1;
+            }
+
+            eProsimaMessageRing_release(ring, slot + 1);
+            EPROSIMA_ATOMIC_ADD32(&ring->dropped, 1);
+            slot = MESSAGE_RING_SLOT(ring, ring->tail);
+            continue;
+        }
+
+        if(EPROSIMA_ATOMIC_LOAD32(&ring->unblock) != 0)
+        {
+            EPROSIMA_ATOMIC_STORE32(&ring->unblock, 0);
+            return NULL;
+        }
+
+        if(!blocking)
+            return NULL;
+
+        // The slot is checked again after announcing the consumer sleeps, so no commit is lost.
+        wakeupValue = EPROSIMA_ATOMIC_LOAD32(&ring->wakeup);
+        EPROSIMA_ATOMIC_ADD32(&ring->waiters, 1);
+
+        if(EPROSIMA_ATOMIC_LOAD64(&slot->sequence) != ring->tail + 1 && EPROSIMA_ATOMIC_LOAD32(&ring->unblock) == 0)
+            waitWakeup(ring, wakeupValue);
+
+        EPROSIMA_ATOMIC_ADD32(&ring->waiters, -1);
+    }
+}
+
+void eProsimaMessageRing_release(struct eProsima_MessageRing *ring, void *message)
+{
+    struct MessageRingSlot *slot = (struct MessageRingSlot*)message - 1;
+
+    // A taken slot has sequence == ticket + 1.
+    EPROSIMA_ATOMIC_STORE64(&slot->sequence, slot->sequence + ring->slotsMask);
+}
+
+unsigned int eProsimaMessageRing_getDropped(struct eProsima_MessageRing *ring)
+{
+    return EPROSIMA_ATOMIC_LOAD32(&ring->dropped);
+}
+
+void eProsimaMessageRing_unblock(struct eProsima_MessageRing *ring)
+{
+    EPROSIMA_ATOMIC_STORE32(&ring->unblock, 1);
+    wakeUp(ring);
+}
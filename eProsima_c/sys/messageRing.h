@@ -0,0 +1,116 @@
+#ifndef _EPROSIMA_C_SYS_MESSAGERING_H_
+#define _EPROSIMA_C_SYS_MESSAGERING_H_
+
+#include "eProsima_c/config.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/**
+ * \brief Bounded lock-free ring of messages with several producers and one consumer.
+ *
+ * The ring is stored in memory provided by the caller, so it can be placed in shared memory and used
+ * by several processes. It doesn't contain pointers. Producers reserve a slot, write the message
+ * directly in it and commit it. The consumer borrows the committed messages without copying them and
+ * releases each one when it is processed. Messages can be released in any order.
+ *
+ * The consumer blocks on a futex in Linux systems, so producers only make a system call when the
+ * consumer is sleeping.
+ */
+struct eProsima_MessageRing;
+
+/**
+ * \brief This function returns the memory needed by a ring.
+ *
+ * \param slotsLength Number of messages. It is rounded up to a power of two.
+ * \param messageSizeMax Maximum size of a message.
+ * \return The size of the memory in bytes.
+ */
+size_t eProsimaMessageRing_getSize(unsigned int slotsLength, unsigned int messageSizeMax);
+
+/**
+ * \brief This function initializes a ring in the given memory.
+ *
+ * \param memory Memory of eProsimaMessageRing_getSize bytes. It must be aligned to 64 bytes. Cannot be NULL.
+ * \param slotsLength Number of messages. It is rounded up to a power of two.
+ * \param messageSizeMax Maximum size of a message.
+ * \return The ring. In error case, NULL value is returned.
+ */
+struct eProsima_MessageRing* eProsimaMessageRing_init(void *memory, unsigned int slotsLength, unsigned int messageSizeMax);
+
+/**
+ * \brief This function checks that memory initialized by other process contains a ring.
+ *
+ * \param memory The memory. Cannot be NULL.
+ * \param size Size of the memory.
+ * \return The ring. If the memory doesn't contain a valid ring, NULL value is returned.
+ */
+struct eProsima_MessageRing* eProsimaMessageRing_attach(void *memory, size_t size);
+
+/**
+ * \brief This function returns the maximum size of a message.
+ */
+unsigned int eProsimaMessageRing_getMessageSizeMax(const struct eProsima_MessageRing *ring);
+
+/**
+ * \brief This function reserves a slot for a message. It never blocks.
+ *
+ * \param ring The ring. Cannot be NULL.
+ * \param ticket Where the ticket of the slot is stored. It is used to commit the message. Cannot be NULL.
+ * \return The memory of the message. If the ring is full, NULL value is returned.
+ */
+void* eProsimaMessageRing_reserve(struct eProsima_MessageRing *ring, unsigned long long *ticket);
+
+/**
+ * \brief This function publishes a message written in a reserved slot and wakes up the consumer.
+ *
+ * \param ring The ring. Cannot be NULL.
+ * \param ticket The ticket returned by eProsimaMessageRing_reserve.
+ * \param length Length of the message.
+ */
+void eProsimaMessageRing_commit(struct eProsima_MessageRing *ring, unsigned long long ticket, unsigned int length);
+
+/**
+ * \brief This function borrows the next message. It can only be called by one thread at the same time.
+ * The messages whose length is greater than the maximum size are released without being returned.
+ *
+ * \param ring The ring. Cannot be NULL.
+ * \param length Where the length of the message is stored. Cannot be NULL.
+ * \param blocking If it is not zero, the function waits until a message arrives or eProsimaMessageRing_unblock is called.
+ * \return The memory of the message. If there is no message or the consumer was unblocked, NULL value is returned.
+ */
+void* eProsimaMessageRing_take(struct eProsima_MessageRing *ring, unsigned int *length, int blocking);
+
+/**
+ * \brief This function returns a borrowed message, so its slot can be reused by the producers.
+ *
+ * \param ring The ring. Cannot be NULL.
+ * \param message The message returned by eProsimaMessageRing_take.
+ */
+void eProsimaMessageRing_release(struct eProsima_MessageRing *ring, void *message);
+
+/**
+ * \brief This function returns the number of messages discarded by eProsimaMessageRing_take because their
+ * length was greater than the maximum size.
+ *
+ * \param ring The ring. Cannot be NULL.
+ */
+unsigned int eProsimaMessageRing_getDropped(struct eProsima_MessageRing *ring);
+
+/**
+ * \brief This function wakes up the consumer. The next call to eProsimaMessageRing_take that has to
+ * wait returns NULL.
+ *
+ * \param ring The ring. Cannot be NULL.
+ */
+void eProsimaMessageRing_unblock(struct eProsima_MessageRing *ring);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_SYS_MESSAGERING_H_
@@ -0,0 +1,330 @@
+#include "trace.h"
+#include "atomic.h"
+#include "clock.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(RTI_WIN32)
+#include <Windows.h>
+#elif defined(RTI_LINUX)
+#include <unistd.h>
+#include <sys/syscall.h>
+#else
+#include <unistd.h>
+#endif
+
+#define TRACE_BLOCKS (EPROSIMA_TRACE_THREAD_EVENTS_MAX / EPROSIMA_TRACE_BLOCK_EVENTS)
+
+#define TRACE_PHASE_BEGIN 'B'
+#define TRACE_PHASE_END 'E'
+
+struct eProsima_TraceEvent
+{
+    const char *name;
+    unsigned long long timestamp;
+    char phase;
+    char detail[EPROSIMA_TRACE_DETAIL_LENGTH];
+};
+
+/**
+ * \brief Events of a thread. Only the thread writes them. The exporter reads the first count events: the
+ * thread stores an event and its block before it publishes the new count.
+ */
+struct eProsima_TraceBuffer
+{
+    struct eProsima_TraceBuffer *next;
+    unsigned long long threadId;
+    /// Published number of events.
+    int count;
+    /// Recorded spans that are not ended. Their end events always have room.
+    int openSpans;
+    /// Spans that were not recorded and are not ended. The spans nested in them are not recorded either.
+    int droppedSpans;
+    struct eProsima_TraceEvent *blocks[TRACE_BLOCKS];
+};
+
+volatile int eProsimaTraceEnabled = 0;
+
+/// The buffers are kept until the process ends, so the exporter can read the ones of finished threads.
+static struct eProsima_TraceBuffer *buffers = NULL;
+
+static int buffersLock = 0;
+
+static unsigned long long dropped = 0;
+
+EPROSIMA_TRACE_THREAD_LOCAL int eProsimaTraceThreadSpans = 0;
+
+static EPROSIMA_TRACE_THREAD_LOCAL struct eProsima_TraceBuffer *threadBuffer = NULL;
+
+static void lockBuffers(void)
+{
+    while(!EPROSIMA_ATOMIC_CAS32(&buffersLock, 0, 1))
+        EPROSIMA_CPU_RELAX();
+}
+
+static void unlockBuffers(void)
+{
+    EPROSIMA_ATOMIC_STORE32(&buffersLock, 0);
+}
+
+static unsigned long long getThreadId(void)
+{
+#if defined(RTI_WIN32)
+    return (unsigned long long)GetCurrentThreadId();
+#elif defined(RTI_LINUX)
+    return (unsigned long long)syscall(SYS_gettid);
+#else
+    static int lastThreadId = 0;
+
+    return (unsigned long long)EPROSIMA_ATOMIC_ADD32(&lastThreadId, 1);
+#endif
+}
+
+static unsigned long getProcessId(void)
+{
+#if defined(RTI_WIN32)
+    return (unsigned long)GetCurrentProcessId();
+#else
+    return (unsigned long)getpid();
+#endif
+}
+
+static struct eProsima_TraceBuffer* getThreadBuffer(void)
+{
+    struct eProsima_TraceBuffer *buffer = threadBuffer;
+
+    if(buffer == NULL)
+    {
+        buffer = (struct eProsima_TraceBuffer*)calloc(1, sizeof(struct eProsima_TraceBuffer));
+
+        if(buffer != NULL)
+        {
+            buffer->threadId = getThreadId();
+
+            lockBuffers();
+            buffer->next = buffers;
+            buffers = buffer;
+            unlockBuffers();
+
+            threadBuffer = buffer;
+        }
+    }
+
+    return buffer;
+}
+
+/**
+ * \brief This function allocates the blocks of the events until the given one.
+ */
+static int reserveEvents(struct eProsima_TraceBuffer *buffer, int last)
+{
+    int block = 0;
+
+    for(block = 0; block <= last / EPROSIMA_TRACE_BLOCK_EVENTS; ++block)
+    {
+        if(buffer->blocks[block] == NULL)
+        {
+            buffer->blocks[block] = (struct eProsima_TraceEvent*)malloc(EPROSIMA_TRACE_BLOCK_EVENTS *
+                sizeof(struct eProsima_TraceEvent));
+
+            if(buffer->blocks[block] == NULL)
+                return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void updateThreadSpans(struct eProsima_TraceBuffer *buffer)
+{
+    eProsimaTraceThreadSpans = buffer->openSpans + buffer->droppedSpans;
+}
+
+static struct eProsima_TraceEvent* getEvent(struct eProsima_TraceBuffer *buffer, int event)
+{
+    return &buffer->blocks[event / EPROSIMA_TRACE_BLOCK_EVENTS][event % EPROSIMA_TRACE_BLOCK_EVENTS];
+}
+
+void eProsimaTrace_setEnabled(int enabled)
+{
+    EPROSIMA_ATOMIC_STORE32(&eProsimaTraceEnabled, enabled ? 1 : 0);
+}
+
+void eProsimaTrace_begin(const char *name, const char *detail)
+{
+    struct eProsima_TraceBuffer *buffer = NULL;
+    struct eProsima_TraceEvent *event = NULL;
+    int i = 0;
+
+    // The thread has spans that are not ended. This one is nested in them, so it is not recorded.
+    if(!EPROSIMA_ATOMIC_LOAD32(&eProsimaTraceEnabled))
+    {
+        if(threadBuffer != NULL)
+        {
+            ++threadBuffer->droppedSpans;
+            updateThreadSpans(threadBuffer);
+        }
+        return;
+    }
+
+    buffer = getThreadBuffer();
+
+    if(buffer == NULL)
+    {
+        EPROSIMA_ATOMIC_ADD64(&dropped, 1);
+        return;
+    }
+
+    // The end events of this span and the open ones need room.
+    if(buffer->droppedSpans > 0 || buffer->count + buffer->openSpans + 2 > EPROSIMA_TRACE_THREAD_EVENTS_MAX ||
+            reserveEvents(buffer, buffer->count + buffer->openSpans + 1) != 0)
+    {
+        ++buffer->droppedSpans;
+        updateThreadSpans(buffer);
+        EPROSIMA_ATOMIC_ADD64(&dropped, 1);
+        return;
+    }
+
+    event = getEvent(buffer, buffer->count);
+    event->name = name;
+    event->phase = TRACE_PHASE_BEGIN;
+    event->detail[0] = '\0';
+
+    if(detail != NULL)
+    {
+        for(i = 0; i < EPROSIMA_TRACE_DETAIL_LENGTH - 1 && detail[i] != '\0'; ++i)
+            event->detail[i] = detail[i];
+        event->detail[i] = '\0';
+    }
+
+    event->timestamp = eProsimaClock_getNanoseconds();
+
+    ++buffer->openSpans;
+    updateThreadSpans(buffer);
+    EPROSIMA_ATOMIC_STORE32(&buffer->count, buffer->count + 1);
+}
+
+void eProsimaTrace_end(const char *name)
+{
+    struct eProsima_TraceBuffer *buffer = threadBuffer;
+    struct eProsima_TraceEvent *event = NULL;
+    unsigned long long timestamp = eProsimaClock_getNanoseconds();
+
+    if(buffer == NULL)
+        return;
+
+    if(buffer->droppedSpans > 0)
+    {
+        --buffer->droppedSpans;
+        updateThreadSpans(buffer);
+        return;
+    }
+
+    // The span was begun before the tracing was enabled.
+    if(buffer->openSpans == 0)
+        return;
+
+    event = getEvent(buffer, buffer->count);
+    event->name = name;
+    event->phase = TRACE_PHASE_END;
+    event->detail[0] = '\0';
+    event->timestamp = timestamp;
+
+    --buffer->openSpans;
+    updateThreadSpans(buffer);
+    EPROSIMA_ATOMIC_STORE32(&buffer->count, buffer->count + 1);
+}
+
+static void writeJsonString(FILE *file, const char *string)
+{
+    const unsigned char *character = (const unsigned char*)string;
+
+    fputc('"', file);
+
+    for(; *character != '\0'; ++character)
+    {
+        if(*character == '"' || *character == '\\')
+            fprintf(file, "\\%c", *character);
+        else if(*character < 0x20)
+            fprintf(file, "\\u%04x", *character);
+        else
+            fputc(*character, file);
+    }
+
+    fputc('"', file);
+}
+
+int eProsimaTrace_writeChromeJson(const char *path)
+{
+    const char* const METHOD_NAME = "eProsimaTrace_writeChromeJson";
+    struct eProsima_TraceBuffer *buffer = NULL;
+    const struct eProsima_TraceEvent *event = NULL;
+    unsigned long processId = getProcessId();
+    FILE *file = NULL;
+    int count = 0, i = 0, first = 1, returnedValue = -1;
+
+    if(path == NULL)
+    {
+        printf("ERROR<%s>: Bad parameters\n", METHOD_NAME);
+        return returnedValue;
+    }
+
+    file = fopen(path, "w");
+
+    if(file == NULL)
+    {
+        printf("ERROR<%s>: Cannot open the file %s\n", METHOD_NAME, path);
+        return returnedValue;
+    }
+
+    // Timestamps are microseconds.
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+    lockBuffers();
+
+    for(buffer = buffers; buffer != NULL; buffer = buffer->next)
+    {
+        count = EPROSIMA_ATOMIC_LOAD32(&buffer->count);
+
+        for(i = 0; i < count; ++i)
+        {
+            event = getEvent(buffer, i);
+
+            fprintf(file, "%s\n{\"name\":", first ? "" : ",");
+            writeJsonString(file, event->name);
+            fprintf(file, ",\"cat\":\"eProsima\",\"ph\":\"%c\",\"ts\":%llu.%03u,\"pid\":%lu,\"tid\":%llu",
+                event->phase, event->timestamp / 1000ULL, (unsigned int)(event->timestamp % 1000ULL), processId,
+                buffer->threadId);
+
+            if(event->detail[0] != '\0')
+            {
+                fprintf(file, ",\"args\":{\"detail\":");
+                writeJsonString(file, event->detail);
+                fputc('}', file);
+            }
+
+            fputc('}', file);
+            first = 0;
+        }
+    }
+
+    unlockBuffers();
+
+    fprintf(file, "\n]}\n");
+
+    if(ferror(file) == 0)
+        returnedValue = 0;
+    else
+        printf("ERROR<%s>: Cannot write the file %s\n", METHOD_NAME, path);
+
+    if(fclose(file) != 0)
+        returnedValue = -1;
+
+    return returnedValue;
+}
+
+unsigned long long eProsimaTrace_getDropped(void)
+{
+    return EPROSIMA_ATOMIC_LOAD64(&dropped);
+}
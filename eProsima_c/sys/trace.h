@@ -0,0 +1,106 @@
+#ifndef _EPROSIMA_C_SYS_TRACE_H_
+#define _EPROSIMA_C_SYS_TRACE_H_
+
+#include "eProsima_c/config.h"
+
+#include <stddef.h>
+
+/**
+ * \brief Maximum number of events that a thread records. The events of each thread are stored in blocks of
+ * EPROSIMA_TRACE_BLOCK_EVENTS, allocated when they are needed.
+ */
+#ifndef EPROSIMA_TRACE_THREAD_EVENTS_MAX
+#define EPROSIMA_TRACE_THREAD_EVENTS_MAX 65536
+#endif // EPROSIMA_TRACE_THREAD_EVENTS_MAX
+
+#define EPROSIMA_TRACE_BLOCK_EVENTS 1024
+
+/**
+ * \brief Maximum length of the detail of a span, including the null character. Longer details are truncated.
+ */
+#define EPROSIMA_TRACE_DETAIL_LENGTH 64
+
+#if defined(_MSC_VER)
+#define EPROSIMA_TRACE_THREAD_LOCAL __declspec(thread)
+#else
+#define EPROSIMA_TRACE_THREAD_LOCAL __thread
+#endif
+
+/**
+ * \brief These macros mark the begin and the end of a span. The spans of a thread have to be nested.
+ *
+ * When the tracing is disabled they only read two flags. The spans that the thread began while it was enabled
+ * are still ended, so the begin and end events stay matched. If EPROSIMA_TRACE_DISABLED is defined they are
+ * removed.
+ *
+ * \param name Name of the span. It has to be a string that is not released (i.e. a literal).
+ * \param detail String that is copied in the begin event, i.e. the name of a library. It can be NULL.
+ */
+#if defined(EPROSIMA_TRACE_DISABLED)
+#define EPROSIMA_TRACE_BEGIN(name, detail) do {} while(0)
+#define EPROSIMA_TRACE_END(name) do {} while(0)
+#else
+#define EPROSIMA_TRACE_BEGIN(name, detail) \
+    do { if(eProsimaTraceEnabled || eProsimaTraceThreadSpans) eProsimaTrace_begin((name), (detail)); } while(0)
+#define EPROSIMA_TRACE_END(name) \
+    do { if(eProsimaTraceEnabled || eProsimaTraceThreadSpans) eProsimaTrace_end(name); } while(0)
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+    /**
+     * \brief Flag read by EPROSIMA_TRACE_BEGIN and EPROSIMA_TRACE_END. It is changed with eProsimaTrace_setEnabled.
+     */
+    extern volatile int eProsimaTraceEnabled;
+
+    /**
+     * \brief Number of spans of the calling thread that are not ended, recorded or not. Read by
+     * EPROSIMA_TRACE_BEGIN and EPROSIMA_TRACE_END.
+     */
+    extern EPROSIMA_TRACE_THREAD_LOCAL int eProsimaTraceThreadSpans;
+
+    /**
+     * \brief This function enables or disables the tracing. The recorded events are kept when it is disabled.
+     *
+     * \param enabled 1 to enable it, 0 to disable it.
+     */
+    void eProsimaTrace_setEnabled(int enabled);
+
+    /**
+     * \brief This function records the begin of a span in the buffer of the calling thread with the time of the
+     * monotonic clock. The buffer is created the first time. When the tracing is disabled, the span is only
+     * counted, so its end is not recorded. Use EPROSIMA_TRACE_BEGIN instead.
+     */
+    void eProsimaTrace_begin(const char *name, const char *detail);
+
+    /**
+     * \brief This function records the end of the last span begun by the calling thread. Use EPROSIMA_TRACE_END
+     * instead.
+     */
+    void eProsimaTrace_end(const char *name);
+
+    /**
+     * \brief This function writes the events of all threads in the Chrome trace event format (JSON), that is
+     * loaded by chrome://tracing and Perfetto. Threads can record events while it is called; their new events
+     * are not written. The timestamps are the ones of the monotonic clock of the system, so files of several
+     * processes of the same host can be joined.
+     *
+     * \param path Path of the file. It is overwritten.
+     * \return 0 if the file was written. In other case -1 is returned.
+     */
+    int eProsimaTrace_writeChromeJson(const char *path);
+
+    /**
+     * \brief This function returns the number of spans that were not recorded because the buffer of a thread was
+     * full (EPROSIMA_TRACE_THREAD_EVENTS_MAX) or a block could not be allocated.
+     */
+    unsigned long long eProsimaTrace_getDropped(void);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _EPROSIMA_C_SYS_TRACE_H_